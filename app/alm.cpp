@@ -88,6 +88,7 @@ void help() noexcept {
 	"  \x1B[1m-\x1B[0m (emplace | remove | change | replace)\r\n\r\n\r\n"
 	"\x1B[34m\x1B[1m[FLAGS]\x1B[0m\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-alm2 | --alm2]                               flag to set ALM type 2\r\n"
+	"\x1B[33m\x1B[1m×\x1B[0m [-alm3 | --alm3]                               flag to set ALM type 3\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-accurate | --accurate]                       flag to accurate check ngram\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-allow-unk | --allow-unk]                     flag allowing to unknown word\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-only-good | --only-good]                     flag allowing to consider words from the white list only\r\n"
@@ -97,6 +98,7 @@ void help() noexcept {
 	"\x1B[33m\x1B[1m×\x1B[0m [-lower-case | --lower-case]                   flag allowing to case-insensitive\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-confidence | --confidence]                   flag arpa file loading without pre-processing the words\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-w-bin-arpa | --w-bin-arpa]                   flag export in binary dictionary of only arpa data without n-gram statistics\r\n"
+	"\x1B[33m\x1B[1m×\x1B[0m [-w-bin-mmap | --w-bin-mmap]                   flag export in binary dictionary of n-gram tables for memory mapping, read only by -alm3 (not with -bin-password)\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-interpolate | --interpolate]                 flag allowing to use interpolation in estimating\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-mixed-dicts | --mixed-dicts]                 flag allowing the use of words consisting of mixed dictionaries\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-allow-stress | --allow-stress]               flag allowing the use of a stress symbol as part of the word\r\n"
@@ -142,6 +144,8 @@ void help() noexcept {
 	"\x1B[33m\x1B[1m×\x1B[0m [-bin-author <value> | --bin-author=<value>]                                 author of the dictionary for binary container\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-bin-copyright <value> | --bin-copyright=<value>]                           copyright of the dictionary owner for binary container\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-bin-aes <value> | --bin-aes=<value>]                                       aes encryption Size \x1B[1m(128, 192, 256) bits\x1B[0m for binary container\r\n"
+	"\x1B[33m\x1B[1m×\x1B[0m [-bin-codec <value> | --bin-codec=<value>]                                   compression codec \x1B[1m(gzip, lz4, zstd)\x1B[0m for binary container, the best available by default\r\n"
+	"\x1B[33m\x1B[1m×\x1B[0m [-w-bin-quant <value> | --w-bin-quant=<value>]                               quantization size \x1B[1m(2 - 16) bits\x1B[0m of n-gram weights for memory mapping (requires -w-bin-mmap, read only by -alm3), unigrams are kept exact, codes take 1 byte up to 8 bits and 2 bytes above\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-bin-password <value> | --bin-password=<value>]                             encryption password \x1B[1m(if required)\x1B[0m, encryption is performed only when setting a password for binary container\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-abbrs <value> | --abbrs=<value>]                                           file address for abbreviations of \x1B[1m*.txt\x1B[0m for import\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-w-text <value> | --w-text=<value>]                                         file address for text of \x1B[1m*.txt\x1B[0m for export\r\n"
@@ -179,6 +183,10 @@ void help() noexcept {
 	"\x1B[33m\x1B[1m×\x1B[0m [-vprune-wltf <value> | --vprune-wltf=<value>]                               \x1B[1mwltf threshold\x1B[0m of pruning vocabulary\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-aprune-threshold <value> | --aprune-threshold=<value>]                     frequency threshold of pruning language model\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-aprune-max-gram <value> | --aprune-max-gram=<value>]                       maximum size of n-grams pruning\r\n"
+	"\x1B[33m\x1B[1m×\x1B[0m [-aprune-count <value> | --aprune-count=<value>]                             maximum number of n-grams, the pruning threshold is selected automatically\r\n"
+	"\x1B[33m\x1B[1m×\x1B[0m [-aprune-size <value> | --aprune-size=<value>]                               maximum size of binary container, the pruning threshold is selected automatically\r\n"
+	"  \x1B[1m-\x1B[0m (nb | nK | nM | nG), example: --aprune-size=2G\r\n"
+	"  \x1B[1m-\x1B[0m vocabulary and metadata are not pruned and count towards the size\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-utokens <value> | --utokens=<value>]                                       list of custom attributes\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-modify <value> | --modify=<value>]                                         modification flag for modify method\r\n"
 	"\x1B[33m\x1B[1m×\x1B[0m [-delta <value> | --delta=<value>]                                           delta size for smoothing by addsmooth algorithm\r\n"
@@ -280,6 +288,28 @@ int main(int argc, char * argv[]) noexcept {
 	if(binDictFile.empty() && !env.is("alphabet")){
 		// Выводим сообщение в консоль
 		print("alphabet in not set\r\n", env.get("log"));
+	// Если таблицы для отображения в память запрошены вместе с шифрованием, их нельзя отобразить из зашифрованного контейнера
+	} else if(env.is("w-bin-mmap") && env.is("bin-password")) {
+		// Выводим сообщение в консоль
+		print("flags -w-bin-mmap and -bin-password cannot be used together, memory mapped tables are not encrypted\r\n", env.get("log"));
+	// Если квантование запрошено без таблиц для отображения в память, квантовать нечего
+	} else if(env.is("w-bin-quant") && !env.is("w-bin-mmap")) {
+		// Выводим сообщение в консоль
+		print("flag -w-bin-quant requires -w-bin-mmap\r\n", env.get("log"));
+	// Если размер квантования не входит в допустимый диапазон
+	} else if(((value = env.get("w-bin-quant")) != nullptr) && (!alphabet.isNumber(value) || (stoi(value) < 2) || (stoi(value) > 16))) {
+		// Выводим сообщение в консоль
+		print("quantization size -w-bin-quant must be from 2 to 16 bits\r\n", env.get("log"));
+	// Если алгоритм сжатия не известен или не поддерживается сборкой
+	} else if(((value = env.get("bin-codec")) != nullptr) && !((string(value).compare("gzip") == 0) ||
+	((string(value).compare("lz4") == 0) && aspl_t::isCodec(aspl_t::codec_t::lz4)) ||
+	((string(value).compare("zstd") == 0) && aspl_t::isCodec(aspl_t::codec_t::zstd)))) {
+		// Выводим сообщение в консоль
+		print(alphabet.format(
+			"compression codec \"%s\" is not supported, available codecs: gzip%s%s\r\n", value,
+			(aspl_t::isCodec(aspl_t::codec_t::lz4) ? ", lz4" : ""),
+			(aspl_t::isCodec(aspl_t::codec_t::zstd) ? ", zstd" : "")
+		), env.get("log"));
 	// Продолжаем дальше
 	} else {
 		// Объявляем прогресс бра
@@ -530,7 +560,13 @@ int main(int argc, char * argv[]) noexcept {
 			if(env.is("method", "sentences") || env.is("method", "ppl") || env.is("method", "find") ||
 			env.is("method", "counts") || env.is("method", "fixcase") || env.is("method", "checktext")){
 				// Создаём обхъект языковой модели
-				unique_ptr <alm_t> alm(env.is("alm2") ? new alm2_t(&alphabet, &tokenizer) : new alm1_t(&alphabet, &tokenizer));
+				unique_ptr <alm_t> alm;
+				// Если нужно использовать ALM третьего типа
+				if(env.is("alm3")) alm.reset(new alm3_t(&alphabet, &tokenizer));
+				// Если нужно использовать ALM второго типа
+				else if(env.is("alm2")) alm.reset(new alm2_t(&alphabet, &tokenizer));
+				// Иначе используем ALM первого типа
+				else alm.reset(new alm1_t(&alphabet, &tokenizer));
 				// Устанавливаем адрес файла для логирования
 				alm->setLogfile(env.get("log"));
 				// Если количество ядер передано
@@ -634,6 +670,12 @@ int main(int argc, char * argv[]) noexcept {
 					if((value = env.get("bin-copyright")) != nullptr) ablm.setCopyright(value);
 					// Устанавливаем флаг отладки
 					if(debug == 1) ablm.setFlag(ablm_t::flag_t::debug);
+					// Если количество ядер передано
+					if(((value = env.get("threads")) != nullptr) && alphabet.isNumber(value)){
+						// Устанавливаем количество потоков
+						ablm.setThreads(stoi(value));
+					// Иначе устанавливаем 1 поток
+					} else ablm.setThreads(1);
 					// Выполняем инициализацию словаря
 					ablm.init();
 					// Если отладка включена, выводим индикатор загрузки
@@ -1067,6 +1109,8 @@ int main(int argc, char * argv[]) noexcept {
 			if(env.is("interpolate")) toolkit.setOption(toolkit_t::options_t::interpolate);
 			// Флаг учитывающий при сборке N-грамм, только те токены, которые соответствуют словам
 			if(env.is("only-token-words")) toolkit.setOption(toolkit_t::options_t::tokenWords);
+			// Если количество ядер передано, устанавливаем количество потоков обучения
+			if(((value = env.get("threads")) != nullptr) && alphabet.isNumber(value)) toolkit.setThreads(stoi(value));
 			// Если нужно установить все токены для идентифицирования как <unk>
 			if(env.is("tokens-all-unknown")) toolkit.setAllTokenUnknown();
 			// Если нужно установить все токены как не идентифицируемые
@@ -1152,6 +1196,12 @@ int main(int argc, char * argv[]) noexcept {
 				if((value = env.get("bin-copyright")) != nullptr) ablm.setCopyright(value);
 				// Устанавливаем флаг отладки
 				if(debug == 1) ablm.setFlag(ablm_t::flag_t::debug);
+				// Если количество ядер передано
+				if(((value = env.get("threads")) != nullptr) && alphabet.isNumber(value)){
+					// Устанавливаем количество потоков
+					ablm.setThreads(stoi(value));
+				// Иначе устанавливаем 1 поток
+				} else ablm.setThreads(1);
 				// Выполняем инициализацию словаря
 				ablm.init();
 				// Если это запрос информации о словаре
@@ -2351,8 +2401,43 @@ int main(int argc, char * argv[]) noexcept {
 					if((value = env.get("aprune-max-gram")) != nullptr) size = stoi(value);
 					// Если параметр прунинга получен
 					if((value = env.get("aprune-threshold")) != nullptr) prune = stod(value);
+					// Максимальное количество n-грамм
+					const size_t count = (((value = env.get("aprune-count")) != nullptr) && alphabet.isNumber(value) ? stoull(value) : 0);
+					// Максимальный размер бинарного контейнера
+					uintmax_t bytes = 0;
+					// Если параметр максимального размера получен
+					if((value = env.get("aprune-size")) != nullptr){
+						// Результат работы регулярного выражения
+						smatch match;
+						// Строка с размером
+						const string limit = value;
+						// Устанавливаем правило регулярного выражения
+						regex e("^\\s*([\\d\\.]+)\\s*(b|k|kb|m|mb|g|gb|t|tb)?\\s*$", regex::ECMAScript | regex::icase);
+						// Выполняем поиск размера
+						regex_search(limit, match, e);
+						// Если данные найдены
+						if(!match.empty()){
+							// Размерность памяти
+							double dimension = 1;
+							// Получаем единицу измерения
+							const string & param = match[2].str();
+							// Определяем размерность по единице измерения
+							switch(param.empty() ? 'b' : ::tolower(param.front())){
+								// Если это размерность в килобайтах
+								case 'k': dimension = 1024.0; break;
+								// Если это размерность в мегабайтах
+								case 'm': dimension = 1048576.0; break;
+								// Если это размерность в гигабайтах
+								case 'g': dimension = 1073741824.0; break;
+								// Если это размерность в терабайтах
+								case 't': dimension = 1099511627776.0; break;
+							}
+							// Запоминаем максимальный размер
+							bytes = uintmax_t(stod(match[1].str()) * dimension);
+						}
+					}
 					// Если параметры получены
-					if((size > 0) && (prune != 0.0)){
+					if((size > 0) && ((prune != 0.0) || (count > 0) || (bytes > 0))){
 						// Если отладка включена, выводим индикатор загрузки
 						if(debug > 0){
 							// Очищаем предыдущий прогресс-бар
@@ -2365,19 +2450,30 @@ int main(int argc, char * argv[]) noexcept {
 								case 2: pss.status(); break;
 							}
 						}
-						// Выполняем прунинг
-						toolkit.prune(prune, size, [debug, &pss](const u_short status) noexcept {
+						// Функция вывода статуса прунинга
+						auto statusFn = [debug, &pss](const u_short status) noexcept {
 							// Отображаем ход процесса
 							switch(debug){
 								case 1: pss.update(status); break;
 								case 2: pss.status(status); break;
 							}
-						});
+						};
+						// Если ограничения модели переданы, порог прунинга подбирается автоматически
+						if((count > 0) || (bytes > 0)){
+							// Выполняем прунинг до заданных ограничений
+							prune = toolkit.pruneTo(count, bytes, size, statusFn);
+						// Выполняем прунинг
+						} else toolkit.prune(prune, size, statusFn);
 						// Отображаем ход процесса
 						switch(debug){
 							case 1: pss.update(100); break;
 							case 2: pss.status(100); break;
 						}
+						// Если порог подобран автоматически, выводим его
+						if((debug > 0) && ((count > 0) || (bytes > 0))){
+							// Выводим подобранный порог прунинга
+							print(alphabet.format("selected pruning threshold: %4.8f\r\n", prune), env.get("log"), alphabet_t::log_t::info, false);
+						}
 					}
 				// Если нужно модифицировать arpa
 				} else if(env.is("method", "modify")) {
@@ -2650,6 +2746,21 @@ int main(int argc, char * argv[]) noexcept {
 						case 256: ablm.setAES(aspl_t::types_t::aes256); break;
 					}
 				}
+				// Если алгоритм сжатия передан
+				if((value = env.get("bin-codec")) != nullptr){
+					// Если это алгоритм gzip
+					if(string(value).compare("gzip") == 0) ablm.setCodec(aspl_t::codec_t::gzip);
+					// Если это алгоритм lz4
+					else if(string(value).compare("lz4") == 0) ablm.setCodec(aspl_t::codec_t::lz4);
+					// Если это алгоритм zstd
+					else if(string(value).compare("zstd") == 0) ablm.setCodec(aspl_t::codec_t::zstd);
+				}
+				// Если количество ядер передано
+				if(((value = env.get("threads")) != nullptr) && alphabet.isNumber(value)){
+					// Устанавливаем количество потоков
+					ablm.setThreads(stoi(value));
+				// Иначе устанавливаем 1 поток
+				} else ablm.setThreads(1);
 				// Если название словаря передано
 				if((value = env.get("bin-name")) != nullptr) ablm.setName(value);
 				// Если автор словаря передан
@@ -2668,6 +2779,10 @@ int main(int argc, char * argv[]) noexcept {
 				if(debug == 1) ablm.setFlag(ablm_t::flag_t::debug);
 				// Устанавливаем флаг сохранения только arpa данных
 				if(env.is("w-bin-arpa")) ablm.setFlag(ablm_t::flag_t::onlyArpa);
+				// Устанавливаем флаг сохранения N-грамм для отображения в память
+				if(env.is("w-bin-mmap")) ablm.setFlag(ablm_t::flag_t::expMmap);
+				// Если количество бит квантования N-грамм для отображения в память передано
+				if(((value = env.get("w-bin-quant")) != nullptr) && alphabet.isNumber(value)) ablm.setQuant(stoi(value));
 				// Устанавливаем флаг сохранения всех данных
 				if(env.is("w-bin-all")) ablm.setFlag(ablm_t::flag_t::expAllData);
 				// Устанавливаем флаг экспорта опций тулкита
@@ -41,6 +41,10 @@
 #define BUFFER_CHUNK 0x19C00
 // Размер бинарного буфера языковой модели
 #define BUFFER_SIZE 0x6400000
+// Сигнатура блока N-грамм отображаемых в память
+#define MMAP_HEADER "ALMMAP05"
+// Выравнивание блока N-грамм отображаемых в память
+#define MMAP_ALIGN 0x1000
 
 #include <functional>
 #include <iostream>
@@ -0,0 +1,67 @@
+/**
+ *  author:   Yuriy Lobarev
+ *  telegram: @forman
+ *  phone:    +7(910)983-95-90
+ *  email:    forman@anyks.com
+ *  site:     https://anyks.com
+ */
+
+#include <chrono>
+#include <random>
+#include <arpa.hpp>
+
+// Устанавливаем область видимости
+using namespace std;
+using namespace anyks;
+
+/**
+ * main Главная функция приложения
+ * @param argc длина массива параметров
+ * @param argv массив параметров
+ * @return     код выхода из приложения
+ *
+ * Микробенчмарк подсчёта n-грамм методом Arpa::add,
+ * параметры: количество предложений (по умолчанию 200000) и размер n-граммы (по умолчанию 3)
+ */
+int main(int argc, char * argv[]){
+	// Количество предложений для обработки
+	const size_t count = (argc > 1 ? stoull(argv[1]) : 200000);
+	// Размер n-граммы
+	const u_short size = (argc > 2 ? stoi(argv[2]) : 3);
+	// Генератор случайных чисел, с фиксированным зерном для повторяемости
+	mt19937_64 generator(0x414C4D);
+	// Распределение длины предложения
+	uniform_int_distribution <size_t> length(5, 30);
+	// Распределение слов близкое к распределению Ципфа
+	geometric_distribution <size_t> word(0.0005);
+	// Распределение для выбора неизвестных слов
+	uniform_int_distribution <size_t> unknown(0, 49);
+	// Список предложений
+	vector <vector <pair_t>> sentences(count);
+	// Формируем предложения заранее, чтобы измерять только подсчёт
+	for(auto & sentence : sentences){
+		// Выделяем память для предложения
+		sentence.resize(length(generator));
+		// Заполняем предложение словами
+		for(auto & item : sentence){
+			// Каждое пятидесятое слово делаем неизвестным
+			if(unknown(generator) == 0) item = make_pair((size_t) token_t::unk, 0);
+			// Иначе добавляем обычное слово, иногда с регистром
+			else item = make_pair(size_t(100 + word(generator)), size_t(unknown(generator) == 1 ? 1 : 0));
+		}
+	}
+	// Создаём объект словаря
+	arpa_t arpa;
+	// Устанавливаем размер n-граммы
+	arpa.setSize(size);
+	// Запоминаем время начала
+	const auto start = chrono::steady_clock::now();
+	// Добавляем все предложения, каждое в своём документе
+	for(size_t i = 0; i < sentences.size(); i++) arpa.add(sentences[i], i);
+	// Получаем время работы в секундах
+	const double seconds = chrono::duration <double> (chrono::steady_clock::now() - start).count();
+	// Выводим результат
+	printf("sentences: %zu, order: %u, time: %.3f s, %.0f sentences/s\n", count, size, seconds, (count / seconds));
+	// Выходим
+	return 0;
+}
@@ -0,0 +1,69 @@
+/**
+ *  author:   Yuriy Lobarev
+ *  telegram: @forman
+ *  phone:    +7(910)983-95-90
+ *  email:    forman@anyks.com
+ *  site:     https://anyks.com
+ */
+
+#include <chrono>
+#include <random>
+#include <alm.hpp>
+#include <aspl.hpp>
+
+// Устанавливаем область видимости
+using namespace std;
+using namespace anyks;
+
+/**
+ * main Главная функция приложения
+ * @param argc длина массива параметров
+ * @param argv массив параметров
+ * @return     код выхода из приложения
+ *
+ * Микробенчмарк записи бинарного контейнера ASpl,
+ * параметры: адрес файла (по умолчанию ./bench.alm), общий объём в мегабайтах (по умолчанию 1024),
+ * размер записи в килобайтах (по умолчанию 32) и количество потоков (по умолчанию 1)
+ */
+int main(int argc, char * argv[]){
+	// Адрес файла контейнера
+	const string filename = (argc > 1 ? argv[1] : "./bench.alm");
+	// Общий объём данных в байтах
+	const size_t total = ((argc > 2 ? stoull(argv[2]) : 1024) * 1048576);
+	// Размер одной записи в байтах
+	const size_t size = ((argc > 3 ? stoull(argv[3]) : 32) * 1024);
+	// Количество потоков сжатия
+	const size_t threads = (argc > 4 ? stoull(argv[4]) : 1);
+	// Генератор случайных чисел, с фиксированным зерном для повторяемости
+	mt19937_64 generator(0x414C4D);
+	// Распределение слов близкое к распределению Ципфа, чтобы данные сжимались как реальные n-граммы
+	geometric_distribution <int> word(0.05);
+	// Пул данных, записи нарезаются из него с разным смещением
+	vector <char> pool(64 * 1048576 + size);
+	// Заполняем пул данными
+	for(auto & item : pool) item = char(word(generator) & 0xFF);
+	// Распределение смещения записи в пуле
+	uniform_int_distribution <size_t> offset(0, pool.size() - size);
+	// Создаём объект контейнера
+	aspl_t aspl(filename);
+	// Устанавливаем количество потоков сжатия
+	aspl.setThreads(threads);
+	// Количество записей
+	const size_t count = (total / size);
+	// Запоминаем время начала
+	const auto start = chrono::steady_clock::now();
+	// Добавляем все записи
+	for(size_t i = 1; i <= count; i++) aspl.set("data_" + to_string(i), pool.data() + offset(generator), size);
+	// Запоминаем время окончания добавления записей
+	const auto middle = chrono::steady_clock::now();
+	// Собираем контейнер
+	const uintmax_t bytes = aspl.write();
+	// Получаем время добавления записей в секундах
+	const double records = chrono::duration <double> (middle - start).count();
+	// Получаем время сборки контейнера в секундах
+	const double build = chrono::duration <double> (chrono::steady_clock::now() - middle).count();
+	// Выводим результат
+	printf("records: %zu x %zu bytes, set: %.3f s (%.1f MB/s), write: %.3f s, container: %ju bytes\n", count, size, records, (total / 1048576.0 / records), build, bytes);
+	// Выходим
+	return 0;
+}
@@ -16,6 +16,7 @@
 #include <string>
 #include <vector>
 #include <bitset>
+#include <thread>
 #include <cstring>
 #include <functional>
 /**
@@ -51,7 +52,8 @@ namespace anyks {
 				expDomZones,  // Флаг экспорта списка доменных имён
 				expBadwords,  // Флаг экспорта чёрного списка слов
 				expGoodwords, // Флаг экспорта белого списка слов
-				expUserTokens // Флаг экспорта пользовательских токенов
+				expUserTokens, // Флаг экспорта пользовательских токенов
+				expMmap       // Флаг экспорта N-грамм для отображения в память
 			};
 		private:
 			/**
@@ -76,9 +78,18 @@ namespace anyks {
 			// Метаданные словаря
 			meta_t meta;
 			// Флаги параметров
-			std::bitset <10> flags;
+			std::bitset <11> flags;
 			// Адрес файла словаря
 			string filename = "";
+			// Количество бит квантования N-грамм для отображения в память
+			u_short quant = 0;
+			// Количество потоков для извлечения и сжатия записей
+			size_t threads = std::thread::hardware_concurrency();
+			// Алгоритм сжатия записей
+			aspl_t::codec_t codec = aspl_t::best();
+		private:
+			// Пул потоков для извлечения записей
+			tpool_t tpool;
 		private:
 			// Объект языковой модели
 			alm_t * alm = nullptr;
@@ -100,6 +111,14 @@ namespace anyks {
 			 * @return       результат проверки
 			 */
 			const bool isFlag(const flag_t flag) const noexcept;
+			/**
+			 * records Метод параллельного извлечения группы записей бинарного контейнера
+			 * @param prefix   префикс ключей записей
+			 * @param count    количество записей
+			 * @param window   количество записей извлекаемых за один раз
+			 * @param callback функция обработки извлечённых записей (буферы записей и номер первой записи)
+			 */
+			void records(const string & prefix, const size_t count, const size_t window, function <void (const vector <vector <char>> &, const size_t)> callback) noexcept;
 		public:
 			/**
 			 * write Метод записи данных словаря в файл
@@ -140,6 +159,11 @@ namespace anyks {
 			 * @param aes размер шифрования для установки
 			 */
 			void setAES(aspl_t::types_t aes) noexcept;
+			/**
+			 * setCodec Метод установки алгоритма сжатия записей
+			 * @param codec алгоритм сжатия для установки
+			 */
+			void setCodec(aspl_t::codec_t codec) noexcept;
 			/**
 			 * setFlag Метод установки флага модуля
 			 * @param flag флаг для установки
@@ -205,6 +229,16 @@ namespace anyks {
 			 * @param filename адрес файла словаря
 			 */
 			void setFilename(const string & filename) noexcept;
+			/**
+			 * setQuant Метод установки количества бит квантования N-грамм для отображения в память
+			 * @param bits количество бит квантования (от 2 до 16, ноль отключает квантование)
+			 */
+			void setQuant(const u_short bits) noexcept;
+			/**
+			 * setThreads Метод установки количества потоков для извлечения и сжатия записей
+			 * @param threads количество потоков для работы
+			 */
+			void setThreads(const size_t threads = 0) noexcept;
 			/**
 			 * setCopyright Метод установки копирайта автора
 			 * @param copyright копирайт автора для установки
@@ -18,10 +18,12 @@
 #include <mutex>
 #include <cmath>
 #include <ctime>
+#include <cstdio>
 #include <memory>
 #include <atomic>
 #include <bitset>
 #include <vector>
+#include <charconv>
 #include <limits>
 #include <fstream>
 #include <functional>
@@ -53,6 +55,8 @@ namespace anyks {
 			// Объявляем дружественные классы
 			friend class Alm1;
 			friend class Alm2;
+			friend class Alm3;
+			friend class AlmMixture;
 		private:
 			/**
 			 * UserToken Структура пользовательского токена
@@ -116,6 +120,44 @@ namespace anyks {
 				 */
 				Seq() : weight(log(0)), backoff(0.0), idw(idw_t::NIDW), oc(0), dc(0), ups(0) {}
 			} seq_t;
+			/**
+			 * State Структура состояния контекста для пословного расчёта весов
+			 */
+			typedef struct State {
+				/**
+				 * Маска суффиксов контекста, все префиксы которых существуют
+				 */
+				size_t mask;
+				/**
+				 * Накопленная обратная частота всех суффиксов контекста
+				 */
+				double backoff;
+				/**
+				 * Контекст последовательности (не более size - 1 слов)
+				 */
+				vector <size_t> context;
+				/**
+				 * Найденные узлы словаря для каждого суффикса контекста
+				 */
+				vector <const void *> nodes;
+				/**
+				 * clear Метод сброса состояния
+				 */
+				void clear() noexcept {
+					// Сбрасываем маску суффиксов
+					this->mask = 0;
+					// Сбрасываем обратную частоту
+					this->backoff = 0.0;
+					// Очищаем контекст
+					this->context.clear();
+					// Очищаем список узлов
+					this->nodes.clear();
+				}
+				/**
+				 * State Конструктор
+				 */
+				State() : mask(0), backoff(0.0) {}
+			} state_t;
 			// Упрощаем тип функции для получения слова
 			typedef function <const word_t * (const size_t)> words_t;
 			// Упрощаем тип функции для добавления слова
@@ -208,6 +250,15 @@ namespace anyks {
 			 * @return    частота и обратная частота n-граммы
 			 */
 			virtual const pair <double, double> frequency(const vector <size_t> & seq) const noexcept;
+			/**
+			 * pplWeight Метод расчёта веса окна последовательности без его копирования
+			 * @param seq   последовательность слов в которой находится окно
+			 * @param begin позиция начала окна в последовательности
+			 * @param end   позиция конца окна в последовательности (не включительно)
+			 * @param unk   разрешено ли неизвестное слово
+			 * @return      граммность и вес n-граммы
+			 */
+			virtual const pair <u_short, double> pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept;
 		private:
 			/**
 			 * set Метод установки последовательности в словарь
@@ -238,6 +289,19 @@ namespace anyks {
 			 * @return        значение перплексии полученное при расчётах
 			 */
 			const pair <double, double> pplCalculate(const double logprob, const size_t words, const size_t oovs) const noexcept;
+			/**
+			 * pplSequences Метод разбивки текста на последовательности предложений для расчёта перплексии
+			 * @param text     текст для разбивки
+			 * @param callback функция обратного вызова для каждого полученного предложения
+			 */
+			void pplSequences(const wstring & text, function <void (const vector <size_t> &)> callback) const noexcept;
+			/**
+			 * byFiles Метод параллельного построчного чтения файла или группы файлов блоками
+			 * @param path     адрес каталога или файла для чтения
+			 * @param ext      расширение файлов в каталоге (если адрес передан каталога)
+			 * @param callback функция обратного вызова для каждой непустой строки (строка, файл, общий размер данных)
+			 */
+			void byFiles(const string & path, const string & ext, function <void (const string &, const string &, const uintmax_t)> callback) const noexcept;
 		public:
 			/**
 			 * perplexity Метод расчёта перплексии текста
@@ -263,6 +327,26 @@ namespace anyks {
 			 * @return     результат расчёта
 			 */
 			virtual const ppl_t perplexity(const vector <size_t> & seq) const noexcept;
+			/**
+			 * perplexityBatch Метод пакетного расчёта перплексии списка текстов
+			 * @param  texts список текстов для расчёта
+			 * @return       список результатов расчёта в порядке текстов
+			 */
+			const vector <ppl_t> perplexityBatch(const vector <string> & texts) const noexcept;
+			/**
+			 * perplexityBatch Метод пакетного расчёта перплексии списка последовательностей
+			 * @param  seqs список последовательностей для расчёта
+			 * @return      список результатов расчёта в порядке последовательностей
+			 */
+			const vector <ppl_t> perplexityBatch(const vector <vector <size_t>> & seqs) const noexcept;
+			/**
+			 * score Метод расчёта веса слова по состоянию контекста
+			 * @param in  входное состояние контекста (пустое для начала расчёта)
+			 * @param idw идентификатор слова для расчёта
+			 * @param out выходное состояние контекста с добавленным словом
+			 * @return    граммность и вес n-граммы
+			 */
+			virtual const pair <u_short, double> score(const state_t & in, const size_t idw, state_t & out) const noexcept;
 			/**
 			 * pplConcatenate Метод объединения перплексий
 			 * @param ppl1 первая перплексия
@@ -404,6 +488,15 @@ namespace anyks {
 			 * @param buffer буфер с бинарными данными
 			 */
 			virtual void setBin(const vector <char> & buffer) const noexcept;
+			/**
+			 * setBins Метод установки группы буферов бинарных данных в словарь
+			 * @param buffers список буферов с бинарными данными в порядке записей
+			 */
+			virtual void setBins(const vector <vector <char>> & buffers) const noexcept;
+			/**
+			 * joinBins Метод завершения групповой установки буферов, останавливает потоки тредпула
+			 */
+			void joinBins() const noexcept;
 			/**
 			 * setBin2 Метод установки бинарных данных в словарь
 			 * @param buffer буфер с бинарными данными
@@ -414,6 +507,13 @@ namespace anyks {
 			 * @param callback функция обратного вызова
 			 */
 			virtual void getBin(function <void (const vector <char> &, const size_t, const u_short)> callback) const noexcept;
+		public:
+			/**
+			 * readMap Метод отображения в память N-грамм и слов из файла словаря
+			 * @param filename адрес файла словаря
+			 * @return         результат отображения
+			 */
+			virtual const bool readMap(const string & filename) const noexcept;
 		public:
 			/**
 			 * clear Метод очистки всех данных
@@ -909,6 +1009,15 @@ namespace anyks {
 			 * @return    частота и обратная частота n-граммы
 			 */
 			virtual const pair <double, double> frequency(const vector <size_t> & seq) const noexcept;
+			/**
+			 * pplWeight Метод расчёта веса окна последовательности без его копирования
+			 * @param seq   последовательность слов в которой находится окно
+			 * @param begin позиция начала окна в последовательности
+			 * @param end   позиция конца окна в последовательности (не включительно)
+			 * @param unk   разрешено ли неизвестное слово
+			 * @return      граммность и вес n-граммы
+			 */
+			virtual const pair <u_short, double> pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept;
 		private:
 			/**
 			 * set Метод установки последовательности в словарь
@@ -935,6 +1044,14 @@ namespace anyks {
 			 * @return     результат расчёта
 			 */
 			virtual const ppl_t perplexity(const vector <size_t> & seq) const noexcept;
+			/**
+			 * score Метод расчёта веса слова по состоянию контекста
+			 * @param in  входное состояние контекста (пустое для начала расчёта)
+			 * @param idw идентификатор слова для расчёта
+			 * @param out выходное состояние контекста с добавленным словом
+			 * @return    граммность и вес n-граммы
+			 */
+			virtual const pair <u_short, double> score(const state_t & in, const size_t idw, state_t & out) const noexcept;
 			/**
 			 * check Метод проверки существования последовательности, с указанным шагом
 			 * @param seq  список слов последовательности
@@ -962,6 +1079,11 @@ namespace anyks {
 			 * @param buffer буфер с бинарными данными
 			 */
 			virtual void setBin(const vector <char> & buffer) const noexcept;
+			/**
+			 * setBins Метод установки группы буферов бинарных данных в словарь
+			 * @param buffers список буферов с бинарными данными в порядке записей
+			 */
+			virtual void setBins(const vector <vector <char>> & buffers) const noexcept;
 			/**
 			 * setBin2 Метод установки бинарных данных в словарь
 			 * @param buffer буфер с бинарными данными
@@ -1076,6 +1198,15 @@ namespace anyks {
 			 * @return    частота и обратная частота n-граммы
 			 */
 			const pair <double, double> frequency(const vector <size_t> & seq) const noexcept;
+			/**
+			 * pplWeight Метод расчёта веса окна последовательности без его копирования
+			 * @param seq   последовательность слов в которой находится окно
+			 * @param begin позиция начала окна в последовательности
+			 * @param end   позиция конца окна в последовательности (не включительно)
+			 * @param unk   разрешено ли неизвестное слово
+			 * @return      граммность и вес n-граммы
+			 */
+			const pair <u_short, double> pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept;
 		private:
 			/**
 			 * set Метод установки последовательности в словарь
@@ -1102,6 +1233,14 @@ namespace anyks {
 			 * @return     результат расчёта
 			 */
 			const ppl_t perplexity(const vector <size_t> & seq) const noexcept;
+			/**
+			 * score Метод расчёта веса слова по состоянию контекста
+			 * @param in  входное состояние контекста (пустое для начала расчёта)
+			 * @param idw идентификатор слова для расчёта
+			 * @param out выходное состояние контекста с добавленным словом
+			 * @return    граммность и вес n-граммы
+			 */
+			const pair <u_short, double> score(const state_t & in, const size_t idw, state_t & out) const noexcept;
 			/**
 			 * check Метод проверки существования последовательности, с указанным шагом
 			 * @param seq  список слов последовательности
@@ -1129,6 +1268,11 @@ namespace anyks {
 			 * @param buffer буфер с бинарными данными
 			 */
 			void setBin(const vector <char> & buffer) const noexcept;
+			/**
+			 * setBins Метод установки группы буферов бинарных данных в словарь
+			 * @param buffers список буферов с бинарными данными в порядке записей
+			 */
+			void setBins(const vector <vector <char>> & buffers) const noexcept;
 			/**
 			 * setBin2 Метод установки бинарных данных в словарь
 			 * @param buffer буфер с бинарными данными
@@ -1191,6 +1335,832 @@ namespace anyks {
 			 */
 			~Alm2() noexcept;
 	} alm2_t;
+	/**
+	 * Alm3 Класс alm третьего типа
+	 */
+	typedef class Alm3 : public Alm1 {
+		private:
+			/**
+			 * Node Структура N-граммы в плоском массиве
+			 */
+			typedef struct Node {
+				/**
+				 * Упакованный ключ N-граммы: в младших битах индекс слова
+				 * в словаре, в старших индекс первого продолжения N-граммы
+				 * в массиве следующего порядка
+				 */
+				size_t key;
+				/**
+				 * Регистры слова
+				 */
+				size_t uppers;
+				/**
+				 * Частота последовательности и
+				 * обратная частота последовательности
+				 */
+				float weight, backoff;
+				/**
+				 * Node Конструктор
+				 */
+				Node() : key(0), uppers(0), weight(log(0)), backoff(0.0f) {}
+			} node_t;
+			/**
+			 * Квантованная N-грамма в плоском массиве хранится без выравнивания: упакованный ключ (как у Node),
+			 * регистры слова, код частоты и код обратной частоты в кодовых книгах порядка. Коды занимают один байт
+			 * при квантовании до 8 бит и два байта при большем, у N-грамм старшего порядка кода обратной частоты нет
+			 */
+			static constexpr size_t QUANTHEAD = (sizeof(size_t) * 2);
+			/**
+			 * Record Структура записи N-граммы до сборки словаря
+			 */
+			typedef struct Record {
+				/**
+				 * Регистры слова
+				 */
+				size_t uppers;
+				/**
+				 * Частота последовательности и
+				 * обратная частота последовательности
+				 */
+				double weight, backoff;
+				/**
+				 * Флаги наличия частот и регистров слова
+				 */
+				bool data, ups;
+				/**
+				 * Record Конструктор
+				 */
+				Record() : uppers(0), weight(log(0)), backoff(0.0), data(false), ups(false) {}
+			} record_t;
+			/**
+			 * Stage Структура списка N-грамм одного порядка до сборки словаря
+			 */
+			typedef struct Stage {
+				// Последовательности N-грамм записанные подряд
+				vector <size_t> seq;
+				// Параметры N-грамм
+				vector <record_t> data;
+			} stage_t;
+			/**
+			 * Level Структура списка N-грамм одного порядка
+			 */
+			typedef struct Level {
+				// Количество N-грамм
+				size_t count;
+				// Список N-грамм
+				const node_t * nodes;
+				// Список квантованных N-грамм
+				const char * quants;
+				// Кодовые книги частот и обратных частот квантованных N-грамм
+				const float * weights, * backoffs;
+				// Таблица идентификаторов слов по их индексам в словаре
+				const size_t * words;
+				// Количество слов в таблице идентификаторов
+				size_t vocab;
+				// Размер кодовых книг квантованных N-грамм
+				size_t book;
+				// Количество бит индекса слова в ключе N-граммы
+				u_short shift;
+				// Размер кода квантованной частоты в байтах и количество кодов квантованной N-граммы
+				u_short width, codes;
+				/**
+				 * stride Метод получения размера квантованной N-граммы
+				 * @return размер N-граммы в байтах
+				 */
+				const size_t stride() const noexcept {return (QUANTHEAD + (this->width * this->codes));}
+				/**
+				 * code Метод получения кода частоты квантованной N-граммы
+				 * @param index индекс N-граммы
+				 * @param pos   номер кода (0 - частота, 1 - обратная частота)
+				 * @return      код частоты
+				 */
+				const size_t code(const size_t index, const u_short pos) const noexcept {
+					// Получаем начало кода
+					const char * data = (this->quants + (index * this->stride()) + QUANTHEAD + (pos * this->width));
+					// Если код занимает один байт, выводим его как есть
+					if(this->width == 1) return u_char(* data);
+					// Код частоты в два байта
+					u_short result = 0;
+					// Извлекаем код
+					memcpy(&result, data, sizeof(result));
+					// Выводим результат
+					return result;
+				}
+				/**
+				 * size Метод получения количества N-грамм
+				 * @return количество N-грамм
+				 */
+				const size_t size() const noexcept {return this->count;}
+				/**
+				 * empty Метод проверки на пустоту списка
+				 * @return результат проверки
+				 */
+				const bool empty() const noexcept {return (this->count == 0);}
+				/**
+				 * data Метод получения бинарных данных списка
+				 * @return указатель на начало списка N-грамм
+				 */
+				const char * data() const noexcept {
+					// Выводим начало списка в зависимости от квантования
+					return (this->quants != nullptr ? reinterpret_cast <const char *> (this->quants) : reinterpret_cast <const char *> (this->nodes));
+				}
+				/**
+				 * idw Метод получения идентификатора слова N-граммы
+				 * @param index индекс N-граммы
+				 * @return      идентификатор слова
+				 */
+				const size_t idw(const size_t index) const noexcept {
+					// Получаем индекс слова в словаре
+					const size_t word = this->word(index);
+					// Выводим идентификатор слова по таблице словаря, если индекс слова в ней находится
+					return (word < this->vocab ? this->words[word] : (size_t) idw_t::NIDW);
+				}
+				/**
+				 * key Метод получения упакованного ключа N-граммы
+				 * @param index индекс N-граммы
+				 * @return      упакованный ключ
+				 */
+				const size_t key(const size_t index) const noexcept {
+					// Если N-граммы не квантованы, выводим ключ как есть
+					if(this->quants == nullptr) return this->nodes[index].key;
+					// Ключ квантованной N-граммы
+					size_t result = 0;
+					// Извлекаем ключ, квантованные N-граммы не выровнены
+					memcpy(&result, this->quants + (index * this->stride()), sizeof(result));
+					// Выводим результат
+					return result;
+				}
+				/**
+				 * word Метод получения индекса слова N-граммы в словаре
+				 * @param index индекс N-граммы
+				 * @return      индекс слова в словаре
+				 */
+				const size_t word(const size_t index) const noexcept {
+					// Выводим младшие биты ключа
+					return (this->key(index) & ((size_t(1) << this->shift) - 1));
+				}
+				/**
+				 * offset Метод получения индекса первого продолжения N-граммы
+				 * @param index индекс N-граммы
+				 * @return      индекс первого продолжения
+				 */
+				const size_t offset(const size_t index) const noexcept {
+					// Выводим старшие биты ключа
+					return (this->key(index) >> this->shift);
+				}
+				/**
+				 * at Метод получения N-граммы по индексу
+				 * @param index индекс N-граммы
+				 * @return      N-грамма списка
+				 */
+				const node_t at(const size_t index) const noexcept {
+					// Если N-граммы не квантованы, выводим их как есть
+					if(this->quants == nullptr) return this->nodes[index];
+					// Результат работы функции
+					node_t result;
+					// Получаем квантованную N-грамму
+					const char * quant = (this->quants + (index * this->stride()));
+					// Восстанавливаем параметры N-граммы
+					memcpy(&result.key, quant, sizeof(result.key));
+					memcpy(&result.uppers, quant + sizeof(result.key), sizeof(result.uppers));
+					// Получаем коды частот, у старшего порядка кода обратной частоты нет, нулевой код означает отсутствие частоты
+					const size_t weight = this->code(index, 0), backoff = (this->codes > 1 ? this->code(index, 1) : 0);
+					// Восстанавливаем частоты N-граммы по кодовым книгам, коды за пределами книг считаем отсутствующими
+					result.weight  = (weight < this->book ? this->weights[weight] : log(0));
+					result.backoff = (backoff < this->book ? this->backoffs[backoff] : 0.0f);
+					// Выводим результат
+					return result;
+				}
+				/**
+				 * operator [] Оператор получения N-граммы по индексу
+				 * @param index индекс N-граммы
+				 * @return      N-грамма списка
+				 */
+				const node_t operator [](const size_t index) const noexcept {return this->at(index);}
+				/**
+				 * Level Конструктор
+				 * @param nodes список N-грамм
+				 * @param count количество N-грамм
+				 * @param words таблица идентификаторов слов
+				 * @param vocab количество слов в таблице идентификаторов
+				 * @param shift количество бит индекса слова в ключе
+				 */
+				Level(const node_t * nodes = nullptr, const size_t count = 0, const size_t * words = nullptr, const size_t vocab = 0, const u_short shift = 0) :
+				count(count), nodes(nodes), quants(nullptr), weights(nullptr), backoffs(nullptr), words(words), vocab(vocab), book(0), shift(shift), width(0), codes(0) {}
+				/**
+				 * Level Конструктор
+				 * @param quants   список квантованных N-грамм
+				 * @param count    количество N-грамм
+				 * @param width    размер кода частоты в байтах
+				 * @param codes    количество кодов N-граммы (у старшего порядка нет кода обратной частоты)
+				 * @param weights  кодовая книга частот
+				 * @param backoffs кодовая книга обратных частот
+				 * @param book     размер кодовых книг
+				 * @param words    таблица идентификаторов слов
+				 * @param vocab    количество слов в таблице идентификаторов
+				 * @param shift    количество бит индекса слова в ключе
+				 */
+				Level(const char * quants, const size_t count, const u_short width, const u_short codes, const float * weights, const float * backoffs, const size_t book, const size_t * words, const size_t vocab, const u_short shift) :
+				count(count), nodes(nullptr), quants(quants), weights(weights), backoffs(backoffs), words(words), vocab(vocab), book(book), shift(shift), width(width), codes(codes) {}
+			} level_t;
+			/**
+			 * Map Структура заголовка N-грамм отображаемых в память
+			 */
+			typedef struct Map {
+				// Сигнатура блока
+				char magic[8];
+				// Размер кода квантованной частоты в байтах (ноль если N-граммы не квантованы)
+				u_int node;
+				/**
+				 * Количество порядков N-грамм, за заголовком идут тройки смещения от начала блока,
+				 * количества N-грамм и смещения кодовых книг порядка (ноль если N-граммы порядка не квантованы)
+				 */
+				u_int levels;
+				// Количество бит квантования частот N-грамм
+				u_int bits;
+				// Размер одной кодовой книги
+				u_int book;
+				// Количество бит индекса слова в ключе N-граммы
+				u_int shift;
+				// Смещение таблицы идентификаторов слов от начала блока
+				size_t vocab;
+				// Количество слов в таблице идентификаторов
+				size_t words;
+				/**
+				 * Смещение словаря слов от начала блока, в словаре идут отсортированные идентификаторы слов,
+				 * смещения данных слов (на одно больше количества слов) и бинарные данные самих слов
+				 */
+				size_t lexicon;
+				// Количество слов в словаре
+				size_t lexemes;
+			} __attribute__((packed)) map_t;
+			/**
+			 * Tail Структура окончания файла с N-граммами отображаемыми в память
+			 */
+			typedef struct Tail {
+				// Сигнатура блока
+				char magic[8];
+				// Смещение блока N-грамм от начала файла
+				size_t offset;
+			} __attribute__((packed)) tail_t;
+			/**
+			 * Lexicon Структура словаря слов отображённого в память
+			 */
+			typedef struct Lexicon {
+				// Количество слов
+				size_t count;
+				// Размер бинарных данных слов
+				size_t size;
+				// Отсортированные идентификаторы слов и смещения их бинарных данных
+				const size_t * ids, * offsets;
+				// Бинарные данные слов
+				const char * data;
+				/**
+				 * Lexicon Конструктор
+				 */
+				Lexicon() : count(0), size(0), ids(nullptr), offsets(nullptr), data(nullptr) {}
+			} lexicon_t;
+			/**
+			 * Spill Структура N-граммы во временном файле порядка до записи блока
+			 */
+			typedef struct Spill {
+				// Идентификатор слова N-граммы
+				size_t idw;
+				// Индекс первого продолжения N-граммы в следующем порядке
+				size_t start;
+				// Регистры слова
+				size_t uppers;
+				// Частота последовательности и обратная частота последовательности
+				float weight, backoff;
+			} __attribute__((packed)) spill_t;
+			/**
+			 * Writer Структура записи блока N-грамм из потока записей arpa без сборки словаря в памяти
+			 */
+			typedef struct Writer {
+				// Флаг ошибки записи или нарушения порядка обхода дерева
+				bool broken;
+				// Количество бит квантования частот N-грамм
+				u_short bits;
+				// Последовательность последней добавленной N-граммы
+				vector <size_t> path;
+				// Количество N-грамм каждого порядка
+				vector <size_t> counts;
+				// Временные файлы N-грамм каждого порядка
+				vector <FILE *> levels;
+				// Временный файл бинарных данных слов словаря
+				FILE * vocab;
+				// Идентификаторы слов словаря и смещения их бинарных данных
+				vector <size_t> ids, offsets;
+				// Кодовые книги частот и обратных частот каждого порядка
+				vector <vector <float>> books;
+				// Идентификаторы слов встреченных в N-граммах
+				std::set <size_t> words;
+				/**
+				 * clear Метод закрытия временных файлов и очистки данных
+				 */
+				void clear() noexcept {
+					// Закрываем все временные файлы, они удаляются автоматически
+					for(auto & file : this->levels) if(file != nullptr) fclose(file);
+					// Закрываем временный файл слов словаря
+					if(this->vocab != nullptr) fclose(this->vocab);
+					// Зануляем временный файл слов словаря
+					this->vocab = nullptr;
+					// Сбрасываем флаг ошибки
+					this->broken = false;
+					// Сбрасываем количество бит квантования
+					this->bits = 0;
+					// Очищаем все данные
+					this->path.clear();
+					this->counts.clear();
+					this->levels.clear();
+					this->books.clear();
+					this->ids.clear();
+					this->offsets.clear();
+					this->words.clear();
+				}
+				/**
+				 * Writer Конструктор
+				 */
+				Writer() noexcept : broken(false), bits(0), vocab(nullptr) {}
+				/**
+				 * ~Writer Деструктор
+				 */
+				~Writer() noexcept {this->clear();}
+			} writer_t;
+		private:
+			// Флаг собранного словаря
+			mutable std::atomic <bool> actual{true};
+			// Список N-грамм ожидающих сборки словаря
+			mutable vector <stage_t> stages;
+			// Собранные списки N-грамм каждого порядка
+			mutable vector <vector <node_t>> nodes;
+			// Словарь языковой модели, отсортированный по порядкам N-грамм
+			mutable vector <level_t> arpa;
+			// Количество бит квантования частот N-грамм
+			mutable u_short bits = 0;
+		private:
+			// Последовательность последней N-граммы, добавленной в порядке обхода дерева
+			mutable vector <size_t> path;
+			// Индексы первых продолжений N-грамм, добавленных в порядке обхода дерева
+			mutable vector <vector <size_t>> starts;
+		private:
+			// Отсортированные идентификаторы слов, индекс в списке - индекс слова в словаре
+			mutable vector <size_t> vocab;
+			// Таблица идентификаторов слов (собранная или отображённая в память)
+			mutable const size_t * words = nullptr;
+			// Количество слов в таблице идентификаторов
+			mutable size_t wordsCount = 0;
+			// Количество бит индекса слова в ключе N-граммы
+			mutable u_short shift = 0;
+		private:
+			// Адрес отображённого в память блока N-грамм
+			mutable void * mapped = nullptr;
+			// Размер отображённого в память блока N-грамм
+			mutable size_t mappedSize = 0;
+			// Словарь слов отображённый в память, слова распаковываются при первом обращении
+			mutable lexicon_t lexicon;
+			// Мютекс распаковки слов отображённого в память словаря
+			mutable std::mutex lexiconLocker;
+		private:
+			// Объект записи блока N-грамм для отображения в память
+			mutable writer_t writer;
+		private:
+			/**
+			 * build Метод сборки словаря из добавленных N-грамм
+			 */
+			void build() const noexcept;
+			/**
+			 * pack Метод упаковки ключей N-грамм, добавленных в порядке обхода дерева
+			 */
+			void pack() const noexcept;
+			/**
+			 * unmap Метод освобождения отображённого в память блока N-грамм
+			 */
+			void unmap() const noexcept;
+			/**
+			 * unpack Метод распаковки всех слов отображённого в память словаря в основной словарь
+			 */
+			void unpack() const noexcept;
+			/**
+			 * lexeme Метод распаковки слова отображённого в память словаря в основной словарь
+			 * @param index индекс слова в отображённом словаре
+			 * @return      распакованное слово или nullptr
+			 */
+			const word_t * lexeme(const size_t index) const noexcept;
+			/**
+			 * range Метод извлечения диапазона продолжений N-граммы
+			 * @param level порядок продолжений (начиная с нуля)
+			 * @param index индекс родительской N-граммы (для юниграмм не используется)
+			 * @return      диапазон индексов продолжений в массиве порядка level
+			 */
+			const pair <size_t, size_t> range(const u_short level, const size_t index) const noexcept;
+			/**
+			 * child Метод поиска продолжения N-граммы
+			 * @param level порядок искомой N-граммы (начиная с нуля)
+			 * @param index индекс родительской N-граммы, idw_t::NIDW для корня словаря
+			 * @param idw   идентификатор искомого слова
+			 * @return      индекс найденной N-граммы или idw_t::NIDW
+			 */
+			const size_t child(const u_short level, const size_t index, const size_t idw) const noexcept;
+			/**
+			 * dense Метод получения индекса слова в словаре по его идентификатору
+			 * @param idw идентификатор слова
+			 * @return    индекс слова в словаре или idw_t::NIDW
+			 */
+			const size_t dense(const size_t idw) const noexcept;
+			/**
+			 * codebook Метод построения кодовой книги по значениям методом равнонаполненных интервалов с уточнением по Ллойду
+			 * @param values значения для построения кодовой книги (будут отсортированы)
+			 * @param book   кодовая книга для заполнения (нулевой код заполняется вызывающей стороной)
+			 * @param size   размер кодовой книги
+			 */
+			void codebook(vector <float> & values, float * book, const size_t size) const noexcept;
+			/**
+			 * encode Метод получения кода ближайшего центра кодовой книги
+			 * @param book  кодовая книга (нулевой код зарезервирован)
+			 * @param size  размер кодовой книги
+			 * @param value кодируемое значение
+			 * @return      код значения
+			 */
+			const u_short encode(const float * book, const size_t size, const float value) const noexcept;
+			/**
+			 * readSpill Метод чтения N-грамм порядка из временного файла
+			 * @param level    порядок N-грамм (начиная с нуля)
+			 * @param callback функция обратного вызова
+			 * @return         результат чтения
+			 */
+			const bool readSpill(const size_t level, function <void (const spill_t &)> callback) const noexcept;
+			/**
+			 * parseBin Метод разбора бинарных данных arpa на последовательности
+			 * @param buffer   буфер с бинарными данными
+			 * @param callback функция обратного вызова
+			 */
+			void parseBin(const vector <char> & buffer, function <void (const vector <seq_t> &)> callback) const noexcept;
+			/**
+			 * map Метод отображения в память блока N-грамм из файла словаря с проверкой его заголовка
+			 * @param filename адрес файла словаря
+			 * @param length   размер отображённого блока
+			 * @return         адрес отображённого блока или nullptr
+			 */
+			void * map(const string & filename, size_t & length) const noexcept;
+		private:
+			/**
+			 * exist Метод проверки существования последовательности
+			 * @param seq список слов последовательности
+			 * @return    результат проверки
+			 */
+			const bool exist(const vector <size_t> & seq) const noexcept;
+			/**
+			 * backoff Метод извлечения обратной частоты последовательности
+			 * @param seq последовательность для извлечения обратной частоты
+			 * @return    обратная частота последовательности
+			 */
+			const double backoff(const vector <size_t> & seq) const noexcept;
+			/**
+			 * weight Метод извлечения веса последовательности
+			 * @param seq последовательность для извлечения веса
+			 * @return    вес последовательноси и n-грамма для которой она получена
+			 */
+			const pair <u_short, double> weight(const vector <size_t> & seq) const noexcept;
+			/**
+			 * frequency Метод извлечения частоты n-граммы
+			 * @param seq список слов последовательности
+			 * @return    частота и обратная частота n-граммы
+			 */
+			const pair <double, double> frequency(const vector <size_t> & seq) const noexcept;
+			/**
+			 * pplWeight Метод расчёта веса окна последовательности без его копирования
+			 * @param seq   последовательность слов в которой находится окно
+			 * @param begin позиция начала окна в последовательности
+			 * @param end   позиция конца окна в последовательности (не включительно)
+			 * @param unk   разрешено ли неизвестное слово
+			 * @return      граммность и вес n-граммы
+			 */
+			const pair <u_short, double> pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept;
+		private:
+			/**
+			 * set Метод установки последовательности в словарь
+			 * @param seq последовательность слов для установки
+			 */
+			void set(const vector <alm_t::seq_t> & seq) const noexcept;
+			/**
+			 * set Метод установки последовательности в словарь
+			 * @param seq     список идентификаторов слов которые нужно добавить
+			 * @param uppers  список верхних регистров последнего слова последовательности
+			 * @param weight  вес n-граммы из файла arpa
+			 * @param backoff обратная частота документа из файла arpa
+			 */
+			void set(const vector <size_t> & seq, const size_t uppers, const double weight, const double backoff) const noexcept;
+			/**
+			 * append Метод добавления последовательности в порядке обхода дерева сразу в списки N-грамм
+			 * @param seq последовательность слов для добавления
+			 */
+			void append(const vector <alm_t::seq_t> & seq) const noexcept;
+			/**
+			 * spill Метод добавления последовательности в порядке обхода дерева во временные файлы порядков
+			 * @param seq последовательность слов для добавления
+			 */
+			void spill(const vector <alm_t::seq_t> & seq) const noexcept;
+		public:
+			/**
+			 * clear Метод очистки всех данных
+			 */
+			void clear();
+		public:
+			/**
+			 * perplexity Метод расчёта перплексии
+			 * @param  seq список последовательностей
+			 * @return     результат расчёта
+			 */
+			const ppl_t perplexity(const vector <size_t> & seq) const noexcept;
+			/**
+			 * score Метод расчёта веса слова по состоянию контекста
+			 * @param in  входное состояние контекста (пустое для начала расчёта)
+			 * @param idw идентификатор слова для расчёта
+			 * @param out выходное состояние контекста с добавленным словом
+			 * @return    граммность и вес n-граммы
+			 */
+			const pair <u_short, double> score(const state_t & in, const size_t idw, state_t & out) const noexcept;
+			/**
+			 * check Метод проверки существования последовательности, с указанным шагом
+			 * @param seq  список слов последовательности
+			 * @param step размер шага проверки последовательности
+			 * @return     результат проверки
+			 */
+			const bool check(const vector <size_t> & seq, const u_short step) const noexcept;
+			/**
+			 * exist Метод проверки существования последовательности
+			 * @param seq  список слов последовательности
+			 * @param step размер шага проверки последовательности
+			 * @return     результат проверки
+			 */
+			const pair <bool, size_t> exist(const vector <size_t> & seq, const u_short step) const noexcept;
+			/**
+			 * check Метод проверки существования последовательности
+			 * @param seq      список слов последовательности
+			 * @param accurate режим точной проверки
+			 * @return         результат проверки
+			 */
+			const pair <bool, size_t> check(const vector <size_t> & seq, const bool accurate = false) const noexcept;
+		public:
+			/**
+			 * setBins Метод установки группы буферов бинарных данных в словарь
+			 * @param buffers список буферов с бинарными данными в порядке записей
+			 */
+			void setBins(const vector <vector <char>> & buffers) const noexcept;
+			/**
+			 * appendBin Метод добавления бинарных данных arpa, записанных в порядке обхода дерева N-грамм
+			 * @param buffer буфер с бинарными данными
+			 */
+			void appendBin(const vector <char> & buffer) const noexcept;
+			/**
+			 * mapBin Метод добавления бинарных данных arpa, записанных в порядке обхода дерева N-грамм, в блок для отображения в память
+			 * @param buffer буфер с бинарными данными
+			 */
+			void mapBin(const vector <char> & buffer) const noexcept;
+			/**
+			 * mapVocab Метод добавления бинарных данных слова, записанных по возрастанию идентификаторов, в блок для отображения в память
+			 * @param buffer буфер с бинарными данными
+			 */
+			void mapVocab(const vector <char> & buffer) const noexcept;
+			/**
+			 * getBin Метод извлечения данных arpa в бинарном виде
+			 * @param callback функция обратного вызова
+			 */
+			void getBin(function <void (const vector <char> &, const size_t, const u_short)> callback) const noexcept;
+		public:
+			/**
+			 * readMap Метод отображения в память N-грамм и слов из файла словаря
+			 * @param filename адрес файла словаря
+			 * @return         результат отображения
+			 */
+			const bool readMap(const string & filename) const noexcept;
+			/**
+			 * verifyMap Метод полной проверки N-грамм отображаемых в память из файла словаря
+			 * @param filename адрес файла словаря
+			 * @return         результат проверки
+			 */
+			const bool verifyMap(const string & filename) const noexcept;
+			/**
+			 * writeMap Метод дописывания N-грамм, добавленных методом mapBin, и слов, добавленных методом mapVocab, в конец файла словаря для отображения в память
+			 * @param filename адрес файла словаря
+			 * @return         результат записи
+			 */
+			const bool writeMap(const string & filename) const noexcept;
+			/**
+			 * quantize Метод построения кодовых книг частот и обратных частот N-грамм, добавленных методом mapBin, для каждого порядка
+			 * @param bits    количество бит квантования (от 2 до 16)
+			 * @param error   среднеквадратичная ошибка квантования частот и обратных частот
+			 * @param maximum максимальная ошибка квантования частот и обратных частот
+			 * @return        результат квантования
+			 */
+			const bool quantize(const u_short bits, pair <double, double> & error, pair <double, double> & maximum) const noexcept;
+		public:
+			/**
+			 * sentences Метод генерации предложений
+			 * @param callback функция обратного вызова
+			 */
+			void sentences(function <const bool (const wstring &)> callback) const noexcept;
+			/**
+			 * getUppers Метод извлечения регистров для каждого слова
+			 * @param seq  последовательность слов для сборки контекста
+			 * @param upps список извлечённых последовательностей
+			 */
+			void getUppers(const vector <size_t> & seq, vector <size_t> & upps) const noexcept;
+			/**
+			 * find Метод поиска n-грамм в тексте
+			 * @param text     текст в котором необходимо найти n-граммы
+			 * @param callback функция обратного вызова
+			 */
+			void find(const wstring & text, function <void (const wstring &)> callback) const noexcept;
+		public:
+			/**
+			 * context Метод сборки текстового контекста из последовательности
+			 * @param seq  последовательность слов для сборки контекста
+			 * @param nwrd флаг разрешающий вывод системных токенов
+			 * @return     собранный текстовый контекст
+			 */
+			const wstring context(const vector <size_t> & seq, const bool nwrd = false) const noexcept;
+		public:
+			/**
+			 * Alm3 Конструктор
+			 */
+			Alm3() noexcept : Alm1() {};
+			/**
+			 * Alm3 Конструктор
+			 * @param alphabet объект алфавита
+			 */
+			Alm3(const alphabet_t * alphabet) noexcept : Alm1(alphabet) {};
+			/**
+			 * Alm3 Конструктор
+			 * @param tokenizer объект токенизатора
+			 */
+			Alm3(const tokenizer_t * tokenizer) noexcept : Alm1(tokenizer) {};
+			/**
+			 * Alm3 Конструктор
+			 * @param alphabet  объект алфавита
+			 * @param tokenizer объект токенизатора
+			 */
+			Alm3(const alphabet_t * alphabet, const tokenizer_t * tokenizer) noexcept : Alm1(alphabet, tokenizer) {};
+			/**
+			 * ~Alm3 Деструктор
+			 */
+			~Alm3() noexcept;
+	} alm3_t;
+	/**
+	 * AlmMixture Класс интерполяции нескольких загруженных языковых моделей во время запроса
+	 */
+	typedef class AlmMixture : public Alm {
+		public:
+			/**
+			 * Режимы интерполяции моделей
+			 */
+			enum class mode_t : u_short {
+				linear,   // Линейная интерполяция вероятностей
+				loglinear // Лог-линейная интерполяция весов (без нормализации)
+			};
+		private:
+			// Режим интерполяции моделей
+			mode_t mode = mode_t::linear;
+		private:
+			// Список интерполируемых языковых моделей
+			vector <const alm_t *> alms;
+			// Список весов интерполируемых моделей
+			vector <double> lambdas;
+			// Флаги разрешения неизвестного слова для каждой модели
+			vector <bool> unks;
+		private:
+			/**
+			 * interpolate Метод интерполяции весов полученных от каждой модели
+			 * @param weights список весов моделей (log(0) если модель вес не вернула)
+			 * @return        интерполированный вес (log(0) если вес не получен ни от одной модели)
+			 */
+			const double interpolate(const vector <double> & weights) const noexcept;
+			/**
+			 * setWords Метод установки функций получения слов из словарей языковых моделей смеси
+			 */
+			void setWords() noexcept;
+		private:
+			/**
+			 * exist Метод проверки существования последовательности
+			 * @param seq список слов последовательности
+			 * @return    результат проверки
+			 */
+			const bool exist(const vector <size_t> & seq) const noexcept;
+			/**
+			 * weight Метод извлечения веса последовательности
+			 * @param seq последовательность для извлечения веса
+			 * @return    вес последовательноси и n-грамма для которой она получена
+			 */
+			const pair <u_short, double> weight(const vector <size_t> & seq) const noexcept;
+			/**
+			 * frequency Метод извлечения частоты n-граммы
+			 * @param seq список слов последовательности
+			 * @return    частота и обратная частота n-граммы
+			 */
+			const pair <double, double> frequency(const vector <size_t> & seq) const noexcept;
+			/**
+			 * pplWeight Метод расчёта веса окна последовательности без его копирования
+			 * @param seq   последовательность слов в которой находится окно
+			 * @param begin позиция начала окна в последовательности
+			 * @param end   позиция конца окна в последовательности (не включительно)
+			 * @param unk   разрешено ли неизвестное слово
+			 * @return      граммность и вес n-граммы
+			 */
+			const pair <u_short, double> pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept;
+		public:
+			/**
+			 * clear Метод очистки всех данных
+			 */
+			void clear();
+		public:
+			/**
+			 * add Метод добавления языковой модели в смесь
+			 * @param alm    объект загруженной языковой модели
+			 * @param lambda вес языковой модели в смеси
+			 */
+			void add(const alm_t * alm, const double lambda = 1.0) noexcept;
+			/**
+			 * setMode Метод установки режима интерполяции моделей
+			 * @param mode режим интерполяции моделей
+			 */
+			void setMode(const mode_t mode) noexcept;
+			/**
+			 * setLambda Метод установки веса языковой модели в смеси
+			 * @param index  индекс языковой модели в смеси
+			 * @param lambda вес языковой модели
+			 */
+			void setLambda(const size_t index, const double lambda) noexcept;
+			/**
+			 * setLambdas Метод установки весов всех языковых моделей в смеси
+			 * @param lambdas список весов языковых моделей
+			 */
+			void setLambdas(const vector <double> & lambdas) noexcept;
+		public:
+			/**
+			 * getMode Метод получения режима интерполяции моделей
+			 * @return режим интерполяции моделей
+			 */
+			const mode_t getMode() const noexcept;
+			/**
+			 * getLambdas Метод получения весов языковых моделей в смеси
+			 * @return список весов языковых моделей
+			 */
+			const vector <double> & getLambdas() const noexcept;
+		public:
+			/**
+			 * perplexity Метод расчёта перплексии
+			 * @param  seq список последовательностей
+			 * @return     результат расчёта
+			 */
+			const ppl_t perplexity(const vector <size_t> & seq) const noexcept;
+			/**
+			 * check Метод проверки существования последовательности, с указанным шагом
+			 * @param seq  список слов последовательности
+			 * @param step размер шага проверки последовательности
+			 * @return     результат проверки
+			 */
+			const bool check(const vector <size_t> & seq, const u_short step) const noexcept;
+			/**
+			 * exist Метод проверки существования последовательности
+			 * @param seq  список слов последовательности
+			 * @param step размер шага проверки последовательности
+			 * @return     результат проверки
+			 */
+			const pair <bool, size_t> exist(const vector <size_t> & seq, const u_short step) const noexcept;
+			/**
+			 * check Метод проверки существования последовательности
+			 * @param seq      список слов последовательности
+			 * @param accurate режим точной проверки
+			 * @return         результат проверки
+			 */
+			const pair <bool, size_t> check(const vector <size_t> & seq, const bool accurate = false) const noexcept;
+		public:
+			/**
+			 * AlmMixture Конструктор
+			 */
+			AlmMixture() noexcept : alm_t() {this->setWords();};
+			/**
+			 * AlmMixture Конструктор
+			 * @param alphabet объект алфавита
+			 */
+			AlmMixture(const alphabet_t * alphabet) noexcept : alm_t(alphabet) {this->setWords();};
+			/**
+			 * AlmMixture Конструктор
+			 * @param tokenizer объект токенизатора
+			 */
+			AlmMixture(const tokenizer_t * tokenizer) noexcept : alm_t(tokenizer) {this->setWords();};
+			/**
+			 * AlmMixture Конструктор
+			 * @param alphabet  объект алфавита
+			 * @param tokenizer объект токенизатора
+			 */
+			AlmMixture(const alphabet_t * alphabet, const tokenizer_t * tokenizer) noexcept : alm_t(alphabet, tokenizer) {this->setWords();};
+			/**
+			 * ~AlmMixture Деструктор
+			 */
+			~AlmMixture() noexcept;
+	} almmix_t;
 };
 
 #endif // __ANYKS_LANGUAGE_MODEL__
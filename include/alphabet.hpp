@@ -69,8 +69,8 @@ namespace anyks {
 			bool typeLatian = true;
 			// Разрешить апостроф как часть слова
 			bool apostrophe = false;
-			// Устанавливаем локаль по умолчанию
-			std::locale locale{ALPHABET_LOCALE};
+			// Прежняя глобальная локаль, локаль алфавита устанавливается в конструкторе
+			std::locale locale;
 			// Алфавит словаря
 			std::wstring alphabet = L"abcdefghijklmnopqrstuvwxyz";
 		private:
@@ -0,0 +1,498 @@
+/**
+ *  author:   Yuriy Lobarev
+ *  telegram: @forman
+ *  phone:    +7(910)983-95-90
+ *  email:    forman@anyks.com
+ *  site:     https://anyks.com
+ */
+
+#ifndef __ANYKS_ARENA__
+#define __ANYKS_ARENA__
+
+/**
+ * Стандартная библиотека
+ */
+#include <new>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+
+/**
+ * anyks пространство имён
+ */
+namespace anyks {
+	/**
+	 * Pools Класс списка пулов блоков памяти всех размеров
+	 */
+	class Pools {
+		private:
+			/**
+			 * locker Метод получения мютекса списка пулов
+			 * @return мютекс списка пулов
+			 */
+			static std::mutex & locker() noexcept {
+				// Мютекс живёт до завершения процесса, как и сами пулы
+				static std::mutex * result = new std::mutex;
+				// Выводим результат
+				return (* result);
+			}
+			/**
+			 * list Метод получения списка функций освобождения слэбов пулов
+			 * @return список функций освобождения слэбов
+			 */
+			static std::vector <void (*)()> & list() noexcept {
+				// Список живёт до завершения процесса, как и сами пулы
+				static std::vector <void (*)()> * result = new std::vector <void (*)()>;
+				// Выводим результат
+				return (* result);
+			}
+		public:
+			/**
+			 * add Метод добавления пула в список
+			 * @param trim функция освобождения слэбов пула
+			 */
+			static void add(void (* trim)()) noexcept {
+				// Блокируем список пулов
+				const std::lock_guard <std::mutex> lock(locker());
+				// Добавляем функцию в список
+				list().push_back(trim);
+			}
+			/**
+			 * trim Метод освобождения слэбов всех пулов, в которых не осталось живых блоков
+			 */
+			static void trim() noexcept {
+				// Блокируем список пулов
+				const std::lock_guard <std::mutex> lock(locker());
+				// Освобождаем слэбы каждого пула
+				for(auto & trim : list()) trim();
+			}
+	};
+	/**
+	 * Pool Класс пула блоков памяти одного размера
+	 *
+	 * Блоки нарезаются из больших слэбов и возвращаются в список свободных блоков,
+	 * у каждого потока свой список, поэтому выделение и освобождение не требуют блокировок,
+	 * с общим списком потоки обмениваются пачками блоков.
+	 * Пул общий для всего процесса, поэтому узлы можно переносить между словарями (extract/insert).
+	 * Когда живых блоков не остаётся, слэбы освобождаются методом Pools::trim, а списки потоков
+	 * со старым поколением слэбов сбрасываются при следующем обращении к ним.
+	 */
+	template <size_t Size>
+	class Pool {
+		private:
+			// Размер одного блока
+			static constexpr size_t block = (((Size < sizeof(void *) ? sizeof(void *) : Size) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t)) * alignof(std::max_align_t);
+			// Количество блоков передаваемых за один раз между потоком и общим списком
+			static constexpr size_t batch = 256;
+			// Размер одного слэба
+			static constexpr size_t slab = (block * batch * 16);
+		private:
+			/**
+			 * Free Структура свободного блока
+			 */
+			typedef struct Free {
+				// Следующий свободный блок
+				Free * next;
+			} free_t;
+			/**
+			 * Cache Структура списка свободных блоков потока
+			 */
+			typedef struct Cache {
+				// Первый свободный блок
+				free_t * head = nullptr;
+				// Количество свободных блоков
+				size_t size = 0;
+				// Поколение слэбов, из которых нарезаны свободные блоки
+				size_t generation = 0;
+				// Флаг регистрации списка в пуле
+				bool registered = false;
+				// Количество блоков выделенных потоком за вычетом освобождённых им (изменяется только своим потоком)
+				std::atomic <ptrdiff_t> live{0};
+				/**
+				 * ~Cache Деструктор
+				 */
+				~Cache() noexcept {
+					// Запоминаем что список потока больше недоступен
+					Pool::dead() = true;
+					// Если список зарегистрирован, убираем его из пула
+					if(this->registered) Pool::get().detach(* this);
+					// Иначе возвращаем все свободные блоки в общий список
+					else if(this->head != nullptr) Pool::get().release(this->head, this->size, this->generation);
+				}
+			} cache_t;
+		private:
+			// Мютекс для блокировки общего списка
+			std::mutex locker;
+			// Общий список свободных блоков
+			free_t * head = nullptr;
+			// Текущая позиция и конец текущего слэба
+			char * cursor = nullptr, * end = nullptr;
+			// Список выделенных слэбов
+			std::vector <void *> slabs;
+			// Зарегистрированные списки свободных блоков потоков
+			std::vector <cache_t *> caches;
+			// Поколение слэбов, увеличивается при их освобождении
+			std::atomic <size_t> generation{0};
+			// Количество живых блоков завершившихся потоков
+			std::atomic <ptrdiff_t> orphan{0};
+		private:
+			/**
+			 * dead Метод получения флага уничтожения списка потока
+			 * @return флаг уничтожения списка свободных блоков потока
+			 */
+			static bool & dead() noexcept {
+				// Флаг уничтожения списка, тривиальный тип доступен и после завершения потока
+				static thread_local bool result = false;
+				// Выводим результат
+				return result;
+			}
+			/**
+			 * cache Метод получения списка свободных блоков потока
+			 * @return список свободных блоков текущего потока
+			 */
+			static cache_t & cache() noexcept {
+				// Список свободных блоков потока
+				static thread_local cache_t result;
+				// Выводим результат
+				return result;
+			}
+		private:
+			/**
+			 * release Метод возврата блоков в общий список
+			 * @param head       первый возвращаемый блок
+			 * @param count      количество возвращаемых блоков
+			 * @param generation поколение слэбов возвращаемых блоков
+			 */
+			void release(free_t * head, const size_t count, const size_t generation) noexcept {
+				// Блокируем общий список
+				const std::lock_guard <std::mutex> lock(this->locker);
+				// Если слэбы блоков уже освобождены, блоки не возвращаем
+				if(generation != this->generation) return;
+				// Последний возвращаемый блок
+				free_t * tail = head;
+				// Ищем последний блок списка
+				for(size_t i = 1; (i < count) && (tail->next != nullptr); i++) tail = tail->next;
+				// Присоединяем общий список к возвращаемым блокам
+				tail->next = this->head;
+				// Запоминаем новое начало общего списка
+				this->head = head;
+			}
+			/**
+			 * attach Метод регистрации списка свободных блоков потока
+			 * @param cache список свободных блоков потока
+			 */
+			void attach(cache_t & cache) noexcept {
+				// Блокируем общий список
+				const std::lock_guard <std::mutex> lock(this->locker);
+				// Добавляем список потока
+				this->caches.push_back(&cache);
+				// Список пустой, поэтому относится к текущему поколению слэбов
+				cache.generation = this->generation;
+				// Запоминаем что список зарегистрирован
+				cache.registered = true;
+			}
+			/**
+			 * detach Метод удаления списка свободных блоков завершившегося потока
+			 * @param cache список свободных блоков потока
+			 */
+			void detach(cache_t & cache) noexcept {
+				// Блокируем общий список
+				const std::lock_guard <std::mutex> lock(this->locker);
+				// Живые блоки потока продолжают учитываться после его завершения
+				this->orphan += cache.live.load();
+				// Удаляем список потока
+				this->caches.erase(std::remove(this->caches.begin(), this->caches.end(), &cache), this->caches.end());
+				// Если свободные блоки относятся к текущему поколению слэбов
+				if((cache.head != nullptr) && (cache.generation == this->generation)){
+					// Последний возвращаемый блок
+					free_t * tail = cache.head;
+					// Ищем последний блок списка
+					while(tail->next != nullptr) tail = tail->next;
+					// Присоединяем общий список к возвращаемым блокам
+					tail->next = this->head;
+					// Запоминаем новое начало общего списка
+					this->head = cache.head;
+				}
+			}
+			/**
+			 * alive Метод подсчёта живых блоков пула (вызывается под блокировкой общего списка)
+			 * @return количество живых блоков
+			 */
+			ptrdiff_t alive() const noexcept {
+				// Живые блоки завершившихся потоков
+				ptrdiff_t result = this->orphan.load();
+				// Добавляем живые блоки всех потоков
+				for(auto cache : this->caches) result += cache->live.load();
+				// Выводим результат
+				return result;
+			}
+			/**
+			 * trim Метод освобождения слэбов, если в пуле не осталось живых блоков
+			 */
+			void trim() noexcept {
+				// Блокируем общий список
+				const std::lock_guard <std::mutex> lock(this->locker);
+				// Если слэбы выделены и живых блоков нет
+				if(!this->slabs.empty() && (this->alive() == 0)){
+					/**
+					 * Сначала меняем поколение, а затем проверяем живые блоки ещё раз: поток, который
+					 * начал выделение после первой проверки, либо уже учтён, либо увидит новое поколение
+					 */
+					this->generation++;
+					// Если живых блоков по-прежнему нет
+					if(this->alive() == 0){
+						// Освобождаем все слэбы
+						for(auto slab : this->slabs) ::operator delete(slab);
+						// Очищаем список слэбов
+						this->slabs.clear();
+						// Сбрасываем общий список и текущий слэб
+						this->head = nullptr;
+						this->cursor = this->end = nullptr;
+					}
+				}
+			}
+			/**
+			 * clean Функция освобождения слэбов пула для списка пулов
+			 */
+			static void clean() noexcept {
+				// Освобождаем слэбы пула
+				Pool::get().trim();
+			}
+			/**
+			 * acquire Метод получения пачки свободных блоков
+			 * @param cache список свободных блоков потока
+			 */
+			void acquire(cache_t & cache){
+				// Блокируем общий список
+				this->locker.lock();
+				// Список потока заполняется блоками текущего поколения слэбов
+				cache.generation = this->generation;
+				// Если в общем списке есть свободные блоки
+				if(this->head != nullptr){
+					// Последний забираемый блок
+					free_t * tail = this->head;
+					// Количество забираемых блоков
+					size_t count = 1;
+					// Отсчитываем пачку блоков
+					for(; (count < batch) && (tail->next != nullptr); count++) tail = tail->next;
+					// Забираем пачку блоков
+					cache.head = this->head;
+					// Запоминаем количество блоков
+					cache.size = count;
+					// Отрезаем пачку от общего списка
+					this->head = tail->next;
+					// Завершаем список потока
+					tail->next = nullptr;
+				// Иначе нарезаем блоки из слэба
+				} else {
+					// Если текущий слэб закончился
+					if(this->cursor == this->end){
+						// Выделяем новый слэб
+						this->cursor = reinterpret_cast <char *> (::operator new(slab, std::nothrow));
+						// Если память не выделена
+						if(this->cursor == nullptr){
+							// Разблокируем общий список
+							this->locker.unlock();
+							// Сообщаем об ошибке
+							throw std::bad_alloc();
+						}
+						// Запоминаем конец слэба
+						this->end = (this->cursor + slab);
+						// Запоминаем слэб
+						this->slabs.push_back(this->cursor);
+					}
+					// Нарезаем пачку блоков
+					for(size_t i = 0; (i < batch) && (this->cursor != this->end); i++){
+						// Получаем новый блок
+						free_t * item = reinterpret_cast <free_t *> (this->cursor);
+						// Добавляем блок в список потока
+						item->next = cache.head;
+						// Запоминаем начало списка
+						cache.head = item;
+						// Увеличиваем количество блоков
+						cache.size++;
+						// Смещаем позицию в слэбе
+						this->cursor += block;
+					}
+				}
+				// Разблокируем общий список
+				this->locker.unlock();
+			}
+		public:
+			/**
+			 * get Метод получения пула
+			 * @return пул блоков памяти
+			 */
+			static Pool & get() noexcept {
+				// Пул создаётся один раз и живёт до завершения процесса, так как узлы могут освобождаться при выходе
+				static Pool * result = new Pool;
+				// Выводим результат
+				return (* result);
+			}
+			/**
+			 * Pool Конструктор
+			 */
+			Pool() noexcept {
+				// Добавляем пул в список пулов
+				Pools::add(&Pool::clean);
+			}
+		public:
+			/**
+			 * allocate Метод выделения блока памяти
+			 * @return выделенный блок памяти
+			 */
+			void * allocate(){
+				// Если список потока уже уничтожен
+				if(dead()){
+					// Учитываем блок среди живых блоков завершившихся потоков
+					this->orphan++;
+					// Получаем временный список
+					cache_t tmp;
+					// Получаем пачку блоков
+					this->acquire(tmp);
+					// Забираем первый блок
+					free_t * item = tmp.head;
+					// Возвращаем остальные блоки
+					tmp.head = item->next;
+					// Уменьшаем количество блоков
+					tmp.size--;
+					// Выводим результат
+					return item;
+				}
+				// Получаем список потока
+				cache_t & cache = Pool::cache();
+				// Если список потока ещё не зарегистрирован, регистрируем его
+				if(!cache.registered) this->attach(cache);
+				// Учитываем блок до проверки поколения, чтобы слэбы не освободили во время выделения
+				cache.live.store(cache.live.load(std::memory_order_relaxed) + 1);
+				// Если слэбы списка потока освобождены, его блоков больше нет
+				if(cache.generation != this->generation){
+					// Сбрасываем список потока
+					cache.head = nullptr;
+					cache.size = 0;
+				}
+				// Если свободных блоков нет, получаем пачку
+				if(cache.head == nullptr) this->acquire(cache);
+				// Забираем первый блок
+				free_t * item = cache.head;
+				// Смещаем начало списка
+				cache.head = item->next;
+				// Уменьшаем количество блоков
+				cache.size--;
+				// Выводим результат
+				return item;
+			}
+			/**
+			 * deallocate Метод освобождения блока памяти
+			 * @param ptr освобождаемый блок памяти
+			 */
+			void deallocate(void * ptr) noexcept {
+				// Получаем освобождаемый блок
+				free_t * item = reinterpret_cast <free_t *> (ptr);
+				// Если список потока уже уничтожен, возвращаем блок в общий список
+				if(dead()){
+					// Завершаем список
+					item->next = nullptr;
+					// Возвращаем блок, блок жив до возврата, поэтому его слэб ещё существует
+					this->release(item, 1, this->generation);
+					// Убираем блок из живых блоков завершившихся потоков
+					this->orphan--;
+				// Иначе добавляем блок в список потока
+				} else {
+					// Получаем список потока
+					cache_t & cache = Pool::cache();
+					// Если список потока ещё не зарегистрирован, регистрируем его
+					if(!cache.registered) this->attach(cache);
+					// Если слэбы списка потока освобождены, сбрасываем список, блок относится к текущему поколению
+					if(cache.generation != this->generation){
+						// Сбрасываем список потока
+						cache.head = nullptr;
+						cache.size = 0;
+						// Запоминаем поколение слэбов
+						cache.generation = this->generation;
+					}
+					// Добавляем блок в начало списка
+					item->next = cache.head;
+					// Запоминаем начало списка
+					cache.head = item;
+					// Если у потока скопилось слишком много блоков, отдаём пачку другим потокам
+					if((++cache.size) > (batch * 2)){
+						// Начало отдаваемой пачки
+						free_t * head = cache.head;
+						// Последний блок отдаваемой пачки
+						free_t * tail = head;
+						// Отсчитываем пачку блоков
+						for(size_t i = 1; i < batch; i++) tail = tail->next;
+						// Отрезаем пачку от списка потока
+						cache.head = tail->next;
+						// Уменьшаем количество блоков
+						cache.size -= batch;
+						// Возвращаем пачку в общий список
+						this->release(head, batch, cache.generation);
+					}
+					// Блок учитываем освобождённым только после возврата, до этого слэбы не освобождаются
+					cache.live.store(cache.live.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+				}
+			}
+	};
+	/**
+	 * Arena Класс аллокатора узлов контейнеров из пула блоков
+	 */
+	template <typename T>
+	class Arena {
+		public:
+			// Тип выделяемого объекта
+			typedef T value_type;
+		public:
+			/**
+			 * allocate Метод выделения памяти
+			 * @param count количество объектов
+			 * @return      указатель на выделенную память
+			 */
+			T * allocate(const size_t count){
+				// Выравнивание узлов не должно превышать выравнивание блоков пула
+				static_assert(alignof(T) <= alignof(std::max_align_t), "alignment of the type is not supported by the pool");
+				// Одиночные узлы выделяем из пула
+				if(count == 1) return reinterpret_cast <T *> (Pool <sizeof(T)>::get().allocate());
+				// Иначе выделяем память обычным способом
+				return reinterpret_cast <T *> (::operator new(count * sizeof(T)));
+			}
+			/**
+			 * deallocate Метод освобождения памяти
+			 * @param ptr   указатель на освобождаемую память
+			 * @param count количество объектов
+			 */
+			void deallocate(T * ptr, const size_t count) noexcept {
+				// Одиночные узлы возвращаем в пул
+				if(count == 1) Pool <sizeof(T)>::get().deallocate(ptr);
+				// Иначе освобождаем память обычным способом
+				else ::operator delete(ptr);
+			}
+		public:
+			/**
+			 * Оператор сравнения, все аллокаторы работают с одним пулом
+			 */
+			template <typename U>
+			bool operator == (const Arena <U> &) const noexcept {return true;}
+			/**
+			 * Оператор сравнения, все аллокаторы работают с одним пулом
+			 */
+			template <typename U>
+			bool operator != (const Arena <U> &) const noexcept {return false;}
+		public:
+			/**
+			 * Arena Конструктор
+			 */
+			Arena() noexcept {}
+			/**
+			 * Arena Конструктор копирования из аллокатора другого типа
+			 */
+			template <typename U>
+			Arena(const Arena <U> &) noexcept {}
+	};
+};
+
+#endif // __ANYKS_ARENA__
@@ -20,6 +20,7 @@
 #include <bitset>
 #include <vector>
 #include <limits>
+#include <charconv>
 #include <fstream>
 #include <functional>
 #include <unordered_map>
@@ -28,8 +29,10 @@
  * Наши модули
  */
 #include <word.hpp>
+#include <arena.hpp>
 #include <alphabet.hpp>
 #include <tokenizer.hpp>
+#include <threadpool.hpp>
 #include <app/alm.hpp>
 
 
@@ -63,6 +66,8 @@ namespace anyks {
 		public:
 			// Упрощаем тип функции для получения слова
 			typedef std::function <const word_t * (const size_t)> words_t;
+			// Размер служебных данных одной записи бинарного контейнера (ключ, md5, размеры, заголовок блока и сжатие)
+			static constexpr u_short BINRECORD = 112;
 		private:
 			// Максимальная длина n-граммы
 			static constexpr u_short MAXSIZE = 9;
@@ -121,10 +126,158 @@ namespace anyks {
 				 */
 				Param() : prob(0.0), total(0), nonevent(0), observed(0), min2Vocab(0), min3Vocab(0), discounted(0) {}
 			} __attribute__((packed)) param_t;
+			/**
+			 * Uppers Класс списка регистров слова, список создаётся только при первом добавлении регистра
+			 */
+			typedef class Uppers {
+				private:
+					// Список позиций букв в верхнем регистре
+					std::unique_ptr <std::map <size_t, size_t>> ups;
+				private:
+					/**
+					 * none Метод получения пустого списка регистров
+					 * @return пустой список регистров
+					 */
+					static const std::map <size_t, size_t> & none() noexcept {
+						// Пустой список регистров
+						static const std::map <size_t, size_t> result;
+						// Выводим результат
+						return result;
+					}
+					/**
+					 * get Метод получения списка регистров для изменения
+					 * @return список регистров слова
+					 */
+					std::map <size_t, size_t> & get(){
+						// Если список ещё не создан, создаём его
+						if(this->ups == nullptr) this->ups.reset(new std::map <size_t, size_t>);
+						// Выводим результат
+						return (* this->ups);
+					}
+				public:
+					/**
+					 * empty Метод проверки на пустоту списка регистров
+					 * @return результат проверки
+					 */
+					bool empty() const noexcept {
+						// Выводим результат
+						return ((this->ups == nullptr) || this->ups->empty());
+					}
+					/**
+					 * size Метод получения количества регистров
+					 * @return количество регистров слова
+					 */
+					size_t size() const noexcept {
+						// Выводим результат
+						return (this->ups != nullptr ? this->ups->size() : 0);
+					}
+					/**
+					 * count Метод проверки существования регистра
+					 * @param key регистр слова
+					 * @return    количество найденных регистров
+					 */
+					size_t count(const size_t key) const noexcept {
+						// Выводим результат
+						return (this->ups != nullptr ? this->ups->count(key) : 0);
+					}
+					/**
+					 * clear Метод очистки списка регистров
+					 */
+					void clear() noexcept {
+						// Удаляем список регистров
+						this->ups.reset();
+					}
+					/**
+					 * begin Метод получения начала списка регистров
+					 * @return итератор начала списка
+					 */
+					std::map <size_t, size_t>::const_iterator begin() const noexcept {
+						// Выводим результат
+						return (this->ups != nullptr ? this->ups->begin() : none().begin());
+					}
+					/**
+					 * end Метод получения конца списка регистров
+					 * @return итератор конца списка
+					 */
+					std::map <size_t, size_t>::const_iterator end() const noexcept {
+						// Выводим результат
+						return (this->ups != nullptr ? this->ups->end() : none().end());
+					}
+					/**
+					 * emplace Метод добавления регистра слова
+					 * @param args регистр слова и его встречаемость
+					 */
+					template <typename... Args>
+					void emplace(Args && ... args){
+						// Добавляем регистр в список
+						this->get().emplace(std::forward <Args> (args)...);
+					}
+				public:
+					/**
+					 * Оператор получения встречаемости регистра
+					 * @param key регистр слова
+					 * @return    встречаемость регистра слова
+					 */
+					size_t & operator [] (const size_t key){
+						// Выводим результат
+						return this->get()[key];
+					}
+					/**
+					 * Оператор приведения к списку регистров
+					 */
+					operator const std::map <size_t, size_t> & () const noexcept {
+						// Выводим результат
+						return (this->ups != nullptr ? (* this->ups) : none());
+					}
+					/**
+					 * Оператор присваивания списка регистров
+					 * @param ups список регистров слова
+					 * @return    текущий объект
+					 */
+					Uppers & operator = (const std::map <size_t, size_t> & ups){
+						// Если список пустой, удаляем его, иначе копируем
+						if(ups.empty()) this->ups.reset(); else this->get() = ups;
+						// Выводим результат
+						return (* this);
+					}
+					/**
+					 * Оператор копирования списка регистров
+					 * @param uppers список регистров слова
+					 * @return       текущий объект
+					 */
+					Uppers & operator = (const Uppers & uppers){
+						// Копируем список регистров
+						if(this != &uppers) (* this) = static_cast <const std::map <size_t, size_t> &> (uppers);
+						// Выводим результат
+						return (* this);
+					}
+					/**
+					 * Оператор перемещения списка регистров
+					 */
+					Uppers & operator = (Uppers &&) noexcept = default;
+				public:
+					/**
+					 * Uppers Конструктор
+					 */
+					Uppers() noexcept {}
+					/**
+					 * Uppers Конструктор перемещения
+					 */
+					Uppers(Uppers &&) noexcept = default;
+					/**
+					 * Uppers Конструктор копирования
+					 * @param uppers список регистров слова
+					 */
+					Uppers(const Uppers & uppers){
+						// Копируем список регистров
+						(* this) = uppers;
+					}
+			} uppers_t;
 			/**
 			 * Структура словаря языковой модели временного словаря
+			 * (узлы выделяются из общего пула блоков, а не отдельными вызовами malloc)
 			 */
-			typedef struct Data : std::map <size_t, Data> {
+			typedef struct Data : std::map <size_t, Data, std::less <size_t>, Arena <std::pair <const size_t, Data>>> {
 				/**
 				 * Родительский объект
 				 */
@@ -144,7 +297,7 @@ namespace anyks {
 				/**
 				 * Список позиций букв в верхнем регистре
 				 */
-				std::map <size_t, size_t> uppers;
+				uppers_t uppers;
 				/**
 				 * Data Конструктор
 				 */
@@ -155,6 +308,8 @@ namespace anyks {
 			u_short size = DEFNGRAM;
 			// Размер текущей n-граммы
 			mutable u_short gram = 1;
+			// Количество потоков для обучения
+			size_t threads = 1;
 		private:
 			// Флаги параметров
 			std::bitset <6> options;
@@ -164,8 +319,10 @@ namespace anyks {
 			mutable param_t param;
 			// Список удалённых слов
 			mutable std::set <size_t> delwords;
-			// Блок шагов (список дочерних грамм для текущей n-граммы)
-			mutable std::map <u_short, std::list <data_t *>> ngrams;
+			// Индекс контекстов по порядкам (контексты порядка хранятся подряд, в порядке обхода дерева)
+			mutable std::vector <std::vector <data_t *>> ngrams;
+			// Тредпул для параллельной обработки контекстов
+			mutable tpool_t tpool;
 		private:
 			// Функция извлечения слова по его идентификатору
 			words_t getWord = nullptr;
@@ -269,6 +426,20 @@ namespace anyks {
 			 * @return        результат расчёта обратной частоты
 			 */
 			const double backoff(const size_t idw, const data_t * context, const u_short gram) const noexcept;
+			/**
+			 * backoff Метод подсчёта обратной частоты n-граммы в заранее найденном контексте отката
+			 * @param idw   идентификатор текущего слова
+			 * @param lower контекст отката и вес последней найденной в нём n-граммы
+			 * @return      результат расчёта обратной частоты
+			 */
+			const double backoff(const size_t idw, const std::pair <const data_t *, double> & lower) const noexcept;
+			/**
+			 * suffix Метод поиска контекста отката, общего для всех слов контекста
+			 * @param context контекст которому принадлежат слова
+			 * @param gram    размер n-граммы для отката
+			 * @return        контекст отката и вес последней найденной в нём n-граммы
+			 */
+			const std::pair <const data_t *, double> suffix(const data_t * context, const u_short gram) const noexcept;
 			/**
 			 * compute Метод расчёта коэффициентов для распределения весов в рамках 1.0
 			 * @param ngram       контекст для расчёта
@@ -277,13 +448,33 @@ namespace anyks {
 			 * @param denominator разность частот отката n-грамм
 			 */
 			const bool compute(data_t * ngram, const u_short gram, double & numerator, double & denominator) const noexcept;
+			/**
+			 * entropy Метод расчёта изменения перплексии от удаления каждой n-граммы контекста
+			 * @param context     контекст n-граммы которого оцениваются
+			 * @param gram        размер оцениваемых n-грамм
+			 * @param numerator   разность частот n-грамм
+			 * @param denominator разность частот отката n-грамм
+			 * @param callback    функция обратного вызова (n-грамма, вес контекста, новый вес, дельта веса, дельта энтропии, изменение перплексии)
+			 * @return            результат расчёта, контексты без частоты отката не оцениваются
+			 */
+			const bool entropy(data_t * context, const u_short gram, double & numerator, double & denominator, std::function <void (data_t *, const double, const double, const double, const double, const double)> callback) const noexcept;
 		protected:
 			/**
 			 * get Метод извлечения списка n-грамм указанного размера
 			 * @param gram размер n-граммы список грамм которой нужно извлечь
 			 * @return     указатель на список запрашиваемых n-грамм
 			 */
-			std::list <data_t *> * get(const u_short gram) const noexcept;
+			std::vector <data_t *> * get(const u_short gram) const noexcept;
+			/**
+			 * unindex Метод сброса индекса контекстов начиная с указанного порядка
+			 * @param gram порядок, начиная с которого индекс становится недействительным
+			 */
+			void unindex(const u_short gram = 1) const noexcept;
+			/**
+			 * unindex Метод сброса индекса контекстов перед добавлением n-граммы в контекст
+			 * @param context контекст, в который добавляется n-грамма
+			 */
+			void unindex(const data_t * context) const noexcept;
 		protected:
 			/**
 			 * contextFn Метод получения контекста
@@ -320,20 +511,6 @@ namespace anyks {
 			 * @param uppers список регистров слова
 			 */
 			void uniUppers(std::multimap <size_t, size_t> & uppers) const noexcept;
-			/**
-			 * sequence Метод извлечения правильной последовательности, игнорирования <unk> токена
-			 * @param seq      последовательность для обработки
-			 * @param callback функция обратного вызова
-			 */
-			void sequence(const std::vector <seq_t> & seq
-                    , std::function <void (const std::vector <seq_t> &, const seq_t &)> callback) const noexcept;
-			/**
-			 * sequence Метод извлечения правильной последовательности, игнорирования <unk> токена
-			 * @param seq      последовательность для обработки
-			 * @param callback функция обратного вызова
-			 */
-			void sequence(const std::vector <pair_t> & seq, std::function <
-                void (const std::vector <pair_t> &, const size_t)> callback) const noexcept;
 		private:
 			/**
 			 * nodiscount Метод проверки на необходимость расчёта скидки
@@ -422,6 +599,11 @@ namespace anyks {
 			 * @param size максимальный размер n-граммы
 			 */
 			void setSize(const u_short size) noexcept;
+			/**
+			 * setThreads Метод установки количества потоков
+			 * @param threads количество потоков для работы
+			 */
+			void setThreads(const size_t threads = 0) noexcept;
 			/**
 			 * setWordMethod Метод установки функции получения слова
 			 * @param word функция получения слова
@@ -460,6 +642,13 @@ namespace anyks {
 			 * @param idd    идентификатор документа в котором получена n-грамма
 			 */
 			void addBin(const std::vector <char> & buffer, const size_t idd = 0) const noexcept;
+			/**
+			 * merge Метод переноса n-грамм из другого словаря
+			 * @param arpa   словарь из которого переносятся n-граммы
+			 * @param shard  номер шарда первого слова n-граммы
+			 * @param shards общее количество шардов
+			 */
+			void merge(const Arpa * arpa, const size_t shard = 0, const size_t shards = 1) const noexcept;
 			/**
 			 * setBin Метод установки бинарных данных в словарь
 			 * @param buffer буфер с бинарными данными
@@ -472,6 +661,12 @@ namespace anyks {
 			 * @param callback функция обратного вызова
 			 */
 			void arpa(const u_short gram, std::function <void (const string &)> callback) const noexcept;
+			/**
+			 * arpaBlocks Метод извлечения данных arpa блоками строк
+			 * @param gram     размер n-граммы для извлечения
+			 * @param callback функция обратного вызова (блок строк arpa, количество n-грамм в блоке)
+			 */
+			void arpaBlocks(const u_short gram, std::function <void (const string &, const size_t)> callback) const noexcept;
 			/**
 			 * grams Метод извлечения данных n-грамм в текстовом виде
 			 * @param gram     размер n-граммы для извлечения
@@ -550,6 +745,18 @@ namespace anyks {
                 , const u_short mingram = 0
                 , std::function <void (const u_short)> status = nullptr
             ) const noexcept;
+			/**
+			 * pruneTo Метод прунинга языковой модели до заданного количества n-грамм или размера
+			 * @param count   максимальное количество n-грамм (0 - не ограничено)
+			 * @param size    максимальный размер записей arpa в бинарном контейнере в байтах (0 - не ограничен)
+			 * @param mingram значение минимальной n-граммы за которую нельзя прунить
+			 * @param status  функция вывода статуса обучения
+			 * @return        подобранный порог прунинга (0 - прунинг не потребовался или ограничения недостижимы)
+			 */
+			const double pruneTo(const size_t count, const uintmax_t size = 0
+                , const u_short mingram = 0
+                , std::function <void (const u_short)> status = nullptr
+            ) const noexcept;
 
 		public:
 			/**
@@ -593,6 +800,20 @@ namespace anyks {
                 , const std::size_t length, const double scale = 0.0
                 , std::function <void (const u_short)> status = nullptr
             ) noexcept;
+		private:
+			/**
+			 * mix Метод интерполяции нескольких моделей объединённым обходом деревьев
+			 * @param lms     список данных языковых моделей для объединения
+			 * @param lambdas список весов моделей при интерполяции
+			 * @param bayes   флаг интерполяции алгоритмом Баеса (иначе логарифмическо-линейная)
+			 * @param length  длина контекста для расчёта (для алгоритма Баеса)
+			 * @param scale   логарифмическая шкала вероятности (для алгоритма Баеса)
+			 * @param status  статус расчёта
+			 *
+			 * Веса всех n-грамм рассчитываются по исходным моделям параллельно по контекстам одного порядка,
+			 * новые n-граммы и веса устанавливаются в текущую модель после расчёта.
+			 */
+			void mix(const std::vector <const Arpa *> & lms, const std::vector <double> & lambdas, const bool bayes, const std::size_t length, const double scale, std::function <void (const u_short)> status) noexcept;
 
 		public:
 			/**
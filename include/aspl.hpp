@@ -18,18 +18,35 @@
 #include <cmath>
 #include <string>
 #include <vector>
+#include <atomic>
+#include <future>
 #include <fstream>
 #include <cstring>
 #include <zlib.h>
+#include <fcntl.h>
 #include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <openssl/md5.h>
 #include <openssl/aes.h>
 #include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
+/**
+ * Необязательные библиотеки сжатия
+ */
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
 /**
  * Наши модули
  */
+#include <threadpool.hpp>
 #include <bigint/BigIntegerLibrary.hh>
 
 // Параметры Zlib
@@ -55,47 +72,139 @@ namespace anyks {
 			 * Набор размеров шифрования
 			 */
 			enum class types_t : u_short {aes128 = 128, aes192 = 192, aes256 = 256};
+			/**
+			 * Набор алгоритмов сжатия записей
+			 */
+			enum class codec_t : u_char {gzip = 1, lz4 = 2, zstd = 3};
 		private:
 			// Максимальный размер слова
 			static constexpr u_short MAXWORD = 35;
 			// Размер чанка в байтах
 			static constexpr u_int CHUNKSIZE = 1048576;
+			// Размер буфера записи в байтах
+			static constexpr u_int WRITESIZE = 16777216;
+			// Размер независимо сжимаемого блока записи в байтах
+			static constexpr u_int BLOCKSIZE = 4194304;
+			// Флаг записи из одного блока, вместо таблицы блоков хранится только размер блока до сжатия
+			static constexpr u_int SINGLE = 0x80000000;
+			// Уровень сжатия zstd
+			static constexpr int ZSTDLEVEL = 3;
 			// Заголовок бинарного файла
 			static constexpr const char * HEADER = "ASPL";
+			// Заголовок бинарного файла с блочным сжатием записей
+			static constexpr const char * HEADERB = "ASPB";
+			// Заголовок бинарного файла с блочным сжатием и шифрованием записей AES-CTR
+			static constexpr const char * HEADERC = "ASPC";
+			// Размер случайной части счётчика AES-CTR, хранится перед зашифрованной записью
+			static constexpr u_short NONCESIZE = 8;
 			// Алфавит символов для генерации ключа
 			static constexpr const char * ALPHABET = "¶abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789+*-_./\\";
 		private:
 			/**
-			 * State Стрейт шифрования
+			 * State Стрейт шифрования, создаётся для каждой записи, чтобы записи можно было обрабатывать параллельно
 			 */
-			mutable struct StateAES {
+			typedef struct StateAES {
 				// Количество обработанных байт
 				int num;
+				// Ключ шифрования
+				AES_KEY key;
 				// Буфер данных для шифрования
 				u_char ivec[AES_BLOCK_SIZE];
 				/**
 				 * StateAES Конструктор
 				 */
 				StateAES() : num(0) {}
-			} stateAES;
+			} saes_t;
+			/**
+			 * Deflater Поток сжатия gzip, создаётся один раз для каждого потока и сбрасывается для каждого блока
+			 */
+			typedef struct Deflater {
+				// Поток zip
+				z_stream zs;
+				// Флаг инициализации потока
+				bool ready;
+				/**
+				 * Deflater Конструктор
+				 */
+				Deflater() noexcept : ready(false) {
+					// Заполняем поток нулями
+					memset(&this->zs, 0, sizeof(this->zs));
+					// Выполняем инициализацию потока
+					this->ready = (deflateInit2(&this->zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MOD_GZIP_ZLIB_WINDOWSIZE + 16, MOD_GZIP_ZLIB_CFACTOR, Z_DEFAULT_STRATEGY) == Z_OK);
+				}
+				/**
+				 * ~Deflater Деструктор
+				 */
+				~Deflater() noexcept {
+					// Закрываем поток
+					if(this->ready) deflateEnd(&this->zs);
+				}
+			} deflater_t;
+			/**
+			 * Inflater Поток расжатия gzip, создаётся один раз для каждого потока и сбрасывается для каждого блока
+			 */
+			typedef struct Inflater {
+				// Поток zip
+				z_stream zs;
+				// Флаг инициализации потока
+				bool ready;
+				/**
+				 * Inflater Конструктор
+				 */
+				Inflater() noexcept : ready(false) {
+					// Заполняем поток нулями
+					memset(&this->zs, 0, sizeof(this->zs));
+					// Выполняем инициализацию потока
+					this->ready = (inflateInit2(&this->zs, MOD_GZIP_ZLIB_WINDOWSIZE + 16) == Z_OK);
+				}
+				/**
+				 * ~Inflater Деструктор
+				 */
+				~Inflater() noexcept {
+					// Закрываем поток
+					if(this->ready) inflateEnd(&this->zs);
+				}
+			} inflater_t;
 		private:
 			// Файловый поток для чтения
 			std::ifstream ifs;
 			// Файловый поток для записи
 			std::ofstream ofs;
+			// Буфер файлового потока для записи, данные сбрасываются на диск только при заполнении буфера
+			std::vector <char> wbuffer;
 			// Список модулей для каждой буквы алфавита
 			std::vector <size_t> xs;
 			// Соль и пароль для шифрования
 			std::string salt, password;
 			// Путь, название и расширение файла
 			std::string path, name, ext;
-			// Список заголовков записей
+			// Список заголовков записей (заполняется при записи контейнера)
 			std::map <size_t, size_t> keys;
 		private:
-			// Ключ шифрования
-			mutable AES_KEY aesKey;
+			// Данные контейнера отображённые в память (при чтении контейнера)
+			const char * mapped = nullptr;
+			// Размер отображённых данных
+			size_t mapsize = 0;
+			// Позиция индекса ключей и количество ключей в индексе
+			size_t index = 0, indexCount = 0;
+		private:
 			// Определяем длину шифрования по умолчанию
 			types_t aeslen = types_t::aes128;
+			// Алгоритм сжатия записей, по умолчанию лучший из доступных
+			codec_t codec = best();
+			// Тип шифрования AES-CTR (nullptr если ключ не получен)
+			const EVP_CIPHER * cipherCTR = nullptr;
+			// Ключ шифрования AES-CTR, вычисляется один раз при установке параметров шифрования
+			u_char keyCTR[EVP_MAX_KEY_LENGTH] = {};
+		private:
+			// Флаг блочного сжатия записей (в контейнерах "ASPL" запись сжата одним потоком gzip)
+			bool blocks = true;
+			// Флаг шифрования записей AES-CTR (в контейнерах "ASPL" и "ASPB" записи зашифрованы потоком AES-CFB)
+			bool counter = true;
+			// Количество потоков сжатия
+			size_t threads = 1;
+			// Пул потоков сжатия
+			mutable tpool_t tpool;
 		private:
 			// Устанавливаем количество раундов
 			int roundsAES = 5;
@@ -106,8 +215,6 @@ namespace anyks {
 			// Позиция raw данных в файле
 			uintmax_t rawpos = 0;
 		private:
-			// Заголовок файла
-			const char * header = HEADER;
 			// Алфавит ключей
 			const string alphabet = ALPHABET;
 		private:
@@ -134,12 +241,10 @@ namespace anyks {
 					const char * bin = reinterpret_cast <const char *> (&value);
 					// Выполняем запись в файл
 					file.write(bin, size);
-					// Запоминаем текущую позицию файла
-					rawpos = file.tellp();
-					// Выполняем сброс данных в файл
-					file.flush();
 					// Запоминаем количество записанных байт
 					result = size;
+					// Запоминаем текущую позицию файла
+					rawpos += result;
 					// Запоминаем позицию записи
 					keys.insert({idw, rawpos - result});
 				}
@@ -167,25 +272,23 @@ namespace anyks {
 					// Размер записываемых данных
 					const size_t size = value.size();
 					// Размер md5 записи
-					const size_t sizeMd5 = md5.size();
-					// Получаем бинарные данные размера записываемых данных
-					const char * bin = reinterpret_cast <const char *> (&size);
-					// Получаем бинарные данные размера md5 записи
-					const char * binMd5 = reinterpret_cast <const char *> (&sizeMd5);
-					// Записываем размер md5 записи
-					file.write(binMd5, sizeof(sizeMd5));
-					// Выполняем запись в файл строку md5
-					file.write(md5.data(), sizeMd5);
-					// Выполняем запись в файл размер строки
-					file.write(bin, sizeof(size));
+					const size_t sizeMd5 = min(md5.size(), size_t(64));
+					// Заголовок записи: размер md5, строка md5 и размер данных
+					char header[64 + (sizeof(size_t) * 2)];
+					// Копируем размер md5 записи
+					memcpy(header, &sizeMd5, sizeof(sizeMd5));
+					// Копируем строку md5
+					memcpy(header + sizeof(sizeMd5), md5.data(), sizeMd5);
+					// Копируем размер записываемых данных
+					memcpy(header + sizeof(sizeMd5) + sizeMd5, &size, sizeof(size));
+					// Выполняем запись в файл заголовка записи
+					file.write(header, sizeMd5 + (sizeof(size) * 2));
 					// Выполняем запись в файл саму строку
 					file.write(value.data(), size);
-					// Запоминаем текущую позицию файла
-					rawpos = file.tellp();
-					// Выполняем сброс данных в файл
-					file.flush();
 					// Запоминаем количество записанных байт
 					result = (size + sizeMd5 + (sizeof(size) * 2));
+					// Запоминаем текущую позицию файла
+					rawpos += result;
 					// Запоминаем позицию записи
 					keys.insert({idw, rawpos - result});
 				}
@@ -225,15 +328,13 @@ namespace anyks {
 						const char * bin = reinterpret_cast <const char *> (&val);
 						// Выполняем запись в файл каждое значение
 						file.write(bin, sizeof(val));
-						// Запоминаем текущую позицию файла
-						rawpos = file.tellp();
-						// Выполняем сброс данных в файл
-						file.flush();
 						// Увеличиваем общий размер данных
 						size += sizeof(val);
 					}
 					// Запоминаем количество записанных байт
 					result = size;
+					// Запоминаем текущую позицию файла
+					rawpos += result;
 					// Запоминаем позицию записи
 					keys.insert({idw, rawpos - result});
 				}
@@ -275,15 +376,13 @@ namespace anyks {
 						file.write(bin, sizeof(length));
 						// Выполняем запись в файл саму строку
 						file.write(it->data(), length);
-						// Запоминаем текущую позицию файла
-						rawpos = file.tellp();
-						// Выполняем сброс данных в файл
-						file.flush();
 						// Увеличиваем общий размер данных
 						size += (sizeof(length) + length);
 					}
 					// Запоминаем количество записанных байт
 					result = size;
+					// Запоминаем текущую позицию файла
+					rawpos += result;
 					// Запоминаем позицию записи
 					keys.insert({idw, rawpos - result});
 				}
@@ -292,21 +391,20 @@ namespace anyks {
 			}
 			/**
 			 * getval Функция считывания целочисленных значений
-			 * @param pos   позиция записи в файле
-			 * @param file  файловый поток для записи
+			 * @param pos   позиция записи в данных
+			 * @param data  данные контейнера
+			 * @param size  размер данных контейнера
 			 * @param value значение записи
-			 * @return      результат операции (количество записанных байт)
+			 * @return      результат операции (количество прочитанных байт)
 			 */
 			template <typename Value>
-			static const uintmax_t getval(const size_t pos, ifstream & file, Value & value) noexcept {
+			static const uintmax_t getval(const size_t pos, const char * data, const size_t size, Value & value) noexcept {
 				// Результат работы функции
 				uintmax_t result = 0;
-				// Если файл открыт удачно
-				if(file.is_open()){
-					// Перемещаемся в указанную позицию файла
-					file.seekg(pos, file.beg);
-					// Выполняем чтение из файла
-					file.read((char *) &value, sizeof(value));
+				// Если значение помещается в данные
+				if((data != nullptr) && (pos <= size) && (sizeof(value) <= (size - pos))){
+					// Считываем значение
+					memcpy(&value, data + pos, sizeof(value));
 					// Запоминаем количество прочитанных байт
 					result = sizeof(value);
 				}
@@ -314,84 +412,100 @@ namespace anyks {
 				return result;
 			}
 			/**
-			 * getdat Функция извлечения бинарных данных
-			 * @param pos   позиция записи в файле
-			 * @param file  файловый поток для записи
-			 * @param value значение записи
-			 * @param md5   хэш md5 если существует
-			 * @return      результат операции (количество прочитанных байт)
+			 * getref Функция получения ссылки на бинарные данные записи без копирования
+			 * @param pos    позиция записи в данных
+			 * @param data   данные контейнера
+			 * @param size   размер данных контейнера
+			 * @param ptr    указатель на данные записи
+			 * @param length размер данных записи
+			 * @param md5    хэш md5 если существует
+			 * @return       результат операции (количество прочитанных байт)
 			 */
-			template <class Container>
-			static const uintmax_t getdat(const size_t pos, ifstream & file, Container & value, string & md5) noexcept {
+			static const uintmax_t getref(const size_t pos, const char * data, const size_t size, const char * & ptr, size_t & length, string & md5) noexcept {
 				// Результат работы функции
 				uintmax_t result = 0;
-				// Если файл открыт удачно
-				if(file.is_open()){
-					// Размер записываемых данных
-					size_t size = 0, sizeMd5 = 0;
-					// Перемещаемся в указанную позицию файла
-					file.seekg(pos, file.beg);
+				// Размер записи md5
+				size_t sizeMd5 = 0;
+				// Сбрасываем данные записи
+				ptr = nullptr;
+				// Сбрасываем размер данных записи
+				length = 0;
+				// Если размер записи md5 помещается в данные, размеры сравниваем вычитанием, чтобы сумма не переполнилась
+				if((data != nullptr) && (pos <= size) && (sizeof(sizeMd5) <= (size - pos))){
 					// Считываем размер записи md5
-					file.read((char *) &sizeMd5, sizeof(sizeMd5));
-					// Если md5 запись получена
-					if(sizeMd5 > 0){
-						// Буфер данных md5 хэша
-						char buffer[64];
-						// Зануляем буфер
-						memset(buffer, 0 , sizeMd5);
-						// Считываем в буфер md5 запись
-						file.read(buffer, sizeMd5);
+					memcpy(&sizeMd5, data + pos, sizeof(sizeMd5));
+					// Если запись md5 и размер данных помещаются в данные
+					if((sizeMd5 <= 64) && ((sizeMd5 + (sizeof(length) * 2)) <= (size - pos))){
 						// Запоминаем полученную строку md5
-						md5.assign(buffer, sizeMd5);
-					}
-					// Выполняем чтение из файла
-					file.read((char *) &size, sizeof(size));
-					// Если размер строки получен
-					if(size > 0){
-						// Создаем буфер данных для чтения строки
-						vector <char> buffer(size);
-						// Выполняем чтение данных строки
-						file.read(buffer.data(), size);
-						// Запоминаем результат
-						value.assign(buffer.begin(), buffer.end());
+						if(sizeMd5 > 0) md5.assign(data + pos + sizeof(sizeMd5), sizeMd5);
+						// Считываем размер данных записи
+						memcpy(&length, data + pos + sizeof(sizeMd5) + sizeMd5, sizeof(length));
+						// Если данные записи не помещаются в данные контейнера, сбрасываем размер
+						if(length > (size - pos - sizeMd5 - (sizeof(length) * 2))) length = 0;
+						// Иначе запоминаем указатель на данные записи
+						else {
+							// Получаем указатель на данные записи
+							ptr = (data + pos + sizeMd5 + (sizeof(length) * 2));
+							// Запоминаем количество прочитанных байт
+							result = (length + sizeMd5 + (sizeof(length) * 2));
+						}
 					}
-					// Запоминаем количество прочитанных байт
-					result = (size + sizeMd5 + (sizeof(size) * 2));
 				}
 				// Выводим результат
 				return result;
 			}
+			/**
+			 * getdat Функция извлечения бинарных данных
+			 * @param pos   позиция записи в данных
+			 * @param data  данные контейнера
+			 * @param size  размер данных контейнера
+			 * @param value значение записи
+			 * @param md5   хэш md5 если существует
+			 * @return      результат операции (количество прочитанных байт)
+			 */
+			template <class Container>
+			static const uintmax_t getdat(const size_t pos, const char * data, const size_t size, Container & value, string & md5) noexcept {
+				// Размер данных записи
+				size_t length = 0;
+				// Указатель на данные записи
+				const char * ptr = nullptr;
+				// Получаем данные записи
+				const uintmax_t result = getref(pos, data, size, ptr, length, md5);
+				// Если данные записи получены, запоминаем их
+				if(length > 0) value.assign(ptr, ptr + length);
+				// Выводим результат
+				return result;
+			}
 			/**
 			 * getvals Функция чтения списка числовых значений
-			 * @param pos   позиция записи в файле
-			 * @param file  файловый поток для записи
+			 * @param pos   позиция записи в данных
+			 * @param data  данные контейнера
+			 * @param size  размер данных контейнера
 			 * @param value значение записи
-			 * @return      результат операции (количество записанных байт)
+			 * @return      результат операции (количество прочитанных байт)
 			 */
 			template <class Container>
-			static const uintmax_t getvals(const size_t pos, ifstream & file, Container & value) noexcept {
+			static const uintmax_t getvals(const size_t pos, const char * data, const size_t size, Container & value) noexcept {
 				// Результат работы функции
 				uintmax_t result = 0;
-				// Если файл открыт удачно
-				if(file.is_open()){
-					// Количество записей в списке
-					size_t count = 0;
-					// Перемещаемся в указанную позицию файла
-					file.seekg(pos, file.beg);
-					// Выполняем чтение из файла количество записей
-					file.read((char *) &count, sizeof(count));
+				// Количество записей в списке
+				size_t count = 0;
+				// Если количество записей помещается в данные
+				if((data != nullptr) && (pos <= size) && (sizeof(count) <= (size - pos))){
+					// Считываем количество записей
+					memcpy(&count, data + pos, sizeof(count));
 					// Запоминаем количество прочитанных байт
 					result = sizeof(count);
-					// Если количество записей больше 0
-					if(count > 0){
+					// Ожидаемое значение
+					typename Container::value_type val;
+					// Если список помещается в данные
+					if((count > 0) && (count <= ((size - pos - sizeof(count)) / sizeof(val)))){
 						// Очищаем контейнер
 						value.clear();
-						// Ожидаемое значение
-						typename Container::value_type val;
 						// Считываем нужное нам количество записей
 						for(size_t i = 0; i < count; i++){
 							// Считываем значение из списка
-							file.read((char *) &val, sizeof(val));
+							memcpy(&val, data + pos + result, sizeof(val));
 							// Добавляем значение в список
 							value.insert(value.end(), val);
 							// Увеличиваем количество прочитанных байт
@@ -404,23 +518,22 @@ namespace anyks {
 			}
 			/**
 			 * getstrs Функция чтения списка строковых значений
-			 * @param pos   позиция записи в файле
-			 * @param file  файловый поток для записи
+			 * @param pos   позиция записи в данных
+			 * @param data  данные контейнера
+			 * @param size  размер данных контейнера
 			 * @param value значение записи
-			 * @return       результат операции (количество записанных байт)
+			 * @return      результат операции (количество прочитанных байт)
 			 */
 			template <class Container>
-			static const uintmax_t getstrs(const size_t pos, ifstream & file, Container & value) noexcept {
+			static const uintmax_t getstrs(const size_t pos, const char * data, const size_t size, Container & value) noexcept {
 				// Результат работы функции
 				uintmax_t result = 0;
-				// Если файл открыт удачно
-				if(file.is_open()){
-					// Количество записей в списке
-					size_t count = 0;
-					// Перемещаемся в указанную позицию файла
-					file.seekg(pos, file.beg);
-					// Выполняем чтение из файла количество записей
-					file.read((char *) &count, sizeof(count));
+				// Количество записей в списке
+				size_t count = 0;
+				// Если количество записей помещается в данные
+				if((data != nullptr) && (pos <= size) && (sizeof(count) <= (size - pos))){
+					// Считываем количество записей
+					memcpy(&count, data + pos, sizeof(count));
 					// Запоминаем количество прочитанных байт
 					result = sizeof(count);
 					// Если количество записей больше 0
@@ -430,32 +543,15 @@ namespace anyks {
 						// Длина строки
 						size_t length = 0;
 						// Считываем нужное нам количество записей
-						for(size_t i = 0; i < count; i++){
+						for(size_t i = 0; (i < count) && (sizeof(length) <= (size - pos - result)); i++){
 							// Считываем длину строки из списка
-							file.read((char *) &length, sizeof(length));
-							// Если длина получена
-							if(length > 0){
-								try {
-									// Создаем буфер данных
-									char * buffer = new char [length + 1];
-									// Зануляем буфер данных
-									memset(buffer, 0, length);
-									// Считываем в буфер данных значение строки
-									file.read(buffer, length);
-									// Добавляем конец строки
-									buffer[length] = '\0';
-									// Добавляем строку в список
-									value.insert(value.end(), buffer);
-									// Удаляем буфер данных
-									delete [] buffer;
-									// Увеличиваем количество прочитанных байт
-									result += (length + sizeof(length));
-								// Если происходит ошибка то игнорируем её
-								} catch(const std::bad_alloc &) {
-									// Выходим из приложения
-									exit(EXIT_FAILURE);
-								}
-							}
+							memcpy(&length, data + pos + result, sizeof(length));
+							// Если строка не помещается в данные, выходим
+							if(length > (size - pos - result - sizeof(length))) break;
+							// Добавляем строку в список
+							value.insert(value.end(), string(data + pos + result + sizeof(length), length));
+							// Увеличиваем количество прочитанных байт
+							result += (length + sizeof(length));
 						}
 					}
 				}
@@ -463,6 +559,66 @@ namespace anyks {
 				return result;
 			}
 		protected:
+			/**
+			 * find Метод поиска позиции записи в индексе ключей
+			 * @param idw идентификатор ключа
+			 * @param pos позиция записи в данных
+			 * @return    результат поиска
+			 */
+			const bool find(const size_t idw, size_t & pos) const noexcept {
+				// Результат работы функции
+				bool result = false;
+				// Если индекс ключей загружен
+				if((this->mapped != nullptr) && (this->indexCount > 0)){
+					// Полученный ключ
+					size_t key = 0;
+					// Получаем начало индекса, ключи в индексе отсортированы по возрастанию
+					const char * index = (this->mapped + this->index);
+					// Границы поиска
+					size_t first = 0, last = this->indexCount, middle = 0;
+					// Выполняем бинарный поиск ключа
+					while(first < last){
+						// Получаем середину диапазона
+						middle = (first + ((last - first) / 2));
+						// Считываем ключ
+						memcpy(&key, index + (middle * sizeof(size_t) * 2), sizeof(key));
+						// Если ключ меньше искомого, ищем справа
+						if(key < idw) first = (middle + 1);
+						// Иначе ищем слева
+						else last = middle;
+					}
+					// Если ключ не вышел за пределы индекса
+					if(first < this->indexCount){
+						// Считываем ключ
+						memcpy(&key, index + (first * sizeof(size_t) * 2), sizeof(key));
+						// Если ключ найден
+						if((result = ((idw > 0) && (key == idw)))){
+							// Считываем позицию записи
+							memcpy(&pos, index + (first * sizeof(size_t) * 2) + sizeof(key), sizeof(pos));
+							// Переводим позицию в позицию в данных контейнера
+							pos += this->address;
+						}
+					}
+				}
+				// Выводим результат
+				return result;
+			}
+			/**
+			 * unmap Метод освобождения отображённых в память данных контейнера
+			 */
+			void unmap() noexcept {
+				// Если данные отображены в память
+				if(this->mapped != nullptr){
+					// Освобождаем отображённые данные
+					munmap((void *) this->mapped, this->mapsize);
+					// Сбрасываем указатель на данные
+					this->mapped = nullptr;
+				}
+				// Сбрасываем размер данных
+				this->mapsize = 0;
+				// Сбрасываем индекс ключей
+				this->index = this->indexCount = 0;
+			}
 			/**
 			 * init Метод инициализации класса
 			 */
@@ -489,6 +645,30 @@ namespace anyks {
 				// Если файл открыт, закрываем его
 				if(this->ofs.is_open()) this->ofs.close();
 			}
+			/**
+			 * buffering Метод установки большого буфера файлового потока для записи
+			 */
+			void buffering() noexcept {
+				// Если буфер ещё не выделен, выделяем его
+				if(this->wbuffer.empty()) this->wbuffer.resize(WRITESIZE);
+				// Устанавливаем буфер файлового потока
+				this->ofs.rdbuf()->pubsetbuf(this->wbuffer.data(), this->wbuffer.size());
+			}
+			/**
+			 * sync Метод сброса данных файла на диск
+			 * @param filename адрес файла для сброса
+			 */
+			void sync(const string & filename) const noexcept {
+				// Открываем файл для получения дескриптора
+				const int fd = ::open(filename.c_str(), O_RDONLY);
+				// Если файл открыт
+				if(fd > -1){
+					// Сбрасываем данные файла на диск
+					::fsync(fd);
+					// Закрываем файл
+					::close(fd);
+				}
+			}
 			/**
 			 * open Метод открытия файла базы на чтение или запись
 			 * @param status статус файлового потока
@@ -514,6 +694,8 @@ namespace anyks {
 							if(this->ofs.is_open()) this->close();
 							// Если файл существует
 							if(!this->isFile(filename)) this->rawpos = 0;
+							// Устанавливаем буфер записи, буфер устанавливается до открытия файла
+							this->buffering();
 							// Открываем файл на запись
 							this->ofs.open(filename.c_str(), ios::binary);
 							// Если позиция не определена
@@ -554,18 +736,31 @@ namespace anyks {
 			 * @return     хэш md5
 			 */
 			const string md5(const vector <char> & dump) const noexcept {
+				// Выводим результат
+				return this->md5(dump.data(), dump.size());
+			}
+			/**
+			 * md5 Метод получения md5 хэша буфера без копирования данных
+			 * @param buffer буфер данных
+			 * @param size   размер буфера данных
+			 * @return       хэш md5
+			 */
+			const string md5(const char * buffer, const size_t size) const noexcept {
 				// Результат работы функции
 				string result;
-				// Если текст передан
-				if(!dump.empty()){
+				// Если буфер передан
+				if((buffer != nullptr) && (size > 0)){
 					// Массив полученных значений
 					u_char digest[16];
 					// Создаем контекст
 					MD5_CTX ctx;
 					// Выполняем инициализацию контекста
 					MD5_Init(&ctx);
-					// Выполняем расчет суммы
-					MD5_Update(&ctx, dump.data(), dump.size());
+					// Выполняем расчет суммы по чанкам, чтобы не держать в кэше весь буфер сразу
+					for(size_t offset = 0; offset < size; offset += CHUNKSIZE){
+						// Добавляем чанк в сумму
+						MD5_Update(&ctx, buffer + offset, min(size_t(CHUNKSIZE), size - offset));
+					}
 					// Копируем полученные данные
 					MD5_Final(digest, &ctx);
 					// Строка md5
@@ -583,9 +778,10 @@ namespace anyks {
 		protected:
 			/**
 			 * initAES Метод инициализации AES шифрования
-			 * @return результат инициализации
+			 * @param state стрейт шифрования для инициализации
+			 * @return      результат инициализации
 			 */
-			const bool initAES() const {
+			const bool initAES(saes_t & state) const {
 				// Экранируем возможность ошибки памяти
 				try {
 					// Создаем тип шифрования
@@ -624,7 +820,7 @@ namespace anyks {
 						return false;
 					}
 					// Устанавливаем ключ шифрования
-					const int res = AES_set_encrypt_key(key, keylen * 8, &this->aesKey);
+					const int res = AES_set_encrypt_key(key, keylen * 8, &state.key);
 					// Удаляем выделенную память для ключа
 					delete [] key;
 					// Если установка ключа не произошло
@@ -635,13 +831,11 @@ namespace anyks {
 						return false;
 					}
 					// Обнуляем номер
-					this->stateAES.num = 0;
+					state.num = 0;
 					// Заполняем половину структуры нулями
-					memset(this->stateAES.ivec, 0, sizeof(this->stateAES.ivec));
+					memset(state.ivec, 0, sizeof(state.ivec));
 					// Копируем данные шифрования
-					memcpy(this->stateAES.ivec, iv, ivlen);
-					// Выполняем шифрование
-					// AES_encrypt(this->stateAES.ivec, this->stateAES.count, &this->aesKey);
+					memcpy(state.ivec, iv, ivlen);
 					// Очищаем выделенную память буферов
 					delete [] iv;
 					// Сообщаем что всё удачно
@@ -652,6 +846,99 @@ namespace anyks {
 					exit(EXIT_FAILURE);
 				}
 			}
+			/**
+			 * initCTR Метод получения ключа шифрования AES-CTR, ключ общий для всех записей контейнера
+			 */
+			void initCTR() noexcept {
+				// Очищаем прежний ключ шифрования
+				OPENSSL_cleanse(this->keyCTR, sizeof(this->keyCTR));
+				// Сбрасываем тип шифрования
+				this->cipherCTR = nullptr;
+				// Если пароль установлен
+				if(!this->password.empty()){
+					// Создаем тип шифрования
+					const EVP_CIPHER * cipher = nullptr;
+					// Устанавливаем длину шифрования
+					switch((u_short) this->aeslen){
+						// Устанавливаем шифрование в 128
+						case (u_short) types_t::aes128: cipher = EVP_aes_128_ctr(); break;
+						// Устанавливаем шифрование в 192
+						case (u_short) types_t::aes192: cipher = EVP_aes_192_ctr(); break;
+						// Устанавливаем шифрование в 256
+						case (u_short) types_t::aes256: cipher = EVP_aes_256_ctr(); break;
+					}
+					// Если тип шифрования получен
+					if(cipher != nullptr){
+						// Буфер вектора инициализации, вектор берётся из счётчика записи
+						u_char iv[EVP_MAX_IV_LENGTH];
+						// Выполняем инициализацию ключа так же, как для AES-CFB
+						if(EVP_BytesToKey(cipher, EVP_sha256(), (this->salt.empty() ? nullptr : (u_char *) this->salt.data()), (u_char *) this->password.data(), this->password.length(), this->roundsAES, this->keyCTR, iv) != 0){
+							// Запоминаем тип шифрования
+							this->cipherCTR = cipher;
+						}
+						// Очищаем вектор инициализации
+						OPENSSL_cleanse(iv, sizeof(iv));
+					}
+				}
+			}
+			/**
+			 * ctr Метод шифрования и дешифрования данных AES-CTR
+			 * @param nonce    случайная часть счётчика записи
+			 * @param input    входные данные
+			 * @param output   буфер для результата (того же размера что и входные данные)
+			 * @param size     размер данных
+			 * @param parallel обрабатывать блоки записи в пуле потоков
+			 * @return         результат операции
+			 */
+			const bool ctr(const u_char * nonce, const u_char * input, u_char * output, const size_t size, const bool parallel) const noexcept {
+				// Если ключ не получен, выходим
+				if(this->cipherCTR == nullptr) return false;
+				// Результат работы функции
+				std::atomic <bool> result(true);
+				// Получаем количество блоков, каждый блок шифруется со своего значения счётчика
+				const size_t count = ((size + BLOCKSIZE - 1) / BLOCKSIZE);
+				/**
+				 * cryptFn Функция шифрования группы блоков
+				 * @param first первый блок группы
+				 * @param last  конец группы блоков
+				 */
+				auto cryptFn = [&](const size_t first, const size_t last) noexcept {
+					// Размер зашифрованных данных
+					int length = 0;
+					// Вектор инициализации блока: случайная часть и номер блока AES в big-endian
+					u_char iv[AES_BLOCK_SIZE];
+					// Создаем контекст
+					EVP_CIPHER_CTX * ctx = EVP_CIPHER_CTX_new();
+					// Если контекст не создан, запоминаем ошибку
+					if(ctx == nullptr) result = false;
+					// Переходим по всем блокам группы
+					for(size_t i = first; result && (i < last); i++){
+						// Получаем смещение блока
+						const size_t offset = (i * BLOCKSIZE);
+						// Получаем номер первого блока AES
+						uint64_t number = (offset / AES_BLOCK_SIZE);
+						// Копируем случайную часть счётчика
+						memcpy(iv, nonce, NONCESIZE);
+						// Записываем номер блока AES в big-endian
+						for(int j = (AES_BLOCK_SIZE - 1); j >= NONCESIZE; j--, number >>= 8) iv[j] = u_char(number & 0xFF);
+						// Выполняем шифрование блока, в режиме CTR шифрование и дешифрование совпадают
+						if((EVP_EncryptInit_ex(ctx, this->cipherCTR, nullptr, this->keyCTR, iv) != 1) ||
+						(EVP_EncryptUpdate(ctx, output + offset, &length, input + offset, int(min(size_t(BLOCKSIZE), size - offset))) != 1)) result = false;
+					}
+					// Очищаем контекст
+					if(ctx != nullptr) EVP_CIPHER_CTX_free(ctx);
+				};
+				// Если блоков несколько и вызывающая сторона не параллельна, шифруем блоки в пуле потоков
+				if(parallel && (this->threads > 1) && (count > 1)){
+					// Запускаем потоки тредпула, если они ещё не запущены, останавливаются они при записи контейнера
+					this->tpool.init(this->threads);
+					// Шифруем блоки
+					this->tpool.parallel_for(0, count, cryptFn, 1);
+				// Иначе шифруем блоки в текущем потоке
+				} else cryptFn(0, count);
+				// Выводим результат
+				return result;
+			}
 			/**
 			 * isFile Метод проверяющий существование файла
 			 * @param  filename адрес файла
@@ -700,46 +987,31 @@ namespace anyks {
 		protected:
 			/**
 			 * encrypt Метод шифрования текста
-			 * @param  buffer буфер данных для шифрования
-			 * @param  size   размер данных для шифрования
-			 * @return        результат шифрования
+			 * @param  buffer   буфер данных для шифрования
+			 * @param  size     размер данных для шифрования
+			 * @param  parallel шифровать блоки записи в пуле потоков
+			 * @return          результат шифрования
 			 */
-			const vector <char> encrypt(const char * buffer = nullptr, const size_t size = 0) const {
+			const vector <char> encrypt(const char * buffer = nullptr, const size_t size = 0, const bool parallel = true) const {
 				// Результат работы функции
 				vector <char> result;
 				// Если буфер данных передан
 				if((buffer != nullptr) && (size > 0)){
 					// Если пароль установлен
 					if(!this->password.empty()){
-						// Выполняем инициализацию
-						this->initAES();
 						// Экранируем возможность ошибки памяти
 						try {
-							// Максимальный размер считываемых данных
-							int chunk = 0;
-							// Размер буфера полученных данных
-							size_t count = 0;
-							// Определяем размер данных для считывания
-							size_t len = size;
-							// Входные данные
-							const u_char * input = (u_char *) buffer;
-							// Выделяем память для буфера данных
-							u_char * output = new u_char [len];
-							// Выполняем извлечение оставшихся данных
-							do {
-								// Максимальный размер считываемых данных
-								chunk = (len > CHUNKSIZE ? CHUNKSIZE : len);
-								// Выполняем сжатие данных
-								AES_cfb128_encrypt(input + count, output + count, chunk, &this->aesKey, this->stateAES.ivec, &this->stateAES.num, AES_ENCRYPT);
-								// Увеличиваем смещение
-								count += chunk;
-								// Вычитаем считанные данные
-								len -= chunk;
-							} while(len > 0);
-							// Запоминаем полученные данные
-							result.insert(result.end(), output, output + count);
-							// Очищаем буфер
-							delete [] output;
+							// Выделяем память для случайной части счётчика и зашифрованных данных
+							result.resize(size + NONCESIZE);
+							// Получаем указатель на результат
+							u_char * output = (u_char *) result.data();
+							// Генерируем случайную часть счётчика, для каждой записи она своя
+							if((RAND_bytes(output, NONCESIZE) != 1) || !this->ctr(output, (const u_char *) buffer, output + NONCESIZE, size, parallel)){
+								// Очищаем результат
+								result.clear();
+								// Освобождаем память
+								result.shrink_to_fit();
+							}
 						// Если происходит ошибка то игнорируем её
 						} catch(const std::bad_alloc &) {
 							// Выходим из приложения
@@ -762,10 +1034,33 @@ namespace anyks {
 				vector <char> result;
 				// Если буфер данных передан
 				if((buffer != nullptr) && (size > 0)){
-					// Если пароль установлен
-					if(!this->password.empty()){
+					// Если пароль установлен и записи зашифрованы AES-CTR
+					if(!this->password.empty() && this->counter){
+						// Если в записи есть данные кроме случайной части счётчика
+						if(size > NONCESIZE){
+							// Экранируем возможность ошибки памяти
+							try {
+								// Выделяем память для расшифрованных данных
+								result.resize(size - NONCESIZE);
+								// Выполняем расшифровку данных, записи извлекаются параллельно вызывающей стороной
+								if(!this->ctr((const u_char *) buffer, (const u_char *) buffer + NONCESIZE, (u_char *) result.data(), result.size(), false)){
+									// Очищаем результат
+									result.clear();
+									// Освобождаем память
+									result.shrink_to_fit();
+								}
+							// Если происходит ошибка то игнорируем её
+							} catch(const std::bad_alloc &) {
+								// Выходим из приложения
+								exit(EXIT_FAILURE);
+							}
+						}
+					// Если пароль установлен, записи зашифрованы потоком AES-CFB
+					} else if(!this->password.empty()){
+						// Стрейт шифрования записи
+						saes_t state;
 						// Выполняем инициализацию
-						this->initAES();
+						this->initAES(state);
 						// Экранируем возможность ошибки памяти
 						try {
 							// Максимальный размер считываемых данных
@@ -783,7 +1078,7 @@ namespace anyks {
 								// Максимальный размер считываемых данных
 								chunk = (len > CHUNKSIZE ? CHUNKSIZE : len);
 								// Выполняем сжатие данных
-								AES_cfb128_encrypt(input + count, output + count, chunk, &this->aesKey, this->stateAES.ivec, &this->stateAES.num, AES_DECRYPT);
+								AES_cfb128_encrypt(input + count, output + count, chunk, &state.key, state.ivec, &state.num, AES_DECRYPT);
 								// Увеличиваем смещение
 								count += chunk;
 								// Вычитаем считанные данные
@@ -805,68 +1100,249 @@ namespace anyks {
 				return result;
 			}
 			/**
-			 * compress Метод сжатия данных
-			 * @param  buffer буфер данных для сжатия
+			 * pack Метод сжатия одного блока данных
+			 * @param buffer буфер данных для сжатия
+			 * @param size   размер данных для сжатия
+			 * @return       сжатый блок (пустой при ошибке)
+			 */
+			const vector <char> pack(const char * buffer, const size_t size) const noexcept {
+				// Результат работы функции
+				vector <char> result;
+				// Определяем алгоритм сжатия
+				switch((u_short) this->codec){
+					// Если это gzip
+					case (u_short) codec_t::gzip: {
+						// Поток zip текущего потока, инициализация потока zip дороже сжатия небольшого блока
+						static thread_local deflater_t deflater;
+						// Получаем поток zip
+						z_stream & zs = deflater.zs;
+						// Если поток инициализирован и сброшен
+						if(deflater.ready && (deflateReset(&zs) == Z_OK)){
+							// Выделяем память под сжатые данные сразу, размер заголовка gzip больше заголовка zlib
+							result.resize(deflateBound(&zs, size) + 18);
+							// Устанавливаем данные для сжатия
+							zs.next_in = (Bytef *) buffer;
+							// Устанавливаем количество данных для сжатия
+							zs.avail_in = size;
+							// Устанавливаем буфер для сжатых данных
+							zs.next_out = (Bytef *) result.data();
+							// Устанавливаем размер буфера для сжатых данных
+							zs.avail_out = result.size();
+							// Сжимаем весь блок за один вызов
+							if(deflate(&zs, Z_FINISH) == Z_STREAM_END) result.resize(zs.total_out);
+							// Иначе сообщаем об ошибке
+							else result.clear();
+						}
+					} break;
+#ifdef USE_LZ4
+					// Если это lz4
+					case (u_short) codec_t::lz4: {
+						// Выделяем память под сжатые данные
+						result.resize(LZ4_compressBound(size));
+						// Выполняем сжатие блока
+						const int bytes = LZ4_compress_default(buffer, result.data(), size, result.size());
+						// Если блок сжат, обрезаем буфер, иначе сообщаем об ошибке
+						if(bytes > 0) result.resize(bytes); else result.clear();
+					} break;
+#endif
+#ifdef USE_ZSTD
+					// Если это zstd
+					case (u_short) codec_t::zstd: {
+						// Выделяем память под сжатые данные
+						result.resize(ZSTD_compressBound(size));
+						// Выполняем сжатие блока
+						const size_t bytes = ZSTD_compress(result.data(), result.size(), buffer, size, ZSTDLEVEL);
+						// Если блок сжат, обрезаем буфер, иначе сообщаем об ошибке
+						if(!ZSTD_isError(bytes)) result.resize(bytes); else result.clear();
+					} break;
+#endif
+				}
+				// Выводим результат
+				return result;
+			}
+			/**
+			 * unpack Метод расжатия одного блока данных
+			 * @param buffer буфер сжатого блока
+			 * @param bytes  размер сжатого блока
+			 * @param data   буфер для расжатых данных
+			 * @param size   размер расжатого блока
+			 * @return       результат расжатия
+			 */
+			const bool unpack(const char * buffer, const size_t bytes, char * data, const size_t size) const noexcept {
+				// Результат работы функции
+				bool result = false;
+				// Определяем алгоритм сжатия
+				switch((u_short) this->codec){
+					// Если это gzip
+					case (u_short) codec_t::gzip: {
+						// Поток zip текущего потока
+						static thread_local inflater_t inflater;
+						// Получаем поток zip
+						z_stream & zs = inflater.zs;
+						// Если поток инициализирован и сброшен
+						if(inflater.ready && (inflateReset(&zs) == Z_OK)){
+							// Устанавливаем сжатые данные
+							zs.next_in = (Bytef *) buffer;
+							// Устанавливаем размер сжатых данных
+							zs.avail_in = bytes;
+							// Устанавливаем буфер для расжатых данных
+							zs.next_out = (Bytef *) data;
+							// Устанавливаем размер буфера для расжатых данных
+							zs.avail_out = size;
+							// Расжимаем весь блок за один вызов
+							result = ((inflate(&zs, Z_FINISH) == Z_STREAM_END) && (zs.total_out == size));
+						}
+					} break;
+#ifdef USE_LZ4
+					// Если это lz4
+					case (u_short) codec_t::lz4:
+						// Выполняем расжатие блока
+						result = (LZ4_decompress_safe(buffer, data, bytes, size) == int(size));
+					break;
+#endif
+#ifdef USE_ZSTD
+					// Если это zstd
+					case (u_short) codec_t::zstd:
+						// Выполняем расжатие блока
+						result = (ZSTD_decompress(data, size, buffer, bytes) == size);
+					break;
+#endif
+				}
+				// Выводим результат
+				return result;
+			}
+			/**
+			 * inflateStream Метод расжатия данных сжатых одним потоком gzip (контейнеры "ASPL")
+			 * @param  buffer буфер данных для расжатия
 			 * @param  size   размер данных для сжатия
-			 * @return        результат сжатия
+			 * @return        результат расжатия
+			 */
+			const vector <char> inflateStream(const char * buffer, const size_t size) const noexcept {
+				// Результат работы функции
+				vector <char> result;
+				// Создаем поток zip
+				z_stream zs;
+				// Заполняем его нулями
+				memset(&zs, 0, sizeof(zs));
+				// Если поток инициализирован
+				if(inflateInit2(&zs, MOD_GZIP_ZLIB_WINDOWSIZE + 16) == Z_OK){
+					// Статус расжатия
+					int status = Z_OK;
+					// Заранее выделяем память, сжатые данные обычно в несколько раз меньше исходных
+					result.reserve(size * 4);
+					// Буфер выходных данных
+					vector <char> outbuff(CHUNKSIZE);
+					// Устанавливаем сжатые данные без копирования
+					zs.next_in = (Bytef *) buffer;
+					// Устанавливаем размер сжатых данных
+					zs.avail_in = size;
+					do {
+						// Устанавливаем буфер для записи расжатых данных
+						zs.next_out = (Bytef *) outbuff.data();
+						// Устанавливаем количество доступных данных для записи
+						zs.avail_out = CHUNKSIZE;
+						// Выполняем расжатие данных
+						status = inflate(&zs, Z_NO_FLUSH);
+						// Если произошла ошибка расжатия, выходим
+						if((status != Z_OK) && (status != Z_STREAM_END)) break;
+						// Добавляем расжатые данные в результат
+						result.insert(result.end(), outbuff.data(), outbuff.data() + (CHUNKSIZE - zs.avail_out));
+					// Если данные ещё не расжаты
+					} while((status != Z_STREAM_END) && ((zs.avail_in > 0) || (zs.avail_out == 0)));
+					// Закрываем поток
+					inflateEnd(&zs);
+				}
+				// Выводим результат
+				return result;
+			}
+			/**
+			 * compress Метод сжатия данных
+			 * @param  buffer   буфер данных для сжатия
+			 * @param  size     размер данных для сжатия
+			 * @param  parallel сжимать блоки записи в пуле потоков
+			 * @return          результат сжатия
 			 */
-			const vector <char> compress(const char * buffer = nullptr, const size_t size = 0) const noexcept {
+			const vector <char> compress(const char * buffer = nullptr, const size_t size = 0, const bool parallel = true) const noexcept {
 				// Результат работы функции
 				vector <char> result;
 				// Если буфер передан
 				if((buffer != nullptr) && (size > 0)){
-					// Создаем поток zip
-					z_stream zs = {0};
-					// Заполняем его нулями
-					memset(&zs, 0, sizeof(zs));
-					// Буфер входных данных
-					uint8_t inbuff[CHUNKSIZE];
-					// Буфер выходных данных
-					uint8_t outbuff[CHUNKSIZE];
-					// Если поток инициализировать не удалось, выходим
-					if(deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MOD_GZIP_ZLIB_WINDOWSIZE + 16, MOD_GZIP_ZLIB_CFACTOR, Z_DEFAULT_STRATEGY) == Z_OK){
-						// Количество оставшихся байт
-						uint32_t nbytes = 0;
-						// Смещение в буфере и размеры доанных
-						size_t offset = 0, count = 0, avail = 0;
-						// Переменная сброса данных
-						int flush = Z_NO_FLUSH;
-						do {
-							// Заполняем нулями буфер входящих данных
-							memset(inbuff, 0, sizeof(inbuff));
-							// Заполняем нулями буфер исходящих данных
-							memset(outbuff, 0, sizeof(outbuff));
-							// Получаем размер доступных данных
-							count = (size - offset);
-							// Высчитываем количество доступных данных
-							avail = (count > size_t(CHUNKSIZE) ? CHUNKSIZE : count);
-							// Устанавливаем количество доступных данных
-							zs.avail_in = avail;
-							// Копируем в буфер данные для шифрования
-							memcpy(inbuff, buffer + offset, zs.avail_in);
-							// Определяем закончено ли шифрование
-							flush = (count > 0 ? Z_NO_FLUSH : Z_FINISH);
-							// Устанавливаем буфер с данными для шифрования
-							zs.next_in = inbuff;
-							do {
-								// Устанавливаем буфер для записи шифрованных данных
-								zs.next_out = outbuff;
-								// Устанавливаем количество доступных данных для записи
-								zs.avail_out = CHUNKSIZE;
-								// Выполняем шифрование данных
-								deflate(&zs, flush);
-								// Получаем количество оставшихся байт
-								nbytes = (CHUNKSIZE - zs.avail_out);
-								// Добавляем оставшиеся данные в список
-								result.insert(result.end(), outbuff, outbuff + nbytes);
-							// Если все данные уже сжаты
-							} while(zs.avail_out == 0);
-							// Увеличиваем смещение в буфере
-							offset += avail;
-						// Если шифрование не зашифрованы
-						} while(flush != Z_FINISH);
-						// Закрываем поток
-						deflateEnd(&zs);
+					// Получаем количество блоков
+					const u_int count = ((size + BLOCKSIZE - 1) / BLOCKSIZE);
+					// Если блок в записи один, таблицу блоков не записываем
+					if(count == 1){
+						// Сжимаем блок
+						const vector <char> & block = this->pack(buffer, size);
+						// Если блок сжат
+						if(!block.empty()){
+							// Размер блока до сжатия с флагом записи из одного блока
+							const u_int head = (u_int(size) | SINGLE);
+							// Выделяем память под результат один раз
+							result.resize(sizeof(head) + block.size());
+							// Записываем размер блока до сжатия
+							memcpy(result.data(), &head, sizeof(head));
+							// Записываем сжатый блок
+							memcpy(result.data() + sizeof(head), block.data(), block.size());
+						}
+						// Выводим результат
+						return result;
+					}
+					// Сжатые блоки
+					vector <vector <char>> data(count);
+					/**
+					 * packFn Функция сжатия группы блоков
+					 * @param first первый блок группы
+					 * @param last  конец группы блоков
+					 */
+					auto packFn = [&](const size_t first, const size_t last) noexcept {
+						// Переходим по всем блокам группы
+						for(size_t i = first; i < last; i++){
+							// Получаем смещение блока
+							const size_t offset = (i * BLOCKSIZE);
+							// Сжимаем блок
+							data[i] = this->pack(buffer + offset, min(size_t(BLOCKSIZE), size - offset));
+						}
+					};
+					// Если вызывающая сторона не параллельна, сжимаем блоки в пуле потоков, так как блоки независимы
+					if(parallel && (this->threads > 1)){
+						// Запускаем потоки тредпула, если они ещё не запущены, останавливаются они при записи контейнера
+						this->tpool.init(this->threads);
+						// Сжимаем блоки
+						this->tpool.parallel_for(0, count, packFn, 1);
+					// Иначе сжимаем блоки в текущем потоке
+					} else packFn(0, count);
+					// Размер заголовка записи: количество блоков и размеры каждого блока до и после сжатия
+					size_t bytes = (sizeof(count) + (count * sizeof(u_int) * 2));
+					// Считаем общий размер сжатых данных
+					for(auto & block : data){
+						// Если блок не сжат, выходим
+						if(block.empty()) return result;
+						// Увеличиваем общий размер
+						bytes += block.size();
+					}
+					// Выделяем память под результат один раз
+					result.resize(bytes);
+					// Получаем указатель на данные результата
+					char * ptr = result.data();
+					// Записываем количество блоков
+					memcpy(ptr, &count, sizeof(count));
+					// Смещаем указатель
+					ptr += sizeof(count);
+					// Записываем размеры блоков
+					for(u_int i = 0; i < count; i++){
+						// Размер блока до и после сжатия
+						const u_int sizes[2] = {u_int(min(size_t(BLOCKSIZE), size - (size_t(i) * BLOCKSIZE))), u_int(data[i].size())};
+						// Записываем размеры блока
+						memcpy(ptr, sizes, sizeof(sizes));
+						// Смещаем указатель
+						ptr += sizeof(sizes);
+					}
+					// Записываем сжатые блоки
+					for(auto & block : data){
+						// Копируем данные блока
+						memcpy(ptr, block.data(), block.size());
+						// Смещаем указатель
+						ptr += block.size();
 					}
 				}
 				// Выводим результат
@@ -883,65 +1359,63 @@ namespace anyks {
 				vector <char> result;
 				// Если буфер передан
 				if((buffer != nullptr) && (size > 0)){
-					// Создаем поток zip
-					z_stream zs = {0};
-					// Заполняем его нулями
-					memset(&zs, 0, sizeof(zs));
-					// Буфер входных данных
-					uint8_t inbuff[CHUNKSIZE];
-					// Буфер выходных данных
-					uint8_t outbuff[CHUNKSIZE];
-					// Если поток инициализировать не удалось, выходим
-					if(inflateInit2(&zs, MOD_GZIP_ZLIB_WINDOWSIZE + 16) == Z_OK){
-						// Количество оставшихся байт
-						uint32_t nbytes = 0;
-						// Смещение в буфере и размеры доанных
-						size_t offset = 0, count = 0, avail = 0;
-						// Переменная сброса данных
-						int flush = Z_NO_FLUSH;
-						do {
-							// Заполняем нулями буфер входящих данных
-							memset(inbuff, 0, sizeof(inbuff));
-							// Заполняем нулями буфер исходящих данных
-							memset(outbuff, 0, sizeof(outbuff));
-							// Получаем размер доступных данных
-							count = (size - offset);
-							// Высчитываем количество доступных данных
-							avail = (count > size_t(CHUNKSIZE) ? CHUNKSIZE : count);
-							// Устанавливаем количество доступных данных
-							zs.avail_in = avail;
-							// Если доступных данных нет
-							if(zs.avail_in == 0) break;
-							// Копируем в буфер данные для шифрования
-							memcpy(inbuff, buffer + offset, zs.avail_in);
-							// Копируем входящий буфер для дешифровки
-							zs.next_in = inbuff;
-							do {
-								// Устанавливаем буфер для записи дешифрованных данных
-								zs.next_out = outbuff;
-								// Устанавливаем количество доступных данных для записи
-								zs.avail_out = CHUNKSIZE;
-								// Выполняем дешифровку данных
-								flush = inflate(&zs, Z_NO_FLUSH);
-								// Если произошла ошибка дешифровки
-								if((flush != Z_OK) && (flush != Z_STREAM_END)){
-									// Выполняем сброс фрейма
-									if(inflateReset(&zs) != Z_OK) fprintf(stderr, "inflateReset failed: %d\n", flush);
-									// Пропускаем блок
-									continue;
-								}
-								// Получаем количество оставшихся байт
-								nbytes = (CHUNKSIZE - zs.avail_out);
-								// Добавляем оставшиеся данные в список
-								result.insert(result.end(), outbuff, outbuff + nbytes);
-							// Если все данные уже дешифрованы
-							} while(zs.avail_out == 0);
-							// Увеличиваем смещение в буфере
-							offset += avail;
-						// Если дешифрование не закончено
-						} while(flush != Z_STREAM_END);
-						// Закрываем поток
-						inflateEnd(&zs);
+					// Если контейнер старого формата, расжимаем запись одним потоком gzip
+					if(!this->blocks) return this->inflateStream(buffer, size);
+					// Количество блоков
+					u_int count = 0;
+					// Если заголовок записи не помещается в буфер, выходим
+					if(size < sizeof(count)) return result;
+					// Извлекаем количество блоков
+					memcpy(&count, buffer, sizeof(count));
+					// Если запись состоит из одного блока, таблицы блоков нет
+					if((count & SINGLE) != 0){
+						// Получаем размер блока до сжатия
+						const u_int bytes = (count & ~SINGLE);
+						// Если размер блока повреждён, выходим
+						if((bytes == 0) || (bytes > BLOCKSIZE)) return result;
+						// Выделяем память под результат
+						result.resize(bytes);
+						// Расжимаем блок, при ошибке очищаем результат
+						if(!this->unpack(buffer + sizeof(count), size - sizeof(count), result.data(), bytes)) result.clear();
+						// Выводим результат
+						return result;
+					}
+					// Смещение сжатых данных
+					size_t offset = (sizeof(count) + (size_t(count) * sizeof(u_int) * 2));
+					// Если размеры блоков не помещаются в буфер, выходим
+					if((count == 0) || (offset > size)) return result;
+					// Размеры блоков до и после сжатия
+					vector <u_int> sizes(size_t(count) * 2);
+					// Извлекаем размеры блоков
+					memcpy(sizes.data(), buffer + sizeof(count), sizes.size() * sizeof(u_int));
+					// Общий размер расжатых данных и сжатых данных
+					size_t total = 0, bytes = offset;
+					// Считаем общие размеры
+					for(u_int i = 0; i < count; i++){
+						// Увеличиваем размер расжатых данных
+						total += sizes[i * 2];
+						// Увеличиваем размер сжатых данных
+						bytes += sizes[i * 2 + 1];
+					}
+					// Если запись повреждена, выходим
+					if(bytes != size) return result;
+					// Выделяем память под результат один раз, размеры блоков известны заранее
+					result.resize(total);
+					// Позиция в расжатых данных
+					size_t pos = 0;
+					// Записи уже расжимаются параллельно при чтении словаря, поэтому блоки одной записи расжимаем по порядку
+					for(u_int i = 0; i < count; i++){
+						// Расжимаем блок
+						if(!this->unpack(buffer + offset, sizes[i * 2 + 1], result.data() + pos, sizes[i * 2])){
+							// Очищаем результат
+							result.clear();
+							// Выходим
+							break;
+						}
+						// Смещаем позицию в расжатых данных
+						pos += sizes[i * 2];
+						// Смещаем позицию в сжатых данных
+						offset += sizes[i * 2 + 1];
 					}
 				}
 				// Выводим результат
@@ -961,41 +1435,66 @@ namespace anyks {
 				if(!filename.empty() && this->isFile(filename)){
 					// Закрываем прежние открытые файлы
 					this->close();
+					// Освобождаем прежние отображённые данные
+					this->unmap();
 					// Открываем файл на чтение
-					this->ifs.open(filename.c_str(), ios::binary);
+					const int fd = ::open(filename.c_str(), O_RDONLY);
 					// Если файл открыт
-					if(this->ifs.is_open()){
-						// Количество записей в файле
-						size_t count = 0;
-						// Устанавливаем позицию чтения
-						this->ifs.seekg(this->address, this->ifs.beg);
-						// Считываем количество записей в файле
-						this->ifs.read((char *) &count, sizeof(count));
-						// Смещаем позицию в файле
-						result = sizeof(count);
-						// Если количество записей больше 0
-						if(count > 0){
-							// Ключ и значение
-							size_t key = 0, val = 0;
-							// Загружаем полученное количество данных
-							for(size_t i = 0; i < count; i++){
-								// Сбрасываем ключ и значение
-								key = 0;
-								val = 0;
-								// Считываем ключ записи
-								this->ifs.read((char *) &key, sizeof(key));
-								// Считываем позицию записи
-								this->ifs.read((char *) &val, sizeof(val));
-								// Смещаем позицию в файле
-								result += (sizeof(size_t) * 2);
-								// Если значение получено, заполняем заголовки ключей
-								if(key > 0) this->keys.insert({key, val});
+					if(fd > -1){
+						// Параметры файла
+						struct stat info;
+						// Если размер файла получен и файл не пустой
+						if((fstat(fd, &info) == 0) && (info.st_size > 0)){
+							// Отображаем файл в память, ключи и записи читаются по требованию
+							void * data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+							// Если файл отображён
+							if(data != MAP_FAILED){
+								// Запоминаем данные
+								this->mapped = reinterpret_cast <const char *> (data);
+								// Запоминаем размер данных
+								this->mapsize = info.st_size;
 							}
 						}
-						// Закрываем файл
-						this->close();
-						// Запоминаем смещение в файле
-						this->address += result;
+						// Дескриптор файла больше не нужен
+						::close(fd);
+					}
+					// Если файл отображён и заголовок помещается в данные
+					if((this->mapped != nullptr) && (this->mapsize >= (strlen(HEADERB) + sizeof(u_char) + sizeof(size_t)))){
+						// Определяем шифруются ли записи AES-CTR
+						this->counter = (strncmp(this->mapped, HEADERC, strlen(HEADERC)) == 0);
+						// Если записи сжаты блоками, в заголовке указан алгоритм сжатия
+						if((this->blocks = (this->counter || (strncmp(this->mapped, HEADERB, strlen(HEADERB)) == 0)))){
+							// Алгоритм сжатия
+							const u_char codec = this->mapped[strlen(HEADERB)];
+							// Запоминаем алгоритм сжатия
+							this->codec = codec_t(codec);
+							// Запоминаем позицию количества ключей
+							this->address = (strlen(HEADERB) + sizeof(codec));
+							// Если алгоритм сжатия не поддерживается сборкой
+							if(!isCodec(this->codec)){
+								// Выводим сообщение об ошибке
+								printf("Codec is not supported: %u\r\n", codec);
+								// Освобождаем отображённые данные, записи контейнера всё равно не расжать
+								this->unmap();
+								// Выходим, контейнер не прочитан
+								return result;
+							}
+						// Иначе записи сжаты одним потоком gzip
+						} else this->address = strlen(HEADER);
+						// Считываем количество ключей в индексе
+						memcpy(&this->indexCount, this->mapped + this->address, sizeof(this->indexCount));
+						// Запоминаем позицию индекса ключей, индекс имеет фиксированную ширину записи
+						this->index = (this->address + sizeof(this->indexCount));
+						// Размер индекса ключей
+						result = (sizeof(this->indexCount) + (this->indexCount * sizeof(size_t) * 2));
+						// Если индекс не помещается в данные, контейнер повреждён
+						if((this->indexCount > ((this->mapsize - this->index) / (sizeof(size_t) * 2)))){
+							// Освобождаем отображённые данные
+							this->unmap();
+							// Сбрасываем результат
+							result = 0;
+						// Запоминаем позицию начала записей
+						} else this->address += result;
 					}
 				}
 				// Выводим результат
@@ -1008,12 +1507,18 @@ namespace anyks {
 			const uintmax_t write() noexcept {
 				// Результат работы функции
 				uintmax_t result = 0;
+				// Все записи установлены, останавливаем потоки сжатия
+				this->tpool.wait();
 				// Адрес файла для открытия
 				const string & raw = (this->filename() + ".raw");
 				// Если адрес файла получен
 				if(!raw.empty() && this->isFile(raw)){
-					// Закрываем прежние открытые файлы
+					// Закрываем прежние открытые файлы, сырые данные сбрасываются из буфера один раз
 					this->close();
+					// Освобождаем отображённые данные, файл будет перезаписан
+					this->unmap();
+					// Устанавливаем буфер записи
+					this->buffering();
 					// Открываем файл на запись
 					this->ofs.open(this->filename().c_str(), ios::binary);
 					// Если файл открыт
@@ -1022,14 +1527,18 @@ namespace anyks {
 						size_t key = 0, val = 0;
 						// Получаем количество записей
 						const size_t count = this->keys.size();
+						// Получаем алгоритм сжатия записей
+						const u_char codec = u_char(this->codec);
 						// Получаем бинарные данные количества ключей
 						const char * bin = reinterpret_cast <const char *> (&count);
-						// Выполняем запись в файл заголовка
-						this->ofs.write(header, strlen(HEADER));
+						// Выполняем запись в файл заголовка, записи всегда шифруются AES-CTR
+						this->ofs.write(HEADERC, strlen(HEADERC));
+						// Выполняем запись в файл алгоритма сжатия
+						this->ofs.write((const char *) &codec, sizeof(codec));
 						// Выполняем запись в файл количество ключей
 						this->ofs.write(bin, sizeof(count));
 						// Запоминаем количество записанных данных
-						result = (strlen(HEADER) + sizeof(count));
+						result = (strlen(HEADERC) + sizeof(codec) + sizeof(count));
 						// Переходим по всему количеству ключей
 						for(auto it = this->keys.cbegin(); it != this->keys.cend(); ++it){
 							// Получаем ключ
@@ -1044,8 +1553,6 @@ namespace anyks {
 							this->ofs.write(binKey, sizeof(key));
 							// Выполняем запись в файл бинарные данные значения
 							this->ofs.write(binVal, sizeof(val));
-							// Выполняем сброс данных в файл
-							this->ofs.flush();
 							// Запоминаем количество записанных данных
 							result += (sizeof(key) + sizeof(val));
 						}
@@ -1059,16 +1566,12 @@ namespace anyks {
 							char bytes[CHUNKSIZE];
 							// Считываем до тех пор пока все удачно
 							while(file.good()){
-								// Зануляем буфер данных
-								memset(bytes, 0, CHUNKSIZE);
 								// Выполняем чтение данных в буфер
 								file.read(bytes, CHUNKSIZE);
 								// Получаем количество прочитанных данных
 								size = file.gcount();
 								// Выполняем запись в файл
 								this->ofs.write(bytes, size);
-								// Выполняем сброс данных в файл
-								this->ofs.flush();
 								// Запоминаем количество записанных данных
 								result += size;
 							}
@@ -1077,8 +1580,10 @@ namespace anyks {
 							// Удаляем временный файл с сырыми данными
 							remove(raw.c_str());
 						}
-						// Закрываем файл
+						// Закрываем файл, данные сбрасываются из буфера один раз
 						this->close();
+						// Сбрасываем данные словаря на диск
+						this->sync(this->filename());
 						// Очищаем объект
 						this->clear();
 					}
@@ -1132,10 +1637,8 @@ namespace anyks {
 						if(!this->ofs.is_open()) this->open(method_t::write, true);
 						// Если нужно зашифровать данные
 						if(encrypt){
-							// Получаем буфер данных
-							const char * buffer = value.data();
 							// Получаем md5 хэш
-							const string & md5 = this->md5(vector <char> (buffer, buffer + value.size()));
+							const string & md5 = this->md5(value.data(), value.size());
 							// Выполняем шифрование данных
 							auto res = this->encrypt(value.data(), value.size());
 							// Если данные зашифрованы
@@ -1160,40 +1663,8 @@ namespace anyks {
 			 * @return        результат операции (количество записанных байт)
 			 */
 			const uintmax_t set(const string & key, const vector <char> & value, const bool encrypt = false) noexcept {
-				// Результат работы функции
-				uintmax_t result = 0;
-				// Если ключ передан
-				if(!key.empty() && !value.empty()){
-					// Получаем идентификатор ключа
-					const size_t idw = this->idw(key);
-					// Если текущая запись не найдена
-					if(this->keys.count(idw) < 1){
-						// Получаем md5 хэш
-						const string & md5 = this->md5(value);
-						// Открываем файл на запись
-						if(!this->ofs.is_open()) this->open(method_t::write, true);
-						// Если нужно зашифровать данные
-						if(encrypt){
-							// Выполняем шифрование данных
-							auto res = this->encrypt(value.data(), value.size());
-							// Если данные зашифрованы
-							if(!res.empty()){
-								// Сжимаем данные перед записью
-								auto data = this->compress(res.data(), res.size());
-								// Выполняем установку данных в файл
-								result = setdat(idw, this->rawpos, this->keys, this->ofs, data, md5);
-							}
-						// Если шифровать данные не надо
-						} else {
-							// Сжимаем данные перед записью
-							auto res = this->compress(value.data(), value.size());
-							// Выполняем установку данных в файл
-							result = setdat(idw, this->rawpos, this->keys, this->ofs, res, md5);
-						}
-					}
-				}
-				// Выводим результат
-				return result;
+				// Выполняем установку данных без копирования буфера
+				return this->set(key, value.data(), value.size(), encrypt);
 			}
 			/**
 			 * set Метод установки бинарных данных
@@ -1212,28 +1683,91 @@ namespace anyks {
 					const size_t idw = this->idw(key);
 					// Если текущая запись не найдена
 					if(this->keys.count(idw) < 1){
-						// Получаем md5 хэш
-						const string & md5 = this->md5(vector <char> (buffer, buffer + size));
+						// Сжатые данные для записи
+						vector <char> data;
+						// Если запись большая и потоков несколько, хэш md5 считаем параллельно со сжатием
+						auto md5 = std::async(((this->threads > 1) && (size >= BLOCKSIZE) ? std::launch::async : std::launch::deferred), [this, buffer, size]{
+							// Получаем md5 хэш
+							return this->md5(buffer, size);
+						});
 						// Открываем файл на запись
 						if(!this->ofs.is_open()) this->open(method_t::write, true);
 						// Если нужно зашифровать данные
 						if(encrypt){
 							// Выполняем шифрование данных
 							auto res = this->encrypt(buffer, size);
-							// Если данные зашифрованны
-							if(!res.empty()){
-								// Сжимаем данные перед записью
-								auto data = this->compress(res.data(), res.size());
-								// Выполняем установку данных в файл
-								result = setdat(idw, this->rawpos, this->keys, this->ofs, data, md5);
-							}
-						// Если шифровать данные не надо
-						} else {
-							// Сжимаем данные перед записью
-							auto res = this->compress(buffer, size);
-							// Выполняем установку данных в файл
-							result = setdat(idw, this->rawpos, this->keys, this->ofs, res, md5);
+							// Если данные зашифрованны, сжимаем их перед записью
+							if(!res.empty()) data = this->compress(res.data(), res.size());
+						// Если шифровать данные не надо, сжимаем их перед записью
+						} else data = this->compress(buffer, size);
+						// Получаем md5 хэш
+						const string & hash = md5.get();
+						// Выполняем установку данных в файл
+						if(!data.empty()) result = setdat(idw, this->rawpos, this->keys, this->ofs, data, hash);
+					}
+				}
+				// Выводим результат
+				return result;
+			}
+			/**
+			 * sets Метод установки группы бинарных записей с ключами по порядку номеров
+			 * @param prefix  префикс ключей записей
+			 * @param first   номер первой записи группы
+			 * @param buffers список буферов записей
+			 * @param encrypt зашифровать данные
+			 * @return        результат операции (количество записанных байт)
+			 */
+			const uintmax_t sets(const string & prefix, const size_t first, const vector <vector <char>> & buffers, const bool encrypt = false) noexcept {
+				// Результат работы функции
+				uintmax_t result = 0;
+				// Если записи переданы
+				if(!prefix.empty() && !buffers.empty()){
+					// Хэши md5 записей
+					vector <string> hashes(buffers.size());
+					// Сжатые данные записей
+					vector <vector <char>> data(buffers.size());
+					/**
+					 * packFn Функция шифрования и сжатия группы записей
+					 * @param begin первая запись группы
+					 * @param end   конец группы записей
+					 */
+					auto packFn = [&](const size_t begin, const size_t end) noexcept {
+						// Переходим по всем записям группы
+						for(size_t i = begin; i < end; i++){
+							// Получаем буфер записи
+							const vector <char> & buffer = buffers[i];
+							// Если буфер пустой, пропускаем запись
+							if(buffer.empty()) continue;
+							// Получаем md5 хэш
+							hashes[i] = this->md5(buffer.data(), buffer.size());
+							// Если нужно зашифровать данные
+							if(encrypt){
+								// Выполняем шифрование данных, записи и так обрабатываются параллельно
+								auto res = this->encrypt(buffer.data(), buffer.size(), false);
+								// Если данные зашифрованны, сжимаем их перед записью
+								if(!res.empty()) data[i] = this->compress(res.data(), res.size(), false);
+							// Если шифровать данные не надо, сжимаем их перед записью
+							} else data[i] = this->compress(buffer.data(), buffer.size(), false);
 						}
+					};
+					// Если потоков несколько, шифруем и сжимаем записи целиком параллельно
+					if((this->threads > 1) && (buffers.size() > 1)){
+						// Запускаем потоки тредпула, если они ещё не запущены, останавливаются они при записи контейнера
+						this->tpool.init(this->threads);
+						// Шифруем и сжимаем записи
+						this->tpool.parallel_for(0, buffers.size(), packFn, 1);
+					// Иначе обрабатываем записи в текущем потоке
+					} else packFn(0, buffers.size());
+					// Открываем файл на запись
+					if(!this->ofs.is_open()) this->open(method_t::write, true);
+					// Записываем записи в файл по порядку номеров
+					for(size_t i = 0; i < buffers.size(); i++){
+						// Если запись не сжата, пропускаем её
+						if(data[i].empty()) continue;
+						// Получаем идентификатор ключа
+						const size_t idw = this->idw(prefix + to_string(first + i));
+						// Если текущая запись не найдена, выполняем установку данных в файл
+						if(this->keys.count(idw) < 1) result += setdat(idw, this->rawpos, this->keys, this->ofs, data[i], hashes[i]);
 					}
 				}
 				// Выводим результат
@@ -1303,19 +1837,10 @@ namespace anyks {
 				uintmax_t result = 0;
 				// Если ключ передан
 				if(!key.empty()){
-					// Получаем идентификатор ключа
-					const size_t idw = this->idw(key);
-					// Если текущая запись найдена
-					if(this->keys.count(idw) > 0){
-						// Получаем позицию записи
-						const size_t pos = this->keys.at(idw);
-						// Открываем файл на чтение
-						this->open(method_t::read);
-						// Выполняем чтение данных из файла
-						result = getval(this->address + pos, this->ifs, value);
-						// Закрываем файл
-						this->close();
-					}
+					// Позиция записи
+					size_t pos = 0;
+					// Если текущая запись найдена, выполняем чтение данных
+					if(this->find(this->idw(key), pos)) result = getval(pos, this->mapped, this->mapsize, value);
 				}
 				// Выводим результат
 				return result;
@@ -1332,18 +1857,14 @@ namespace anyks {
 				uintmax_t result = 0;
 				// Если ключ передан
 				if(!key.empty()){
-					// Получаем идентификатор ключа
-					const size_t idw = this->idw(key);
+					// Позиция записи
+					size_t pos = 0;
 					// Если текущая запись найдена
-					if(this->keys.count(idw) > 0){
+					if(this->find(this->idw(key), pos)){
 						// Хэш md5 если существует
 						string md5 = "";
-						// Получаем позицию записи
-						const size_t pos = this->keys.at(idw);
-						// Открываем файл на чтение
-						this->open(method_t::read);
-						// Выполняем чтение данных из файла
-						result = getdat(this->address + pos, this->ifs, value, md5);
+						// Выполняем чтение данных
+						result = getdat(pos, this->mapped, this->mapsize, value, md5);
 						// Если нужно дешифровать данные
 						if(decrypt){
 							// Выполняем декомпрессию данных
@@ -1363,43 +1884,39 @@ namespace anyks {
 								}
 							}
 						}
-						// Закрываем файл
-						this->close();
 					}
 				}
 				// Выводим результат
 				return result;
 			}
 			/**
-			 * get Метод извлечения бинарных данных
+			 * get Метод извлечения бинарных данных (потокобезопасен, записи можно извлекать параллельно)
 			 * @param key     ключ записи
 			 * @param value   полученное значение ключа
 			 * @param decrypt расшифровать данные
 			 * @return        результат операции (количество прочитанных байт)
 			 */
-			const uintmax_t get(const string & key, vector <char> & value, const bool decrypt = false) noexcept {
+			const uintmax_t get(const string & key, vector <char> & value, const bool decrypt = false) const noexcept {
 				// Результат работы функции
 				uintmax_t result = 0;
 				// Если ключ передан
 				if(!key.empty()){
-					// Получаем идентификатор ключа
-					const size_t idw = this->idw(key);
+					// Позиция записи
+					size_t pos = 0;
 					// Если текущая запись найдена
-					if(this->keys.count(idw) > 0){
+					if(this->find(this->idw(key), pos)){
 						// Хэш md5 если существует
 						string md5 = "";
-						// Данные для извлечения
-						std::vector <char> buffer;
-						// Получаем позицию записи
-						const size_t pos = this->keys.at(idw);
-						// Открываем файл на чтение
-						this->open(method_t::read);
-						// Выполняем чтение данных из файла
-						result = getdat(this->address + pos, this->ifs, buffer, md5);
-						// Если буфер не пустой
-						if(!buffer.empty()){
+						// Размер данных записи
+						size_t length = 0;
+						// Указатель на данные записи
+						const char * buffer = nullptr;
+						// Получаем данные записи, данные отображены в память и не копируются
+						result = getref(pos, this->mapped, this->mapsize, buffer, length, md5);
+						// Если данные записи получены
+						if(length > 0){
 							// Выполняем декомпрессию данных
-							auto data = this->decompress(buffer.data(), buffer.size());
+							auto data = this->decompress(buffer, length);
 							// Если декомпрессия получилсь
 							if(!data.empty()){
 								// Если нужно дешифровать данные
@@ -1426,8 +1943,6 @@ namespace anyks {
 								}
 							}
 						}
-						// Закрываем файл
-						this->close();
 					}
 				}
 				// Выводим результат
@@ -1446,19 +1961,10 @@ namespace anyks {
 				uintmax_t result = 0;
 				// Если ключ передан
 				if(!key.empty()){
-					// Получаем идентификатор ключа
-					const size_t idw = this->idw(key);
-					// Если текущая запись найдена
-					if(this->keys.count(idw) > 0){
-						// Получаем позицию записи
-						const size_t pos = this->keys.at(idw);
-						// Открываем файл на чтение
-						this->open(method_t::read);
-						// Выполняем чтение данных из файла
-						result = getvals(this->address + pos, this->ifs, value);
-						// Закрываем файл
-						this->close();
-					}
+					// Позиция записи
+					size_t pos = 0;
+					// Если текущая запись найдена, выполняем чтение данных
+					if(this->find(this->idw(key), pos)) result = getvals(pos, this->mapped, this->mapsize, value);
 				}
 				// Выводим результат
 				return result;
@@ -1475,19 +1981,10 @@ namespace anyks {
 				uintmax_t result = 0;
 				// Если ключ передан
 				if(!key.empty()){
-					// Получаем идентификатор ключа
-					const size_t idw = this->idw(key);
-					// Если текущая запись найдена
-					if(this->keys.count(idw) > 0){
-						// Получаем позицию записи
-						const size_t pos = this->keys.at(idw);
-						// Открываем файл на чтение
-						this->open(method_t::read);
-						// Выполняем чтение данных из файла
-						result = getstrs(this->address + pos, this->ifs, value);
-						// Закрываем файл
-						this->close();
-					}
+					// Позиция записи
+					size_t pos = 0;
+					// Если текущая запись найдена, выполняем чтение данных
+					if(this->find(this->idw(key), pos)) result = getstrs(pos, this->mapped, this->mapsize, value);
 				}
 				// Выводим результат
 				return result;
@@ -1499,10 +1996,16 @@ namespace anyks {
 			void clear() noexcept {
 				// Закрываем открытый файл
 				this->close();
+				// Освобождаем отображённые данные
+				this->unmap();
 				// Очищаем позицию raw данных
 				this->rawpos = 0;
 				// Очищаем список ключей
 				this->keys.clear();
+				// Новые записи сжимаются блоками
+				this->blocks = true;
+				// Новые записи шифруются AES-CTR
+				this->counter = true;
 				// Смещаем указатель начала данных
 				this->address = strlen(HEADER);
 			}
@@ -1513,6 +2016,72 @@ namespace anyks {
 			void setAES(types_t aeslen) noexcept {
 				// Устанавливаем размер шифрования
 				this->aeslen = aeslen;
+				// Обновляем ключ шифрования
+				this->initCTR();
+			}
+			/**
+			 * best Метод получения лучшего из доступных алгоритмов сжатия
+			 * @return алгоритм сжатия
+			 */
+			static constexpr codec_t best() noexcept {
+#if defined(USE_ZSTD)
+				// Выводим zstd
+				return codec_t::zstd;
+#elif defined(USE_LZ4)
+				// Выводим lz4
+				return codec_t::lz4;
+#else
+				// Выводим gzip
+				return codec_t::gzip;
+#endif
+			}
+			/**
+			 * isCodec Метод проверки поддержки алгоритма сжатия
+			 * @param codec алгоритм сжатия для проверки
+			 * @return      результат проверки
+			 */
+			static const bool isCodec(const codec_t codec) noexcept {
+				// Определяем алгоритм сжатия
+				switch((u_short) codec){
+					// Если это gzip, он доступен всегда
+					case (u_short) codec_t::gzip: return true;
+					// Если это lz4
+					case (u_short) codec_t::lz4:
+#ifdef USE_LZ4
+						// Сообщаем что алгоритм доступен
+						return true;
+#else
+						// Сообщаем что алгоритм не доступен
+						return false;
+#endif
+					// Если это zstd
+					case (u_short) codec_t::zstd:
+#ifdef USE_ZSTD
+						// Сообщаем что алгоритм доступен
+						return true;
+#else
+						// Сообщаем что алгоритм не доступен
+						return false;
+#endif
+				}
+				// Выводим результат
+				return false;
+			}
+			/**
+			 * setCodec Метод установки алгоритма сжатия записей
+			 * @param codec алгоритм сжатия (если не поддерживается сборкой, используется gzip)
+			 */
+			void setCodec(const codec_t codec) noexcept {
+				// Устанавливаем алгоритм сжатия
+				this->codec = (isCodec(codec) ? codec : codec_t::gzip);
+			}
+			/**
+			 * setThreads Метод установки количества потоков сжатия
+			 * @param threads количество потоков для работы
+			 */
+			void setThreads(const size_t threads = 0) noexcept {
+				// Устанавливаем новое количество потоков
+				this->threads = (threads > 0 ? threads : std::thread::hardware_concurrency());
 			}
 			/**
 			 * setRoundAES Метод установки количества раундов шифрования
@@ -1521,6 +2090,8 @@ namespace anyks {
 			void setRoundAES(const int round) noexcept {
 				// Устанавливаем количество раундов шифрования
 				this->roundsAES = round;
+				// Обновляем ключ шифрования
+				this->initCTR();
 			}
 			/**
 			 * setSalt Метод установки соли шифрования
@@ -1529,6 +2100,8 @@ namespace anyks {
 			void setSalt(const string & salt) noexcept {
 				// Если соль передана
 				if(!salt.empty()) this->salt = move(salt);
+				// Обновляем ключ шифрования
+				this->initCTR();
 			}
 			/**
 			 * setPassword Метод установки пароля шифрования
@@ -1537,6 +2110,8 @@ namespace anyks {
 			void setPassword(const string & password) noexcept {
 				// Если пароль передан
 				if(!password.empty()) this->password = move(password);
+				// Обновляем ключ шифрования
+				this->initCTR();
 			}
 			/**
 			 * setFilename Метод установки имени файла базы
@@ -1633,6 +2208,8 @@ namespace anyks {
 			~ASpl() noexcept {
 				// Очищаем все данные
 				this->clear();
+				// Очищаем ключ шифрования
+				OPENSSL_cleanse(this->keyCTR, sizeof(this->keyCTR));
 			}
 	} aspl_t;
 };
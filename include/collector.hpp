@@ -19,6 +19,7 @@
 #include <atomic>
 #include <vector>
 #include <functional>
+#include <string_view>
 /**
  * Наши модули
  */
@@ -34,6 +35,29 @@ namespace anyks {
 	 * Collector Класс для с общучением в многопоточном режиме
 	 */
 	typedef class Collector {
+		private:
+			/**
+			 * Shard Структура шарда n-грамм
+			 */
+			typedef struct Shard {
+				// Мютекс для блокировки шарда
+				std::mutex locker;
+				// Словарь n-грамм шарда
+				arpa_t arpa;
+			} shard_t;
+			/**
+			 * Part Структура слов блока документа, разбитого между потоками
+			 */
+			typedef struct Part {
+				// Количество документов и слов блока
+				size_t ad, cw;
+				// Слова блока
+				std::map <size_t, word_t> words;
+				/**
+				 * Part Конструктор
+				 */
+				Part() : ad(0), cw(0) {}
+			} part_t;
 		private:
 			// Прогресс бар
 			progress_t pss;
@@ -67,6 +91,8 @@ namespace anyks {
 			size_t threads = std::thread::hardware_concurrency();
 			// Функция прогресс бара
 			std::function <void (const wstring &, const u_short)> progressFn = nullptr;
+			// Шарды n-грамм, разбитые по первому слову
+			vector <shard_t> shards;
 		private:
 			// Создаем тредпул
 			tpool_t * tpool = nullptr;
@@ -92,6 +118,23 @@ namespace anyks {
 			 * finish Метод завершения работы тредпула
 			 */
 			void finish();
+			/**
+			 * merge Метод слияния собранных данных с основным словарём
+			 * @param toolkit тулкит с собранными данными
+			 * @param idd     идентификатор документа
+			 */
+			void merge(const toolkit_t & toolkit, const size_t idd) noexcept;
+			/**
+			 * merge Метод слияния слов блоков одного документа с основным словарём
+			 * @param parts слова блоков документа в порядке следования блоков
+			 */
+			void merge(const vector <part_t> & parts) noexcept;
+			/**
+			 * shard Метод переноса n-грамм собранных данных в шарды
+			 * @param toolkit тулкит с собранными данными
+			 * @param idd     идентификатор документа
+			 */
+			void shard(const toolkit_t & toolkit, const size_t idd) noexcept;
 			/**
 			 * dumpRaw Метод дампа промежуточных данных
 			 */
@@ -111,6 +154,11 @@ namespace anyks {
 			 * @return     размер сегмента в байтах
 			 */
 			const long getSize(const string & str) const noexcept;
+			/**
+			 * prepare Метод подготовки тулкита потока по параметрам основного тулкита
+			 * @param toolkit тулкит для подготовки
+			 */
+			void prepare(toolkit_t & toolkit) const noexcept;
 			/**
 			 * train Обучения полученного текста
 			 * @param filename файл для чтения
@@ -118,11 +166,19 @@ namespace anyks {
 			 */
 			void train(const string & filename, const size_t idd) noexcept;
 			/**
-			 * train Обучения полученного текста
-			 * @param texts список строк текста для обучения
-			 * @param idd   идентификатор документа
+			 * learn Метод обучения блока текста в текущем потоке
+			 * @param text блок текста для обучения (строки разделены переносом строки)
+			 * @param idd  идентификатор документа
+			 * @param part слова блока, если документ разбит на блоки (иначе слова сливаются с основным словарём)
+			 */
+			void learn(const std::string_view & text, const size_t idd, part_t * part = nullptr) noexcept;
+			/**
+			 * cut Метод разбивки текста на сегменты по накопленной длине строк
+			 * @param text     текст для разбивки
+			 * @param size     накопленная длина строк текущего сегмента (переходит между файлами)
+			 * @param callback функция обратного вызова (позиция начала строки, с которой начинается новый сегмент)
 			 */
-			void train(const vector <string> & texts, const size_t idd) noexcept;
+			void cut(const std::string_view & text, uintmax_t & size, function <void (const size_t)> callback) const noexcept;
 		public:
 			/**
 			 * allowPython Метод разрешения использования объекта Python
@@ -13,11 +13,14 @@
  * Стандартная библиотека
  */
 #include <string>
+#include <vector>
+#include <cstring>
 #include <fstream>
 #include <codecvt>
 #include <sstream>
 #include <unistd.h>
 #include <functional>
+#include <zlib.h>
 #include <pwd.h>
 #include <grp.h>
 #include <cstdlib>
@@ -28,6 +31,7 @@
 #include <sys/types.h>
 
 #include <filesystem>
+#include <string_view>
 
 #include <limits>
 
@@ -618,6 +622,219 @@ namespace anyks {
 				} else std::cerr << "error: the file name: \"" << filename << "\" is not found" << endl;
 			}
 		}
+		/**
+		 * split Функция разбивки буфера на блоки, выровненные по переносу строки
+		 * @param data   буфер для разбивки
+		 * @param offset начало разбиваемой части буфера
+		 * @param length размер буфера
+		 * @param size   ориентировочный размер одного блока (0 - одним блоком)
+		 * @param chunks список полученных блоков
+		 */
+		static void split(const char * data, const uintmax_t offset, const uintmax_t length, const uintmax_t size, std::vector <std::string_view> & chunks) noexcept {
+			// Переходим по всему буферу
+			for(uintmax_t first = offset, end = 0; first < length; first = end){
+				// Определяем предварительный конец блока
+				end = ((size > 0) && ((length - first) > size) ? (first + size) : length);
+				// Если блок обрывается посреди строки
+				if(end < length){
+					// Выполняем поиск ближайшего переноса строки
+					const char * pos = reinterpret_cast <const char *> (memchr(data + end, '\n', length - end));
+					// Расширяем блок до конца строки
+					end = (pos != nullptr ? (pos - data) + 1 : length);
+				}
+				// Добавляем полученный блок
+				chunks.emplace_back(data + first, end - first);
+			}
+		}
+		/**
+		 * gunzip Функция распаковки данных в формате gzip (поддерживаются склеенные потоки gzip)
+		 * @param data   буфер сжатых данных
+		 * @param size   размер сжатых данных
+		 * @param result распакованные данные
+		 * @return       результат распаковки
+		 */
+		static const bool gunzip(const char * data, const uintmax_t size, std::string & result) noexcept {
+			// Результат работы функции
+			int status = Z_OK;
+			// Буфер распакованного блока
+			std::vector <char> buffer(0x100000);
+			// Создаём поток zlib
+			z_stream zs;
+			// Заполняем его нулями
+			memset(&zs, 0, sizeof(zs));
+			// Если поток инициализировать не удалось, выходим (16 - разбирать заголовок gzip)
+			if(inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) return false;
+			// Очищаем результат
+			result.clear();
+			// Указываем данные для распаковки
+			zs.next_in = (Bytef *) data;
+			// Указываем размер данных, размер ограничен типом uInt, поэтому подаём данные частями
+			zs.avail_in = uInt(std::min(size, uintmax_t(0x40000000)));
+			// Выполняем распаковку
+			do {
+				// Указываем буфер для распакованных данных
+				zs.next_out = (Bytef *) buffer.data();
+				// Указываем размер буфера
+				zs.avail_out = buffer.size();
+				// Выполняем распаковку
+				status = inflate(&zs, Z_NO_FLUSH);
+				// Добавляем распакованные данные в результат
+				result.append(buffer.data(), buffer.size() - zs.avail_out);
+				// Если входные данные закончились, подаём следующую часть
+				if((zs.avail_in == 0) && (zs.total_in < size)) zs.avail_in = uInt(std::min(size - zs.total_in, uintmax_t(0x40000000)));
+				// Если поток gzip закончился, а данные ещё есть, значит далее следующий поток gzip
+				if((status == Z_STREAM_END) && (zs.avail_in > 0)){
+					// Запоминаем позицию следующего потока
+					const uLong total = zs.total_in;
+					// Сбрасываем поток zlib
+					status = inflateReset(&zs);
+					// Восстанавливаем счётчик прочитанных данных, inflateReset его обнуляет
+					zs.total_in = total;
+				}
+			} while(status == Z_OK);
+			// Закрываем поток
+			inflateEnd(&zs);
+			// Выводим результат
+			return (status == Z_STREAM_END);
+		}
+		/**
+		 * rchunks Функция отображения файла в памяти и разбивки его на блоки, выровненные по переносу строки
+		 * @param filename адрес файла для чтения
+		 * @param size     ориентировочный размер одного блока (0 - весь файл одним блоком)
+		 * @param callback функция обратного вызова (блоки действительны только внутри вызова)
+		 *
+		 * Файлы в формате gzip определяются по сигнатуре и распаковываются в памяти.
+		 */
+		static void rchunks(const string & filename, const uintmax_t size
+			, std::function <void (const std::vector <std::string_view> &, const uintmax_t)> callback
+		) noexcept {
+			// Если адрес файла передан
+			if(!filename.empty()){
+				// Если файл существует
+				if(isfile(filename)){
+					// Файловый дескриптор файла
+					int fd = -1;
+					// Структура статистики файла
+					struct stat info;
+					// Если файл не открыт
+					if((fd = open(filename.c_str(), O_RDONLY)) < 0)
+						// Выводим сообщение об ошибке
+						std::cerr << "error: the file name: \"" << filename << "\" is broken" << endl;
+					// Если файл открыт удачно
+					else if(fstat(fd, &info) < 0)
+						// Выводим сообщение об ошибке
+						std::cerr << "error: the file name: \"" << filename << "\" is unknown size" << endl;
+					// Если файл не пустой
+					else if(info.st_size > 0) {
+						// Буфер входящих данных
+						void * buffer = nullptr;
+						// Получаем размер файла
+						const uintmax_t length = info.st_size;
+						// Выполняем отображение файла в памяти
+						if((buffer = mmap(0, length, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED)
+							// Выводим сообщение что прочитать файл не удалось
+							std::cerr << "error: the file name: \"" << filename << "\" is not read" << std::endl;
+						// Если файл прочитан удачно
+						else {
+							// Сообщаем ядру, что файл будет читаться последовательно
+							madvise(buffer, length, MADV_SEQUENTIAL);
+							// Распакованные данные файла gzip
+							std::string text;
+							// Получаем данные файла
+							const char * data = reinterpret_cast <const char *> (buffer);
+							// Если файл сжат gzip (сигнатура 1f 8b)
+							if((length > 2) && (u_char(data[0]) == 0x1F) && (u_char(data[1]) == 0x8B)){
+								// Если файл распаковать не удалось, выводим сообщение об ошибке
+								if(!gunzip(data, length, text)) std::cerr << "error: the file name: \"" << filename << "\" is not a valid gzip file" << std::endl;
+								// Если файл распакован, но пустой, выводим сообщение об ошибке
+								else if(text.empty()) std::cerr << "error: the file name: \"" << filename << "\" is empty" << std::endl;
+								// Иначе выполняем разбивку распакованных данных
+								else {
+									// Список полученных блоков
+									std::vector <std::string_view> chunks;
+									// Выполняем разбивку буфера на блоки
+									split(text.data(), 0, text.size(), size, chunks);
+									// Выводим полученные блоки
+									callback(chunks, text.size());
+								}
+							// Иначе разбиваем отображённый файл
+							} else {
+								// Список полученных блоков
+								std::vector <std::string_view> chunks;
+								// Выполняем разбивку буфера на блоки
+								split(data, 0, length, size, chunks);
+								// Выводим полученные блоки
+								callback(chunks, length);
+							}
+							// Удаляем отображение файла
+							munmap(buffer, length);
+						}
+					}
+					// Если файл открыт, закрываем его
+					if(fd > -1) close(fd);
+				// Выводим сообщение об ошибке
+				} else std::cerr << "error: the file name: \"" << filename << "\" is not found" << endl;
+			}
+		}
+		/**
+		 * rarpa Функция отображения файла arpa в памяти и разбивки секций n-грамм на блоки, выровненные по переносу строки
+		 * @param filename адрес файла для чтения
+		 * @param size     ориентировочный размер одного блока (0 - каждая секция одним блоком)
+		 * @param callback функция обратного вызова (блоки действительны только внутри вызова)
+		 *
+		 * Секции начинаются со строк \N-grams: после заголовка \data\, блоки не пересекают границы секций.
+		 */
+		static void rarpa(const string & filename, const uintmax_t size
+			, std::function <void (const std::vector <std::string_view> &, const uintmax_t)> callback
+		) noexcept {
+			// Выполняем отображение файла в памяти
+			rchunks(filename, 0, [&size, &callback](const std::vector <std::string_view> & file, const uintmax_t length) noexcept {
+				// Список полученных блоков
+				std::vector <std::string_view> chunks;
+				// Получаем данные файла
+				const std::string_view & text = file.front();
+				// Выполняем поиск заголовка
+				size_t pos = text.find("\\data\\");
+				// Переходим по всем секциям n-грамм
+				while((pos != std::string_view::npos) && ((pos = text.find("-grams:", pos)) != std::string_view::npos)){
+					// Выполняем поиск конца строки секции
+					const size_t first = text.find('\n', pos);
+					// Если конец строки не найден, выходим
+					if(first == std::string_view::npos) break;
+					// Выполняем поиск начала следующей секции
+					pos = text.find("\n\\", first);
+					// Выполняем разбивку секции на блоки
+					split(text.data(), first + 1, (pos != std::string_view::npos ? pos + 1 : text.size()), size, chunks);
+				}
+				// Выводим полученные блоки
+				callback(chunks, length);
+			});
+		}
+		/**
+		 * lines Функция перебора непустых строк блока текста без копирования
+		 * @param text     блок текста для разбивки
+		 * @param callback функция обратного вызова
+		 */
+		template <typename Func>
+		static void lines(const std::string_view & text, Func && callback) noexcept {
+			// Смещение в блоке и позиция переноса строки
+			size_t offset = 0, pos = 0;
+			// Переходим по всем строкам блока
+			while(offset < text.size()){
+				// Выполняем поиск переноса строки
+				pos = text.find('\n', offset);
+				// Если перенос строки не найден, берём остаток блока
+				if(pos == std::string_view::npos) pos = text.size();
+				// Получаем длину строки
+				size_t length = (pos - offset);
+				// Если строка завершается возвратом каретки, отбрасываем его
+				if((length > 0) && (text[offset + length - 1] == '\r')) length--;
+				// Если строка не пустая, выводим её
+				if(length > 0) callback(text.substr(offset, length));
+				// Выполняем смещение
+				offset = (pos + 1);
+			}
+		}
 // Если это clang v10 или выше
 #if defined(__ANYKS_EXPERIMENTAL__)
 		/**
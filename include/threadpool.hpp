@@ -12,14 +12,21 @@
 /**
  * Стандартная библиотека
  */
-#include <queue>
+#include <new>
 #include <mutex>
-#include <vector>
+#include <tuple>
+#include <atomic>
+#include <future>
 #include <memory>
 #include <thread>
-#include <future>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
 #include <stdexcept>
 #include <functional>
+#include <type_traits>
 #include <condition_variable>
 
 
@@ -31,48 +38,354 @@ namespace anyks {
 	 * Класс пула потоков
 	 */
 	typedef class ThreadPool {
+		private:
+			/**
+			 * Task Класс задачи, небольшие функции хранятся внутри задачи без выделения памяти
+			 */
+			typedef class Task {
+				private:
+					// Размер встроенного буфера функции
+					static constexpr size_t capacity = 112;
+				private:
+					// Операции над хранимой функцией
+					enum class op_t : uint8_t {call, move, destroy};
+				private:
+					// Встроенный буфер функции
+					alignas(std::max_align_t) unsigned char data[capacity];
+					// Обработчик операций над хранимой функцией
+					void (* manager)(const op_t, Task *, Task *) noexcept = nullptr;
+				private:
+					/**
+					 * Шаблон обработчика функции хранящейся во встроенном буфере
+					 */
+					template <class Func>
+					/**
+					 * local Метод обработки операций над функцией во встроенном буфере
+					 * @param op    операция над функцией
+					 * @param self  текущая задача
+					 * @param other задача в которую перемещается функция
+					 */
+					static void local(const op_t op, Task * self, Task * other) noexcept {
+						// Получаем хранимую функцию
+						Func * func = std::launder(reinterpret_cast <Func *> (self->data));
+						// Определяем операцию
+						switch((uint8_t) op){
+							// Если нужно вызвать функцию
+							case (uint8_t) op_t::call: (* func)(); break;
+							// Если нужно переместить функцию в другую задачу
+							case (uint8_t) op_t::move: {
+								// Перемещаем функцию в буфер другой задачи
+								new (other->data) Func(std::move(* func));
+								// Удаляем перемещённую функцию
+								func->~Func();
+							} break;
+							// Если нужно удалить функцию
+							case (uint8_t) op_t::destroy: func->~Func(); break;
+						}
+					}
+					/**
+					 * Шаблон обработчика функции хранящейся в динамической памяти
+					 */
+					template <class Func>
+					/**
+					 * remote Метод обработки операций над функцией в динамической памяти
+					 * @param op    операция над функцией
+					 * @param self  текущая задача
+					 * @param other задача в которую перемещается функция
+					 */
+					static void remote(const op_t op, Task * self, Task * other) noexcept {
+						// Получаем указатель на хранимую функцию
+						Func ** func = std::launder(reinterpret_cast <Func **> (self->data));
+						// Определяем операцию
+						switch((uint8_t) op){
+							// Если нужно вызвать функцию
+							case (uint8_t) op_t::call: (** func)(); break;
+							// Если нужно переместить функцию, переносим только указатель
+							case (uint8_t) op_t::move: new (other->data) Func * (* func); break;
+							// Если нужно удалить функцию
+							case (uint8_t) op_t::destroy: delete (* func); break;
+						}
+					}
+				public:
+					/**
+					 * reset Метод удаления хранимой функции
+					 */
+					void reset() noexcept {
+						// Если функция существует, удаляем её
+						if(this->manager != nullptr) this->manager(op_t::destroy, this, nullptr);
+						// Зануляем обработчик
+						this->manager = nullptr;
+					}
+					/**
+					 * operator () Оператор вызова хранимой функции
+					 */
+					void operator()() noexcept {
+						// Если функция существует, вызываем её
+						if(this->manager != nullptr) this->manager(op_t::call, this, nullptr);
+					}
+					/**
+					 * operator = Оператор перемещения задачи
+					 * @param task задача для перемещения
+					 * @return     текущая задача
+					 */
+					Task & operator = (Task && task) noexcept {
+						// Если это другая задача
+						if(this != &task){
+							// Удаляем текущую функцию
+							this->reset();
+							// Если у задачи есть функция
+							if(task.manager != nullptr){
+								// Перемещаем функцию
+								task.manager(op_t::move, &task, this);
+								// Запоминаем обработчик функции
+								this->manager = task.manager;
+								// Зануляем обработчик перемещённой задачи
+								task.manager = nullptr;
+							}
+						}
+						// Выводим текущую задачу
+						return (* this);
+					}
+				public:
+					/**
+					 * Task Конструктор
+					 */
+					Task() noexcept {}
+					/**
+					 * Task Конструктор перемещения
+					 * @param task задача для перемещения
+					 */
+					Task(Task && task) noexcept {
+						// Выполняем перемещение задачи
+						(* this) = std::move(task);
+					}
+					/**
+					 * Шаблон конструктора задачи из функции
+					 */
+					template <class Func, class = typename std::enable_if <!std::is_same <typename std::decay <Func>::type, Task>::value>::type>
+					/**
+					 * Task Конструктор
+					 * @param func функция задачи
+					 */
+					Task(Func && func) noexcept {
+						// Получаем тип хранимой функции
+						using func_t = typename std::decay <Func>::type;
+						// Если функция помещается во встроенный буфер
+						if constexpr ((sizeof(func_t) <= capacity) && (alignof(func_t) <= alignof(std::max_align_t)) && std::is_nothrow_move_constructible <func_t>::value){
+							// Размещаем функцию во встроенном буфере
+							new (this->data) func_t(std::forward <Func> (func));
+							// Запоминаем обработчик функции
+							this->manager = &Task::local <func_t>;
+						// Иначе размещаем функцию в динамической памяти
+						} else {
+							// Размещаем указатель на функцию во встроенном буфере
+							new (this->data) func_t * (new func_t(std::forward <Func> (func)));
+							// Запоминаем обработчик функции
+							this->manager = &Task::remote <func_t>;
+						}
+					}
+					/**
+					 * ~Task Деструктор
+					 */
+					~Task() noexcept {
+						// Удаляем хранимую функцию
+						this->reset();
+					}
+			} task_t;
+			/**
+			 * Queue Структура очереди задач одного потока, кольцевой буфер переиспользует память
+			 */
+			typedef struct Queue {
+				// Индекс первой задачи и количество задач
+				size_t head, count;
+				// Кольцевой буфер задач
+				std::vector <task_t> tasks;
+				// Мьютекс для разграничения доступа к очереди
+				mutable std::mutex mtx;
+				/**
+				 * push Метод добавления задачи в конец очереди
+				 * @param task задача для добавления
+				 */
+				void push(task_t && task) noexcept {
+					// Если кольцевой буфер заполнен, увеличиваем его
+					if(this->count == this->tasks.size()){
+						// Новый кольцевой буфер
+						std::vector <task_t> tasks(this->tasks.empty() ? 64 : (this->tasks.size() * 2));
+						// Переносим задачи в новый буфер сохраняя их порядок
+						for(size_t i = 0; i < this->count; i++) tasks[i] = std::move(this->tasks[(this->head + i) % this->tasks.size()]);
+						// Заменяем кольцевой буфер
+						this->tasks.swap(tasks);
+						// Задачи теперь начинаются с начала буфера
+						this->head = 0;
+					}
+					// Добавляем задачу в конец очереди
+					this->tasks[(this->head + this->count) % this->tasks.size()] = std::move(task);
+					// Увеличиваем количество задач
+					this->count++;
+				}
+				/**
+				 * pop Метод извлечения задачи из начала очереди (для потока владельца очереди)
+				 * @param task извлечённая задача
+				 * @return     результат извлечения
+				 */
+				const bool pop(task_t & task) noexcept {
+					// Если очередь пустая, выходим
+					if(this->count == 0) return false;
+					// Извлекаем первую задачу
+					task = std::move(this->tasks[this->head]);
+					// Смещаем начало очереди
+					this->head = ((this->head + 1) % this->tasks.size());
+					// Уменьшаем количество задач
+					this->count--;
+					// Сообщаем что задача извлечена
+					return true;
+				}
+				/**
+				 * steal Метод извлечения задачи из конца очереди (для других потоков)
+				 * @param task извлечённая задача
+				 * @return     результат извлечения
+				 */
+				const bool steal(task_t & task) noexcept {
+					// Если очередь пустая, выходим
+					if(this->count == 0) return false;
+					// Уменьшаем количество задач
+					this->count--;
+					// Извлекаем последнюю задачу
+					task = std::move(this->tasks[(this->head + this->count) % this->tasks.size()]);
+					// Сообщаем что задача извлечена
+					return true;
+				}
+				/**
+				 * clear Метод очистки очереди
+				 */
+				void clear() noexcept {
+					// Удаляем все задачи
+					for(auto & task : this->tasks) task.reset();
+					// Обнуляем начало и количество задач
+					this->head = this->count = 0;
+				}
+				/**
+				 * Queue Конструктор
+				 */
+				Queue() noexcept : head(0), count(0) {}
+			} queue_t;
 		private:
 			// Сингнал остановки работы пула потоков
-			bool volatile stop = false;
+			std::atomic <bool> stop{false};
 			// Количество потоков
 			size_t threads = 1;
 		private:
-			// Тип очереди задач
-			typedef std::queue <std::function <void()>> TaskQueue_t;
+			// Количество задач ожидающих исполнения
+			std::atomic <size_t> pending{0};
+			// Количество потоков ожидающих появления задач
+			std::atomic <size_t> sleeping{0};
+			// Счётчик распределения задач внешних потоков по очередям
+			std::atomic <size_t> cursor{0};
 		private:
-			// Очередь задач на исполнение
-			TaskQueue_t tasks;
-			// Мьютекс для разграничения доступа к очереди задач
+			// Очереди задач каждого потока
+			std::vector <std::unique_ptr <queue_t>> queues;
+			// Мьютекс для ожидания появления задач
 			mutable std::mutex queue_mutex;
 			// Рабочие потоки для обработки задач
 			std::vector <std::thread> workers;
 			// Условная переменная, контролирующая исполнение задачи
 			std::condition_variable condition;
 		private:
+			/**
+			 * worker Метод получения индекса рабочего потока текущего пула
+			 * @return ссылка на пул и индекс потока в котором выполняется код
+			 */
+			static std::pair <const ThreadPool *, size_t> & worker() noexcept {
+				// Пул и индекс рабочего потока
+				static thread_local std::pair <const ThreadPool *, size_t> result = {nullptr, 0};
+				// Выводим результат
+				return result;
+			}
+			/**
+			 * queue Метод выбора очереди для новой задачи
+			 * @return индекс очереди
+			 */
+			const size_t queue() noexcept {
+				// Получаем рабочий поток текущего пула
+				const auto & current = worker();
+				// Задачи рабочего потока добавляем в его собственную очередь
+				if(current.first == this) return current.second;
+				// Задачи внешних потоков распределяем по очередям по кругу
+				return (this->cursor.fetch_add(1, std::memory_order_relaxed) % std::max(std::min(this->threads, this->queues.size()), size_t(1)));
+			}
+			/**
+			 * notify Метод оповещения ожидающих потоков о новых задачах
+			 * @param all флаг оповещения всех потоков
+			 */
+			void notify(const bool all = false) noexcept {
+				// Если есть потоки ожидающие задач
+				if(this->sleeping.load() > 0){
+					// Синхронизируемся с засыпающими потоками, чтобы оповещение не потерялось
+					{
+						// Выполняем блокировку мютекса ожидания
+						std::lock_guard <std::mutex> lock(this->queue_mutex);
+					}
+					// Будим потоки
+					if(all) this->condition.notify_all();
+					else this->condition.notify_one();
+				}
+			}
+			/**
+			 * take Метод извлечения задачи своей очереди или кражи её из чужой
+			 * @param index индекс очереди потока
+			 * @param task  извлечённая задача
+			 * @return      результат извлечения
+			 */
+			const bool take(const size_t index, task_t & task) noexcept {
+				// Результат работы функции
+				bool result = false;
+				// Переходим по всем очередям, начиная со своей
+				for(size_t i = 0; !result && (i < this->queues.size()); i++){
+					// Получаем очередь
+					queue_t & queue = (* this->queues[(index + i) % this->queues.size()]);
+					// Выполняем блокировку очереди
+					std::lock_guard <std::mutex> lock(queue.mtx);
+					// Из своей очереди берём первую задачу, из чужой последнюю
+					result = (i == 0 ? queue.pop(task) : queue.steal(task));
+				}
+				// Если задача извлечена, уменьшаем количество ожидающих задач
+				if(result) this->pending.fetch_sub(1);
+				// Выводим результат
+				return result;
+			}
 			/**
 			 * work Метод обработки очереди задач в одном потоке
+			 * @param index индекс очереди потока
 			 */
-			void work() noexcept {
+			void work(const size_t index) noexcept {
+				// Запоминаем пул и индекс рабочего потока
+				worker() = {this, index};
+				// Создаём текущее задание
+				task_t task;
 				// Запускаем бесконечный цикл
 				for(;;){
-					// Создаём текущее задание
-					function <void()> task;
-					// Ожидаем своей задачи в очереди потоков
-					{
+					// Если задача получена
+					if(this->take(index, task)){
+						// Исполняем задачу
+						task();
+						// Освобождаем данные задачи
+						task.reset();
+					// Иначе ожидаем появления задач
+					} else {
 						// Выполняем блокировку уникальным мютексом
 						std::unique_lock <std::mutex> lock(this->queue_mutex);
+						// Сообщаем что поток ожидает задачи
+						this->sleeping.fetch_add(1);
 						// Если это не остановка приложения и список задач пустой, ожидаем добавления нового задания
-						this->condition.wait(lock, [this]{return this->stop || !this->tasks.empty();});
+						this->condition.wait(lock, [this]{return (this->stop || (this->pending.load() > 0));});
+						// Сообщаем что поток больше не ожидает
+						this->sleeping.fetch_sub(1);
 						// Если это остановка приложения и список задач пустой, выходим
-						if(this->stop && this->tasks.empty()) return;
-						// Получаем текущее задание
-						task = move(this->tasks.front());
-						// Удаляем текущее задание
-						this->tasks.pop();
+						if(this->stop && (this->pending.load() == 0)) break;
 					}
-					// Задача появилась, исполняем ее и сообщаем о том, что задача выбрана из очереди
-					task();
 				}
+				// Сбрасываем индекс рабочего потока
+				worker() = {nullptr, 0};
 			}
 		public:
 			/**
@@ -80,21 +393,21 @@ namespace anyks {
 			 */
 			void wait() noexcept {
 				{
-					// Останавливаем работу потоков
-					this->stop = true;
 					// Создаем уникальный мютекс
 					std::unique_lock <std::mutex> lock(this->queue_mutex);
+					// Останавливаем работу потоков
+					this->stop = true;
 				}
-				// Создаем пустой список задач
-				TaskQueue_t empty;
 				// Сообщаем всем что мы завершаем работу
 				this->condition.notify_all();
 				// Ожидаем завершение работы каждого воркера
 				for(std::thread & worker: this->workers) worker.join();
 				// Очищаем список потоков
 				this->workers.clear();
-				// Очищаем список задач
-				swap(this->tasks, empty);
+				// Очищаем очереди задач, не исполненные без потоков задачи удаляются
+				for(auto & queue : this->queues) queue->clear();
+				// Обнуляем количество задач
+				this->pending = 0;
 				// Восстанавливаем работу потоков
 				this->stop = false;
 			}
@@ -107,10 +420,12 @@ namespace anyks {
 				if(threads > 0) this->threads = threads;
 				// Ели количество потоков передано
 				if(this->threads > 0){
+					// Очередей должно быть не меньше чем потоков, лишние очереди разбираются кражей задач
+					while(this->queues.size() < this->threads) this->queues.emplace_back(new queue_t);
 					// Добавляем в список воркеров, новую задачу
-					for(size_t i = 0; i < this->threads; ++i){
+					for(size_t i = this->workers.size(); i < this->threads; ++i){
 						// Добавляем новую задачу
-						this->workers.emplace_back(std::bind(&ThreadPool::work, this));
+						this->workers.emplace_back(&ThreadPool::work, this, i);
 					}
 				}
 			}
@@ -119,18 +434,18 @@ namespace anyks {
 			 * @return результат работы функции
 			 */
 			const size_t getTaskQueueSize() const noexcept {
-				// Выполняем блокировку уникальным мютексом
-				std::unique_lock <std::mutex> lock(this->queue_mutex);
 				// Выводим количество заданий
-				return this->tasks.size();
+				return this->pending.load();
 			}
 			/**
 			 * ThreadPool Конструктор
 			 * @param threads потоки
 			 */
-			explicit ThreadPool(const size_t threads = std::thread::hardware_concurrency()) noexcept : stop(false), threads(0) {
+			explicit ThreadPool(const size_t threads = std::thread::hardware_concurrency()) noexcept : threads(0) {
 				// Ели количество потоков передано
 				if(threads > 0) this->threads = threads;
+				// Создаём очереди задач, чтобы задачи можно было добавлять до запуска потоков
+				while(this->queues.size() < std::max(this->threads, size_t(1))) this->queues.emplace_back(new queue_t);
 			}
 			/**
 			 * ~ThreadPool Деструктор
@@ -140,6 +455,139 @@ namespace anyks {
 				this->wait();
 			}
 		public:
+			/**
+			 * Шаблон метода добавления задачи без ожидания результата
+			 */
+			template <class Func, class ... Args>
+			/**
+			 * post Метод добавления задачи без ожидания результата (без выделения памяти для небольших функций)
+			 * @param func функция для обработки
+			 * @param args аргументы для передачи в функцию
+			 */
+			void post(Func && func, Args && ... args) noexcept {
+				// Если это остановка работы, выходим
+				if(this->stop) return;
+				// Формируем задачу, аргументы копируются как в std::bind
+				task_t task([func = std::forward <Func> (func), args = std::make_tuple(std::forward <Args> (args)...)]() mutable {
+					// Вызываем функцию с сохранёнными аргументами
+					std::apply(func, args);
+				});
+				// Получаем очередь для задачи
+				queue_t & queue = (* this->queues[this->queue()]);
+				// Увеличиваем количество задач до добавления, чтобы счётчик не ушёл в минус
+				this->pending.fetch_add(1);
+				{
+					// Выполняем блокировку очереди
+					std::lock_guard <std::mutex> lock(queue.mtx);
+					// Добавляем задачу в очередь
+					queue.push(std::move(task));
+				}
+				// Сообщаем потокам, что появилась новая задача
+				this->notify();
+			}
+			/**
+			 * Шаблон метода пакетного добавления задач
+			 */
+			template <class Func>
+			/**
+			 * bulk Метод пакетного добавления задач, каждая очередь блокируется один раз
+			 * @param count количество задач
+			 * @param func  функция задачи, получает индекс задачи от 0 до count
+			 */
+			void bulk(const size_t count, const Func & func) noexcept {
+				// Если это не остановка работы и задачи переданы
+				if(!this->stop && (count > 0)){
+					// Количество очередей между которыми распределяются задачи
+					const size_t size = std::max(std::min(this->threads, this->queues.size()), size_t(1));
+					// Увеличиваем количество задач до добавления
+					this->pending.fetch_add(count);
+					// Переходим по всем очередям
+					for(size_t i = 0; i < size; i++){
+						// Получаем диапазон задач очереди
+						const size_t first = (i * count / size), last = ((i + 1) * count / size);
+						// Если диапазон пустой, пропускаем очередь
+						if(first == last) continue;
+						// Получаем очередь
+						queue_t & queue = (* this->queues[i]);
+						// Выполняем блокировку очереди
+						std::lock_guard <std::mutex> lock(queue.mtx);
+						// Добавляем задачи диапазона
+						for(size_t j = first; j < last; j++) queue.push(task_t([func, j]{func(j);}));
+					}
+					// Сообщаем всем потокам, что появились новые задачи
+					this->notify(true);
+				}
+			}
+			/**
+			 * Шаблон метода параллельной обработки диапазона
+			 */
+			template <class Func>
+			/**
+			 * parallel_for Метод параллельной обработки диапазона индексов блоками
+			 * @param first начало диапазона
+			 * @param last  конец диапазона (не включая)
+			 * @param func  функция обработки блока, получает границы блока [first, last)
+			 * @param grain минимальный размер блока (0 - подбирается по количеству потоков)
+			 */
+			void parallel_for(const size_t first, const size_t last, const Func & func, const size_t grain = 0) noexcept {
+				// Если диапазон пустой, выходим
+				if(first >= last) return;
+				// Получаем количество потоков участвующих в обработке
+				const size_t threads = this->workers.size();
+				// Получаем размер диапазона
+				const size_t size = (last - first);
+				// Получаем размер блока, по несколько блоков на поток для балансировки
+				const size_t step = std::max((grain > 0 ? grain : (size / (threads * 4 + 1))), size_t(1));
+				// Получаем количество блоков
+				const size_t blocks = ((size + step - 1) / step);
+				// Если потоков нет или блок всего один, обрабатываем диапазон в текущем потоке
+				if((threads == 0) || (blocks < 2) || this->stop) func(first, last);
+				// Иначе распределяем блоки между потоками
+				else {
+					/**
+					 * State Структура состояния обработки диапазона
+					 */
+					typedef struct State {
+						// Индекс следующего блока и количество обработанных блоков
+						std::atomic <size_t> next{0}, done{0};
+						// Мьютекс ожидания обработки блоков
+						std::mutex mtx;
+						// Условная переменная ожидания обработки блоков
+						std::condition_variable cv;
+					} state_t;
+					// Состояние разделяется с помощниками, которые могут запуститься уже после завершения обработки
+					auto state = std::make_shared <state_t> ();
+					/**
+					 * runFn Функция обработки блоков, пока они не закончатся
+					 */
+					auto runFn = [state, &func, first, last, step, blocks]{
+						// Индекс блока
+						size_t index = 0;
+						// Забираем блоки, пока они есть
+						while((index = state->next.fetch_add(1)) < blocks){
+							// Получаем начало блока
+							const size_t begin = (first + index * step);
+							// Обрабатываем блок
+							func(begin, std::min(begin + step, last));
+							// Если обработан последний блок
+							if((state->done.fetch_add(1) + 1) == blocks){
+								// Выполняем блокировку мютекса ожидания
+								std::lock_guard <std::mutex> lock(state->mtx);
+								// Сообщаем о завершении обработки
+								state->cv.notify_all();
+							}
+						}
+					};
+					// Запускаем помощников, текущий поток тоже обрабатывает блоки
+					this->bulk(std::min(threads, blocks - 1), [runFn](const size_t){runFn();});
+					// Обрабатываем блоки в текущем потоке
+					runFn();
+					// Выполняем блокировку мютекса ожидания
+					std::unique_lock <std::mutex> lock(state->mtx);
+					// Ожидаем завершения блоков, взятых помощниками
+					state->cv.wait(lock, [&state, blocks]{return (state->done.load() == blocks);});
+				}
+			}
 			/**
 			 * Шаблон метода добавления задач в пул
 			 */
@@ -156,14 +604,8 @@ namespace anyks {
 				auto task = std::make_shared <std::packaged_task <return_type()>> (std::bind(std::forward <Func>(func), std::forward <Args> (args)...));
 				// Создаем шаблон асинхронных операций
 				std::future <return_type> res = task->get_future();
-				{
-					// Выполняем блокировку уникальным мютексом
-					std::unique_lock <std::mutex> lock(this->queue_mutex);
-					// Если это не остановка работы
-					if(!this->stop) this->tasks.emplace([task](){(* task)();});
-				}
-				// Сообщаем потокам, что появилась новая задача
-				this->condition.notify_one();
+				// Добавляем задачу в очередь
+				this->post([task](){(* task)();});
 				// Выводим результат
 				return res;
 			}
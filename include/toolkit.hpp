@@ -19,9 +19,11 @@
 #include <bitset>
 #include <vector>
 #include <atomic>
+#include <charconv>
 #include <fstream>
 #include <functional>
 #include <unordered_map>
+#include <zlib.h>
 #include <sys/stat.h>
 /**
  * Наши модули
@@ -108,11 +110,16 @@ namespace anyks {
 				 */
 				UserToken() : idw(idw_t::NIDW), name("") {}
 			} utoken_t;
+		private:
+			// Размер заголовка и метаданных бинарного контейнера (без словаря и arpa)
+			static constexpr u_int BINHEADER = 8192;
 		private:
 			// Замена неизвестному слову
 			size_t unknown = 0;
 			// Размер n-грамм
 			u_short size = DEFNGRAM;
+			// Количество потоков для обучения
+			size_t threads = 1;
 			// Флаг запрещающий очистку объект питона
 			bool notCleanPython = false;
 		private:
@@ -128,6 +135,8 @@ namespace anyks {
 			std::set <size_t> goodwords;
 			// Мютекс блокировки потока
 			std::recursive_mutex locker;
+			// Тредпул для параллельного чтения
+			tpool_t tpool;
 			// Список токенов приводимых к <unk>
 			std::set <token_t> tokenUnknown;
 			// Список запрещённых токенов
@@ -326,6 +335,11 @@ namespace anyks {
 			 * @param logifle адрес файла для вывода отладочной информации
 			 */
 			void setLogfile(const char * logfile) noexcept;
+			/**
+			 * setThreads Метод установки количества потоков
+			 * @param threads количество потоков для работы
+			 */
+			void setThreads(const size_t threads = 0) noexcept;
 			/**
 			 * setUserToken Метод добавления токена пользователя
 			 * @param name слово - обозначение токена
@@ -478,6 +492,15 @@ namespace anyks {
 			 * @param status    функция вывода статуса обучения
 			 */
 			void prune(const double threshold, const u_short mingram, function <void (const u_short)> status = nullptr) const noexcept;
+			/**
+			 * pruneTo Метод прунинга языковой модели до заданного количества n-грамм или размера
+			 * @param count   максимальное количество n-грамм (0 - не ограничено)
+			 * @param size    максимальный размер бинарного контейнера в байтах, вместе со словарём и метаданными (0 - не ограничен)
+			 * @param mingram значение минимальной n-граммы за которую нельзя прунить
+			 * @param status  функция вывода статуса обучения
+			 * @return        подобранный порог прунинга (0 - прунинг не потребовался или ограничения недостижимы)
+			 */
+			const double pruneTo(const size_t count, const uintmax_t size, const u_short mingram, function <void (const u_short)> status = nullptr) const noexcept;
 			/**
 			 * pruneVocab Метод прунинга словаря
 			 * @param wltf   пороговый вес слова для прунинга
@@ -527,6 +550,18 @@ namespace anyks {
 			 * @param idd    идентификатор документа в котором получена n-грамма
 			 */
 			void appendArpa(const vector <char> & buffer, const size_t idd = 0) const noexcept;
+			/**
+			 * appendArpa Метод переноса n-грамм из объекта arpa в словарь
+			 * @param arpa объект arpa из которого переносятся n-граммы
+			 */
+			void appendArpa(const arpa_t * arpa) const noexcept;
+			/**
+			 * shardArpa Метод переноса n-грамм шарда из словаря в объект arpa
+			 * @param arpa   объект arpa шарда
+			 * @param shard  номер шарда первого слова n-граммы
+			 * @param shards общее количество шардов
+			 */
+			void shardArpa(const arpa_t * arpa, const size_t shard, const size_t shards) const noexcept;
 		public:
 			/**
 			 * saveInfoVocab Метод сохранения бинарных информационных данных словаря
@@ -539,7 +574,7 @@ namespace anyks {
 			 */
 			void saveVocab(function <void (const vector <char> &, const u_short)> callback) const noexcept;
 			/**
-			 * writeArpa Метод записи данных в файл arpa
+			 * writeArpa Метод записи данных в файл arpa (если адрес оканчивается на .gz, файл сжимается gzip)
 			 * @param filename адрес файла для записи
 			 * @param status   функция вывода статуса записи
 			 */
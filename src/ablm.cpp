@@ -17,6 +17,38 @@ const bool anyks::AbLM::isFlag(const flag_t flag) const noexcept {
 	// Выполняем проверку наличия флага
 	return this->flags.test((u_short) flag);
 }
+/**
+ * records Метод параллельного извлечения группы записей бинарного контейнера
+ * @param prefix   префикс ключей записей
+ * @param count    количество записей
+ * @param window   количество записей извлекаемых за один раз
+ * @param callback функция обработки извлечённых записей (буферы записей и номер первой записи)
+ */
+void anyks::AbLM::records(const string & prefix, const size_t count, const size_t window, function <void (const vector <vector <char>> &, const size_t)> callback) noexcept {
+	// Если записи существуют
+	if((count > 0) && (window > 0) && (callback != nullptr)){
+		// Флаг шифрования записей
+		const bool decrypt = !this->meta.password.empty();
+		// Буферы извлечённых записей
+		vector <vector <char>> buffers;
+		// Запускаем потоки тредпула, если они ещё не запущены, останавливаются они в конце чтения
+		this->tpool.init(this->threads);
+		// Переходим по всем записям окнами, чтобы в памяти не держать все записи сразу
+		for(size_t first = 1; first <= count; first += window){
+			// Очищаем буферы прошлого окна
+			buffers.clear();
+			// Выделяем буферы для записей окна
+			buffers.resize(min(window, count - first + 1));
+			// Считываем, расшифровываем и распаковываем записи окна параллельно
+			this->tpool.parallel_for(0, buffers.size(), [&](const size_t begin, const size_t end){
+				// Переходим по всем записям блока
+				for(size_t i = begin; i < end; i++) this->aspl->get(prefix + to_string(first + i), buffers[i], decrypt);
+			}, 1);
+			// Передаём записи окна на обработку в порядке их номеров
+			callback(buffers, first);
+		}
+	}
+}
 /**
  * write Метод записи данных словаря в файл
  * @param status статус записи данных в бинарный контейнер
@@ -26,6 +58,10 @@ const bool anyks::AbLM::write(function <void (const u_short)> status) noexcept {
 	bool result = false;
 	// Устанавливаем тип шифрования
 	this->aspl->setAES(this->meta.aes);
+	// Устанавливаем алгоритм сжатия
+	this->aspl->setCodec(this->codec);
+	// Устанавливаем количество потоков сжатия
+	this->aspl->setThreads(max(this->threads, size_t(1)));
 	// Устанавливаем дату генерации словаря
 	this->aspl->set("date", this->meta.date);
 	// Устанавливаем название словаря
@@ -175,6 +211,16 @@ const bool anyks::AbLM::write(function <void (const u_short)> status) noexcept {
 		// Выполняем сохранение алгоритма сглаживания
 		this->aspl->set("algorithm", params.algorithm);
 	}
+	// Объект записи N-грамм для отображения в память, N-граммы хранятся во временных файлах, а не в памяти
+	alm3_t alm(this->alphabet, this->tokenizer);
+	// Зашифрованный словарь нельзя отображать в память в открытом виде
+	const bool mmap = (this->isFlag(flag_t::expMmap) && this->meta.password.empty());
+	// Если таблицы для отображения в память запрошены вместе с паролем, сообщаем, что они не будут записаны
+	if(this->isFlag(flag_t::expMmap) && !mmap) this->alphabet->log("%s", alphabet_t::log_t::warning, this->logfile, "ablm - n-grams for memory mapping are not written to an encrypted dictionary");
+	// Если квантование запрошено без таблиц для отображения в память, сообщаем, что оно не будет выполнено
+	if(!mmap && (this->quant > 0)) this->alphabet->log("%s", alphabet_t::log_t::warning, this->logfile, "ablm - quantization applies only to n-grams for memory mapping");
+	// Устанавливаем размер N-граммы
+	if(mmap) alm.setSize(this->toolkit->getSize());
 	/**
 	 * Блок записи данных словаря и arpa
 	 */
@@ -183,12 +229,18 @@ const bool anyks::AbLM::write(function <void (const u_short)> status) noexcept {
 		size_t count = 0;
 		// Буфер данных
 		vector <char> buffer;
+		// Записи накопленные для сжатия одной группой
+		vector <vector <char>> buffers;
+		// Флаг шифрования записей
+		const bool encrypt = !this->meta.password.empty();
+		// Количество записей сжимаемых за один раз
+		const size_t window = (max(this->threads, size_t(1)) * 256);
 		// Выполняем сохранение информационных данных словаря
 		this->toolkit->saveInfoVocab(buffer);
 		// Префиксы словаря и arpa
 		const string prefixVocab = "vocab_", prefixArpa = "arpa_";
 		// Если буфер данных получен
-		if(!buffer.empty()) this->aspl->set("infoVocab", buffer, !this->meta.password.empty());
+		if(!buffer.empty()) this->aspl->set("infoVocab", buffer, encrypt);
 		// Выполняем сохранение словаря
 		this->toolkit->saveVocab([&](const vector <char> & buffer, const u_short rate){
 			// Если буфер не пустой
@@ -197,10 +249,23 @@ const bool anyks::AbLM::write(function <void (const u_short)> status) noexcept {
 				count++;
 				// Если нужно вывести статистику загрузки
 				if(status != nullptr) status(u_short(rate / double(200) * 100.0));
-				// Выполняем запись буфера словаря
-				this->aspl->set(prefixVocab + to_string(count), buffer, !this->meta.password.empty());
+				// Добавляем запись в группу
+				buffers.push_back(buffer);
+				// Если группа собрана, сжимаем её записи параллельно и записываем по порядку
+				if(buffers.size() == window){
+					// Выполняем запись группы буферов словаря
+					this->aspl->sets(prefixVocab, count - buffers.size() + 1, buffers, encrypt);
+					// Очищаем группу
+					buffers.clear();
+				}
+				// Добавляем слово в блок для отображения в память
+				if(mmap) alm.mapVocab(buffer);
 			}
 		});
+		// Выполняем запись оставшихся буферов словаря
+		this->aspl->sets(prefixVocab, count - buffers.size() + 1, buffers, encrypt);
+		// Очищаем группу
+		buffers.clear();
 		// Если данные не получены, выходим
 		if(!(result = (count > 0))) return result;
 		// Сохраняем количество записей словаря
@@ -215,16 +280,50 @@ const bool anyks::AbLM::write(function <void (const u_short)> status) noexcept {
 				count++;
 				// Если нужно вывести статистику загрузки
 				if(status != nullptr) status(u_short((rate + 100) / double(200) * 100.0));
-				// Выполняем запись буфера словаря
-				this->aspl->set(prefixArpa + to_string(count), buffer, !this->meta.password.empty());
+				// Добавляем запись в группу
+				buffers.push_back(buffer);
+				// Если группа собрана, сжимаем её записи параллельно и записываем по порядку
+				if(buffers.size() == window){
+					// Выполняем запись группы буферов arpa
+					this->aspl->sets(prefixArpa, count - buffers.size() + 1, buffers, encrypt);
+					// Очищаем группу
+					buffers.clear();
+				}
+				// Записи arpa идут в порядке обхода дерева, поэтому N-граммы сразу сбрасываем во временные файлы порядков
+				if(mmap) alm.mapBin(buffer);
 			}
 		}, this->isFlag(flag_t::onlyArpa));
+		// Выполняем запись оставшихся буферов arpa
+		this->aspl->sets(prefixArpa, count - buffers.size() + 1, buffers, encrypt);
+		// Очищаем группу
+		buffers.clear();
 		// Если данные не получены, выходим
 		if(!(result = (count > 0))) return result;
 		// Сохраняем количество записей arpa
 		this->aspl->set("arpaCount", count);
 		// Сохраняем флаг содержания в словаре только данных arpa
 		this->aspl->set("onlyArpa", this->isFlag(flag_t::onlyArpa));
+		// Сохраняем флаг наличия N-грамм для отображения в память
+		this->aspl->set("mmap", mmap);
+		// Если N-граммы для отображения в память нужно квантовать
+		if(mmap && (this->quant > 0)){
+			// Среднеквадратичные и максимальные ошибки квантования частот и обратных частот
+			pair <double, double> error = {0.0, 0.0}, maximum = {0.0, 0.0};
+			// Выполняем квантование N-грамм
+			if(alm.quantize(this->quant, error, maximum)){
+				// Сохраняем количество бит квантования
+				this->aspl->set("quant", this->quant);
+				// Сохраняем ошибку квантования частот
+				this->aspl->set("quantWeight", error.first);
+				// Сохраняем ошибку квантования обратных частот
+				this->aspl->set("quantBackoff", error.second);
+				// Сохраняем максимальную ошибку квантования частот
+				this->aspl->set("quantWeightMax", maximum.first);
+				// Сохраняем максимальную ошибку квантования обратных частот
+				this->aspl->set("quantBackoffMax", maximum.second);
+			// Выводим сообщение об ошибке
+			} else if(this->isFlag(flag_t::debug)) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "ablm - n-grams for memory mapping are not quantized");
+		}
 	}
 	// Выполняем запись данных словаря
 	if(this->aspl->write() < 1){
@@ -232,6 +331,12 @@ const bool anyks::AbLM::write(function <void (const u_short)> status) noexcept {
 		if(this->isFlag(flag_t::debug)) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "ablm - dictionary file is wrong");
 		// Сбрасываем флаг результата
 		result = false;
+	// Дописываем N-граммы для отображения в память в конец файла словаря
+	} else if(mmap && !alm.writeMap(this->filename)) {
+		// Выводим сообщение об ошибке
+		if(this->isFlag(flag_t::debug)) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "ablm - memory mapping block is not written");
+		// Сбрасываем флаг результата
+		result = false;
 	}
 	// Выводим результат
 	return result;
@@ -606,8 +711,6 @@ const bool anyks::AbLM::readAlm(function <void (const u_short)> status) noexcept
 		 * Блок извлечения данных словаря и arpa
 		 */
 		{
-			// Буфер бинарных данных словаря
-			vector <char> buffer;
 			// Флаг содержания в словаре только данных arpa
 			bool onlyArpa = false;
 			// Извлекаем флаг содержания в словаре только данных arpa
@@ -616,34 +719,63 @@ const bool anyks::AbLM::readAlm(function <void (const u_short)> status) noexcept
 			if(onlyArpa) this->setFlag(flag_t::onlyArpa);
 			// Префиксы словаря и arpa
 			const string prefixVocab = "vocab_", prefixArpa = "arpa_";
-			// Переходим по всему списку слов словаря
-			for(size_t i = 1; i <= vocabCount; i++){
-				// Извлекаем бинарные данные словаря
-				this->aspl->get(prefixVocab + to_string(i), buffer, !this->meta.password.empty());
-				// Если бинарные данные словаря получены
-				if(!buffer.empty()) this->alm->setVocab(buffer);
-				// Если нужно вывести статистику загрузки
-				if(status != nullptr){
-					// Увеличиваем количество блоков
-					index++;
-					// Выводим результат если необходимо
-					status(u_short(index / double(count) * 100.0));
-				}
+			// Количество потоков извлечения записей
+			const size_t threads = max(this->threads, size_t(1));
+			// Флаг наличия N-грамм для отображения в память
+			bool mmap = false;
+			// Извлекаем флаг наличия N-грамм для отображения в память
+			this->aspl->get("mmap", mmap);
+			// Если N-граммы и слова удалось отобразить в память, данные словаря и arpa не загружаем
+			if(mmap) mmap = this->alm->readMap(this->filename);
+			// Если слова не отображены в память
+			if(!mmap){
+				// Извлекаем записи словаря параллельно, слова добавляем по порядку
+				this->records(prefixVocab, vocabCount, threads * 256, [&](const vector <vector <char>> & buffers, const size_t){
+					// Переходим по всем записям окна
+					for(auto & buffer : buffers){
+						// Если бинарные данные словаря получены
+						if(!buffer.empty()) this->alm->setVocab(buffer);
+						// Если нужно вывести статистику загрузки
+						if(status != nullptr){
+							// Увеличиваем количество блоков
+							index++;
+							// Выводим результат если необходимо
+							status(u_short(index / double(count) * 100.0));
+						}
+					}
+				});
+			// Если нужно вывести статистику загрузки
+			} else if(status != nullptr) {
+				// Увеличиваем количество блоков
+				index += vocabCount;
+				// Выводим результат если необходимо
+				status(u_short(index / double(count) * 100.0));
 			}
-			// Переходим по всему списку данных arpa
-			for(size_t i = 1; i <= arpaCount; i++){
-				// Извлекаем бинарные данные arpa
-				this->aspl->get(prefixArpa + to_string(i), buffer, !this->meta.password.empty());
-				// Если бинарные данные arpa получены
-				if(!buffer.empty()) this->alm->setBin(buffer);
-				// Если нужно вывести статистику загрузки
-				if(status != nullptr){
-					// Увеличиваем количество блоков
-					index++;
-					// Выводим результат если необходимо
-					status(u_short(index / double(count) * 100.0));
-				}
+			// Если N-граммы не отображены в память
+			if(!mmap){
+				// Извлекаем записи arpa параллельно, большими окнами, как и записи словаря
+				this->records(prefixArpa, arpaCount, threads * 256, [&](const vector <vector <char>> & buffers, const size_t){
+					// Устанавливаем все записи окна
+					this->alm->setBins(buffers);
+					// Если нужно вывести статистику загрузки
+					if(status != nullptr){
+						// Увеличиваем количество блоков
+						index += buffers.size();
+						// Выводим результат если необходимо
+						status(u_short(index / double(count) * 100.0));
+					}
+				});
+			// Если нужно вывести статистику загрузки
+			} else if(status != nullptr) {
+				// Увеличиваем количество блоков
+				index += arpaCount;
+				// Выводим результат если необходимо
+				status(u_short(index / double(count) * 100.0));
 			}
+			// Останавливаем потоки извлечения записей
+			this->tpool.wait();
+			// Останавливаем потоки установки записей в словарь
+			this->alm->joinBins();
 		}
 	// Выводим сообщение об ошибке
 	} else if(this->isFlag(flag_t::debug)) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "ablm - dictionary file is wrong");
@@ -1077,34 +1209,40 @@ const bool anyks::AbLM::readToolkit(function <void (const u_short)> status) noex
 				// Выводим результат если необходимо
 				status(u_short(index / double(count) * 100.0));
 			}
-			// Переходим по всему списку слов словаря
-			for(size_t i = 1; i <= vocabCount; i++){
-				// Извлекаем бинарные данные словаря
-				this->aspl->get(prefixVocab + to_string(i), buffer, !this->meta.password.empty());
-				// Если бинарные данные словаря получены
-				if(!buffer.empty()) this->toolkit->loadVocab(buffer);
-				// Если нужно вывести статистику загрузки
-				if(status != nullptr){
-					// Увеличиваем количество блоков
-					index++;
-					// Выводим результат если необходимо
-					status(u_short(index / double(count) * 100.0));
+			// Количество записей извлекаемых за один раз
+			const size_t window = (max(this->threads, size_t(1)) * 256);
+			// Извлекаем записи словаря параллельно, слова добавляем по порядку
+			this->records(prefixVocab, vocabCount, window, [&](const vector <vector <char>> & buffers, const size_t){
+				// Переходим по всем записям окна
+				for(auto & buffer : buffers){
+					// Если бинарные данные словаря получены
+					if(!buffer.empty()) this->toolkit->loadVocab(buffer);
+					// Если нужно вывести статистику загрузки
+					if(status != nullptr){
+						// Увеличиваем количество блоков
+						index++;
+						// Выводим результат если необходимо
+						status(u_short(index / double(count) * 100.0));
+					}
 				}
-			}
-			// Переходим по всему списку данных arpa
-			for(size_t i = 1; i <= arpaCount; i++){
-				// Извлекаем бинарные данные arpa
-				this->aspl->get(prefixArpa + to_string(i), buffer, !this->meta.password.empty());
-				// Если бинарные данные arpa получены
-				if(!buffer.empty()) this->toolkit->loadArpa(buffer, onlyArpa);
-				// Если нужно вывести статистику загрузки
-				if(status != nullptr){
-					// Увеличиваем количество блоков
-					index++;
-					// Выводим результат если необходимо
-					status(u_short(index / double(count) * 100.0));
+			});
+			// Извлекаем записи arpa параллельно, последовательности добавляем по порядку, так как от него зависит их разбор
+			this->records(prefixArpa, arpaCount, window, [&](const vector <vector <char>> & buffers, const size_t){
+				// Переходим по всем записям окна
+				for(auto & buffer : buffers){
+					// Если бинарные данные arpa получены
+					if(!buffer.empty()) this->toolkit->loadArpa(buffer, onlyArpa);
+					// Если нужно вывести статистику загрузки
+					if(status != nullptr){
+						// Увеличиваем количество блоков
+						index++;
+						// Выводим результат если необходимо
+						status(u_short(index / double(count) * 100.0));
+					}
 				}
-			}
+			});
+			// Останавливаем потоки извлечения записей
+			this->tpool.wait();
 		}
 	// Выводим сообщение об ошибке
 	} else if(this->isFlag(flag_t::debug)) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "ablm - dictionary file is wrong");
@@ -1168,6 +1306,14 @@ void anyks::AbLM::info() const noexcept {
 			u_short size = 0, aes = 0;
 			// Количество основных блоков данных
 			size_t vocabCount = 0, arpaCount = 0;
+			// Флаг наличия N-грамм для отображения в память
+			bool mmap = false;
+			// Количество бит квантования N-грамм
+			u_short quant = 0;
+			// Среднеквадратичные ошибки квантования частот и обратных частот
+			double quantWeight = 0.0, quantBackoff = 0.0;
+			// Максимальные ошибки квантования частот и обратных частот
+			double quantWeightMax = 0.0, quantBackoffMax = 0.0;
 			// Метаданные информации о словаре
 			string alphabet = "", author = "", lictype = "", lictext = "", contacts = "", copyright = "";
 			// Извлекаем тип шифрования
@@ -1186,6 +1332,18 @@ void anyks::AbLM::info() const noexcept {
 			this->aspl->get("alphabet", alphabet);
 			// Считываем копирайт словаря
 			this->aspl->get("copyright", copyright);
+			// Считываем флаг наличия N-грамм для отображения в память
+			this->aspl->get("mmap", mmap);
+			// Считываем количество бит квантования N-грамм
+			this->aspl->get("quant", quant);
+			// Считываем ошибку квантования частот
+			this->aspl->get("quantWeight", quantWeight);
+			// Считываем ошибку квантования обратных частот
+			this->aspl->get("quantBackoff", quantBackoff);
+			// Считываем максимальную ошибку квантования частот
+			this->aspl->get("quantWeightMax", quantWeightMax);
+			// Считываем максимальную ошибку квантования обратных частот
+			this->aspl->get("quantBackoffMax", quantBackoffMax);
 			// Считываем количество записей arpa
 			this->aspl->get("arpaCount", arpaCount);
 			// Считываем количество записей словаря
@@ -1236,6 +1394,15 @@ void anyks::AbLM::info() const noexcept {
 			if(vocabCount > 0) printf("* \x1B[1mWords:\x1B[0m %zu\r\n\r\n", vocabCount);
 			// Выводим количество N-грамм в языковой моделе
 			if(arpaCount > 0) printf("* \x1B[1mN-grams:\x1B[0m %zu\r\n\r\n", arpaCount);
+			// Если в словаре есть N-граммы для отображения в память
+			if(mmap){
+				// Объект языковой модели для проверки блока N-грамм
+				const alm3_t alm;
+				// Выводим наличие N-грамм для отображения в память и результат полной проверки блока
+				printf("* \x1B[1mMemory mapping:\x1B[0m %s\r\n\r\n", (alm.verifyMap(this->filename) ? "yes, verified" : "yes, broken"));
+			}
+			// Выводим параметры квантования N-грамм
+			if(quant > 0) printf("* \x1B[1mQuantization:\x1B[0m %u bits (unigrams are exact), RMS error weight %.6f backoff %.6f, max error weight %.6f backoff %.6f\r\n\r\n", quant, quantWeight, quantBackoff, quantWeightMax, quantBackoffMax);
 			// Выводим в консоль данные автора
 			if(!author.empty()) printf("* \x1B[1mAuthor:\x1B[0m %s\r\n\r\n", author.c_str());
 			// Выводим в консоль данные автора
@@ -1267,6 +1434,14 @@ void anyks::AbLM::setAES(aspl_t::types_t aes) noexcept {
 	// Выполняем установку размера шифрования
 	this->meta.aes = aes;
 }
+/**
+ * setCodec Метод установки алгоритма сжатия записей
+ * @param codec алгоритм сжатия для установки
+ */
+void anyks::AbLM::setCodec(aspl_t::codec_t codec) noexcept {
+	// Выполняем установку алгоритма сжатия
+	this->codec = codec;
+}
 /**
  * setFlag Метод установки флага модуля
  * @param flag флаг для установки
@@ -1371,6 +1546,22 @@ void anyks::AbLM::setFilename(const string & filename) noexcept {
 	// Устанавливаем имя файла
 	if(!filename.empty()) this->filename = filename;
 }
+/**
+ * setQuant Метод установки количества бит квантования N-грамм для отображения в память
+ * @param bits количество бит квантования (от 2 до 16, ноль отключает квантование)
+ */
+void anyks::AbLM::setQuant(const u_short bits) noexcept {
+	// Устанавливаем количество бит квантования
+	if((bits == 0) || ((bits > 1) && (bits <= 16))) this->quant = bits;
+}
+/**
+ * setThreads Метод установки количества потоков для извлечения и сжатия записей
+ * @param threads количество потоков для работы
+ */
+void anyks::AbLM::setThreads(const size_t threads) noexcept {
+	// Устанавливаем новое количество потоков
+	this->threads = (threads > 0 ? threads : std::thread::hardware_concurrency());
+}
 /**
  * setCopyright Метод установки копирайта автора
  * @param copyright копирайт автора для установки
@@ -8,6 +8,9 @@
 
 #include <alm.hpp>
 
+#include <numeric>
+#include <algorithm>
+
 /**
  * isOption Метод проверки наличия опции
  * @param option опция для проверки
@@ -65,6 +68,23 @@ const std::pair <double, double> anyks::Alm::frequency(const std::vector <size_t
 	// Выводим результат
 	return {this->zero, this->zero};
 }
+/**
+ * pplWeight Метод расчёта веса окна последовательности без его копирования
+ * @param seq   последовательность слов в которой находится окно
+ * @param begin позиция начала окна в последовательности
+ * @param end   позиция конца окна в последовательности (не включительно)
+ * @param unk   разрешено ли неизвестное слово
+ * @return      граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::Alm::pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept {
+	// Блокируем варнинг
+	(void) seq;
+	(void) end;
+	(void) unk;
+	(void) begin;
+	// Выводим результат
+	return {0, 0.0};
+}
 /**
  * set Метод установки последовательности в словарь
  * @param seq последовательность слов для установки
@@ -143,15 +163,13 @@ const anyks::Alm::ppl_t anyks::Alm::perplexity(const string & text) const noexce
 	return result;
 }
 /**
- * perplexity Метод расчёта перплексии текста
- * @param  text текст для расчёта
- * @return      результат расчёта
+ * pplSequences Метод разбивки текста на последовательности предложений для расчёта перплексии
+ * @param text     текст для разбивки
+ * @param callback функция обратного вызова для каждого полученного предложения
  */
-const anyks::Alm::ppl_t anyks::Alm::perplexity(const wstring & text) const noexcept {
-	// Результат работы функции
-	ppl_t result;
+void anyks::Alm::pplSequences(const wstring & text, function <void (const vector <size_t> &)> callback) const noexcept {
 	// Если текст передан
-	if(!text.empty()){
+	if(!text.empty() && (callback != nullptr)){
 		// Список собранных OOV слов
 		std::unordered_map <std::wstring, std::size_t> oovs;
 		// Идентификатор неизвестного слова
@@ -185,14 +203,14 @@ const anyks::Alm::ppl_t anyks::Alm::perplexity(const wstring & text) const noexc
 		/**
 		 * resFn Функция вывода результата
 		 */
-		auto resFn = [&result, &seq, fid, sid, this]() noexcept {
+		auto resFn = [&callback, &seq, fid, sid]() noexcept {
 			// Добавляем в список конец предложения
 			seq.push_back(fid);
 			/**
 			 * Если слова всего два, значит это начало и конец предложения
 			 * Нам же нужны только нормальные n-граммы
 			 */
-			if(seq.size() > 2) result = (result.words == 0 ? this->perplexity(seq) : this->pplConcatenate(result, this->perplexity(seq)));
+			if(seq.size() > 2) callback(seq);
 			// Очищаем список последовательностей
 			seq.clear();
 			// Добавляем в список начало предложения
@@ -264,6 +282,87 @@ const anyks::Alm::ppl_t anyks::Alm::perplexity(const wstring & text) const noexc
 		};
 		// Выполняем разбивку текста на токены
 		this->tokenizer->run(text, modeFn);
+		// Если список неизвестных слов получен и есть куда его выводить
+		if(!oovs.empty() && (this->oovfile != nullptr)){
+			// Блокируем поток
+			this->locker.lock();
+			// Переходим по всему списку неизвестных слов
+			for(auto & item : oovs){
+				// Добавляем слово в файл
+				this->alphabet->log(
+					"%ls\t%u",
+					alphabet_t::log_t::null,
+					this->oovfile,
+					item.first.c_str(),
+					item.second
+				);
+			}
+			// Разблокируем поток
+			this->locker.unlock();
+		}
+	}
+}
+/**
+ * byFiles Метод параллельного построчного чтения файла или группы файлов блоками
+ * @param path     адрес каталога или файла для чтения
+ * @param ext      расширение файлов в каталоге (если адрес передан каталога)
+ * @param callback функция обратного вызова для каждой непустой строки (строка, файл, общий размер данных)
+ */
+void anyks::Alm::byFiles(const string & path, const string & ext, function <void (const string &, const string &, const uintmax_t)> callback) const noexcept {
+	// Если данные переданы
+	if(!path.empty() && (callback != nullptr)){
+		// Выполняем инициализацию тредпула
+		this->tpool.init(this->threads);
+		/**
+		 * readFn Функция чтения одного файла блоками
+		 * @param filename адрес файла для чтения
+		 * @param size     общий размер обрабатываемых данных
+		 */
+		auto readFn = [&callback, this](const string & filename, const uintmax_t size) noexcept {
+			// Размер блока рассчитываем так, чтобы на каждый поток приходилось несколько блоков
+			const uintmax_t chunk = max(fsys_t::fsize(filename) / (max(this->threads, size_t(1)) * 8), uintmax_t(0x10000));
+			// Выполняем отображение файла в памяти и разбивку его на блоки
+			fsys_t::rchunks(filename, chunk, [&](const vector <std::string_view> & chunks, const uintmax_t length) noexcept {
+				// Обрабатываем блоки параллельно, отображение файла живёт до завершения обработки
+				this->tpool.parallel_for(0, chunks.size(), [&](const size_t first, const size_t last){
+					// Буфер строки, переиспользуемый для всех строк блока
+					string text = "";
+					// Переходим по всем блокам
+					for(size_t i = first; i < last; i++){
+						// Переходим по всем строкам блока
+						fsys_t::lines(chunks[i], [&](const std::string_view & line){
+							// Копируем строку в буфер
+							text.assign(line.data(), line.size());
+							// Выводим полученную строку
+							callback(text, filename, size);
+						});
+					}
+				}, 1);
+			});
+		};
+		// Если это файл
+		if(fsys_t::isfile(path)) readFn(path, fsys_t::fsize(path));
+		// Если это каталог, читаем все файлы каталога
+		else if(fsys_t::isdir(path)) fsys_t::rdir(path, ext, readFn);
+		// Ожидаем завершения обработки
+		this->tpool.wait();
+	}
+}
+/**
+ * perplexity Метод расчёта перплексии текста
+ * @param  text текст для расчёта
+ * @return      результат расчёта
+ */
+const anyks::Alm::ppl_t anyks::Alm::perplexity(const wstring & text) const noexcept {
+	// Результат работы функции
+	ppl_t result;
+	// Если текст передан
+	if(!text.empty()){
+		// Выполняем разбивку текста на предложения
+		this->pplSequences(text, [&result, this](const vector <size_t> & seq) noexcept {
+			// Выполняем расчёт перплексии предложения и объединяем её с полученным результатом
+			result = (result.words == 0 ? this->perplexity(seq) : this->pplConcatenate(result, this->perplexity(seq)));
+		});
 		// Выводим отладочную информацию
 		if((this->isOption(options_t::debug)) && (this->threads == 1)){
 			// Выводим сообщение отладки - количество слов
@@ -286,24 +385,6 @@ const anyks::Alm::ppl_t anyks::Alm::perplexity(const wstring & text) const noexc
 				result.ppl1
 			);
 		}
-		// Если список неизвестных слов получен и есть куда его выводить
-		if(!oovs.empty() && (this->oovfile != nullptr)){
-			// Блокируем поток
-			this->locker.lock();
-			// Переходим по всему списку неизвестных слов
-			for(auto & item : oovs){
-				// Добавляем слово в файл
-				this->alphabet->log(
-					"%ls\t%u",
-					alphabet_t::log_t::null,
-					this->oovfile,
-					item.first.c_str(),
-					item.second
-				);
-			}
-			// Разблокируем поток
-			this->locker.unlock();
-		}
 	}
 	// Выводим результат
 	return result;
@@ -349,6 +430,188 @@ const anyks::Alm::ppl_t anyks::Alm::perplexity(const vector <size_t> & seq) cons
 	// Выводим результат
 	return ppl_t();
 }
+/**
+ * perplexityBatch Метод пакетного расчёта перплексии списка текстов
+ * @param  texts список текстов для расчёта
+ * @return       список результатов расчёта в порядке текстов
+ */
+const std::vector <anyks::Alm::ppl_t> anyks::Alm::perplexityBatch(const vector <string> & texts) const noexcept {
+	// Результат работы функции
+	vector <ppl_t> result(texts.size());
+	// Если список текстов передан
+	if(!texts.empty()){
+		// Список предложений всех текстов
+		vector <vector <size_t>> seqs;
+		// Список индексов текстов которым принадлежат предложения
+		vector <size_t> owners;
+		// Переходим по всему списку текстов
+		for(size_t i = 0; i < texts.size(); i++){
+			// Если текст не пустой
+			if(!texts.at(i).empty()){
+				// Выполняем разбивку текста на предложения
+				this->pplSequences(this->alphabet->convert(texts.at(i)), [i, &seqs, &owners](const vector <size_t> & seq) noexcept {
+					// Добавляем предложение в общий список
+					seqs.push_back(seq);
+					// Запоминаем текст которому принадлежит предложение
+					owners.push_back(i);
+				});
+			}
+		}
+		// Выполняем пакетный расчёт перплексии всех предложений сразу
+		const auto & ppls = this->perplexityBatch(seqs);
+		// Переходим по всем полученным перплексиям предложений
+		for(size_t i = 0; i < ppls.size(); i++){
+			// Получаем перплексию текста которому принадлежит предложение
+			ppl_t & ppl = result.at(owners.at(i));
+			// Объединяем перплексию предложения с перплексией текста
+			ppl = (ppl.words == 0 ? ppls.at(i) : this->pplConcatenate(ppl, ppls.at(i)));
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * perplexityBatch Метод пакетного расчёта перплексии списка последовательностей
+ * @param  seqs список последовательностей для расчёта
+ * @return      список результатов расчёта в порядке последовательностей
+ */
+const std::vector <anyks::Alm::ppl_t> anyks::Alm::perplexityBatch(const vector <vector <size_t>> & seqs) const noexcept {
+	// Результат работы функции
+	vector <ppl_t> result(seqs.size());
+	// Если список последовательностей передан
+	if(!seqs.empty() && (this->size > 0)){
+		// Если включён режим отладки, считаем каждую последовательность отдельно
+		if(this->isOption(options_t::debug)){
+			// Переходим по всему списку последовательностей
+			for(size_t i = 0; i < seqs.size(); i++){
+				// Выполняем расчёт перплексии последовательности
+				result.at(i) = this->perplexity(seqs.at(i));
+			}
+		// Если режим отладки не включён
+		} else {
+			// Проверяем разрешено ли неизвестное слово
+			const bool isAllowUnk = (this->frequency({size_t(token_t::unk)}).first != this->zero);
+			// Если языковая модель не загружена, выходим
+			if(this->frequency({size_t(token_t::finish)}).first == this->zero) return result;
+			// Список индексов последовательностей
+			vector <size_t> order(seqs.size());
+			// Заполняем список индексов
+			std::iota(order.begin(), order.end(), 0);
+			/**
+			 * Сортируем последовательности лексикографически, чтобы
+			 * последовательности с общими префиксами шли подряд
+			 */
+			std::sort(order.begin(), order.end(), [&seqs](const size_t a, const size_t b) noexcept {
+				// Выполняем сравнение последовательностей
+				return (seqs[a] < seqs[b]);
+			});
+			// Предыдущая рассчитанная последовательность
+			const vector <size_t> * prev = nullptr;
+			// Количество рассчитанных позиций предыдущей последовательности
+			size_t ready = 0;
+			/**
+			 * Список весов n-грамм по позициям в последовательности,
+			 * вес позиции зависит только от префикса последовательности до неё
+			 */
+			vector <pair <u_short, double>> weights;
+			// Переходим по всему списку последовательностей
+			for(auto & index : order){
+				// Получаем последовательность
+				const auto & seq = seqs[index];
+				// Если последовательность корректна
+				if((seq.size() > 2) && (seq.front() == size_t(token_t::start)) && (seq.back() == size_t(token_t::finish))){
+					// Получаем результат расчёта последовательности
+					ppl_t & ppl = result[index];
+					// Количество слов в последовательности
+					const size_t count = seq.size();
+					// Определяем конец рассчитываемых позиций (как в методе perplexity)
+					const size_t last = (count >= size_t(this->size) ? count : count - 1);
+					// Длина общего префикса с предыдущей последовательностью
+					size_t common = 0;
+					// Если предыдущая последовательность существует
+					if(prev != nullptr){
+						// Получаем максимально возможную длину общего префикса
+						const size_t length = std::min(ready, std::min(count, prev->size()));
+						// Определяем длину общего префикса
+						while((common < length) && (seq[common] == (* prev)[common])) common++;
+					}
+					// Увеличиваем список весов если это требуется
+					if(weights.size() < last) weights.resize(last);
+					// Переходим по всем нерассчитанным позициям последовательности
+					for(size_t pos = std::max(common, size_t(1)); pos < last; pos++){
+						// Выполняем расчёт веса n-граммы окончивающейся в текущей позиции
+						weights[pos] = this->pplWeight(seq, (pos >= size_t(this->size) ? pos - this->size + 1 : 0), pos + 1, isAllowUnk);
+					}
+					// Сбрасываем значение результата
+					ppl.logprob = 0.0;
+					// Переходим по всем позициям последовательности
+					for(size_t pos = 1; pos < last; pos++){
+						// Если вес получен, увеличиваем общее значение веса
+						if(weights[pos].second != 0.0) ppl.logprob += weights[pos].second;
+						// Увеличиваем количество нулевых весов
+						else ppl.zeroprobs++;
+					}
+					// Если неизвестное слово не разрешено
+					if(!isAllowUnk){
+						// Считаем количество неизвестных слов
+						ppl.oovs = std::count(seq.begin(), seq.end(), size_t(token_t::unk));
+					}
+					// Устанавливаем предложение
+					ppl.sentences = 1;
+					// Устанавливаем количество слов
+					ppl.words = (count - 2);
+					// Если количество нулевых весов и количество неизвестных слов получено
+					if((ppl.oovs > 0) && (ppl.zeroprobs > 0)) ppl.zeroprobs -= ppl.oovs;
+					// Выполняем расчёт перплексии
+					const auto & calc = this->pplCalculate(ppl.logprob, ppl.words, ppl.oovs);
+					// Усталавниваем полученные значения перплексии
+					ppl.ppl  = calc.first;
+					ppl.ppl1 = calc.second;
+					// Запоминаем рассчитанную последовательность
+					prev = &seq;
+					// Запоминаем количество рассчитанных позиций
+					ready = last;
+				}
+			}
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * score Метод расчёта веса слова по состоянию контекста
+ * @param in  входное состояние контекста (пустое для начала расчёта)
+ * @param idw идентификатор слова для расчёта
+ * @param out выходное состояние контекста с добавленным словом
+ * @return    граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::Alm::score(const state_t & in, const size_t idw, state_t & out) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Если размер n-граммы установлен
+	if(this->size > 0){
+		// Проверяем разрешено ли неизвестное слово
+		const bool isAllowUnk = (this->frequency({size_t(token_t::unk)}).first != this->zero);
+		// Копируем контекст входного состояния
+		if(&out != &in) out.context = in.context;
+		// Добавляем слово в контекст
+		out.context.push_back(idw);
+		// Если контекст длиннее n-граммы, удаляем лишние слова
+		if(out.context.size() > size_t(this->size)) out.context.erase(out.context.begin(), out.context.end() - this->size);
+		// Выполняем расчёт веса n-граммы по всему окну
+		result = this->pplWeight(out.context, 0, out.context.size(), isAllowUnk);
+		// Оставляем в контексте не более size - 1 слов
+		if(out.context.size() == size_t(this->size)) out.context.erase(out.context.begin());
+		// Сбрасываем маску суффиксов
+		out.mask = 0;
+		// Сбрасываем обратную частоту
+		out.backoff = 0.0;
+		// Очищаем список узлов
+		out.nodes.clear();
+	}
+	// Выводим результат
+	return result;
+}
 /**
  * pplConcatenate Метод объединения перплексий
  * @param ppl1 первая перплексия
@@ -387,8 +650,6 @@ const anyks::Alm::ppl_t anyks::Alm::pplByFiles(const string & path, function <vo
 	ppl_t result;
 	// Если адрес файла передан
 	if(!path.empty()){
-		// Выполняем инициализацию тредпула
-		this->tpool.init(this->threads);
 		// Параметры индикаторы процесса
 		size_t csize = 0, actual = 0, rate = 0;
 		/**
@@ -411,57 +672,24 @@ const anyks::Alm::ppl_t anyks::Alm::pplByFiles(const string & path, function <vo
 		};
 		/**
 		 * runFn Функция расчёта перплексии
-		 * @param text текст для обработки
-		 * @param size общий размер обрабатываемых данных
+		 * @param text     текст для обработки
+		 * @param readfile обрабатываемый в данный момент файл
+		 * @param size     общий размер обрабатываемых данных
 		 */
-		auto runFn = [&result, &statusFn, this](const string & text, const size_t size){
-			// Если это не первый этап обработки
-			if(result.words != 0){
-				// Выполняем расчёт перплексии
-				ppl_t res = this->perplexity(text);
-				// Выполняем блокировку потока
-				this->locker.lock();
-				// Выполняем сложение перплексий
-				result = this->pplConcatenate(result, res);
-				// Выводим статус прогресса работы
-				statusFn(text.size(), size);
-				// Выполняем разблокировку потока
-				this->locker.unlock();
-			// Если это первый этап обработки
-			} else {
-				// Выполняем расчёт перплексии
-				result = this->perplexity(text);
-				// Выводим статус прогресса работы
-				statusFn(text.size(), size);
-			}
+		auto runFn = [&result, &statusFn, this](const string & text, const string & readfile, const uintmax_t size){
+			// Выполняем расчёт перплексии
+			const ppl_t & res = this->perplexity(text);
+			// Выполняем блокировку потока
+			this->locker.lock();
+			// Если перплексия рассчитана, выполняем сложение перплексий
+			if(res.words > 0) result = (result.words > 0 ? this->pplConcatenate(result, res) : res);
+			// Выводим статус прогресса работы
+			statusFn(text.size(), size);
+			// Выполняем разблокировку потока
+			this->locker.unlock();
 		};
-		// Если это файл
-		if(fsys_t::isfile(path)){
-			// Выполняем загрузку данных текстового файла
-			fsys_t::rfile(path, [&](const string & text, const uintmax_t fileSize) noexcept {
-				// Если текст передан
-				if(!text.empty()){
-					// Если это первый расчёт, считаем его в основном потоке
-					if(result.words == 0) runFn(text, fileSize);
-					// Добавляем в тредпул новое задание на обработку
-					else this->tpool.push(runFn, text, fileSize);
-				}
-			});
-		// Если это каталог
-		} else if(fsys_t::isdir(path)) {
-			// Выполняем загрузку каталога с текстовыми файлами
-			fsys_t::rfdir(path, ext, [&](const string & text, const string & filename, const uintmax_t fileSize, const uintmax_t dirSize) noexcept {
-				// Если текст передан
-				if(!text.empty()){
-					// Если это первый расчёт, считаем его в основном потоке
-					if(result.words == 0) runFn(text, dirSize);
-					// Добавляем в тредпул новое задание на обработку
-					else this->tpool.push(runFn, text, dirSize);
-				}
-			});
-		}
-		// Ожидаем завершения обработки
-		this->tpool.wait();
+		// Выполняем чтение файла или каталога блоками
+		this->byFiles(path, ext, runFn);
 		// Выводим отладочную информацию
 		if(this->isOption(options_t::debug)){
 			// Выводим разделитель
@@ -1180,6 +1408,21 @@ void anyks::Alm::setBin(const vector <char> & buffer) const noexcept {
 	// Блокируем варнинг
 	(void) buffer;
 }
+/**
+ * setBins Метод установки группы буферов бинарных данных в словарь
+ * @param buffers список буферов с бинарными данными в порядке записей
+ */
+void anyks::Alm::setBins(const vector <vector <char>> & buffers) const noexcept {
+	// Устанавливаем буферы по порядку
+	for(auto & buffer : buffers) this->setBin(buffer);
+}
+/**
+ * joinBins Метод завершения групповой установки буферов, останавливает потоки тредпула
+ */
+void anyks::Alm::joinBins() const noexcept {
+	// Ожидаем завершения работы потоков
+	this->tpool.wait();
+}
 /**
  * setBin2 Метод установки бинарных данных в словарь
  * @param buffer буфер с бинарными данными
@@ -1196,6 +1439,17 @@ void anyks::Alm::getBin(function <void (const vector <char> &, const size_t, con
 	// Выводим результат
 	callback({}, 0, 100);
 }
+/**
+ * readMap Метод отображения в память N-грамм и слов из файла словаря
+ * @param filename адрес файла словаря
+ * @return         результат отображения
+ */
+const bool anyks::Alm::readMap(const string & filename) const noexcept {
+	// Блокируем варнинг
+	(void) filename;
+	// Отображение в память не поддерживается
+	return false;
+}
 /**
  * clear Метод очистки всех данных
  */
@@ -1403,6 +1657,8 @@ void anyks::Alm::setUnknown(const string & word) noexcept {
 		this->unknown = this->tokenizer->idw(this->alphabet->convert(word));
 		// Если идентификатор получен
 		if(this->unknown > 0){
+			// Запрашиваем слово, чтобы словарь хранящийся вне объекта успел загрузить его
+			this->getWord(this->unknown);
 			// Если слова нет в словаре, добавляем его
 			if(this->vocab.count(this->unknown) < 1)
 				// Добавляем слово в список
@@ -1865,130 +2121,216 @@ void anyks::Alm::find(const wstring & text, function <void (const wstring &)> ca
 void anyks::Alm::read(const string & filename, function <void (const u_short)> status) noexcept {
 	// Если адрес файла передан
 	if(!filename.empty() && fsys_t::isfile(filename)){
-		// Тип извлечения данных
-		u_short type = 0;
+		/**
+		 * Ngram Структура прочитанной n-граммы
+		 */
+		typedef struct Ngram {
+			// Вес и частота отката n-граммы
+			double weight, backoff;
+			// Границы последовательности n-граммы в списке блока
+			size_t begin, end;
+			// Идентификатор и регистры последнего слова
+			size_t idw, uppers;
+			// Последнее слово n-граммы для добавления в словарь
+			word_t word;
+		} ngram_t;
+		/**
+		 * Chunk Структура разобранного блока файла
+		 */
+		typedef struct Chunk {
+			// Размер блока в байтах
+			size_t size = 0;
+			// Список n-грамм блока
+			vector <ngram_t> ngrams;
+			// Последовательности всех n-грамм блока
+			vector <size_t> seqs;
+		} chunk_t;
 		// Последовательность для добавления
 		vector <size_t> seq;
-		// Список полученных слов последовательности
-		vector <wstring> words;
 		// Текущий и предыдущий статус
 		u_short actual = 0, past = 100;
 		// Количество обработанных данных
-		size_t index = 0, pos = 0, loc = 0;
+		size_t index = 0;
 		// Идентификатор неизвестного слова
 		const size_t uid = (size_t) token_t::unk;
-		// Выполняем считывание всех строк текста
-		fsys_t::rfile(filename, [&](const string & text, const uintmax_t fileSize) noexcept {
-			// Если слово получено
-			if(!text.empty()){
-				// Определяем тип считываемых данных
-				switch(type){
-					// Если получено обозначение заголовка
-					case 0: if(text.find("\\data\\") != string::npos) type++; break;
-					// Если мы дошли до считывания данных слов
-					case 1: if(text.rfind("-grams:") != string::npos) type++; break;
-					// Если это тип считывания данных n-грамм
-					case 2: {
-						// Если мы дошли до конца, выходим
-						if(text.find("\\end\\") != string::npos) break;
-						// Иначе считываем данные n-граммы
-						else if((pos = text.find("\t")) != string::npos){
-							// Обнуляем локальную позицию
-							loc = 0;
-							// Данные n-граммы и обратной частоты документа
-							string ngram = "", backoff = "0.0";
-							// Считываем частоту n-граммы
-							const string & weight = this->alphabet->trim(text.substr(loc, pos));
-							// Запоминаем текущую позицию
-							loc = pos;
-							// Ищем значение n-граммы
-							if((pos = text.find("\t", pos + 1)) != string::npos){
-								// Извлекаем данные n-граммы
-								ngram = this->alphabet->trim(text.substr(loc + 1, pos - (loc + 1)));
-								// Излвлекаем обратную частоту документа
-								backoff = this->alphabet->trim(text.substr(pos + 1, text.length() - (pos + 1)));
-							// Извлекаем данные n-граммы
-							} else ngram = this->alphabet->trim(text.substr(loc + 1, text.length() - (loc + 1)));
-							// Если данные получены
-							if(!ngram.empty() && !weight.empty()){
-								// Очищаем последовательность
-								seq.clear();
-								// Выполняем сплит n-грамм
-								this->alphabet->split(ngram, " ", words);
-								// Если список слов получен
-								if(!words.empty()){
-									// Полученное слово
-									word_t word = L"";
-									// Идентификатор и регистры слова
-									size_t idw = 0, uppers = 0;
-									// Переходим по всему списку слов
-									for(auto & item : words){
-										// Получаем слово
-										word = move(item);
-										// Получаем идентификатор слова
-										idw = this->getIdw(word, !this->isOption(options_t::confidence));
-										// Проверяем отсутствует ли слово в списке запрещённых слов
-										if(this->badwords.count(idw) < 1){
-											// Если это неизвестное слово
-											if(uid == idw){
-												// Если неизвестное слово не установлено
-												if(this->unknown == 0){
-													// Обнуляем регистры слова
-													uppers = 0;
-													// Формируем последовательность
-													seq.push_back(idw);
-												// Если неизвестное слово установлено
-												} else if(this->unknown > 0) {
-													// Формируем последовательность
-													seq.push_back(this->unknown);
-													// Получаем регистры слова
-													uppers = this->vocab.at(this->unknown).getUppers();
-												}
-											// Добавляем слово в список последовательности
-											} else {
-												// Формируем последовательность
-												seq.push_back(idw);
-												// Получаем регистры слова
-												uppers = ((words.size() > 1) && (this->utokens.count(idw) > 0) ? 0 : word.getUppers());
-											}
-										// Если слово найдено в всписке запрещённых
-										} else {
-											// Очищаем последовательность
-											seq.clear();
-											// Выходим из цикла
-											break;
-										}
-									}
-									// Если количество собранных n-грамм выше установленных, меняем
-									if(seq.size() > size_t(this->size)) this->size = seq.size();
-									// Добавляем последовательность в словарь
-									if(!seq.empty()){
-										// Проверяем отсутствует ли слово в списке запрещённых слов
-										if(!this->tokenizer->isToken(idw) && (this->badwords.count(idw) < 1)) this->addWord(idw, word);
-										// Добавляем последовательность в языковую модель
-										this->set(seq, uppers, stod(weight), stod(backoff));
-									}
-								}
-							}
+		// Флаг проверки слов при получении идентификатора
+		const bool check = !this->isOption(options_t::confidence);
+		/**
+		 * trimFn Функция удаления пробелов по краям строки без копирования
+		 * @param text строка для обработки
+		 * @return     строка без пробелов по краям
+		 */
+		auto trimFn = [](std::string_view text) noexcept {
+			// Удаляем пробелы в начале строки
+			while(!text.empty() && isspace(text.front())) text.remove_prefix(1);
+			// Удаляем пробелы в конце строки
+			while(!text.empty() && isspace(text.back())) text.remove_suffix(1);
+			// Выводим результат
+			return text;
+		};
+		/**
+		 * parseFn Функция разбора строки n-граммы
+		 * @param line  строка для разбора
+		 * @param chunk блок в который добавляется n-грамма
+		 * @param word  слово, переиспользуемое для всех слов блока
+		 */
+		auto parseFn = [&](const std::string_view & line, chunk_t & chunk, word_t & word) noexcept {
+			// Получаем позицию разделителя веса
+			const size_t pos = line.find('\t');
+			// Если разделитель найден
+			if(pos != std::string_view::npos){
+				// Прочитанная n-грамма
+				ngram_t ngram;
+				// Данные n-граммы и частоты отката
+				std::string_view text = "", backoff = "";
+				// Считываем частоту n-граммы
+				const std::string_view weight = trimFn(line.substr(0, pos));
+				// Ищем значение частоты отката
+				const size_t loc = line.find('\t', pos + 1);
+				// Если частота отката найдена
+				if(loc != std::string_view::npos){
+					// Извлекаем данные n-граммы
+					text = trimFn(line.substr(pos + 1, loc - (pos + 1)));
+					// Излвлекаем обратную частоту документа
+					backoff = trimFn(line.substr(loc + 1));
+				// Извлекаем данные n-граммы
+				} else text = trimFn(line.substr(pos + 1));
+				// Если данные не получены или вес не является числом, пропускаем строку
+				if(text.empty() || weight.empty() || (std::from_chars(weight.data(), weight.data() + weight.size(), ngram.weight).ec != std::errc())) return;
+				// Если частота отката не получена, устанавливаем её нулевой
+				if(backoff.empty() || (std::from_chars(backoff.data(), backoff.data() + backoff.size(), ngram.backoff).ec != std::errc())) ngram.backoff = 0.0;
+				// Получаем текст n-граммы
+				const wstring & ngramText = this->alphabet->convert(string(text));
+				// Получаем количество слов в n-грамме
+				const size_t count = (std::count(ngramText.begin(), ngramText.end(), L' ') + 1);
+				// Запоминаем начало последовательности
+				ngram.begin = chunk.seqs.size();
+				// Идентификатор и регистры слова
+				size_t idw = 0, uppers = 0;
+				// Переходим по всем словам n-граммы
+				for(size_t i = 0, j = 0; i <= ngramText.size(); i = (j + 1)){
+					// Ищем конец слова
+					if((j = ngramText.find(L' ', i)) == wstring::npos) j = ngramText.size();
+					// Если слово пустое, пропускаем его
+					if(j == i) continue;
+					// Получаем слово
+					word.assign(ngramText.data() + i, j - i);
+					// Получаем идентификатор слова
+					idw = this->getIdw(word, check);
+					// Если слово найдено в всписке запрещённых, пропускаем n-грамму
+					if(this->badwords.count(idw) > 0){
+						// Удаляем последовательность n-граммы
+						chunk.seqs.resize(ngram.begin);
+						// Выходим
+						return;
+					}
+					// Если это неизвестное слово
+					if(uid == idw){
+						// Если неизвестное слово не установлено
+						if(this->unknown == 0){
+							// Обнуляем регистры слова
+							uppers = 0;
+							// Формируем последовательность
+							chunk.seqs.push_back(idw);
+						// Если неизвестное слово установлено
+						} else if(this->unknown > 0) {
+							// Формируем последовательность
+							chunk.seqs.push_back(this->unknown);
+							// Получаем регистры слова
+							uppers = this->vocab.at(this->unknown).getUppers();
 						}
-					} break;
+					// Добавляем слово в список последовательности
+					} else {
+						// Формируем последовательность
+						chunk.seqs.push_back(idw);
+						// Получаем регистры слова
+						uppers = ((count > 1) && (this->utokens.count(idw) > 0) ? 0 : word.getUppers());
+					}
 				}
+				// Запоминаем конец последовательности
+				ngram.end = chunk.seqs.size();
+				// Запоминаем идентификатор последнего слова
+				ngram.idw = idw;
+				// Запоминаем регистры последнего слова
+				ngram.uppers = uppers;
+				// Если последнее слово не является токеном, запоминаем его для словаря
+				if(!this->tokenizer->isToken(idw)) ngram.word = word;
+				// Добавляем n-грамму в блок
+				if(ngram.end > ngram.begin) chunk.ngrams.push_back(std::move(ngram));
 			}
-			// Если функция вывода статуса передана
-			if(status != nullptr){
-				// Увеличиваем количество записанных n-грамм
-				index += text.size();
-				// Выполняем расчёт текущего статуса
-				actual = u_short(index / double(fileSize) * 100.0);
-				// Если статус обновился
-				if(actual != past){
-					// Запоминаем текущий статус
-					past = actual;
-					// Выводим статус извлечения
-					status(actual);
+		};
+		// Выполняем инициализацию тредпула
+		this->tpool.init(this->threads);
+		/**
+		 * Выполняем отображение файла в памяти, блоки разбираются параллельно,
+		 * а n-граммы добавляются последовательно в порядке файла.
+		 */
+		fsys_t::rarpa(filename, 0x400000, [&](const vector <std::string_view> & chunks, const uintmax_t fileSize) noexcept {
+			// Количество блоков разбираемых за один проход
+			const size_t window = (max(this->threads, size_t(1)) * 2);
+			// Разобранные блоки
+			vector <chunk_t> parsed(window);
+			// Переходим по всем блокам проходами
+			for(size_t first = 0; first < chunks.size(); first += window){
+				// Получаем конец прохода
+				const size_t last = min(first + window, chunks.size());
+				// Выполняем разбор блоков параллельно
+				this->tpool.parallel_for(first, last, [&](const size_t begin, const size_t end){
+					// Слово, переиспользуемое для всех слов блока
+					word_t word = L"";
+					// Переходим по всем блокам
+					for(size_t i = begin; i < end; i++){
+						// Получаем разобранный блок
+						chunk_t & chunk = parsed[i - first];
+						// Очищаем список n-грамм
+						chunk.ngrams.clear();
+						// Очищаем последовательности
+						chunk.seqs.clear();
+						// Запоминаем размер блока
+						chunk.size = chunks[i].size();
+						// Переходим по всем строкам блока
+						fsys_t::lines(chunks[i], [&](const std::string_view & line){
+							// Выполняем разбор строки
+							parseFn(line, chunk, word);
+						});
+					}
+				}, 1);
+				// Добавляем разобранные n-граммы в порядке файла
+				for(size_t i = first; i < last; i++){
+					// Получаем разобранный блок
+					const chunk_t & chunk = parsed[i - first];
+					// Переходим по всем n-граммам блока
+					for(auto & ngram : chunk.ngrams){
+						// Получаем последовательность n-граммы
+						seq.assign(chunk.seqs.begin() + ngram.begin, chunk.seqs.begin() + ngram.end);
+						// Если количество собранных n-грамм выше установленных, меняем
+						if(seq.size() > size_t(this->size)) this->size = seq.size();
+						// Добавляем слово в словарь
+						if(!ngram.word.empty()) this->addWord(ngram.idw, ngram.word);
+						// Добавляем последовательность в языковую модель
+						this->set(seq, ngram.uppers, ngram.weight, ngram.backoff);
+					}
+					// Если функция вывода статуса передана
+					if(status != nullptr){
+						// Увеличиваем количество обработанных данных
+						index += chunk.size;
+						// Выполняем расчёт текущего статуса
+						actual = u_short(index / double(fileSize) * 100.0);
+						// Если статус обновился
+						if(actual != past){
+							// Запоминаем текущий статус
+							past = actual;
+							// Выводим статус извлечения
+							status(actual);
+						}
+					}
 				}
 			}
 		});
+		// Ожидаем завершения обработки
+		this->tpool.wait();
+		// Заголовок файла в блоки не входит, поэтому завершаем вывод статуса
+		if((status != nullptr) && (actual != 100)) status(100);
 	// Выводим сообщение об ошибке
 	} else if(this->isOption(options_t::debug)) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "arpa file is not exist");
 }
@@ -2105,25 +2447,8 @@ void anyks::Alm::findByFiles(const string & path, const string & filename, funct
 				this->locker.unlock();
 			}
 		};
-		// Выполняем инициализацию тредпула
-		this->tpool.init(this->threads);
-		// Если это файл
-		if(fsys_t::isfile(path)){
-			// Выполняем считывание всех строк текста
-			fsys_t::rfile(path, [&path, &runFn, this](const string & text, const uintmax_t fileSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, path, fileSize);
-			});
-		// Если это каталог
-		} else if(fsys_t::isdir(path)) {
-			// Выполняем загрузку каталога с текстовыми файлами
-			fsys_t::rfdir(path, ext, [&](const string & text, const string & filename, const uintmax_t fileSize, const uintmax_t dirSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, filename, dirSize);
-			});
-		}
-		// Ожидаем завершения обработки
-		this->tpool.wait();
+		// Выполняем чтение файла или каталога блоками
+		this->byFiles(path, ext, runFn);
 	}
 }
 /**
@@ -2182,25 +2507,8 @@ void anyks::Alm::fixUppersByFiles(const string & path, const string & filename,
 				this->locker.unlock();
 			}
 		};
-		// Выполняем инициализацию тредпула
-		this->tpool.init(this->threads);
-		// Если это файл
-		if(fsys_t::isfile(path)){
-			// Выполняем считывание всех строк текста
-			fsys_t::rfile(path, [&path, &runFn, this](const string & text, const uintmax_t fileSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, path, fileSize);
-			});
-		// Если это каталог
-		} else if(fsys_t::isdir(path)) {
-			// Выполняем загрузку каталога с текстовыми файлами
-			fsys_t::rfdir(path, ext, [&](const string & text, const string & filename, const uintmax_t fileSize, const uintmax_t dirSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, filename, dirSize);
-			});
-		}
-		// Ожидаем завершения обработки
-		this->tpool.wait();
+		// Выполняем чтение файла или каталога блоками
+		this->byFiles(path, ext, runFn);
 	}
 }
 /**
@@ -2297,25 +2605,8 @@ void anyks::Alm::countsByFiles(const string & path, const string & filename, con
 				this->locker.unlock();
 			}
 		};
-		// Выполняем инициализацию тредпула
-		this->tpool.init(this->threads);
-		// Если это файл
-		if(fsys_t::isfile(path)){
-			// Выполняем считывание всех строк текста
-			fsys_t::rfile(path, [&path, &runFn, this](const string & text, const uintmax_t fileSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, path, fileSize);
-			});
-		// Если это каталог
-		} else if(fsys_t::isdir(path)) {
-			// Выполняем загрузку каталога с текстовыми файлами
-			fsys_t::rfdir(path, ext, [&](const string & text, const string & filename, const uintmax_t fileSize, const uintmax_t dirSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, filename, dirSize);
-			});
-		}
-		// Ожидаем завершения обработки
-		this->tpool.wait();
+		// Выполняем чтение файла или каталога блоками
+		this->byFiles(path, ext, runFn);
 		// Выводим сообщение об общем количестве обработанных n-грамм в консоль
 		this->alphabet->log("Counts %hugrams: %zu\r\n", alphabet_t::log_t::null, nullptr, (ngrams == 1 ? this->size : ngrams), count);
 		// Выводим сообщение об общем количестве обработанных n-грамм в файл
@@ -2380,25 +2671,8 @@ void anyks::Alm::checkByFiles(const string & path, const string & filename, cons
 				this->locker.unlock();
 			}
 		};
-		// Выполняем инициализацию тредпула
-		this->tpool.init(this->threads);
-		// Если это файл
-		if(fsys_t::isfile(path)){
-			// Выполняем считывание всех строк текста
-			fsys_t::rfile(path, [&path, &runFn, this](const string & text, const uintmax_t fileSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, path, fileSize);
-			});
-		// Если это каталог
-		} else if(fsys_t::isdir(path)) {
-			// Выполняем загрузку каталога с текстовыми файлами
-			fsys_t::rfdir(path, ext, [&](const string & text, const string & filename, const uintmax_t fileSize, const uintmax_t dirSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, filename, dirSize);
-			});
-		}
-		// Ожидаем завершения обработки
-		this->tpool.wait();
+		// Выполняем чтение файла или каталога блоками
+		this->byFiles(path, ext, runFn);
 		// Выводим сообщение об общем количестве обработанных предложений
 		this->alphabet->log("All texts: %zu\r\nExists texts: %zu\r\nNot exists texts: %zu\r\n", alphabet_t::log_t::null, nullptr, count, exists, count - exists);
 		// Выполняем запись в файл
@@ -2463,25 +2737,8 @@ void anyks::Alm::checkByFiles(const string & path, const string & filename, cons
 				this->locker.unlock();
 			}
 		};
-		// Выполняем инициализацию тредпула
-		this->tpool.init(this->threads);
-		// Если это файл
-		if(fsys_t::isfile(path)){
-			// Выполняем считывание всех строк текста
-			fsys_t::rfile(path, [&path, &runFn, this](const string & text, const uintmax_t fileSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, path, fileSize);
-			});
-		// Если это каталог
-		} else if(fsys_t::isdir(path)) {
-			// Выполняем загрузку каталога с текстовыми файлами
-			fsys_t::rfdir(path, ext, [&](const string & text, const string & filename, const uintmax_t fileSize, const uintmax_t dirSize) noexcept {
-				// Выполняем обработку
-				this->tpool.push(runFn, text, filename, dirSize);
-			});
-		}
-		// Ожидаем завершения обработки
-		this->tpool.wait();
+		// Выполняем чтение файла или каталога блоками
+		this->byFiles(path, ext, runFn);
 		// Выводим сообщение об общем количестве обработанных предложений
 		this->alphabet->log("All texts: %zu\r\nExists texts: %zu\r\nNot exists texts: %zu\r\n", alphabet_t::log_t::null, nullptr, count, exists, count - exists);
 		// Выполняем запись в файл
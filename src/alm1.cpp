@@ -139,6 +139,66 @@ const std::pair <double, double> anyks::Alm1::frequency(const vector <size_t> &
 	// Выводим результат
 	return result;
 }
+/**
+ * pplWeight Метод расчёта веса окна последовательности без его копирования
+ * @param seq   последовательность слов в которой находится окно
+ * @param begin позиция начала окна в последовательности
+ * @param end   позиция конца окна в последовательности (не включительно)
+ * @param unk   разрешено ли неизвестное слово
+ * @return      граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::Alm1::pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Позиция первого слова окна
+	size_t first = begin;
+	// Если неизвестное слово не разрешено, пропускаем все первые неизвестные слова
+	if(!unk) while((first < end) && (seq[first] == size_t(token_t::unk))) first++;
+	// Если есть еще смысл искать
+	if(first < end){
+		// Копируем основную карту
+		const arpa_t * obj = &this->arpa;
+		// Переходим по всему окну последовательности
+		for(size_t i = first; i < end; i++){
+			// Ищем нашу n-грамму
+			auto it = obj->find(seq[i]);
+			// Если n-грамма найдена
+			if(it != obj->end()){
+				// Запоминаем следующую n-грамму
+				obj = &it->second;
+				// Запоминаем вес n-граммы
+				if(obj->weight != this->zero) result.second = obj->weight;
+			// Если n-грамма не найдена
+			} else {
+				// Если последнее слово последовательности найдено
+				if(this->arpa.count(seq[end - 1]) > 0){
+					// Копируем окно последовательности только для расчёта отката
+					vector <size_t> tmp(seq.begin() + first, seq.begin() + end);
+					// Получаем вес последовательности
+					const auto & wrs = this->weight(tmp);
+					// Получаем грамность
+					result.first = wrs.first;
+					// Запоминаем полученный вес
+					result.second = wrs.second;
+					// Если вес получен для юниграммы, выполняем поиск частоты отката
+					if(result.first == 1){
+						// Удаляем последнее слово для извлечения обратной частоты
+						tmp.pop_back();
+						// Выполняем расчёт веса n-граммы
+						result.second += this->backoff(tmp);
+					}
+				// Если слово не найдено, устанавливаем -inf
+				} else result.second = 0.0;
+				// Выходим из цикла
+				break;
+			}
+			// Увеличиваем граммность
+			result.first++;
+		}
+	}
+	// Выводим результат
+	return result;
+}
 /**
  * set Метод установки последовательности в словарь
  * @param seq последовательность слов для установки
@@ -288,63 +348,8 @@ const anyks::Alm::ppl_t anyks::Alm1::perplexity(const vector <size_t> & seq) con
 		 * @return    вес n-граммы
 		 */
 		auto calcFn = [isAllowUnk, this](const vector <size_t> & seq) noexcept {
-			// Результат работы функции
-			pair <u_short, double> result = {0, 0.0};
-			// Если данные не пустые
-			if(!seq.empty()){
-				// Получаем нашу последовательность
-				vector <size_t> tmp = seq;
-				// Если первый элемент является неизвестным словом, удаляем его
-				if(!isAllowUnk){
-					// Удаляем все первые неизвестные слова
-					while(!tmp.empty() && (tmp.front() == size_t(token_t::unk))){
-						// Удаляем первый элемент в списке
-						tmp.assign(tmp.begin() + 1, tmp.end());
-					}
-				}
-				// Если есть еще смысл искать
-				if(!tmp.empty()){
-					// Копируем основную карту
-					const arpa_t * obj = &this->arpa;
-					// Переходим по всей последовательностив
-					for(auto & idw : tmp){
-						// Ищем нашу n-грамму
-						auto it = obj->find(idw);
-						// Если n-грамма найдена
-						if(it != obj->end()){
-							// Запоминаем следующую n-грамму
-							obj = &it->second;
-							// Запоминаем вес n-граммы
-							if(obj->weight != this->zero) result.second = obj->weight;
-						// Если n-грамма не найдена
-						} else {
-							// Если последнее слово последовательности найдено
-							if(this->arpa.count(tmp.back()) > 0){
-								// Получаем вес последовательности
-								const auto & wrs = this->weight(tmp);
-								// Получаем грамность
-								result.first = wrs.first;
-								// Запоминаем полученный вес
-								result.second = wrs.second;
-								// Если вес получен для юниграммы, выполняем поиск частоты отката
-								if(result.first == 1){
-									// Получаем список последовательности для извлечения обратной частоты
-									tmp.assign(tmp.begin(), tmp.end() - 1);
-									// Выполняем расчёт веса n-граммы
-									result.second += this->backoff(tmp);
-								}
-							// Если слово не найдено, устанавливаем -inf
-							} else result.second = 0.0;
-							// Выходим из цикла
-							break;
-						}
-						// Увеличиваем граммность
-						result.first++;
-					}
-				}
-			}
-			// Выводим результат
-			return result;
+			// Выполняем расчёт веса n-граммы по всей последовательности
+			return this->pplWeight(seq, 0, seq.size(), isAllowUnk);
 		};
 		/**
 		 * putDebugFn Функция расчёта отладочной информации
@@ -502,6 +507,137 @@ const anyks::Alm::ppl_t anyks::Alm1::perplexity(const vector <size_t> & seq) con
 	// Выводим результат
 	return result;
 }
+/**
+ * score Метод расчёта веса слова по состоянию контекста
+ * @param in  входное состояние контекста (пустое для начала расчёта)
+ * @param idw идентификатор слова для расчёта
+ * @param out выходное состояние контекста с добавленным словом
+ * @return    граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::Alm1::score(const state_t & in, const size_t idw, state_t & out) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Если словарь не пустой
+	if(!this->arpa.empty() && (this->size > 0)){
+		// Количество слов в контексте
+		const size_t count = in.context.size();
+		// Если состояние совпадает с выходным или не рассчитано этим словарём
+		if((&in == &out) || (in.nodes.size() != count) || (count >= size_t(this->size))){
+			// Копируем входное состояние
+			state_t state = in;
+			// Если контекст длиннее n-граммы, удаляем лишние слова
+			if(count >= size_t(this->size)) state.context.erase(state.context.begin(), state.context.end() - (this->size - 1));
+			// Сбрасываем обратную частоту
+			state.backoff = 0.0;
+			// Сбрасываем список узлов
+			state.nodes.assign(state.context.size(), nullptr);
+			// Переходим по всем суффиксам контекста, начиная с самого короткого
+			for(size_t j = state.context.size(); j > 0; j--){
+				// Копируем основную карту
+				const arpa_t * obj = &this->arpa;
+				// Переходим по всему суффиксу контекста
+				for(size_t i = (j - 1); (obj != nullptr) && (i < state.context.size()); i++){
+					// Ищем нашу n-грамму
+					auto it = obj->find(state.context[i]);
+					// Запоминаем найденную n-грамму
+					obj = (it != obj->end() ? &it->second : nullptr);
+				}
+				// Запоминаем узел суффикса
+				state.nodes[j - 1] = obj;
+				// Если суффикс найден, увеличиваем обратную частоту
+				if((obj != nullptr) && (obj->backoff != this->zero)) state.backoff = (obj->backoff + state.backoff);
+			}
+			// Выполняем расчёт по восстановленному состоянию
+			return this->score(state, idw, out);
+		}
+		// Проверяем разрешено ли неизвестное слово
+		const bool isAllowUnk = (this->frequency({size_t(token_t::unk)}).first != this->zero);
+		// Позиция первого слова окна
+		size_t first = 0;
+		// Если неизвестное слово не разрешено, пропускаем все первые неизвестные слова
+		if(!isAllowUnk) while((first < count) && (in.context[first] == size_t(token_t::unk))) first++;
+		// Копируем контекст входного состояния
+		out.context = in.context;
+		// Добавляем слово в контекст
+		out.context.push_back(idw);
+		// Выделяем память для узлов суффиксов
+		out.nodes.resize(count + 1);
+		// Переходим по всем суффиксам контекста и ищем в них слово
+		for(size_t j = 0; j <= count; j++){
+			// Получаем узел суффикса контекста
+			const arpa_t * obj = (j < count ? static_cast <const arpa_t *> (in.nodes[j]) : &this->arpa);
+			// Если узел суффикса существует
+			if(obj != nullptr){
+				// Ищем нашу n-грамму
+				auto it = obj->find(idw);
+				// Запоминаем найденную n-грамму
+				obj = (it != obj->end() ? &it->second : nullptr);
+			}
+			// Запоминаем узел нового суффикса
+			out.nodes[j] = obj;
+		}
+		// Если окно не состоит только из неизвестных слов
+		if(isAllowUnk || (first < count) || (idw != size_t(token_t::unk))){
+			// Получаем узел всего окна
+			const arpa_t * obj = static_cast <const arpa_t *> (out.nodes[first]);
+			// Если всё окно найдено, запоминаем его вес
+			if((obj != nullptr) && (obj->weight != this->zero)) result = std::make_pair(u_short(count - first + 1), obj->weight);
+			// Если окно не найдено, но последнее слово известно
+			else if((obj == nullptr) && (this->arpa.count(idw) > 0)) {
+				// Переходим по всем более коротким суффиксам окна
+				for(size_t j = (first + 1); j <= count; j++){
+					// Получаем узел суффикса
+					obj = static_cast <const arpa_t *> (out.nodes[j]);
+					// Если суффикс найден и имеет вес
+					if((obj != nullptr) && (obj->weight != this->zero)){
+						// Формируем полученный вес n-граммы
+						result = std::make_pair(u_short(count - j + 1), obj->weight);
+						// Выходим из цикла
+						break;
+					}
+				}
+				// Если вес получен для юниграммы, выполняем поиск частоты отката
+				if(result.first == 1){
+					// Обратная частота контекста окна
+					double backoff = in.backoff;
+					// Если начало контекста было пропущено, считаем обратную частоту заново
+					if(first > 0){
+						// Сбрасываем обратную частоту
+						backoff = 0.0;
+						// Переходим по всем суффиксам контекста окна, начиная с самого короткого
+						for(size_t j = count; j > first; j--){
+							// Получаем узел суффикса
+							obj = static_cast <const arpa_t *> (in.nodes[j - 1]);
+							// Если суффикс найден, увеличиваем обратную частоту
+							if((obj != nullptr) && (obj->backoff != this->zero)) backoff = (obj->backoff + backoff);
+						}
+					}
+					// Выполняем расчёт веса n-граммы
+					result.second += backoff;
+				}
+			// Иначе выполняем полный расчёт веса окна
+			} else result = this->pplWeight(out.context, 0, out.context.size(), isAllowUnk);
+		}
+		// Если контекст достиг размера n-граммы
+		if(out.context.size() == size_t(this->size)){
+			// Удаляем первое слово контекста
+			out.context.erase(out.context.begin());
+			// Удаляем узел первого суффикса
+			out.nodes.erase(out.nodes.begin());
+		}
+		// Сбрасываем обратную частоту
+		out.backoff = 0.0;
+		// Переходим по всем суффиксам нового контекста, начиная с самого короткого
+		for(size_t j = out.nodes.size(); j > 0; j--){
+			// Получаем узел суффикса
+			const arpa_t * obj = static_cast <const arpa_t *> (out.nodes[j - 1]);
+			// Если суффикс найден, увеличиваем обратную частоту
+			if((obj != nullptr) && (obj->backoff != this->zero)) out.backoff = (obj->backoff + out.backoff);
+		}
+	}
+	// Выводим результат
+	return result;
+}
 /**
  * check Метод проверки существования последовательности, с указанным шагом
  * @param seq  список слов последовательности
@@ -807,6 +943,97 @@ void anyks::Alm1::setBin(const vector <char> & buffer) const noexcept {
 		}
 	}
 }
+/**
+ * setBins Метод установки группы буферов бинарных данных в словарь
+ * @param buffers список буферов с бинарными данными в порядке записей
+ */
+void anyks::Alm1::setBins(const vector <vector <char>> & buffers) const noexcept {
+	// Количество шардов по первому слову последовательности
+	const size_t shards = this->threads;
+	// Если потоков меньше двух, устанавливаем буферы по порядку
+	if((shards < 2) || (this->size == 0)) alm_t::setBins(buffers);
+	// Иначе устанавливаем последовательности параллельно по шардам первого слова
+	else if(!buffers.empty()) {
+		// Смещения последовательностей каждого шарда в каждом буфере
+		vector <vector <size_t>> offsets(buffers.size() * shards);
+		// Первые слова последовательностей каждого буфера
+		vector <vector <size_t>> firsts(buffers.size());
+		// Запускаем потоки тредпула, если они ещё не запущены, останавливаются они в joinBins
+		this->tpool.init(this->threads);
+		// Размечаем последовательности всех буферов по шардам
+		this->tpool.parallel_for(0, buffers.size(), [&](const size_t first, const size_t last){
+			// Первое слово последовательности
+			seq_t sequence;
+			// Количество слов в последовательности
+			u_short count = 0;
+			// Переходим по всем буферам блока
+			for(size_t i = first; i < last; i++){
+				// Смещение в буфере
+				size_t offset = 0;
+				// Получаем данные буфера
+				const char * data = buffers[i].data();
+				// Выполняем перебор данных всего буфера
+				while(offset < buffers[i].size()){
+					// Извлекаем количество слов в последовательности
+					memcpy(&count, data + offset, sizeof(count));
+					// Если последовательность получена
+					if(count > 0){
+						// Извлекаем данные первого слова
+						memcpy(&sequence, data + offset + sizeof(count), sizeof(sequence));
+						// Запоминаем смещение последовательности в её шарде
+						offsets[i * shards + (sequence.idw % shards)].push_back(offset);
+						// Последовательности идут в порядке обхода дерева, поэтому первые слова повторяются подряд
+						if(firsts[i].empty() || (firsts[i].back() != sequence.idw)) firsts[i].push_back(sequence.idw);
+					}
+					// Увеличиваем смещение
+					offset += (sizeof(count) + (count * sizeof(sequence)));
+				}
+			}
+		}, 1);
+		// Добавляем первые слова заранее, после этого корень словаря только читается
+		for(auto & words : firsts){
+			// Добавляем все первые слова буфера
+			for(auto & idw : words) this->arpa.emplace(idw, arpa_t());
+		}
+		// Устанавливаем последовательности, каждый шард изменяет только свои ветки словаря
+		this->tpool.parallel_for(0, shards, [&](const size_t first, const size_t last){
+			// Полученная последовательность
+			seq_t sequence;
+			// Количество слов в последовательности
+			u_short count = 0;
+			// Переходим по всем шардам блока
+			for(size_t shard = first; shard < last; shard++){
+				// Переходим по всем буферам по порядку
+				for(size_t i = 0; i < buffers.size(); i++){
+					// Получаем данные буфера
+					const char * data = buffers[i].data();
+					// Переходим по всем последовательностям шарда в буфере
+					for(auto & offset : offsets[i * shards + shard]){
+						// Извлекаем количество слов в последовательности
+						memcpy(&count, data + offset, sizeof(count));
+						// Текущий узел словаря
+						arpa_t * obj = nullptr;
+						// Переходим по всем словам последовательности
+						for(u_short j = 0; j < count; j++){
+							// Извлекаем данные слова
+							memcpy(&sequence, data + offset + sizeof(count) + (j * sizeof(sequence)), sizeof(sequence));
+							// Первое слово уже добавлено, остальные добавляем в ветку шарда
+							obj = (j == 0 ? &this->arpa.find(sequence.idw)->second : &obj->emplace(sequence.idw, arpa_t()).first->second);
+							// Запоминаем количество документов
+							obj->weight = sequence.weight;
+							// Запоминаем встречаемость так-как она есть
+							obj->backoff = sequence.backoff;
+							// Если регистры слова переданы, считаем их
+							if(sequence.ups > 0) obj->uppers = sequence.ups;
+							// Если количество n-грамм достигло предела, выходим
+							if((j + 1) > (this->size - 1)) break;
+						}
+					}
+				}
+			}
+		}, 1);
+	}
+}
 /**
  * setBin2 Метод установки бинарных данных в словарь
  * @param buffer буфер с бинарными данными
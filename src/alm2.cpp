@@ -125,6 +125,64 @@ const std::pair <double, double> anyks::Alm2::frequency(const vector <size_t> &
 	// Выводим результат
 	return result;
 }
+/**
+ * pplWeight Метод расчёта веса окна последовательности без его копирования
+ * @param seq   последовательность слов в которой находится окно
+ * @param begin позиция начала окна в последовательности
+ * @param end   позиция конца окна в последовательности (не включительно)
+ * @param unk   разрешено ли неизвестное слово
+ * @return      граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::Alm2::pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Позиция первого слова окна
+	size_t first = begin;
+	// Если неизвестное слово не разрешено, пропускаем все первые неизвестные слова
+	if(!unk) while((first < end) && (seq[first] == size_t(token_t::unk))) first++;
+	// Если есть еще смысл искать
+	if(first < end){
+		// Список последовательности
+		vector <size_t> tmp;
+		// Резервируем память под окно последовательности
+		tmp.reserve(end - first);
+		// Переходим по всему окну последовательности
+		for(size_t i = first; i < end; i++){
+			// Формируем последовательность
+			tmp.push_back(seq[i]);
+			// Получаем частоту последовательности
+			result.second = this->frequency(tmp).first;
+			// Если последовательность не существует
+			if((seq[i] != size_t(token_t::start)) && (seq[i] != size_t(token_t::unk)) && (result.second == this->zero)){
+				// Если последнее слово последовательности существует
+				if(this->exist({seq[end - 1]})){
+					// Формируем окно последовательности целиком
+					tmp.assign(seq.begin() + first, seq.begin() + end);
+					// Получаем вес последовательности
+					const auto & wrs = this->weight(tmp);
+					// Получаем грамность
+					result.first = wrs.first;
+					// Запоминаем полученный вес
+					result.second = wrs.second;
+					// Если вес получен для юниграммы, выполняем поиск частоты отката
+					if(result.first == 1){
+						// Удаляем последнее слово для извлечения обратной частоты
+						tmp.pop_back();
+						// Выполняем расчёт веса n-граммы
+						result.second += this->backoff(tmp);
+					}
+				// Если слово не найдено, устанавливаем -inf
+				} else result.second = 0.0;
+				// Выходим из цикла
+				break;
+			}
+			// Увеличиваем граммность
+			result.first++;
+		}
+	}
+	// Выводим результат
+	return result;
+}
 /**
  * set Метод установки последовательности в словарь
  * @param seq последовательность слов для установки
@@ -270,59 +328,8 @@ const anyks::Alm::ppl_t anyks::Alm2::perplexity(const vector <size_t> & seq) con
 		 * @return    вес n-граммы
 		 */
 		auto calcFn = [isAllowUnk, this](const vector <size_t> & seq) noexcept {
-			// Результат работы функции
-			pair <u_short, double> result = {0, 0.0};
-			// Если данные не пустые
-			if(!seq.empty()){
-				// Получаем нашу последовательность
-				vector <size_t> tmp = seq;
-				// Если первый элемент является неизвестным словом, удаляем его
-				if(!isAllowUnk){
-					// Удаляем все первые неизвестные слова
-					while(!tmp.empty() && (tmp.front() == size_t(token_t::unk))){
-						// Удаляем первый элемент в списке
-						tmp.assign(tmp.begin() + 1, tmp.end());
-					}
-				}
-				// Если есть еще смысл искать
-				if(!tmp.empty()){
-					// Список последовательности
-					vector <size_t> seq;
-					// Переходим по всей последовательностив
-					for(auto & idw : tmp){
-						// Формируем последовательность
-						seq.push_back(idw);
-						// Получаем частоту последовательности
-						result.second = this->frequency(seq).first;
-						// Если последовательность не существует
-						if((idw != size_t(token_t::start)) && (idw != size_t(token_t::unk)) && (result.second == this->zero)){
-							// Если последнее слово последовательности существует
-							if(this->exist({tmp.back()})){
-								// Получаем вес последовательности
-								const auto & wrs = this->weight(tmp);
-								// Получаем грамность
-								result.first = wrs.first;
-								// Запоминаем полученный вес
-								result.second = wrs.second;
-								// Если вес получен для юниграммы, выполняем поиск частоты отката
-								if(result.first == 1){
-									// Получаем список последовательности для извлечения обратной частоты
-									tmp.assign(tmp.begin(), tmp.end() - 1);
-									// Выполняем расчёт веса n-граммы
-									result.second += this->backoff(tmp);
-								}
-							// Если слово не найдено, устанавливаем -inf
-							} else result.second = 0.0;
-							// Выходим из цикла
-							break;
-						}
-						// Увеличиваем граммность
-						result.first++;
-					}
-				}
-			}
-			// Выводим результат
-			return result;
+			// Выполняем расчёт веса n-граммы по всей последовательности
+			return this->pplWeight(seq, 0, seq.size(), isAllowUnk);
 		};
 		/**
 		 * putDebugFn Функция расчёта отладочной информации
@@ -480,6 +487,190 @@ const anyks::Alm::ppl_t anyks::Alm2::perplexity(const vector <size_t> & seq) con
 	// Выводим результат
 	return result;
 }
+/**
+ * score Метод расчёта веса слова по состоянию контекста
+ * @param in  входное состояние контекста (пустое для начала расчёта)
+ * @param idw идентификатор слова для расчёта
+ * @param out выходное состояние контекста с добавленным словом
+ * @return    граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::Alm2::score(const state_t & in, const size_t idw, state_t & out) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Если словарь не пустой
+	if(!this->arpa.empty() && (this->size > 0)){
+		// Если n-грамма не помещается в маску суффиксов, выполняем расчёт общим методом
+		if(size_t(this->size) > (sizeof(size_t) * 8)) return alm_t::score(in, idw, out);
+		// Количество слов в контексте
+		const size_t count = in.context.size();
+		// Временная последовательность
+		vector <size_t> tmp;
+		// Выделяем память для временной последовательности
+		tmp.reserve(count + 1);
+		/**
+		 * findFn Функция поиска n-граммы в словаре
+		 * @param seq последовательность для поиска
+		 * @return    найденная n-грамма
+		 */
+		auto findFn = [this](const vector <size_t> & seq) noexcept -> const ngram_t * {
+			// Результат работы функции
+			const ngram_t * result = nullptr;
+			// Выполняем поиск списка N-грамм
+			auto it = this->arpa.find(seq.size());
+			// Если список N-грамм получен
+			if(it != this->arpa.end()){
+				// Выполняем проверку существования последовательности
+				auto jt = it->second.find(seq.size() > 1 ? this->tokenizer->ids(seq) : seq.front());
+				// Если последовательность существует, запоминаем её
+				if(jt != it->second.end()) result = &jt->second;
+			}
+			// Выводим результат
+			return result;
+		};
+		/**
+		 * passFn Функция проверки прохождения префикса окна
+		 * @param idw  последнее слово префикса
+		 * @param gram найденная n-грамма префикса
+		 * @return     результат проверки
+		 */
+		auto passFn = [this](const size_t idw, const ngram_t * gram) noexcept {
+			// Выводим результат
+			return ((idw == size_t(token_t::start)) || (idw == size_t(token_t::unk)) || ((gram != nullptr) && (gram->weight != this->zero)));
+		};
+		// Если состояние совпадает с выходным или не рассчитано этим словарём
+		if((&in == &out) || (in.nodes.size() != count) || (count >= size_t(this->size))){
+			// Копируем входное состояние
+			state_t state = in;
+			// Если контекст длиннее n-граммы, удаляем лишние слова
+			if(count >= size_t(this->size)) state.context.erase(state.context.begin(), state.context.end() - (this->size - 1));
+			// Сбрасываем маску суффиксов
+			state.mask = 0;
+			// Сбрасываем обратную частоту
+			state.backoff = 0.0;
+			// Сбрасываем список узлов
+			state.nodes.assign(state.context.size(), nullptr);
+			// Переходим по всем суффиксам контекста, начиная с самого короткого
+			for(size_t j = state.context.size(); j > 0; j--){
+				// Флаг прохождения всех префиксов суффикса
+				bool pass = true;
+				// Найденная n-грамма
+				const ngram_t * gram = nullptr;
+				// Очищаем временную последовательность
+				tmp.clear();
+				// Переходим по всем префиксам суффикса
+				for(size_t i = (j - 1); i < state.context.size(); i++){
+					// Формируем префикс суффикса
+					tmp.push_back(state.context[i]);
+					// Выполняем поиск префикса
+					gram = findFn(tmp);
+					// Проверяем прохождение префикса
+					pass = (pass && passFn(state.context[i], gram));
+				}
+				// Запоминаем узел суффикса
+				state.nodes[j - 1] = gram;
+				// Если все префиксы суффикса пройдены, отмечаем это в маске
+				if(pass) state.mask |= (size_t(1) << (j - 1));
+				// Если суффикс найден, увеличиваем обратную частоту
+				if((gram != nullptr) && (gram->backoff != this->zero)) state.backoff = (gram->backoff + state.backoff);
+			}
+			// Выполняем расчёт по восстановленному состоянию
+			return this->score(state, idw, out);
+		}
+		// Проверяем разрешено ли неизвестное слово
+		const bool isAllowUnk = (this->frequency({size_t(token_t::unk)}).first != this->zero);
+		// Позиция первого слова окна
+		size_t first = 0;
+		// Маска суффиксов нового контекста
+		size_t mask = 0;
+		// Если неизвестное слово не разрешено, пропускаем все первые неизвестные слова
+		if(!isAllowUnk) while((first < count) && (in.context[first] == size_t(token_t::unk))) first++;
+		// Копируем контекст входного состояния
+		out.context = in.context;
+		// Добавляем слово в контекст
+		out.context.push_back(idw);
+		// Выделяем память для узлов суффиксов
+		out.nodes.resize(count + 1);
+		// Переходим по всем суффиксам контекста и ищем в них слово
+		for(size_t j = 0; j <= count; j++){
+			// Формируем суффикс нового контекста
+			tmp.assign(out.context.begin() + j, out.context.end());
+			// Выполняем поиск суффикса
+			const ngram_t * gram = findFn(tmp);
+			// Запоминаем узел нового суффикса
+			out.nodes[j] = gram;
+			// Если все префиксы суффикса пройдены, отмечаем это в маске
+			if(((j == count) || ((in.mask >> j) & 1)) && passFn(idw, gram)) mask |= (size_t(1) << j);
+		}
+		// Если окно не состоит только из неизвестных слов
+		if(isAllowUnk || (first < count) || (idw != size_t(token_t::unk))){
+			// Если все префиксы окна пройдены
+			if((mask >> first) & 1){
+				// Получаем n-грамму всего окна
+				const ngram_t * gram = static_cast <const ngram_t *> (out.nodes[first]);
+				// Формируем полученный вес n-граммы
+				result = std::make_pair(u_short(count - first + 1), (gram != nullptr ? gram->weight : this->zero));
+			// Если последнее слово окна существует
+			} else if(out.nodes[count] != nullptr) {
+				// Переходим по всем более коротким суффиксам окна
+				for(size_t j = (first + 1); j <= count; j++){
+					// Если n-грамм такой длины нет, выходим
+					if(this->arpa.count(count - j + 1) < 1) break;
+					// Получаем n-грамму суффикса
+					const ngram_t * gram = static_cast <const ngram_t *> (out.nodes[j]);
+					// Если суффикс найден и имеет вес
+					if((gram != nullptr) && (gram->weight != this->zero)){
+						// Формируем полученный вес n-граммы
+						result = std::make_pair(u_short(count - j + 1), gram->weight);
+						// Выходим из цикла
+						break;
+					}
+				}
+				// Если вес получен для юниграммы, выполняем поиск частоты отката
+				if(result.first == 1){
+					// Обратная частота контекста окна
+					double backoff = in.backoff;
+					// Если начало контекста было пропущено, считаем обратную частоту заново
+					if(first > 0){
+						// Сбрасываем обратную частоту
+						backoff = 0.0;
+						// Переходим по всем суффиксам контекста окна, начиная с самого короткого
+						for(size_t j = count; j > first; j--){
+							// Получаем n-грамму суффикса
+							const ngram_t * gram = static_cast <const ngram_t *> (in.nodes[j - 1]);
+							// Если суффикс найден, увеличиваем обратную частоту
+							if((gram != nullptr) && (gram->backoff != this->zero)) backoff = (gram->backoff + backoff);
+						}
+					}
+					// Выполняем расчёт веса n-граммы
+					result.second += backoff;
+				}
+			// Иначе выполняем полный расчёт веса окна
+			} else result = this->pplWeight(out.context, 0, out.context.size(), isAllowUnk);
+		}
+		// Если контекст достиг размера n-граммы
+		if(out.context.size() == size_t(this->size)){
+			// Смещаем маску суффиксов
+			mask >>= 1;
+			// Удаляем первое слово контекста
+			out.context.erase(out.context.begin());
+			// Удаляем узел первого суффикса
+			out.nodes.erase(out.nodes.begin());
+		}
+		// Запоминаем маску суффиксов
+		out.mask = mask;
+		// Сбрасываем обратную частоту
+		out.backoff = 0.0;
+		// Переходим по всем суффиксам нового контекста, начиная с самого короткого
+		for(size_t j = out.nodes.size(); j > 0; j--){
+			// Получаем n-грамму суффикса
+			const ngram_t * gram = static_cast <const ngram_t *> (out.nodes[j - 1]);
+			// Если суффикс найден, увеличиваем обратную частоту
+			if((gram != nullptr) && (gram->backoff != this->zero)) out.backoff = (gram->backoff + out.backoff);
+		}
+	}
+	// Выводим результат
+	return result;
+}
 /**
  * check Метод проверки существования последовательности, с указанным шагом
  * @param seq  список слов последовательности
@@ -779,6 +970,14 @@ void anyks::Alm2::setBin(const vector <char> & buffer) const noexcept {
 		}
 	}
 }
+/**
+ * setBins Метод установки группы буферов бинарных данных в словарь
+ * @param buffers список буферов с бинарными данными в порядке записей
+ */
+void anyks::Alm2::setBins(const vector <vector <char>> & buffers) const noexcept {
+	// Хэш-таблицы N-грамм общие для всех слов, поэтому устанавливаем буферы по порядку
+	alm_t::setBins(buffers);
+}
 /**
  * setBin2 Метод установки бинарных данных в словарь
  * @param buffer буфер с бинарными данными
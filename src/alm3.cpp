@@ -0,0 +1,2913 @@
+/**
+ *  author:   Yuriy Lobarev
+ *  telegram: @forman
+ *  phone:    +7(910)983-95-90
+ *  email:    forman@anyks.com
+ *  site:     https://anyks.com
+ */
+
+#include <alm.hpp>
+
+#include <numeric>
+#include <algorithm>
+
+/**
+ * build Метод сборки словаря из добавленных N-грамм
+ */
+void anyks::Alm3::build() const noexcept {
+	// Если словарь требует сборки
+	if(!this->actual){
+		// Блокируем поток
+		const std::lock_guard <std::recursive_mutex> lock(this->locker);
+		// Если N-граммы добавлены в порядке обхода дерева, достаточно упаковать их ключи
+		if(!this->actual && !this->path.empty()) this->pack();
+		// Если словарь так и не был собран в другом потоке
+		if(!this->actual){
+			// Если словарь уже был собран ранее, выгружаем его перед новыми N-граммами
+			if(!this->arpa.empty()){
+				// Собранные последовательности N-грамм предыдущего и текущего порядков
+				vector <size_t> parents, current;
+				// Список выгруженных N-грамм
+				vector <stage_t> stages(this->arpa.size());
+				// Переходим по всем порядкам N-грамм
+				for(u_short level = 0; level < this->arpa.size(); level++){
+					// Получаем список N-грамм текущего порядка
+					const auto & nodes = this->arpa.at(level);
+					// Получаем объект выгружаемых N-грамм
+					stage_t & stage = stages.at(level);
+					// Выделяем память под записи N-грамм
+					stage.data.resize(nodes.size());
+					// Очищаем список последовательностей текущего порядка
+					current.clear();
+					// Переходим по всем родительским N-граммам
+					for(size_t i = 0, j = 0; i < (level > 0 ? this->arpa.at(level - 1).size() : 1); i++){
+						// Получаем диапазон продолжений родительской N-граммы
+						const auto & range = this->range(level, i);
+						// Переходим по всем продолжениям
+						for(j = range.first; j < range.second; j++){
+							// Добавляем последовательность родительской N-граммы
+							current.insert(current.end(), parents.begin() + (i * level), parents.begin() + ((i + 1) * level));
+							// Добавляем текущее слово
+							current.push_back(nodes.idw(j));
+							// Получаем запись N-граммы
+							record_t & record = stage.data.at(j);
+							// Запоминаем параметры N-граммы
+							record.data    = record.ups = true;
+							record.uppers  = nodes.at(j).uppers;
+							record.weight  = nodes.at(j).weight;
+							record.backoff = nodes.at(j).backoff;
+						}
+					}
+					// Запоминаем последовательности текущего порядка
+					stage.seq = current;
+					// Запоминаем последовательности как родительские
+					parents.swap(current);
+				}
+				// Если новых порядков N-грамм больше чем собранных
+				if(this->stages.size() > stages.size()) stages.resize(this->stages.size());
+				// Добавляем новые N-граммы после выгруженных, чтобы они имели приоритет
+				for(size_t i = 0; i < this->stages.size(); i++){
+					// Добавляем последовательности N-грамм
+					stages.at(i).seq.insert(stages.at(i).seq.end(), this->stages.at(i).seq.begin(), this->stages.at(i).seq.end());
+					// Добавляем параметры N-грамм
+					stages.at(i).data.insert(stages.at(i).data.end(), this->stages.at(i).data.begin(), this->stages.at(i).data.end());
+				}
+				// Заменяем список ожидания
+				this->stages.swap(stages);
+			}
+			// Получаем количество порядков N-грамм
+			const u_short levels = this->stages.size();
+			// Отсортированные последовательности N-грамм каждого порядка
+			vector <vector <size_t>> keys(levels);
+			// Освобождаем отображённый в память блок, его N-граммы уже выгружены
+			this->unmap();
+			// Очищаем прежний словарь
+			this->arpa.clear();
+			// Собранный словарь не квантован
+			this->bits = 0;
+			// Выделяем память под словарь
+			this->nodes.assign(levels, vector <node_t> ());
+			// Очищаем прежний список слов
+			this->vocab.clear();
+			// Переходим по всем порядкам N-грамм
+			for(auto & stage : this->stages){
+				// Получаем копию слов текущего порядка
+				vector <size_t> words = stage.seq, tmp;
+				// Сортируем слова текущего порядка
+				std::sort(words.begin(), words.end());
+				// Удаляем повторяющиеся слова
+				words.erase(std::unique(words.begin(), words.end()), words.end());
+				// Объединяем слова текущего порядка со словами предыдущих
+				std::set_union(this->vocab.begin(), this->vocab.end(), words.begin(), words.end(), std::back_inserter(tmp));
+				// Запоминаем полученный список слов
+				this->vocab.swap(tmp);
+			}
+			// Запоминаем таблицу идентификаторов слов
+			this->words = this->vocab.data();
+			// Запоминаем количество слов в таблице
+			this->wordsCount = this->vocab.size();
+			// Количество бит индекса слова выбираем по размеру словаря
+			for(this->shift = 0; (size_t(1) << this->shift) < this->wordsCount; this->shift++);
+			// Переходим по всем порядкам N-грамм, начиная со старшего
+			for(u_short level = levels; level-- > 0;){
+				// Получаем размер N-граммы
+				const size_t size = (level + 1);
+				// Получаем объект добавленных N-грамм
+				stage_t & stage = this->stages.at(level);
+				// Список индексов добавленных N-грамм
+				vector <size_t> order(stage.data.size());
+				// Заполняем список индексов
+				std::iota(order.begin(), order.end(), 0);
+				// Сортируем N-граммы сохраняя порядок добавления одинаковых N-грамм
+				std::stable_sort(order.begin(), order.end(), [&stage, size](const size_t a, const size_t b) noexcept {
+					// Выполняем сравнение последовательностей
+					return std::lexicographical_compare(
+						stage.seq.begin() + (a * size), stage.seq.begin() + ((a + 1) * size),
+						stage.seq.begin() + (b * size), stage.seq.begin() + ((b + 1) * size)
+					);
+				});
+				// Получаем список N-грамм текущего порядка
+				auto & nodes = this->nodes.at(level);
+				// Получаем список последовательностей текущего порядка
+				auto & seq = keys.at(level);
+				// Переходим по всем добавленным N-граммам
+				for(size_t i = 0; i < order.size(); i++){
+					// Получаем начало последовательности N-граммы
+					auto it = stage.seq.begin() + (order.at(i) * size);
+					// Если такая N-грамма ещё не добавлена
+					if(seq.empty() || !std::equal(it, it + size, seq.end() - size)){
+						// Добавляем новую N-грамму
+						nodes.emplace_back();
+						// Запоминаем индекс слова в словаре
+						nodes.back().key = this->dense(* (it + (size - 1)));
+						// Запоминаем последовательность N-граммы
+						seq.insert(seq.end(), it, it + size);
+					}
+					// Получаем запись N-граммы
+					const record_t & record = stage.data.at(order.at(i));
+					// Если частоты переданы
+					if(record.data){
+						// Запоминаем частоту N-граммы
+						nodes.back().weight = record.weight;
+						// Запоминаем обратную частоту N-граммы
+						nodes.back().backoff = record.backoff;
+					}
+					// Если регистры переданы, запоминаем их
+					if(record.ups) nodes.back().uppers = record.uppers;
+				}
+				// Освобождаем выделенную память
+				stage_t().seq.swap(stage.seq);
+				stage_t().data.swap(stage.data);
+				// Если это не юниграммы
+				if(level > 0){
+					// Получаем объект N-грамм младшего порядка
+					stage_t & parent = this->stages.at(level - 1);
+					// Переходим по всем собранным N-граммам
+					for(size_t i = 0; i < nodes.size(); i++){
+						// Получаем начало последовательности N-граммы
+						auto it = seq.begin() + (i * size);
+						// Если префикс не совпадает с предыдущим, добавляем его в младший порядок
+						if((i == 0) || !std::equal(it, it + level, it - size)){
+							// Добавляем последовательность префикса
+							parent.seq.insert(parent.seq.end(), it, it + level);
+							// Добавляем пустую запись, гарантирующую существование префикса
+							parent.data.emplace_back();
+						}
+					}
+				}
+			}
+			// Переходим по всем порядкам N-грамм, кроме старшего
+			for(u_short level = 0; (level + 1) < levels; level++){
+				// Получаем размер N-граммы
+				const size_t size = (level + 1);
+				// Получаем последовательности текущего и следующего порядков
+				const auto & seq = keys.at(level), & next = keys.at(level + 1);
+				// Получаем количество N-грамм следующего порядка
+				const size_t count = this->nodes.at(level + 1).size();
+				// Переходим по всем N-граммам текущего порядка
+				for(size_t i = 0, j = 0; i < this->nodes.at(level).size(); i++){
+					// Запоминаем начало продолжений N-граммы в старших битах ключа
+					this->nodes.at(level).at(i).key |= (j << this->shift);
+					// Пропускаем все продолжения текущей N-граммы
+					while((j < count) && std::equal(next.begin() + (j * (size + 1)), next.begin() + (j * (size + 1) + size), seq.begin() + (i * size))) j++;
+				}
+			}
+			// Формируем словарь из собранных списков N-грамм
+			for(auto & nodes : this->nodes) this->arpa.emplace_back(nodes.data(), nodes.size(), this->words, this->wordsCount, this->shift);
+			// Освобождаем список ожидания
+			vector <stage_t> ().swap(this->stages);
+			// Запоминаем что словарь собран
+			this->actual = true;
+		}
+	}
+}
+/**
+ * unmap Метод освобождения отображённого в память блока N-грамм
+ */
+void anyks::Alm3::unmap() const noexcept {
+	// Если блок N-грамм отображён в память
+	if(this->mapped != nullptr){
+		// Слова отображённого словаря больше не будут доступны, распаковываем оставшиеся
+		this->unpack();
+		// Выполняем освобождение памяти
+		munmap(this->mapped, this->mappedSize);
+		// Зануляем адрес блока
+		this->mapped = nullptr;
+		// Зануляем размер блока
+		this->mappedSize = 0;
+	}
+}
+/**
+ * unpack Метод распаковки всех слов отображённого в память словаря в основной словарь
+ */
+void anyks::Alm3::unpack() const noexcept {
+	// Блокируем распаковку слов
+	const std::lock_guard <std::mutex> lock(this->lexiconLocker);
+	// Переходим по всем словам отображённого словаря
+	for(size_t i = 0; i < this->lexicon.count; i++){
+		// Если слово ещё не распаковано, распаковываем его
+		if(this->alm_t::vocab.count(this->lexicon.ids[i]) < 1) this->lexeme(i);
+	}
+	// Зануляем отображённый словарь
+	this->lexicon = lexicon_t();
+}
+/**
+ * lexeme Метод распаковки слова отображённого в память словаря в основной словарь
+ * @param index индекс слова в отображённом словаре
+ * @return      распакованное слово или nullptr
+ */
+const anyks::word_t * anyks::Alm3::lexeme(const size_t index) const noexcept {
+	// Результат работы функции
+	const word_t * result = nullptr;
+	// Если индекс слова существует
+	if(index < this->lexicon.count){
+		// Получаем границы бинарных данных слова
+		const size_t begin = this->lexicon.offsets[index], end = this->lexicon.offsets[index + 1];
+		// Смещения проверяются при обращении, а полная проверка словаря выполняется методом verifyMap
+		if((begin < end) && (end <= this->lexicon.size)){
+			// Слово для распаковки
+			word_t word = L"";
+			// Извлекаем слово из бинарных данных
+			word.set(this->lexicon.data + begin, end - begin);
+			// Если слово получено, добавляем его в основной словарь
+			if(!word.empty()) result = &this->alm_t::vocab.emplace(this->lexicon.ids[index], move(word)).first->second;
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * pack Метод упаковки ключей N-грамм, добавленных в порядке обхода дерева
+ */
+void anyks::Alm3::pack() const noexcept {
+	// Если N-граммы добавлены в порядке обхода дерева
+	if(!this->path.empty()){
+		// Очищаем прежний список слов
+		this->vocab.clear();
+		// Переходим по всем порядкам N-грамм
+		for(auto & nodes : this->nodes){
+			// Список слов текущего порядка и объединённый список слов
+			vector <size_t> words(nodes.size()), tmp;
+			// Ключи N-грамм пока содержат идентификаторы слов
+			for(size_t i = 0; i < nodes.size(); i++) words.at(i) = nodes.at(i).key;
+			// Сортируем слова текущего порядка
+			std::sort(words.begin(), words.end());
+			// Удаляем повторяющиеся слова
+			words.erase(std::unique(words.begin(), words.end()), words.end());
+			// Объединяем слова текущего порядка со словами предыдущих
+			std::set_union(this->vocab.begin(), this->vocab.end(), words.begin(), words.end(), std::back_inserter(tmp));
+			// Запоминаем полученный список слов
+			this->vocab.swap(tmp);
+		}
+		// Запоминаем таблицу идентификаторов слов
+		this->words = this->vocab.data();
+		// Запоминаем количество слов в таблице
+		this->wordsCount = this->vocab.size();
+		// Количество бит индекса слова выбираем по размеру словаря
+		for(this->shift = 0; (size_t(1) << this->shift) < this->wordsCount; this->shift++);
+		// Переходим по всем порядкам N-грамм
+		for(size_t level = 0; level < this->nodes.size(); level++){
+			// Получаем список N-грамм текущего порядка
+			auto & nodes = this->nodes.at(level);
+			// Переходим по всем N-граммам порядка
+			for(size_t i = 0; i < nodes.size(); i++){
+				// Заменяем идентификатор слова его индексом в словаре
+				nodes.at(i).key = this->dense(nodes.at(i).key);
+				// Если это не старший порядок, запоминаем начало продолжений в старших битах ключа
+				if((level + 1) < this->nodes.size()) nodes.at(i).key |= (this->starts.at(level).at(i) << this->shift);
+			}
+			// Добавляем порядок N-грамм в словарь
+			this->arpa.emplace_back(nodes.data(), nodes.size(), this->words, this->wordsCount, this->shift);
+		}
+		// Освобождаем начала продолжений и последнюю последовательность
+		vector <vector <size_t>> ().swap(this->starts);
+		vector <size_t> ().swap(this->path);
+		// Запоминаем что словарь собран
+		this->actual = true;
+	}
+}
+/**
+ * range Метод извлечения диапазона продолжений N-граммы
+ * @param level порядок продолжений (начиная с нуля)
+ * @param index индекс родительской N-граммы (для юниграмм не используется)
+ * @return      диапазон индексов продолжений в массиве порядка level
+ */
+const std::pair <size_t, size_t> anyks::Alm3::range(const u_short level, const size_t index) const noexcept {
+	// Результат работы функции
+	pair <size_t, size_t> result = {0, 0};
+	// Если порядок N-граммы существует
+	if(level < this->arpa.size()){
+		// Если это юниграммы, выводим весь список
+		if(level == 0) result.second = this->arpa.front().size();
+		// Если родительская N-грамма существует
+		else if(index < this->arpa.at(level - 1).size()) {
+			// Получаем список родительских N-грамм
+			const auto & nodes = this->arpa.at(level - 1);
+			// Запоминаем начало диапазона
+			result.first = nodes.offset(index);
+			// Конец диапазона - начало продолжений следующей N-граммы
+			result.second = ((index + 1) < nodes.size() ? nodes.offset(index + 1) : this->arpa.at(level).size());
+			// Если диапазон повреждён (отображённый блок при загрузке не проверяется), продолжений нет
+			if((result.first > result.second) || (result.second > this->arpa.at(level).size())) result = {0, 0};
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * child Метод поиска продолжения N-граммы
+ * @param level порядок искомой N-граммы (начиная с нуля)
+ * @param index индекс родительской N-граммы, idw_t::NIDW для корня словаря
+ * @param idw   идентификатор искомого слова
+ * @return      индекс найденной N-граммы или idw_t::NIDW
+ */
+const size_t anyks::Alm3::child(const u_short level, const size_t index, const size_t idw) const noexcept {
+	// Результат работы функции
+	size_t result = idw_t::NIDW;
+	// Получаем диапазон поиска
+	auto range = this->range(level, index);
+	// Запоминаем конец диапазона поиска
+	const size_t end = range.second;
+	// Получаем индекс искомого слова в словаре
+	const size_t word = this->dense(idw);
+	// Если слово есть в словаре и диапазон не пустой
+	if((word != idw_t::NIDW) && (range.first < range.second)){
+		// Получаем список N-грамм
+		const auto & nodes = this->arpa.at(level);
+		// Если юниграммы содержат весь словарь, индекс слова совпадает с индексом юниграммы
+		if((level == 0) && (nodes.size() == this->wordsCount)) return word;
+		/**
+		 * Индексы слов упорядочены так же как их идентификаторы и распределены
+		 * равномерно, поэтому на больших диапазонах сначала сужаем его интерполяционным поиском
+		 */
+		for(u_short i = 0; ((range.second - range.first) > 32) && (i < 8); i++){
+			// Получаем крайние индексы слов диапазона
+			const size_t first = nodes.word(range.first), last = nodes.word(range.second - 1);
+			// Если слово находится за пределами диапазона, выходим
+			if((word < first) || (word > last)) return result;
+			// Определяем предполагаемую позицию слова
+			const size_t pos = (range.first + size_t((long double) (word - first) / (long double) (last - first) * (range.second - range.first - 1)));
+			// Если слово найдено, выводим его
+			if(nodes.word(pos) == word) return pos;
+			// Если слово находится правее, сдвигаем начало
+			else if(nodes.word(pos) < word) range.first = (pos + 1);
+			// Иначе сдвигаем конец диапазона
+			else range.second = pos;
+		}
+		// Выполняем бинарный поиск в оставшемся диапазоне
+		while(range.first < range.second){
+			// Получаем середину диапазона
+			const size_t pos = (range.first + ((range.second - range.first) / 2));
+			// Если слово находится правее, сдвигаем начало
+			if(nodes.word(pos) < word) range.first = (pos + 1);
+			// Иначе сдвигаем конец диапазона
+			else range.second = pos;
+		}
+		// Если слово найдено, запоминаем его индекс
+		if((range.first < end) && (nodes.word(range.first) == word)) result = range.first;
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * dense Метод получения индекса слова в словаре по его идентификатору
+ * @param idw идентификатор слова
+ * @return    индекс слова в словаре или idw_t::NIDW
+ */
+const size_t anyks::Alm3::dense(const size_t idw) const noexcept {
+	// Диапазон поиска слова
+	size_t first = 0, last = this->wordsCount;
+	// Идентификаторы слов являются хешами и распределены равномерно, сужаем диапазон интерполяционным поиском
+	for(u_short i = 0; ((last - first) > 32) && (i < 8); i++){
+		// Получаем крайние идентификаторы диапазона
+		const size_t left = this->words[first], right = this->words[last - 1];
+		// Если слово находится за пределами диапазона, выходим
+		if((idw < left) || (idw > right)) return idw_t::NIDW;
+		// Определяем предполагаемую позицию слова
+		const size_t pos = (first + size_t((long double) (idw - left) / (long double) (right - left) * (last - first - 1)));
+		// Если слово найдено, выводим его индекс
+		if(this->words[pos] == idw) return pos;
+		// Если слово находится правее, сдвигаем начало
+		else if(this->words[pos] < idw) first = (pos + 1);
+		// Иначе сдвигаем конец диапазона
+		else last = pos;
+	}
+	// Выполняем бинарный поиск в оставшемся диапазоне
+	const size_t * it = std::lower_bound(this->words + first, this->words + last, idw);
+	// Выводим индекс найденного слова
+	return ((it != (this->words + last)) && (* it == idw) ? size_t(it - this->words) : idw_t::NIDW);
+}
+/**
+ * exist Метод проверки существования последовательности
+ * @param seq список слов последовательности
+ * @return    результат проверки
+ */
+const bool anyks::Alm3::exist(const vector <size_t> & seq) const noexcept {
+	// Результат работы функции
+	bool result = false;
+	// Выполняем сборку словаря
+	this->build();
+	// Если список последовательностей передан
+	if(!seq.empty() && (this->size > 0) && !this->arpa.empty()){
+		// Итератор для подсчета длины n-граммы
+		u_short i = 0;
+		// Индекс найденной N-граммы
+		size_t index = idw_t::NIDW;
+		// Переходим по всему объекту
+		for(auto & idw : seq){
+			// Выполняем поиск нашего слова
+			index = this->child(i, index, idw);
+			// Если слово найдено
+			if(index != idw_t::NIDW){
+				// Если мы дошли до конца
+				result = (i == (seq.size() - 1));
+			// Выходим из цикла
+			} else break;
+			// Если количество n-грамм достигло предела, выходим
+			if((++i) > (this->size - 1)) break;
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * backoff Метод извлечения обратной частоты последовательности
+ * @param seq последовательность для извлечения обратной частоты
+ * @return    обратная частота последовательности
+ */
+const double anyks::Alm3::backoff(const vector <size_t> & seq) const noexcept {
+	// Результат работы функции
+	double result = 0.0;
+	// Выполняем сборку словаря
+	this->build();
+	// Если контекст передан
+	if(!seq.empty() && !this->arpa.empty()){
+		// Получаем частоту последовательности
+		const auto & data = this->frequency(seq);
+		// Запоминаем обратную частоту последовательности
+		if(data.second != this->zero) result = data.second;
+		// Если последовательность длинее юниграммы
+		if(seq.size() > 1){
+			// Временная последовательность
+			vector <size_t> tmp(seq.begin() + 1, seq.end());
+			// Продолжаем увеличение обратной частоты
+			result += this->backoff(tmp);
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * weight Метод извлечения веса последовательности
+ * @param seq последовательность для извлечения веса
+ * @return    вес последовательноси и n-грамма для которой она получена
+ */
+const std::pair <u_short, double> anyks::Alm3::weight(const vector <size_t> & seq) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Выполняем сборку словаря
+	this->build();
+	// Если контекст передан
+	if(!seq.empty() && !this->arpa.empty()){
+		// Итератор для подсчета длины n-граммы
+		u_short i = 0;
+		// Индекс найденной N-граммы
+		size_t index = idw_t::NIDW;
+		// Временная последовательность
+		vector <size_t> tmp(seq.begin() + 1, seq.end());
+		// Переходим по всей последовательности
+		for(auto & idw : tmp){
+			// Ищем нашу n-грамму
+			index = this->child(i, index, idw);
+			// Если n-грамма не найдена, выходим из цикла
+			if(index == idw_t::NIDW) break;
+			// Увеличиваем длину n-граммы
+			i++;
+		}
+		// Если последовательность существует, получаем её вес
+		if(!tmp.empty() && (i == tmp.size()) && (this->arpa.at(i - 1).at(index).weight != this->zero))
+			// Формируем полученный вес n-граммы
+			result = std::make_pair((u_short) tmp.size(), double(this->arpa.at(i - 1).at(index).weight));
+		// Иначе продолжаем дальше
+		else result = this->weight(tmp);
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * frequency Метод извлечения частоты n-граммы
+ * @param seq список слов последовательности
+ * @return    частота и обратная частота n-граммы
+ */
+const std::pair <double, double> anyks::Alm3::frequency(const vector <size_t> & seq) const noexcept {
+	// Результат работы функции
+	pair <double, double> result = {this->zero, this->zero};
+	// Выполняем сборку словаря
+	this->build();
+	// Если список последовательностей передан
+	if(!seq.empty() && (this->size > 0) && !this->arpa.empty()){
+		// Итератор для подсчета длины n-граммы
+		u_short i = 0;
+		// Индекс найденной N-граммы
+		size_t index = idw_t::NIDW;
+		// Переходим по всему объекту
+		for(auto & idw : seq){
+			// Выполняем поиск нашего слова
+			index = this->child(i, index, idw);
+			// Если слово найдено
+			if(index != idw_t::NIDW){
+				// Если мы дошли до конца
+				if(i == (seq.size() - 1)){
+					// Получаем блок структуры
+					const node_t & node = this->arpa.at(i).at(index);
+					// Запоминаем частоту и обратную частоту
+					result = std::make_pair(node.weight, node.backoff);
+				}
+			// Выходим из цикла
+			} else break;
+			// Если количество n-грамм достигло предела, выходим
+			if((++i) > (this->size - 1)) break;
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * pplWeight Метод расчёта веса окна последовательности без его копирования
+ * @param seq   последовательность слов в которой находится окно
+ * @param begin позиция начала окна в последовательности
+ * @param end   позиция конца окна в последовательности (не включительно)
+ * @param unk   разрешено ли неизвестное слово
+ * @return      граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::Alm3::pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Позиция первого слова окна
+	size_t first = begin;
+	// Если неизвестное слово не разрешено, пропускаем все первые неизвестные слова
+	if(!unk) while((first < end) && (seq[first] == size_t(token_t::unk))) first++;
+	// Если есть еще смысл искать
+	if(first < end){
+		// Индекс найденной n-граммы
+		size_t index = idw_t::NIDW;
+		// Переходим по всему окну последовательности
+		for(size_t i = first; i < end; i++){
+			// Ищем нашу n-грамму
+			index = this->child(result.first, index, seq[i]);
+			// Если n-грамма найдена
+			if(index != idw_t::NIDW){
+				// Получаем найденную n-грамму
+				const node_t & node = this->arpa.at(result.first).at(index);
+				// Запоминаем вес n-граммы
+				if(node.weight != this->zero) result.second = node.weight;
+			// Если n-грамма не найдена
+			} else {
+				// Если последнее слово последовательности найдено
+				if(this->child(0, idw_t::NIDW, seq[end - 1]) != idw_t::NIDW){
+					// Копируем окно последовательности только для расчёта отката
+					vector <size_t> tmp(seq.begin() + first, seq.begin() + end);
+					// Получаем вес последовательности
+					const auto & wrs = this->weight(tmp);
+					// Получаем грамность
+					result.first = wrs.first;
+					// Запоминаем полученный вес
+					result.second = wrs.second;
+					// Если вес получен для юниграммы, выполняем поиск частоты отката
+					if(result.first == 1){
+						// Удаляем последнее слово для извлечения обратной частоты
+						tmp.pop_back();
+						// Выполняем расчёт веса n-граммы
+						result.second += this->backoff(tmp);
+					}
+				// Если слово не найдено, устанавливаем -inf
+				} else result.second = 0.0;
+				// Выходим из цикла
+				break;
+			}
+			// Увеличиваем граммность
+			result.first++;
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * set Метод установки последовательности в словарь
+ * @param seq последовательность слов для установки
+ */
+void anyks::Alm3::set(const vector <alm_t::seq_t> & seq) const noexcept {
+	// Если список последовательностей передан
+	if(!seq.empty() && (this->size > 0)){
+		// Запись N-граммы
+		record_t record;
+		// Итератор для подсчета длины n-граммы
+		u_short i = 0;
+		// Временная последовательность
+		vector <size_t> tmp;
+		// Переходим по всему объекту
+		for(auto & item : seq){
+			// Формируем последовательность
+			tmp.push_back(item.idw);
+			// Если порядка N-грамм ещё нет, добавляем его
+			if(this->stages.size() <= i) this->stages.resize(i + 1);
+			// Получаем объект N-грамм текущего порядка
+			stage_t & stage = this->stages.at(i);
+			// Запоминаем параметры N-граммы
+			record.data    = true;
+			record.ups     = (item.ups > 0);
+			record.uppers  = item.ups;
+			record.weight  = item.weight;
+			record.backoff = item.backoff;
+			/**
+			 * Бинарный словарь передаёт префиксы N-грамм для каждой последовательности,
+			 * поэтому повторы идущие подряд не добавляем
+			 */
+			if(stage.data.empty() || !std::equal(tmp.begin(), tmp.end(), stage.seq.end() - tmp.size()) ||
+			(stage.data.back().uppers != record.uppers) || (stage.data.back().ups != record.ups) ||
+			(stage.data.back().weight != record.weight) || (stage.data.back().backoff != record.backoff)){
+				// Добавляем последовательность N-граммы
+				stage.seq.insert(stage.seq.end(), tmp.begin(), tmp.end());
+				// Добавляем параметры N-граммы
+				stage.data.push_back(record);
+			}
+			// Если количество n-грамм достигло предела, выходим
+			if((++i) > (this->size - 1)) break;
+		}
+		// Запоминаем что словарь требует сборки
+		this->actual = false;
+	}
+}
+/**
+ * set Метод установки последовательности в словарь
+ * @param seq     список идентификаторов слов которые нужно добавить
+ * @param uppers  список верхних регистров последнего слова последовательности
+ * @param weight  вес n-граммы из файла arpa
+ * @param backoff обратная частота документа из файла arpa
+ */
+void anyks::Alm3::set(const vector <size_t> & seq, const size_t uppers, const double weight, const double backoff) const noexcept {
+	// Если список последовательностей передан
+	if(!seq.empty() && (this->size > 0)){
+		// Запись N-граммы
+		record_t record;
+		// Получаем размер N-граммы
+		const u_short size = min(seq.size(), size_t(this->size));
+		// Если порядка N-грамм ещё нет, добавляем его
+		if(this->stages.size() < size) this->stages.resize(size);
+		// Если последовательность не длиннее максимального порядка
+		if(size == seq.size()){
+			// Запоминаем регистры слова
+			record.uppers = uppers;
+			// Запоминаем обратную частоту документа
+			record.backoff = (backoff == 0.0 ? this->zero : backoff);
+			// Запоминаем частоту n-граммы
+			record.weight = ((weight == 0.0) || (fabs(round(weight)) >= 99.0) ? this->zero : weight);
+			// Запоминаем что параметры N-граммы переданы
+			record.data = record.ups = true;
+		}
+		// Получаем объект N-грамм текущего порядка
+		stage_t & stage = this->stages.at(size - 1);
+		// Добавляем последовательность N-граммы
+		stage.seq.insert(stage.seq.end(), seq.begin(), seq.begin() + size);
+		// Добавляем параметры N-граммы
+		stage.data.push_back(record);
+		// Запоминаем что словарь требует сборки
+		this->actual = false;
+	}
+}
+/**
+ * append Метод добавления последовательности в порядке обхода дерева сразу в списки N-грамм
+ * @param seq последовательность слов для добавления
+ */
+void anyks::Alm3::append(const vector <alm_t::seq_t> & seq) const noexcept {
+	// Если список последовательностей передан
+	if(!seq.empty() && (this->size > 0)){
+		// Флаг расхождения с предыдущей последовательностью
+		bool fresh = false;
+		// Получаем размер N-граммы
+		const u_short size = min(seq.size(), size_t(this->size));
+		// Переходим по всем словам последовательности
+		for(u_short i = 0; i < size; i++){
+			// Получаем слово последовательности
+			const auto & item = seq.at(i);
+			// Если последовательность ещё совпадает с предыдущей, N-грамма уже добавлена
+			if(!fresh && (i < this->path.size()) && (this->path.at(i) == item.idw)) continue;
+			// Если последовательность нарушает порядок обхода дерева
+			if(!fresh && (i < this->path.size()) && (this->path.at(i) > item.idw)){
+				// Собираем уже добавленные N-граммы
+				this->build();
+				// Добавляем последовательность через список ожидания
+				this->set(seq);
+				// Выходим из функции
+				return;
+			}
+			// Все следующие N-граммы последовательности новые
+			fresh = true;
+			// Если порядка N-грамм ещё нет, добавляем его
+			if(this->nodes.size() <= i) this->nodes.resize(i + 1);
+			// Получаем список N-грамм текущего порядка
+			auto & nodes = this->nodes.at(i);
+			// Добавляем новую N-грамму
+			nodes.emplace_back();
+			// До упаковки ключ содержит идентификатор слова
+			nodes.back().key = item.idw;
+			// Запоминаем параметры N-граммы
+			nodes.back().uppers  = item.ups;
+			nodes.back().weight  = item.weight;
+			nodes.back().backoff = item.backoff;
+			// Если это не старший порядок
+			if((i + 1) < this->size){
+				// Если списка начал продолжений порядка ещё нет, добавляем его
+				if(this->starts.size() <= i) this->starts.resize(i + 1);
+				// Продолжения N-граммы начнутся с конца списка следующего порядка
+				this->starts.at(i).push_back(this->nodes.size() > size_t(i + 1) ? this->nodes.at(i + 1).size() : 0);
+			}
+			// Обрезаем последнюю последовательность до родителя
+			this->path.resize(i);
+			// Запоминаем слово N-граммы
+			this->path.push_back(item.idw);
+		}
+		// Запоминаем что словарь требует упаковки
+		this->actual = false;
+	}
+}
+/**
+ * spill Метод добавления последовательности в порядке обхода дерева во временные файлы порядков
+ * @param seq последовательность слов для добавления
+ */
+void anyks::Alm3::spill(const vector <alm_t::seq_t> & seq) const noexcept {
+	// Если список последовательностей передан и запись блока не прервана
+	if(!seq.empty() && (this->size > 0) && !this->writer.broken){
+		// Флаг расхождения с предыдущей последовательностью
+		bool fresh = false;
+		// Получаем размер N-граммы
+		const u_short size = min(seq.size(), size_t(this->size));
+		// Переходим по всем словам последовательности
+		for(u_short i = 0; i < size; i++){
+			// Получаем слово последовательности
+			const auto & item = seq.at(i);
+			// Если последовательность ещё совпадает с предыдущей, N-грамма уже добавлена
+			if(!fresh && (i < this->writer.path.size()) && (this->writer.path.at(i) == item.idw)) continue;
+			// Если последовательность нарушает порядок обхода дерева, блок без сборки словаря записать нельзя
+			if(!fresh && (i < this->writer.path.size()) && (this->writer.path.at(i) > item.idw)){
+				// Запоминаем что запись блока прервана
+				this->writer.broken = true;
+				// Выходим из функции
+				return;
+			}
+			// Все следующие N-граммы последовательности новые
+			fresh = true;
+			// Если порядка N-грамм ещё нет, добавляем его
+			if(this->writer.levels.size() <= i){
+				// Добавляем временные файлы и количество N-грамм порядков
+				this->writer.levels.resize(i + 1, nullptr);
+				this->writer.counts.resize(i + 1, 0);
+			}
+			// Если временный файл порядка не открыт, открываем его
+			if(this->writer.levels.at(i) == nullptr) this->writer.levels.at(i) = tmpfile();
+			// N-грамма во временном файле
+			spill_t node;
+			// Запоминаем параметры N-граммы
+			node.idw     = item.idw;
+			node.uppers  = item.ups;
+			node.weight  = item.weight;
+			node.backoff = item.backoff;
+			// Продолжения N-граммы начнутся с конца списка следующего порядка
+			node.start = ((i + 1) < this->writer.counts.size() ? this->writer.counts.at(i + 1) : 0);
+			// Если временный файл не открыт или N-грамма не записана, запись блока прерываем
+			if((this->writer.levels.at(i) == nullptr) || (fwrite(&node, sizeof(node), 1, this->writer.levels.at(i)) != 1)){
+				// Запоминаем что запись блока прервана
+				this->writer.broken = true;
+				// Выходим из функции
+				return;
+			}
+			// Увеличиваем количество N-грамм порядка
+			this->writer.counts.at(i)++;
+			// Запоминаем слово для таблицы идентификаторов
+			this->writer.words.insert(item.idw);
+			// Обрезаем последнюю последовательность до родителя
+			this->writer.path.resize(i);
+			// Запоминаем слово N-граммы
+			this->writer.path.push_back(item.idw);
+		}
+	}
+}
+/**
+ * clear Метод очистки всех данных
+ */
+void anyks::Alm3::clear(){
+	// Выполняем очистку объекта arpa
+	this->arpa.clear();
+	// Выполняем очистку собранных списков N-грамм
+	this->nodes.clear();
+	// Словарь больше не квантован
+	this->bits = 0;
+	// Выполняем очистку списка слов
+	this->vocab.clear();
+	// Зануляем таблицу идентификаторов слов
+	this->words = nullptr;
+	// Зануляем количество слов и бит индекса слова
+	this->shift = this->wordsCount = 0;
+	// Отображённый словарь очищается вместе с основным словарём
+	this->lexicon = lexicon_t();
+	// Освобождаем отображённый в память блок
+	this->unmap();
+	// Выполняем очистку списка ожидания
+	this->stages.clear();
+	// Выполняем очистку N-грамм добавленных в порядке обхода дерева
+	this->path.clear();
+	this->starts.clear();
+	// Закрываем временные файлы записи блока N-грамм
+	this->writer.clear();
+	// Запоминаем что словарь собран
+	this->actual = true;
+	// Выполняем удаление всех основных параметров
+	reinterpret_cast <alm_t *> (this)->clear();
+}
+/**
+ * perplexity Метод расчёта перплексии
+ * @param  seq список последовательностей
+ * @return     результат расчёта
+ */
+const anyks::Alm::ppl_t anyks::Alm3::perplexity(const vector <size_t> & seq) const noexcept {
+	// Результат работы функции
+	ppl_t result;
+	// Выполняем сборку словаря
+	this->build();
+	// Если текст передан
+	if(!this->arpa.empty() && (seq.size() > 2) && (this->size > 0) &&
+	(seq.front() == size_t(token_t::start)) && (seq.back() == size_t(token_t::finish))){
+		// Позиция n-граммы в контексте
+		size_t index = 0;
+		// Количество переданных последовательностей
+		const size_t count = seq.size();
+		// Текст данных отладки собранных при расчёте
+		std::map <size_t, std::pair <std::string, std::string>> debugMessages;
+		// Временная последовательность
+		std::vector <size_t> tmp;
+		// Определяем смещение в последовательности
+		size_t offset1 = 0, offset2 = (count > size_t(this->size) ? this->size : count);
+		// Проверяем разрешено ли неизвестное слово
+		const bool isAllowUnk = (this->frequency({size_t(token_t::unk)}).first != this->zero);
+		/**
+		 * debugFn Функция вывода отладочной информации
+		 * @param first  первое слово
+		 * @param second второе слово
+		 * @param bigram является ли n-грамма длиннее биграммы
+		 * @param gram   граммность n-граммы для которой был произведён расчёт
+		 * @param weight полученный вес n-граммы при расчёте
+		 * @param delim  проверочный делитель n-граммы
+		 * @param pos    позиция n-граммы в контексте
+		 */
+		auto debugFn = [&debugMessages, this](const string & first, const string & second, const bool bigram, const u_short gram, const double weight, const double delim, const size_t pos){
+			// Выводим отладочную информацию
+			if(this->isOption(options_t::debug)){
+				// Результат работы функции
+				pair <string, string> result;
+				// Граммность n-граммы
+				string numGram = "OOV";
+				// Значение полученного веса
+				double prob = 0.0, lprob = this->zero;
+				// Если вес не нулевой
+				if(weight != 0.0){
+					// Запоминаем вес n-граммы
+					lprob = weight;
+					// Избавляемся от логорифма
+					prob = pow(10, weight);
+					// Устанавливаем граммность
+					numGram = (std::to_string(gram) + "gram");
+				}
+				// Формируем информационное сообщение
+				result.first = this->alphabet->format(
+					"p( %s | %s %s) \t= [%s] %4.8f [ %4.8f ] / %4.8f",
+					second.c_str(),
+					first.c_str(),
+					(bigram ? "..." : ""),
+					numGram.c_str(),
+					prob, lprob, delim
+				);
+				// Выполняем округление делителя
+				const double value = (ceil((delim * 10000.0) + 0.5) / 10000.0);
+				// Если делитель не сходится к единице, выводим сообщение
+				if(fabs(value - 1.0) > 0.0009) result.second = this->alphabet->format("word probs for this context sum to %4.8f != 1", delim);
+				// Блокируем поток
+				this->locker.lock();
+				// Добавляем в список отладки
+				debugMessages.emplace(pos, move(result));
+				// Разблокируем поток
+				this->locker.unlock();
+			}
+		};
+		/**
+		 * calcFn Функция расчёта перплексии
+		 * @param seq последовательность слов для обработки
+		 * @return    вес n-граммы
+		 */
+		auto calcFn = [isAllowUnk, this](const vector <size_t> & seq) noexcept {
+			// Выполняем расчёт веса n-граммы по всей последовательности
+			return this->pplWeight(seq, 0, seq.size(), isAllowUnk);
+		};
+		/**
+		 * putDebugFn Функция расчёта отладочной информации
+		 * @param seq    последовательность слов для обработки
+		 * @param gram   граммность n-граммы для которой был произведён расчёт
+		 * @param weight полученный вес n-граммы при расчёте
+		 * @param pos    позиция n-граммы в контексте
+		 */
+		auto putDebugFn = [&debugFn, this](const vector <size_t> & seq, const u_short gram, const double weight, const size_t pos) noexcept {
+			// Если последовательность передана
+			if(!seq.empty() && this->isOption(options_t::debug)){
+				// Получившийся разделитель
+				double delim = 0.0;
+				// Получаем нашу последовательность
+				vector <size_t> tmp = seq;
+				// Получаем количество слов в последовательности
+				const size_t count = tmp.size();
+				// Выполняем првоерку больше ли переданная последовательность биграммы
+				const bool isBigram = (count > 2);
+				// Получаем второе слово
+				const string & second = this->word(tmp.back()).real();
+				// Получаем первое слово
+				const string & first = this->word(tmp.at(count - 2)).real();
+				// Укорачиваем последовательность до 2-х слов
+				if(count > 2) tmp.assign(tmp.begin() + (count - 2), tmp.end());
+				// Удаляем последний элемент в списке
+				tmp.pop_back();
+				// Выполняем расчёт обратной частоты последовательности
+				const double backoff = this->backoff(tmp);
+				// Переходим по всем словам словаря
+				for(size_t i = 0; i < this->arpa.front().size(); i++){
+					// Получаем данные юниграммы
+					const node_t & value = this->arpa.front().at(i);
+					// Если веса у n-граммы нету
+					if((value.weight != this->zero)){
+						// Формируем нашу последовательность
+						tmp.push_back(this->arpa.front().idw(i));
+						// Получаем частоту последовательности
+						auto calc = this->frequency(tmp);
+						// Если частота последовательности получена
+						if(calc.first != this->zero) delim += exp(calc.first * this->mln10);
+						// Если последовательность не существует, считаем частоту иначе
+						else delim += exp((this->weight(tmp).second + backoff) * this->mln10);
+						// Удаляем последний элемент в списке
+						tmp.pop_back();
+					}
+				}
+				// Выводим отладочную информацию
+				debugFn(first, second, isBigram, gram, weight, delim, pos);
+			}
+		};
+		// Сбрасываем значение результата
+		result.logprob = 0.0;
+		/**
+		 * runFn Функция запуска расчёта перплексии
+		 * @param seq последовательность слов для обработки
+		 * @param pos позиция n-граммы в контексте
+		 */
+		auto runFn = [&result, &calcFn, &putDebugFn](const vector <size_t> & seq, const size_t pos){
+			// Выполняем проверку существования граммы
+			auto calc = calcFn(seq);
+			// Если вес получен
+			if(calc.second != 0.0)
+				// Увеличиваем общее значение веса
+				result.logprob += calc.second;
+			// Увеличиваем количество нулевых весов
+			else result.zeroprobs++;
+			// Выводим отладочную информацию
+			putDebugFn(seq, calc.first, calc.second, pos);
+		};
+		// Обрабатываем первую часть n-грамм
+		for(u_short i = 2; i < offset2; i++){
+			// Получаем первую часть последовательности
+			tmp.assign(seq.begin(), seq.begin() + i);
+			// Добавляем в тредпул новое задание на обработку
+			runFn(tmp, index);
+			// Увеличиваем смещение позиции
+			index++;
+		}
+		// Если есть ещё n-граммы
+		if(count >= this->size){
+			// Выполняем извлечение данных
+			while(offset2 < (count + 1)){
+				// Получаем первую часть последовательности
+				tmp.assign(seq.begin() + offset1, seq.begin() + offset2);
+				// Добавляем в тредпул новое задание на обработку
+				runFn(tmp, index);
+				// Увеличиваем смещение позиции
+				index++;
+				// Увеличиваем смещение
+				offset1++;
+				offset2++;
+			}
+		}
+		// Если неизвестное слово не разрешено
+		if(!isAllowUnk){
+			// Считаем количество неизвестных слов
+			for(auto & idw : seq){
+				// Считаем количество неизвестных слов
+				if(idw == size_t(token_t::unk)) result.oovs++;
+			}
+		}
+		// Устанавливаем предложение
+		result.sentences = 1;
+		// Устанавливаем количество слов
+		result.words = (seq.size() - 2);
+		// Если количество нулевых весов и количество неизвестных слов получено
+		if((result.oovs > 0) && (result.zeroprobs > 0)) result.zeroprobs -= result.oovs;
+		// Выполняем расчёт перплексии
+		const auto ppl = this->pplCalculate(result.logprob, result.words, result.oovs);
+		// Усталавниваем полученные значения перплексии
+		result.ppl  = ppl.first;
+		result.ppl1 = ppl.second;
+		// Выводим отладочную информацию
+		if(this->isOption(options_t::debug)){
+			// Блокируем поток
+			this->locker.lock();
+			// Если список отладки сформирован
+			if(!debugMessages.empty()){
+				// Получаем обрабатываемый текст
+				const wstring & text = this->context(seq, true);
+				// Выводим сообщение отладки - количество слов
+				this->alphabet->log("%ls\n", alphabet_t::log_t::info, this->logfile, text.c_str());
+				// Переходим по всему списку отладки
+				for(auto & mess : debugMessages){
+					// Выводим основное сообщение отладки
+					this->alphabet->log("%s", alphabet_t::log_t::info, this->logfile, mess.second.first.c_str());
+					// Если второе сообщение существует, выводим и его
+					if(!mess.second.second.empty()) this->alphabet->log("%s", alphabet_t::log_t::warning, this->logfile, mess.second.second.c_str());
+				}
+			}
+			// Выводим разделитель
+			this->alphabet->log("%s", alphabet_t::log_t::null, this->logfile, "\r\n");
+			// Выводим сообщение отладки - количество слов
+			this->alphabet->log(
+				"%u sentences, %u words, %u OOVs",
+				alphabet_t::log_t::info,
+				this->logfile,
+				result.sentences,
+				result.words,
+				result.oovs
+			);
+			// Выводим сообщение отладки - результатов расчёта
+			this->alphabet->log(
+				"%u zeroprobs, logprob= %4.8f ppl= %4.8f ppl1= %4.8f\r\n",
+				alphabet_t::log_t::info,
+				this->logfile,
+				result.zeroprobs,
+				result.logprob,
+				result.ppl,
+				result.ppl1
+			);
+			// Разблокируем поток
+			this->locker.unlock();
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * score Метод расчёта веса слова по состоянию контекста
+ * @param in  входное состояние контекста (пустое для начала расчёта)
+ * @param idw идентификатор слова для расчёта
+ * @param out выходное состояние контекста с добавленным словом
+ * @return    граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::Alm3::score(const state_t & in, const size_t idw, state_t & out) const noexcept {
+	// Выполняем расчёт общим методом по окну контекста
+	return alm_t::score(in, idw, out);
+}
+/**
+ * check Метод проверки существования последовательности, с указанным шагом
+ * @param seq  список слов последовательности
+ * @param step размер шага проверки последовательности
+ * @return     результат проверки
+ */
+const bool anyks::Alm3::check(const vector <size_t> & seq, const u_short step) const noexcept {
+	// Результат работы функции
+	bool result = false;
+	// Выполняем сборку словаря
+	this->build();
+	// Если последовательность передана
+	if(!seq.empty() && (seq.size() >= size_t(step)) && (this->size >= step) && !this->arpa.empty()){
+		// Временная последовательность
+		vector <size_t> tmp, sequence;
+		// Если последовательность не экранированна
+		if((seq.back() == size_t(token_t::finish)) &&
+		(seq.front() == size_t(token_t::start))) sequence.assign(seq.begin() + 1, seq.end() - 1);
+		else if(seq.back() == size_t(token_t::finish)) sequence.assign(seq.begin(), seq.end() - 1);
+		else if(seq.front() == size_t(token_t::start)) sequence.assign(seq.begin() + 1, seq.end());
+		else sequence.assign(seq.begin(), seq.end());
+		// Если последовательность, до сих пор соответствует
+		if(sequence.size() >= size_t(step)){
+			// Количество переданных последовательностей
+			const size_t count = sequence.size();
+			// Определяем смещение в последовательности
+			size_t offset1 = 0, offset2 = (count > size_t(step) ? (step < 2 ? 2 : step) : count);
+			// Выполняем извлечение данных
+			while(offset2 < (count + 1)){
+				// Получаем первую часть последовательности
+				tmp.assign(sequence.begin() + offset1, sequence.begin() + offset2);
+				// Если последовательность получена
+				if(!tmp.empty()){
+					// Выполняем проверку существования последовательности
+					result = this->exist(tmp);
+					// Если последовательность не найдена, выходим
+					if(!result) break;
+				// Выходим из цикла
+				} else break;
+				// Увеличиваем смещение
+				offset1++;
+				offset2++;
+			}
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * exist Метод проверки существования последовательности
+ * @param seq  список слов последовательности
+ * @param step размер шага проверки последовательности
+ * @return     результат проверки
+ */
+const std::pair <bool, std::size_t> anyks::Alm3::exist(const std::vector <std::size_t> & seq, const u_short step) const noexcept {
+	// Результат работы функции
+	pair <bool, size_t> result = {false, 0};
+	// Выполняем сборку словаря
+	this->build();
+	// Если последовательность передана
+	if(!seq.empty() && (seq.size() >= size_t(step)) && (this->size >= step) && !this->arpa.empty()){
+		// Временная последовательность
+		vector <size_t> sequence;
+		// Если последовательность не экранированна
+		if((seq.back() == size_t(token_t::finish)) &&
+		(seq.front() == size_t(token_t::start))) sequence.assign(seq.begin() + 1, seq.end() - 1);
+		else if(seq.back() == size_t(token_t::finish)) sequence.assign(seq.begin(), seq.end() - 1);
+		else if(seq.front() == size_t(token_t::start)) sequence.assign(seq.begin() + 1, seq.end());
+		else sequence.assign(seq.begin(), seq.end());
+		// Если последовательность, до сих пор соответствует
+		if(sequence.size() >= size_t(step)){
+			/**
+			 * Прототип функции проверки на существование последовательности
+			 * @param начальная позиция итератора в последовательности
+			 * @return результат проверки, сущестования последовательности
+			 */
+			function <const pair <bool, size_t> (u_short)> checkFn;
+			/**
+			 * checkFn Функция проверки на существование последовательности
+			 * @param start начальная позиция итератора в последовательности
+			 * @return      результат проверки, сущестования последовательности
+			 */
+			checkFn = [&checkFn, &sequence, step, this](u_short start) noexcept {
+				// Результат работы функции
+				pair <bool, size_t> result = {false, 0};
+				// Порядок искомой n-граммы
+				u_short level = 0;
+				// Идентификатор слова, индекс найденной n-граммы и количество слов в последовательности
+				size_t idw = idw_t::NIDW, index = idw_t::NIDW, count = sequence.size();
+				// Получаем конечный элемент
+				const u_short stop = (start + ((count - size_t(start)) >= size_t(step) ? step : count - start));
+				// Переходим по всему объекту
+				for(u_short i = start; i < stop; i++){
+					// Получаем идентификатор слова
+					idw = sequence.at(i);
+					// Если идентификатор токена - валиден
+					if(this->tokenizer->isIdWord(idw)){
+						// Выполняем поиск нашего слова
+						index = this->child(level++, index, idw);
+						// Если слово найдено
+						if(index != idw_t::NIDW){
+							// Если мы дошли до конца
+							result.first = (i == (stop - 1));
+							// Увеличиваем начало следующей итерации
+							if(result.first){
+								// Увеличиваем стартовую позицию
+								start++;
+								// Устанавливаем количество совпадений
+								if(step == stop) result.second = step;
+							}
+						// Выходим из цикла
+						} else break;
+					// Если токен не валиден
+					} else {
+						// Увеличиваем начало следующей итерации
+						start += 2;
+						// Запоминаем, что результат возможем
+						result.first = true;
+						// Выходим из цикла
+						break;
+					}
+				}
+				// Если начало следующей итерации еще возможно
+				if(result.first && (size_t(start) < count)){
+					// Выполняем поиск дальше
+					const auto & res = checkFn(start);
+					// Устанавливаем результат поиска
+					result.first = res.first;
+					// Увеличиваем количество найденных совпадений
+					result.second += res.second;
+				}
+				// Выводим результат проверки
+				return result;
+			};
+			// Выполняем проверку
+			result = checkFn(0);
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * check Метод проверки существования последовательности
+ * @param seq      список слов последовательности
+ * @param accurate режим точной проверки
+ * @return         результат проверки
+ */
+const std::pair <bool, std::size_t> anyks::Alm3::check(const std::vector <std::size_t> & seq, const bool accurate) const noexcept {
+	// Результат работы функции
+	pair <bool, size_t> result = {false, 0};
+	// Выполняем сборку словаря
+	this->build();
+	// Если последовательность передана
+	if(!seq.empty() && !this->arpa.empty()){
+		// Временная последовательность
+		vector <size_t> tmp, sequence;
+		// Если последовательность не экранированна
+		if((seq.back() == size_t(token_t::finish)) &&
+		(seq.front() == size_t(token_t::start))) sequence.assign(seq.begin() + 1, seq.end() - 1);
+		else if(seq.back() == size_t(token_t::finish)) sequence.assign(seq.begin(), seq.end() - 1);
+		else if(seq.front() == size_t(token_t::start)) sequence.assign(seq.begin() + 1, seq.end());
+		else sequence.assign(seq.begin(), seq.end());
+		/**
+		 * Прототип функции проверки существования последовательности
+		 * @param  список слов последовательности
+		 * @return результат проверки
+		 */
+		function <const pair <bool, size_t> (const vector <size_t> &)> checkFn;
+		/**
+		 * checkFn Функция проверки существования последовательности
+		 * @param seq список слов последовательности
+		 * @return    результат проверки
+		 */
+		checkFn = [&checkFn, accurate, this](const vector <size_t> & seq) noexcept {
+			// Регистры слова в последовательности
+			pair <bool, size_t> result = {false, 0};
+			// Если список последовательностей передан
+			if(!seq.empty() && (this->size > 0)){
+				// Итератор для подсчета длины n-граммы
+				u_short i = 0;
+				// Индекс найденной n-граммы
+				size_t index = idw_t::NIDW;
+				// Переходим по всему объекту
+				for(auto & idw : seq){
+					// Выполняем поиск нашего слова
+					index = this->child(i, index, idw);
+					// Если слово найдено
+					if(index != idw_t::NIDW){
+						// Если мы дошли до конца
+						result.first = (i == (seq.size() - 1));
+						// Если последовательность существует
+						if(result.first) result.second = this->arpa.at(i).at(index).uppers;
+					// Выходим из цикла
+					} else break;
+					// Если количество n-грамм достигло предела, выходим
+					if((++i) > (this->size - 1)) break;
+				}
+				// Если последовательность не существует
+				if(!accurate && !result.first && (seq.size() > 2)){
+					// Получаем новую последовательность
+					vector <size_t> tmp(seq.begin() + 1, seq.end());
+					// Пробуем уменьшить n-грамму
+					result = checkFn(tmp);
+				}
+			}
+			// Выводим результат
+			return result;
+		};
+		// Количество переданных последовательностей
+		const size_t count = sequence.size();
+		// Определяем смещение в последовательности
+		size_t offset1 = 0, offset2 = (count > size_t(this->size) ? this->size : count);
+		// Выполняем извлечение данных
+		while(offset2 < (count + 1)){
+			// Получаем первую часть последовательности
+			tmp.assign(sequence.begin() + offset1, sequence.begin() + offset2);
+			// Если последовательность получена
+			if(!tmp.empty()){
+				// Получаем регистр слова
+				result = checkFn(tmp);
+				// Если последовательность не найдена, выходим
+				if(!result.first) break;
+			// Выходим из цикла
+			} else break;
+			// Увеличиваем смещение
+			offset1++;
+			offset2++;
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * setBins Метод установки группы буферов бинарных данных в словарь
+ * @param buffers список буферов с бинарными данными в порядке записей
+ */
+void anyks::Alm3::setBins(const vector <vector <char>> & buffers) const noexcept {
+	// Списки N-грамм собираются в порядке записей, поэтому устанавливаем буферы по порядку
+	alm_t::setBins(buffers);
+}
+/**
+ * parseBin Метод разбора бинарных данных arpa на последовательности
+ * @param buffer   буфер с бинарными данными
+ * @param callback функция обратного вызова
+ */
+void anyks::Alm3::parseBin(const vector <char> & buffer, function <void (const vector <seq_t> &)> callback) const noexcept {
+	// Если буфер передан
+	if(!buffer.empty()){
+		// Полученная последовательность
+		seq_t sequence;
+		// Количество слов в последовательности
+		u_short count = 0;
+		// Смещение в буфере
+		size_t offset = 0;
+		// Полученные данные последовательности
+		vector <seq_t> seq;
+		// Получаем данные буфера
+		const char * data = buffer.data();
+		// Выполняем перебор данных всего буфера
+		while(offset < buffer.size()){
+			// Извлекаем количество слов в последовательности
+			memcpy(&count, data + offset, sizeof(count));
+			// Увеличиваем смещение
+			offset += sizeof(count);
+			// Если последовательность получена
+			if(count > 0){
+				// Очищаем последовательность
+				seq.clear();
+				// Переходим по всем словам последовательности
+				for(u_short i = 0; i < count; i++){
+					// Извлекаем данные слова
+					memcpy(&sequence, data + offset, sizeof(sequence));
+					// Добавляем последовательность в список
+					seq.push_back(sequence);
+					// Увеличиваем смещение
+					offset += sizeof(sequence);
+				}
+				// Передаём полученную последовательность
+				callback(seq);
+			}
+		}
+	}
+}
+/**
+ * appendBin Метод добавления бинарных данных arpa, записанных в порядке обхода дерева N-грамм
+ * @param buffer буфер с бинарными данными
+ */
+void anyks::Alm3::appendBin(const vector <char> & buffer) const noexcept {
+	// Разбираем буфер и добавляем последовательности в словарь
+	this->parseBin(buffer, [this](const vector <seq_t> & seq) noexcept {
+		// Если словарь пустой, добавляем последовательность сразу в списки N-грамм
+		if(this->arpa.empty() && this->stages.empty()) this->append(seq);
+		// Иначе добавляем последовательность через список ожидания
+		else this->set(seq);
+	});
+}
+/**
+ * mapBin Метод добавления бинарных данных arpa, записанных в порядке обхода дерева N-грамм, в блок для отображения в память
+ * @param buffer буфер с бинарными данными
+ */
+void anyks::Alm3::mapBin(const vector <char> & buffer) const noexcept {
+	// Разбираем буфер и добавляем последовательности во временные файлы порядков
+	this->parseBin(buffer, [this](const vector <seq_t> & seq) noexcept {
+		// Добавляем последовательность
+		this->spill(seq);
+	});
+}
+/**
+ * mapVocab Метод добавления бинарных данных слова, записанных по возрастанию идентификаторов, в блок для отображения в память
+ * @param buffer буфер с бинарными данными
+ */
+void anyks::Alm3::mapVocab(const vector <char> & buffer) const noexcept {
+	// Если буфер передан и запись блока не прервана
+	if((buffer.size() > sizeof(size_t)) && !this->writer.broken){
+		// Идентификатор слова
+		size_t idw = 0;
+		// Извлекаем идентификатор слова
+		memcpy(&idw, buffer.data(), sizeof(idw));
+		// Получаем размер бинарных данных слова
+		const size_t size = (buffer.size() - sizeof(idw));
+		// Если временный файл слов не открыт, открываем его
+		if(this->writer.vocab == nullptr) this->writer.vocab = tmpfile();
+		/**
+		 * Поиск слова в отображённом словаре бинарный, поэтому слова должны идти по возрастанию
+		 * идентификаторов, иначе словарь без сборки записать нельзя
+		 */
+		if((!this->writer.ids.empty() && (this->writer.ids.back() >= idw)) || (this->writer.vocab == nullptr) ||
+		(fwrite(buffer.data() + sizeof(idw), 1, size, this->writer.vocab) != size)){
+			// Запоминаем что запись блока прервана
+			this->writer.broken = true;
+			// Выходим из функции
+			return;
+		}
+		// Смещения слов начинаются с нуля
+		if(this->writer.offsets.empty()) this->writer.offsets.push_back(0);
+		// Запоминаем идентификатор слова
+		this->writer.ids.push_back(idw);
+		// Запоминаем конец бинарных данных слова
+		this->writer.offsets.push_back(this->writer.offsets.back() + size);
+	}
+}
+/**
+ * getBin Метод извлечения данных arpa в бинарном виде
+ * @param callback функция обратного вызова
+ */
+void anyks::Alm3::getBin(function <void (const vector <char> &, const size_t, const u_short)> callback) const noexcept {
+	// Выполняем сборку словаря
+	this->build();
+	// Если данные загружены
+	if(!this->arpa.empty()){
+		// Данные последовательности
+		seq_t sequence;
+		// Собранная последовательность
+		vector <seq_t> seq;
+		// Буфер данных n-граммы
+		vector <char> buffer;
+		// Индекс обработки статуса и количество обработанных N-грамм
+		size_t index = 0, countNgrams = 0;
+		/**
+		 * resultFn Метод формирования результата
+		 * @param index индекс обработанного буфера
+		 * @param seq   список собранной последовательности
+		 */
+		auto resultFn = [&buffer, &countNgrams, &callback, this](const size_t index, const vector <seq_t> & seq) noexcept {
+			// Если последовательность не пустая
+			if(!seq.empty()){
+				// Получаем количество n-грамм в списке
+				u_short count = seq.size();
+				// Увеличиваем количество обработанных N-грамм
+				if(count == this->size) countNgrams++;
+				// Получаем бинарные данные количества слов
+				const char * bin = reinterpret_cast <const char *> (&count);
+				// Добавляем в буфер количество слов
+				buffer.insert(buffer.end(), bin, bin + sizeof(count));
+				// Переходим по всему списку последовательности
+				for(auto & item : seq){
+					// Получаем бинарные данные последовательности
+					bin = reinterpret_cast <const char *> (&item);
+					// Добавляем в буфер бинарные данные последовательности
+					buffer.insert(buffer.end(), bin, bin + sizeof(item));
+				}
+				// Если буфер имеет размер в 100Mb
+				if(buffer.size() >= BUFFER_SIZE){
+					// Выводим собранную последовательность
+					callback(buffer, countNgrams, u_short(index / double(this->arpa.front().size()) * 100.0));
+					// Очищаем полученный буфер n-граммы
+					buffer.clear();
+				}
+			}
+		};
+		/**
+		 * Прототип функции запуска формирования map карты последовательностей
+		 * @param порядок извлекаемых n-грамм
+		 * @param индекс родительской n-граммы
+		 */
+		function <void (const u_short, const size_t)> runFn;
+		/**
+		 * runFn Функция запуска формирования map карты последовательностей
+		 * @param level  порядок извлекаемых n-грамм
+		 * @param parent индекс родительской n-граммы
+		 */
+		runFn = [&](const u_short level, const size_t parent) noexcept {
+			// Получаем диапазон n-грамм
+			const auto & range = this->range(level, parent);
+			// Переходим по всему диапазону n-грамм
+			for(size_t i = range.first; i < range.second; i++){
+				// Увеличиваем индекс если это юниграмма
+				if(level == 0) index++;
+				// Получаем данные n-граммы
+				const node_t & node = this->arpa.at(level).at(i);
+				// Извлекаем основные данные
+				sequence.idw     = this->arpa.at(level).idw(i);
+				sequence.ups     = node.uppers;
+				sequence.weight  = node.weight;
+				sequence.backoff = node.backoff;
+				// Формируем последовательность
+				seq.push_back(sequence);
+				// Получаем диапазон продолжений n-граммы
+				const auto & next = this->range(level + 1, i);
+				// Если еще есть продолжение граммы
+				if(next.first < next.second) runFn(level + 1, i);
+				// Иначе выводим то что есть
+				else resultFn(index, seq);
+				// Удаляем последний элемент в списке
+				seq.pop_back();
+			}
+		};
+		// Запускаем извлечение данных
+		runFn(0, idw_t::NIDW);
+		// Если буфер не пустой
+		if(!buffer.empty()){
+			// Выводим собранную последовательность
+			callback(buffer, countNgrams, u_short(index / double(this->arpa.front().size()) * 100.0));
+			// Очищаем полученный буфер n-граммы
+			buffer.clear();
+			// Освобождаем выделенную память
+			vector <char> ().swap(buffer);
+		}
+	// Выводим пустой результат
+	} else callback({}, 0, 0);
+}
+/**
+ * map Метод отображения в память блока N-грамм из файла словаря с проверкой его заголовка
+ * @param filename адрес файла словаря
+ * @param length   размер отображённого блока
+ * @return         адрес отображённого блока или nullptr
+ */
+void * anyks::Alm3::map(const string & filename, size_t & length) const noexcept {
+	// Результат работы функции
+	void * result = nullptr;
+	// Зануляем размер блока
+	length = 0;
+	// Если файл словаря существует
+	if(!filename.empty() && fsys_t::isfile(filename)){
+		// Структура статистики файла
+		struct stat info;
+		// Открываем файл на чтение
+		const int fd = ::open(filename.c_str(), O_RDONLY);
+		// Если файл открыт и его размер получен
+		if((fd > -1) && (fstat(fd, &info) == 0) && (size_t(info.st_size) > sizeof(tail_t))){
+			// Окончание файла с N-граммами
+			tail_t tail;
+			// Получаем размер файла без окончания
+			const size_t size = (info.st_size - sizeof(tail_t));
+			// Если окончание файла прочитано и содержит блок N-грамм
+			if((pread(fd, &tail, sizeof(tail), size) == sizeof(tail)) &&
+			(memcmp(tail.magic, MMAP_HEADER, sizeof(tail.magic)) == 0) &&
+			((tail.offset % MMAP_ALIGN) == 0) && ((tail.offset + sizeof(map_t)) < size)){
+				// Получаем размер блока N-грамм
+				const size_t block = (size - tail.offset);
+				// Выполняем отображение блока N-грамм в память
+				void * buffer = mmap(0, block, PROT_READ, MAP_SHARED, fd, tail.offset);
+				// Если блок отображён удачно
+				if(buffer != MAP_FAILED){
+					// Получаем данные блока
+					const char * data = reinterpret_cast <const char *> (buffer);
+					// Получаем заголовок блока
+					const map_t * header = reinterpret_cast <const map_t *> (data);
+					// Получаем таблицу смещений, количества N-грамм и кодовых книг каждого порядка
+					const size_t * table = reinterpret_cast <const size_t *> (data + sizeof(map_t));
+					// Получаем размер кода квантованной частоты, до 8 бит код занимает один байт
+					const size_t width = (header->bits > 0 ? (header->bits > 8 ? 2 : 1) : 0);
+					// Получаем размер кодовых книг одного порядка
+					const size_t book = (header->book * sizeof(float) * 2);
+					/**
+					 * Проверяем только заголовок и границы разделов блока, это не требует чтения
+					 * N-грамм, поэтому загрузка не зависит от размера словаря и не затрагивает его страницы
+					 */
+					bool check = ((memcmp(header->magic, MMAP_HEADER, sizeof(header->magic)) == 0) &&
+					(header->node == width) && (header->levels > 0) && (header->bits <= 16) &&
+					((header->bits == 0) || (header->book == (size_t(1) << header->bits))) &&
+					((sizeof(map_t) + (header->levels * sizeof(size_t) * 3)) <= block) && (header->shift < 64) &&
+					(header->vocab <= block) && (header->words <= ((block - header->vocab) / sizeof(size_t))) &&
+					(header->words <= (size_t(1) << header->shift)) && (header->lexemes > 0) && (header->lexicon <= block) &&
+					(header->lexemes < (block / sizeof(size_t))) && (((header->lexemes * 2) + 1) <= ((block - header->lexicon) / sizeof(size_t))));
+					// Если таблица словаря внутри блока
+					if(check){
+						// Получаем начало бинарных данных слов
+						const size_t start = (header->lexicon + (((header->lexemes * 2) + 1) * sizeof(size_t)));
+						// Размер бинарных данных слов хранится в последнем смещении и не должен выходить за пределы блока
+						check = (reinterpret_cast <const size_t *> (data + header->lexicon)[header->lexemes * 2] <= (block - start));
+					}
+					// Проверяем что все порядки N-грамм и их кодовые книги находятся внутри блока
+					for(u_int i = 0; check && (i < header->levels); i++){
+						// Порядок без кодовых книг хранится без квантования, у старшего порядка нет кода обратной частоты
+						const size_t bytes = (table[i * 3 + 2] > 0 ? (QUANTHEAD + (width * ((i + 1) < header->levels ? 2 : 1))) : sizeof(node_t));
+						// Если порядок N-грамм выходит за пределы блока
+						check = ((table[i * 3] <= block) && (table[i * 3 + 1] <= ((block - table[i * 3]) / bytes)));
+						// Если кодовые книги порядка выходят за пределы блока
+						if(check && (header->bits > 0) && (table[i * 3 + 2] > 0)) check = ((table[i * 3 + 2] <= block) && (book <= (block - table[i * 3 + 2])));
+					}
+					// Если блок N-грамм корректный, запоминаем его
+					if(check){
+						// Запоминаем адрес блока
+						result = buffer;
+						// Запоминаем размер блока
+						length = block;
+					// Освобождаем отображённый блок
+					} else munmap(buffer, block);
+				}
+			}
+		}
+		// Если файл открыт, закрываем его
+		if(fd > -1) ::close(fd);
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * readMap Метод отображения в память N-грамм и слов из файла словаря
+ * @param filename адрес файла словаря
+ * @return         результат отображения
+ */
+const bool anyks::Alm3::readMap(const string & filename) const noexcept {
+	// Размер отображённого блока
+	size_t length = 0;
+	// Выполняем отображение блока N-грамм в память
+	void * buffer = this->map(filename, length);
+	// Если блок отображён удачно
+	if(buffer != nullptr){
+		// Получаем данные блока
+		const char * data = reinterpret_cast <const char *> (buffer);
+		// Получаем заголовок блока
+		const map_t * header = reinterpret_cast <const map_t *> (data);
+		// Получаем таблицу смещений, количества N-грамм и кодовых книг каждого порядка
+		const size_t * table = reinterpret_cast <const size_t *> (data + sizeof(map_t));
+		// Блокируем поток
+		const std::lock_guard <std::recursive_mutex> lock(this->locker);
+		// Очищаем прежний словарь
+		this->arpa.clear();
+		this->nodes.clear();
+		this->vocab.clear();
+		this->stages.clear();
+		this->starts.clear();
+		this->path.clear();
+		// Освобождаем прежний отображённый блок
+		this->unmap();
+		// Запоминаем количество бит квантования
+		this->bits = header->bits;
+		// Запоминаем количество бит индекса слова
+		this->shift = header->shift;
+		// Запоминаем количество слов в таблице
+		this->wordsCount = header->words;
+		// Запоминаем таблицу идентификаторов слов
+		this->words = reinterpret_cast <const size_t *> (data + header->vocab);
+		// Запоминаем отображённый словарь
+		{
+			// Блокируем распаковку слов
+			const std::lock_guard <std::mutex> lock(this->lexiconLocker);
+			// Запоминаем количество слов словаря
+			this->lexicon.count = header->lexemes;
+			// Запоминаем отсортированные идентификаторы слов
+			this->lexicon.ids = reinterpret_cast <const size_t *> (data + header->lexicon);
+			// Запоминаем смещения бинарных данных слов
+			this->lexicon.offsets = (this->lexicon.ids + header->lexemes);
+			// Запоминаем бинарные данные слов
+			this->lexicon.data = reinterpret_cast <const char *> (this->lexicon.offsets + header->lexemes + 1);
+			// Запоминаем размер бинарных данных слов
+			this->lexicon.size = this->lexicon.offsets[header->lexemes];
+		}
+		/**
+		 * Слова не извлекаются из файла целиком, а распаковываются из отображённого
+		 * словаря при первом обращении к ним, поэтому устанавливаем свои функции работы со словами
+		 */
+		const_cast <alm3_t *> (this)->setWordFn([this](const size_t idw) noexcept {
+			// Результат работы функции
+			const word_t * result = nullptr;
+			// Блокируем распаковку слов
+			const std::lock_guard <std::mutex> lock(this->lexiconLocker);
+			// Выполняем поиск среди распакованных слов
+			auto it = this->alm_t::vocab.find(idw);
+			// Если слово уже распаковано, выводим его
+			if(it != this->alm_t::vocab.end()) result = &it->second;
+			// Иначе ищем слово в отображённом словаре
+			else if(this->lexicon.count > 0) {
+				// Выполняем поиск идентификатора слова
+				const size_t * item = std::lower_bound(this->lexicon.ids, this->lexicon.ids + this->lexicon.count, idw);
+				// Если слово найдено, распаковываем его
+				if((item != (this->lexicon.ids + this->lexicon.count)) && (* item == idw)) result = this->lexeme(item - this->lexicon.ids);
+			}
+			// Выводим результат
+			return result;
+		}, [this](const size_t idw, const word_t & word) noexcept {
+			// Блокируем распаковку слов
+			const std::lock_guard <std::mutex> lock(this->lexiconLocker);
+			// Добавляем слово в основной словарь
+			this->alm_t::vocab.emplace(idw, word);
+		});
+		// Запоминаем адрес блока
+		this->mapped = buffer;
+		// Запоминаем размер блока
+		this->mappedSize = length;
+		/**
+		 * Индексы слов, коды и диапазоны продолжений отдельных N-грамм здесь не проверяются,
+		 * они проверяются при обращении к N-грамме во время поиска, а полная проверка блока
+		 * выполняется методом verifyMap
+		 */
+		for(u_int i = 0; i < header->levels; i++){
+			// Если N-граммы порядка не квантованы, добавляем порядок N-грамм как есть
+			if((header->bits == 0) || (table[i * 3 + 2] == 0)) this->arpa.emplace_back(reinterpret_cast <const node_t *> (data + table[i * 3]), table[i * 3 + 1], this->words, this->wordsCount, this->shift);
+			// Иначе добавляем порядок квантованных N-грамм вместе с кодовыми книгами
+			else {
+				// Получаем кодовые книги порядка
+				const float * books = reinterpret_cast <const float *> (data + table[i * 3 + 2]);
+				// Добавляем порядок N-грамм, у старшего порядка нет кода обратной частоты
+				this->arpa.emplace_back(data + table[i * 3], table[i * 3 + 1], header->node, ((i + 1) < header->levels ? 2 : 1), books, books + header->book, header->book, this->words, this->wordsCount, this->shift);
+			}
+		}
+		// Поиск по словарю выполняется в случайном порядке
+		madvise(buffer, length, MADV_RANDOM);
+		// Запоминаем что словарь собран
+		this->actual = true;
+	}
+	// Выводим результат
+	return (buffer != nullptr);
+}
+/**
+ * verifyMap Метод полной проверки N-грамм отображаемых в память из файла словаря
+ * @param filename адрес файла словаря
+ * @return         результат проверки
+ */
+const bool anyks::Alm3::verifyMap(const string & filename) const noexcept {
+	// Размер отображённого блока
+	size_t length = 0;
+	// Выполняем отображение блока N-грамм в память
+	void * buffer = this->map(filename, length);
+	// Результат работы функции
+	bool result = (buffer != nullptr);
+	// Если блок отображён удачно
+	if(result){
+		// Блок проверяется последовательно
+		madvise(buffer, length, MADV_SEQUENTIAL);
+		// Получаем данные блока
+		const char * data = reinterpret_cast <const char *> (buffer);
+		// Получаем заголовок блока
+		const map_t * header = reinterpret_cast <const map_t *> (data);
+		// Получаем таблицу смещений, количества N-грамм и кодовых книг каждого порядка
+		const size_t * table = reinterpret_cast <const size_t *> (data + sizeof(map_t));
+		// Маска индекса слова в ключе N-граммы
+		const size_t mask = ((size_t(1) << header->shift) - 1);
+		// Получаем отсортированные идентификаторы слов словаря
+		const size_t * ids = reinterpret_cast <const size_t *> (data + header->lexicon);
+		// Получаем смещения бинарных данных слов словаря
+		const size_t * offsets = (ids + header->lexemes);
+		// Идентификаторы слов словаря возрастают, а смещения их бинарных данных не убывают
+		for(size_t i = 0; result && (i < header->lexemes); i++){
+			// Проверяем порядок идентификатора и смещения слова
+			result = (((i == 0) || (ids[i - 1] < ids[i])) && (offsets[i] <= offsets[i + 1]));
+		}
+		// Проверяем индексы слов, коды и диапазоны продолжений всех N-грамм каждого порядка
+		for(u_int i = 0; result && (i < header->levels); i++){
+			// Начало продолжений предыдущей N-граммы
+			size_t last = 0;
+			// Получаем начало порядка N-грамм
+			const char * level = (data + table[i * 3]);
+			// Порядок без кодовых книг хранится без квантования
+			const bool exact = ((header->bits == 0) || (table[i * 3 + 2] == 0));
+			// Получаем количество N-грамм следующего порядка
+			const size_t count = ((i + 1) < header->levels ? table[(i + 1) * 3 + 1] : 0);
+			// Получаем количество кодов квантованной N-граммы, у старшего порядка нет кода обратной частоты
+			const u_short codes = ((i + 1) < header->levels ? 2 : 1);
+			// Порядок N-грамм для чтения ключей и кодов, кодовые книги и таблица слов для проверки не нужны
+			const level_t view = (exact ?
+				level_t(reinterpret_cast <const node_t *> (level), table[i * 3 + 1]) :
+				level_t(level, table[i * 3 + 1], header->node, codes, nullptr, nullptr, header->book, nullptr, 0, header->shift)
+			);
+			// Переходим по всем N-граммам порядка
+			for(size_t j = 0; result && (j < table[i * 3 + 1]); j++){
+				// Получаем ключ N-граммы
+				const size_t key = view.key(j);
+				// Индекс слова должен находиться в таблице слов
+				result = ((key & mask) < header->words);
+				// Коды квантованной N-граммы должны находиться в кодовых книгах
+				if(result && !exact) result = ((view.code(j, 0) < header->book) && ((codes < 2) || (view.code(j, 1) < header->book)));
+				// Если это не старший порядок
+				if(result && ((i + 1) < header->levels)){
+					// Получаем начало продолжений N-граммы
+					const size_t start = (key >> header->shift);
+					// Начала продолжений не убывают и не выходят за пределы следующего порядка
+					result = ((start >= last) && (start <= count));
+					// Запоминаем начало продолжений
+					last = start;
+				}
+			}
+		}
+		// Освобождаем отображённый блок
+		munmap(buffer, length);
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * writeMap Метод дописывания N-грамм, добавленных методом mapBin, и слов, добавленных методом mapVocab, в конец файла словаря для отображения в память
+ * @param filename адрес файла словаря
+ * @return         результат записи
+ */
+const bool anyks::Alm3::writeMap(const string & filename) const noexcept {
+	// Результат работы функции
+	bool result = false;
+	// Блокируем поток
+	const std::lock_guard <std::recursive_mutex> lock(this->locker);
+	// Если N-граммы и слова добавлены без ошибок и словарь не пустой
+	if(!filename.empty() && !this->writer.broken && !this->writer.counts.empty() && (this->writer.counts.front() > 0) && !this->writer.ids.empty()){
+		// Отсортированная таблица идентификаторов слов
+		const vector <size_t> words(this->writer.words.begin(), this->writer.words.end());
+		// Количество бит индекса слова в ключе N-граммы
+		u_short shift = 0;
+		// Количество бит индекса слова выбираем по размеру словаря
+		for(; (size_t(1) << shift) < words.size(); shift++);
+		// Проверяем что индексы продолжений помещаются в ключ N-граммы
+		bool fits = true;
+		// Переходим по всем порядкам N-грамм
+		for(auto & count : this->writer.counts) fits = (fits && ((shift == 0) || ((count >> (64 - shift)) == 0)));
+		// Открываем файл на дописывание
+		ofstream file(filename, ios::binary | ios::app);
+		// Если индексы продолжений помещаются в ключ и файл открыт
+		if(fits && file.is_open()){
+			// Заголовок блока N-грамм
+			map_t header;
+			// Окончание файла с N-граммами
+			tail_t tail;
+			// Выравнивание порядков N-грамм внутри блока
+			const size_t align = 64;
+			// Получаем количество порядков N-грамм
+			const size_t levels = this->writer.counts.size();
+			// Получаем размер кода квантованной частоты, до 8 бит код занимает один байт
+			const u_short width = (this->writer.bits > 0 ? (this->writer.bits > 8 ? 2 : 1) : 0);
+			// Получаем размер одной кодовой книги
+			const size_t book = (this->writer.bits > 0 ? (size_t(1) << this->writer.bits) : 0);
+			// Таблица смещений, количества N-грамм и кодовых книг каждого порядка
+			vector <size_t> table(levels * 3, 0);
+			// Функция выравнивания смещения
+			auto alignFn = [](const size_t offset, const size_t align) noexcept {
+				// Выводим выровненное смещение
+				return (((offset + align - 1) / align) * align);
+			};
+			// Функция проверки квантования порядка, униграммы хранятся без квантования
+			auto quantFn = [this](const size_t index) noexcept {
+				// Выводим результат проверки
+				return ((index > 0) && (this->writer.bits > 0));
+			};
+			// Функция получения размера одной N-граммы порядка, у старшего порядка нет кода обратной частоты
+			auto sizeFn = [&](const size_t index) noexcept {
+				// Выводим размер N-граммы порядка
+				return (quantFn(index) ? (QUANTHEAD + (width * ((index + 1) < levels ? 2 : 1))) : sizeof(node_t));
+			};
+			// Функция получения индекса слова в таблице идентификаторов
+			auto denseFn = [&words](const size_t idw) noexcept {
+				// Выводим индекс слова, все слова N-грамм находятся в таблице
+				return size_t(std::lower_bound(words.begin(), words.end(), idw) - words.begin());
+			};
+			// Перемещаемся в конец файла
+			file.seekp(0, file.end);
+			// Получаем текущий размер файла
+			const size_t size = file.tellp();
+			// Блок N-грамм начинается с границы страницы, чтобы его можно было отобразить в память
+			tail.offset = alignFn(size, MMAP_ALIGN);
+			// Заполняем сигнатуры блока
+			memcpy(tail.magic, MMAP_HEADER, sizeof(tail.magic));
+			memcpy(header.magic, MMAP_HEADER, sizeof(header.magic));
+			// Запоминаем размер кода квантованной частоты
+			header.node = width;
+			// Запоминаем количество порядков N-грамм
+			header.levels = levels;
+			// Запоминаем количество бит квантования
+			header.bits = this->writer.bits;
+			// Запоминаем размер одной кодовой книги
+			header.book = book;
+			// Запоминаем количество бит индекса слова
+			header.shift = shift;
+			// Запоминаем количество слов в таблице
+			header.words = words.size();
+			// Таблица идентификаторов слов идёт сразу за таблицей порядков
+			header.vocab = alignFn(sizeof(map_t) + (table.size() * sizeof(size_t)), align);
+			// Запоминаем количество слов в словаре
+			header.lexemes = this->writer.ids.size();
+			// Словарь слов идёт сразу за таблицей идентификаторов слов
+			header.lexicon = alignFn(header.vocab + (words.size() * sizeof(size_t)), align);
+			// Смещение первого порядка N-грамм
+			size_t offset = (header.lexicon + ((this->writer.ids.size() + this->writer.offsets.size()) * sizeof(size_t)) + this->writer.offsets.back());
+			// Переходим по всем порядкам N-грамм
+			for(size_t i = 0; i < levels; i++){
+				// Запоминаем смещение порядка
+				table.at(i * 3) = alignFn(offset, align);
+				// Запоминаем количество N-грамм порядка
+				table.at(i * 3 + 1) = this->writer.counts.at(i);
+				// Смещаемся за пределы порядка
+				offset = (table.at(i * 3) + (this->writer.counts.at(i) * sizeFn(i)));
+				// Если N-граммы порядка квантованы
+				if(quantFn(i)){
+					// Запоминаем смещение кодовых книг порядка
+					table.at(i * 3 + 2) = alignFn(offset, align);
+					// Смещаемся за пределы кодовых книг
+					offset = (table.at(i * 3 + 2) + (book * sizeof(float) * 2));
+				}
+			}
+			// Буфер выравнивания
+			const vector <char> zeros(MMAP_ALIGN, 0);
+			// Выравниваем начало блока
+			file.write(zeros.data(), tail.offset - size);
+			// Выполняем запись заголовка блока
+			file.write(reinterpret_cast <const char *> (&header), sizeof(header));
+			// Выполняем запись таблицы порядков N-грамм
+			file.write(reinterpret_cast <const char *> (table.data()), table.size() * sizeof(size_t));
+			// Выравниваем начало таблицы идентификаторов слов
+			file.write(zeros.data(), header.vocab - (sizeof(map_t) + (table.size() * sizeof(size_t))));
+			// Выполняем запись таблицы идентификаторов слов
+			file.write(reinterpret_cast <const char *> (words.data()), words.size() * sizeof(size_t));
+			// Выравниваем начало словаря слов
+			file.write(zeros.data(), header.lexicon - (header.vocab + (words.size() * sizeof(size_t))));
+			// Выполняем запись идентификаторов слов словаря и смещений их бинарных данных
+			file.write(reinterpret_cast <const char *> (this->writer.ids.data()), this->writer.ids.size() * sizeof(size_t));
+			file.write(reinterpret_cast <const char *> (this->writer.offsets.data()), this->writer.offsets.size() * sizeof(size_t));
+			{
+				// Буфер бинарных данных слов
+				vector <char> buffer(0x100000);
+				// Количество прочитанных байт
+				size_t count = 0, total = 0;
+				// Перемещаемся в начало временного файла слов
+				rewind(this->writer.vocab);
+				// Копируем бинарные данные слов порциями
+				while((count = fread(buffer.data(), 1, buffer.size(), this->writer.vocab)) > 0){
+					// Выполняем запись бинарных данных слов
+					file.write(buffer.data(), count);
+					// Учитываем прочитанные байты
+					total += count;
+				}
+				// Временный файл должен быть прочитан полностью и без ошибок
+				result = ((ferror(this->writer.vocab) == 0) && (total == this->writer.offsets.back()));
+			}
+			// Запоминаем смещение от начала блока
+			offset = (header.lexicon + ((this->writer.ids.size() + this->writer.offsets.size()) * sizeof(size_t)) + this->writer.offsets.back());
+			// Переходим по всем порядкам N-грамм
+			for(size_t i = 0; result && (i < levels); i++){
+				// Собранные N-граммы порядка, записываются в файл частями
+				vector <node_t> nodes;
+				// Собранные квантованные N-граммы порядка, упакованные без выравнивания
+				vector <char> quants;
+				// Получаем размер одной N-граммы порядка
+				const size_t stride = sizeFn(i);
+				// Получаем кодовые книги порядка, если N-граммы порядка квантуются
+				const float * books = (quantFn(i) ? this->writer.books.at(i).data() : nullptr);
+				/**
+				 * codeFn Функция записи кода частоты квантованной N-граммы
+				 * @param data начало кода
+				 * @param code код частоты
+				 */
+				auto codeFn = [width](char * data, const u_short code) noexcept {
+					// Если код занимает один байт, записываем его как есть
+					if(width == 1) (* data) = char(code);
+					// Иначе записываем код в два байта
+					else memcpy(data, &code, sizeof(code));
+				};
+				// Функция записи собранных N-грамм в файл
+				auto flushFn = [&file, &nodes, &quants]() noexcept {
+					// Выполняем запись N-грамм
+					file.write(reinterpret_cast <const char *> (nodes.data()), nodes.size() * sizeof(node_t));
+					file.write(quants.data(), quants.size());
+					// Очищаем записанные N-граммы
+					nodes.clear();
+					quants.clear();
+				};
+				// Выравниваем начало порядка
+				file.write(zeros.data(), table.at(i * 3) - offset);
+				// Читаем N-граммы порядка из временного файла
+				result = this->readSpill(i, [&](const spill_t & item) noexcept {
+					// Упаковываем индекс слова в словаре
+					size_t key = denseFn(item.idw);
+					// Если это не старший порядок, запоминаем начало продолжений в старших битах ключа
+					if((i + 1) < levels) key |= (item.start << shift);
+					// Если N-граммы порядка квантуются
+					if(books != nullptr){
+						// Добавляем квантованную N-грамму, коды заполнены нулями
+						quants.resize(quants.size() + stride, 0);
+						// Получаем начало N-граммы
+						char * quant = (quants.data() + quants.size() - stride);
+						// Запоминаем параметры N-граммы
+						memcpy(quant, &key, sizeof(key));
+						memcpy(quant + sizeof(key), &item.uppers, sizeof(item.uppers));
+						// Кодируем частоты по кодовым книгам, нулевые коды означают отсутствующие частоты
+						if(item.weight != float(this->zero)) codeFn(quant + QUANTHEAD, this->encode(books, book, item.weight));
+						// У старшего порядка обратной частоты нет, её код не записывается
+						if((item.backoff != 0.0f) && ((i + 1) < levels)) codeFn(quant + QUANTHEAD + width, this->encode(books + book, book, item.backoff));
+					// Иначе добавляем N-грамму без квантования
+					} else {
+						// Добавляем N-грамму
+						nodes.emplace_back();
+						// Запоминаем параметры N-граммы
+						nodes.back().key     = key;
+						nodes.back().uppers  = item.uppers;
+						nodes.back().weight  = item.weight;
+						nodes.back().backoff = item.backoff;
+					}
+					// Если собрано достаточно N-грамм, записываем их
+					if((nodes.size() + (quants.size() / stride)) >= 0x10000) flushFn();
+				});
+				// Записываем оставшиеся N-граммы
+				flushFn();
+				// Смещаемся за пределы порядка
+				offset = (table.at(i * 3) + (this->writer.counts.at(i) * sizeFn(i)));
+				// Если N-граммы порядка квантованы
+				if(books != nullptr){
+					// Выравниваем начало кодовых книг
+					file.write(zeros.data(), table.at(i * 3 + 2) - offset);
+					// Выполняем запись кодовых книг частот и обратных частот
+					file.write(reinterpret_cast <const char *> (books), book * sizeof(float) * 2);
+					// Смещаемся за пределы кодовых книг
+					offset = (table.at(i * 3 + 2) + (book * sizeof(float) * 2));
+				}
+			}
+			// Выполняем запись окончания файла
+			file.write(reinterpret_cast <const char *> (&tail), sizeof(tail));
+			// Запоминаем результат записи
+			result = (result && file.good());
+			// Закрываем файл
+			file.close();
+		}
+	}
+	// Закрываем временные файлы, блок записывается один раз
+	this->writer.clear();
+	// Выводим результат
+	return result;
+}
+/**
+ * codebook Метод построения кодовой книги по значениям методом равнонаполненных интервалов с уточнением по Ллойду
+ * @param values значения для построения кодовой книги (будут отсортированы)
+ * @param book   кодовая книга для заполнения (нулевой код заполняется вызывающей стороной)
+ * @param size   размер кодовой книги
+ */
+void anyks::Alm3::codebook(vector <float> & values, float * book, const size_t size) const noexcept {
+	// Количество заполненных кодов книги
+	size_t count = 1;
+	// Если значения переданы
+	if(!values.empty() && (size > 1)){
+		// Сортируем значения по возрастанию
+		std::sort(values.begin(), values.end());
+		// Список уникальных значений
+		vector <float> unique;
+		// Собираем уникальные значения, пока они помещаются в книгу
+		for(size_t i = 0; (i < values.size()) && (unique.size() < size); i++){
+			// Если значение отличается от предыдущего, добавляем его
+			if(unique.empty() || (unique.back() != values.at(i))) unique.push_back(values.at(i));
+		}
+		// Если все уникальные значения помещаются в книгу, записываем их без потерь
+		if(unique.size() <= (size - 1)){
+			// Копируем уникальные значения в книгу
+			std::copy(unique.begin(), unique.end(), book + 1);
+			// Запоминаем количество заполненных кодов
+			count = (unique.size() + 1);
+		// Иначе разбиваем значения на интервалы с одинаковым количеством значений
+		} else {
+			// Получаем границы конечных значений
+			auto first = std::find_if(values.begin(), values.end(), [](const float value) noexcept {return std::isfinite(value);});
+			auto last = std::find_if(first, values.end(), [](const float value) noexcept {return !std::isfinite(value);});
+			// Бесконечно малое значение записываем в книгу без потерь
+			if(first != values.begin()) book[count++] = values.front();
+			// Количество интервалов разбиения, бесконечно большому значению оставляем отдельный код
+			const size_t bins = (size - count - (last != values.end() ? 1 : 0));
+			// Количество конечных значений
+			const size_t length = std::distance(first, last);
+			// Центры интервалов конечных значений
+			vector <double> centers;
+			// Переходим по всем интервалам
+			for(size_t i = 0; i < bins; i++){
+				// Получаем границы интервала
+				const size_t begin = (i * length / bins), end = ((i + 1) * length / bins);
+				// Если интервал пустой, пропускаем его
+				if(begin >= end) continue;
+				// Центром интервала считаем среднее значение
+				centers.push_back(std::accumulate(first + begin, first + end, 0.0) / double(end - begin));
+			}
+			/**
+			 * Равнонаполненные интервалы плохо описывают редкие хвосты распределения,
+			 * поэтому уточняем центры несколькими итерациями алгоритма Ллойда
+			 */
+			for(u_short n = 0; !centers.empty() && (n < 8); n++){
+				// Сумма и количество значений каждого интервала
+				vector <pair <double, size_t>> sums(centers.size(), {0.0, 0});
+				// Переходим по всем конечным значениям, они отсортированы
+				for(size_t i = 0, j = 0; i < length; i++){
+					// Получаем значение
+					const double value = *(first + i);
+					// Переходим к ближайшему центру, центры тоже отсортированы
+					while(((j + 1) < centers.size()) && ((value - centers.at(j)) > (centers.at(j + 1) - value))) j++;
+					// Учитываем значение в интервале
+					sums.at(j).first += value;
+					sums.at(j).second++;
+				}
+				// Пересчитываем центры непустых интервалов
+				for(size_t i = 0; i < centers.size(); i++){
+					// Если интервал не пустой, центром считаем среднее значение
+					if(sums.at(i).second > 0) centers.at(i) = (sums.at(i).first / double(sums.at(i).second));
+				}
+			}
+			// Переносим центры в кодовую книгу
+			for(auto & center : centers) book[count++] = float(center);
+			// Бесконечно большое значение записываем в книгу без потерь
+			if(last != values.end()) book[count++] = values.back();
+		}
+	}
+	// Оставшиеся коды заполняем последним центром, чтобы книга оставалась отсортированной
+	for(size_t i = count; i < size; i++) book[i] = book[count - 1];
+}
+/**
+ * encode Метод получения кода ближайшего центра кодовой книги
+ * @param book  кодовая книга (нулевой код зарезервирован)
+ * @param size  размер кодовой книги
+ * @param value кодируемое значение
+ * @return      код значения
+ */
+const u_short anyks::Alm3::encode(const float * book, const size_t size, const float value) const noexcept {
+	// Ищем первый центр не меньше значения
+	const float * it = std::lower_bound(book + 1, book + size, value);
+	// Если значение больше всех центров, выводим последний код
+	if(it == (book + size)) return u_short(size - 1);
+	// Если предыдущий центр ближе к значению, выводим его код
+	if((it > (book + 1)) && ((value - *(it - 1)) < (*it - value))) it--;
+	// Выводим код центра
+	return u_short(it - book);
+}
+/**
+ * readSpill Метод чтения N-грамм порядка из временного файла
+ * @param level    порядок N-грамм (начиная с нуля)
+ * @param callback функция обратного вызова
+ * @return         результат чтения
+ */
+const bool anyks::Alm3::readSpill(const size_t level, function <void (const spill_t &)> callback) const noexcept {
+	// Результат работы функции
+	bool result = false;
+	// Если временный файл порядка существует
+	if((level < this->writer.levels.size()) && (this->writer.levels.at(level) != nullptr)){
+		// Получаем временный файл порядка
+		FILE * file = this->writer.levels.at(level);
+		// Буфер прочитанных N-грамм
+		vector <spill_t> buffer(0x10000);
+		// Количество прочитанных N-грамм
+		size_t count = 0, total = 0;
+		// Перемещаемся в начало файла
+		rewind(file);
+		// Читаем N-граммы порциями
+		while((count = fread(buffer.data(), sizeof(spill_t), buffer.size(), file)) > 0){
+			// Передаём прочитанные N-граммы
+			for(size_t i = 0; i < count; i++) callback(buffer.at(i));
+			// Учитываем прочитанные N-граммы
+			total += count;
+		}
+		// Файл должен быть прочитан полностью и без ошибок
+		result = ((ferror(file) == 0) && (total == this->writer.counts.at(level)));
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * quantize Метод построения кодовых книг частот и обратных частот N-грамм, добавленных методом mapBin, для каждого порядка
+ * @param bits    количество бит квантования (от 2 до 16)
+ * @param error   среднеквадратичная ошибка квантования частот и обратных частот
+ * @param maximum максимальная ошибка квантования частот и обратных частот
+ * @return        результат квантования
+ */
+const bool anyks::Alm3::quantize(const u_short bits, pair <double, double> & error, pair <double, double> & maximum) const noexcept {
+	// Результат работы функции
+	bool result = false;
+	// Блокируем поток
+	const std::lock_guard <std::recursive_mutex> lock(this->locker);
+	// Если количество бит квантования допустимо и N-граммы добавлены без ошибок
+	if((bits > 1) && (bits <= 16) && !this->writer.broken && !this->writer.counts.empty()){
+		// Запоминаем что словарь можно квантовать
+		result = true;
+		// Размер кодовой книги
+		const size_t size = (size_t(1) << bits);
+		// Количество квантованных частот и обратных частот
+		size_t weights = 0, backoffs = 0;
+		// Сумма квадратов ошибок квантования частот и обратных частот
+		double weightError = 0.0, backoffError = 0.0;
+		// Максимальные ошибки квантования частот и обратных частот
+		double weightMax = 0.0, backoffMax = 0.0;
+		// Кодовые книги каждого порядка
+		vector <vector <float>> books(this->writer.counts.size());
+		/**
+		 * Униграммы составляют малую часть словаря, но участвуют почти в каждом расчёте,
+		 * поэтому как и в KenLM оставляем частоты и обратные частоты первого порядка без потерь.
+		 * N-граммы читаются из временных файлов, поэтому в памяти находятся только значения одного порядка
+		 */
+		for(size_t i = 1; result && (i < books.size()); i++){
+			// Выделяем память под кодовые книги порядка
+			books.at(i).resize(size * 2, 0.0f);
+			// Получаем кодовые книги порядка
+			float * weightBook = books.at(i).data(), * backoffBook = (books.at(i).data() + size);
+			// Значения частот и обратных частот порядка
+			vector <float> weightValues, backoffValues;
+			// Собираем частоты и обратные частоты порядка
+			result = this->readSpill(i, [&](const spill_t & item) noexcept {
+				// Если частота существует, добавляем её
+				if(item.weight != float(this->zero)) weightValues.push_back(item.weight);
+				// Если обратная частота существует, добавляем её
+				if(item.backoff != 0.0f) backoffValues.push_back(item.backoff);
+			});
+			// Нулевой код частоты зарезервирован под отсутствующую частоту
+			weightBook[0] = float(this->zero);
+			// Нулевой код обратной частоты зарезервирован под отсутствующую обратную частоту
+			backoffBook[0] = 0.0f;
+			// Строим кодовые книги порядка
+			this->codebook(weightValues, weightBook, size);
+			this->codebook(backoffValues, backoffBook, size);
+			// Освобождаем память значений порядка
+			vector <float> ().swap(weightValues);
+			vector <float> ().swap(backoffValues);
+			// Считаем ошибки квантования порядка
+			if(result) result = this->readSpill(i, [&](const spill_t & item) noexcept {
+				// Если частота существует
+				if(item.weight != float(this->zero)){
+					// Если значение конечное
+					if(std::isfinite(item.weight)){
+						// Получаем ошибку квантования
+						const double delta = fabs(double(weightBook[this->encode(weightBook, size, item.weight)]) - double(item.weight));
+						// Учитываем ошибку квантования
+						weightError += (delta * delta);
+						// Запоминаем максимальную ошибку
+						weightMax = std::max(weightMax, delta);
+					}
+					// Увеличиваем количество квантованных частот
+					weights++;
+				}
+				// Если обратная частота существует
+				if(item.backoff != 0.0f){
+					// Если значение конечное
+					if(std::isfinite(item.backoff)){
+						// Получаем ошибку квантования
+						const double delta = fabs(double(backoffBook[this->encode(backoffBook, size, item.backoff)]) - double(item.backoff));
+						// Учитываем ошибку квантования
+						backoffError += (delta * delta);
+						// Запоминаем максимальную ошибку
+						backoffMax = std::max(backoffMax, delta);
+					}
+					// Увеличиваем количество квантованных обратных частот
+					backoffs++;
+				}
+			});
+		}
+		// Если кодовые книги построены
+		if(result){
+			// Запоминаем среднеквадратичные ошибки квантования
+			error.first = (weights > 0 ? sqrt(weightError / double(weights)) : 0.0);
+			error.second = (backoffs > 0 ? sqrt(backoffError / double(backoffs)) : 0.0);
+			// Запоминаем максимальные ошибки квантования
+			maximum.first = weightMax;
+			maximum.second = backoffMax;
+			// Запоминаем кодовые книги
+			this->writer.books.swap(books);
+			// Запоминаем количество бит квантования
+			this->writer.bits = bits;
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * sentences Метод генерации предложений
+ * @param callback функция обратного вызова
+ */
+void anyks::Alm3::sentences(function <const bool (const wstring &)> callback) const noexcept {
+	// Выполняем сборку словаря
+	this->build();
+	// Если языковая модель загружена
+	if(!this->arpa.empty()){
+		/**
+		 * resultFn Функция формирования предложения
+		 * @param data собранный список n-грамм
+		 * @return     флаг продолжения или завершения работы
+		 */
+		auto resultFn = [&callback, this](const list <vector <size_t>> & data){
+			// Если список последовательностей передан
+			if(!data.empty()){
+				// Флаг сборки первой n-граммы
+				bool isStart = false;
+				// Строка результата
+				vector <size_t> result = {size_t(token_t::start)};
+				// Переходим по всему списку n-грамм
+				for(auto & seq : data){
+					// Если это первая итерация
+					if(!isStart && (isStart = !isStart))
+						// Добавляем в список первую n-грамму
+						result.insert(result.end(), seq.begin(), seq.end());
+					// Если это не первая n-грамма
+					else result.push_back(seq.back());
+					// Если последняя грамма является концом предложения
+					if(seq.back() == size_t(token_t::finish)){
+						// Выводим результат
+						if(!callback(this->context(result, true))) return false;
+						// Удаляем последний элемент в списке
+						result.pop_back();
+					}
+				}
+			}
+			// Продолжаем обработку
+			return true;
+		};
+		/**
+		 * Прототип функции оценки собранных последовательностей
+		 * @param  список собранной последовательности
+		 * @return список собранных последовательностей
+		 */
+		function <const list <vector <size_t>> (const vector <size_t> &)> estimateFn;
+		/**
+		 * estimateFn Функция оценки собранных последовательностей
+		 * @param seq список собранной последовательности
+		 * @return    список собранных последовательностей
+		 */
+		estimateFn = [&estimateFn, this](const vector <size_t> & seq) noexcept {
+			// Результат работы функции
+			list <vector <size_t>> result;
+			// Если найден - конец предложения
+			if(seq.back() == size_t(token_t::finish)) result.push_back(seq);
+			// Если последовательность передана
+			else if(seq.size() > 1){
+				// Получаем новый список последовательности
+				vector <size_t> tmp(seq.begin() + 1, seq.end());
+				// Если последовательность не пустая
+				if(!tmp.empty()){
+					// Итератор для подсчета длины n-граммы
+					u_short i = 0;
+					// Индекс найденной n-граммы
+					size_t index = idw_t::NIDW;
+					// Переходим по всему объекту
+					for(auto & idw : seq){
+						// Выполняем поиск нашего слова
+						index = this->child(i, index, idw);
+						// Если слово найдено
+						if(index != idw_t::NIDW){
+							// Получаем диапазон продолжений n-граммы
+							const auto & range = this->range(i + 1, index);
+							// Если мы дошли до конца
+							if(i == (seq.size() - 1)){
+								// Если это не конец и следующий блок пустой, выходим
+								if(range.first < range.second){
+									// Переходим по всему списку следующих n-грамм
+									for(size_t j = range.first; j < range.second; j++){
+										// Получаем идентификатор следующего слова
+										const size_t idw = this->arpa.at(i + 1).idw(j);
+										// Добавляем полученную грамму в список последовательности
+										tmp.push_back(idw);
+										// Если это конец предложения
+										if(idw == size_t(token_t::finish)){
+											// Если результат пустой, добавляем в него первоначальную последовательность
+											if(result.empty()) result.push_back(seq);
+											// Добавляем в список полученную последовательность
+											result.push_back(tmp);
+										// Если это не конец предложения
+										} else {
+											// Выполняем новый запрос
+											const auto & res = estimateFn(tmp);
+											// Если результат получен
+											if(!res.empty()){
+												// Если результат пустой, добавляем в него первоначальную последовательность
+												if(result.empty()) result.push_back(seq);
+												// Добавляем в список полученную последовательность
+												result.insert(result.end(), res.begin(), res.end());
+											}
+										}
+										// Удаляем последнее добавление
+										tmp.pop_back();
+									}
+								}
+								// Выходим из цикла
+								break;
+							// Если это не конец и следующий блок пустой, выходим
+							} else if(range.first == range.second) break;
+						// Выходим из цикла
+						} else break;
+						// Если количество n-грамм достигло предела, выходим
+						if((++i) > (this->size - 1)) break;
+					}
+				}
+			}
+			// Выводим результат
+			return result;
+		};
+		/**
+		 * Прототип функции запуска перебора предложения
+		 * @param  список собранной последовательности
+		 * @param  порядок n-грамм в котором нужно собирать данные
+		 * @param  индекс n-граммы контекста в котором нужно собирать данные
+		 * @return флаг продолжения или завершения работы
+		 */
+		function <const bool (vector <size_t>, const u_short, const size_t)> runFn;
+		/**
+		 * runFn Функция запуска перебора предложения
+		 * @param seq     список собранной последовательности
+		 * @param level   порядок n-грамм в котором нужно собирать данные
+		 * @param context индекс n-граммы контекста в котором нужно собирать данные
+		 * @return        флаг продолжения или завершения работы
+		 */
+		runFn = [&runFn, &estimateFn, &resultFn, this](vector <size_t> seq, const u_short level, const size_t context) noexcept {
+			// Если данные переданы
+			if(!seq.empty() && (context != idw_t::NIDW)){
+				// Получаем диапазон продолжений контекста
+				const auto & range = this->range(level, context);
+				// Переходим по всему списку
+				for(size_t i = range.first; i < range.second; i++){
+					// Добавляем в список n-грамму
+					seq.push_back(this->arpa.at(level).idw(i));
+					// Получаем диапазон продолжений n-граммы
+					const auto & next = this->range(level + 1, i);
+					// Продолжаем сборку данных
+					if(next.first < next.second) runFn(seq, level + 1, i);
+					// Выполняем расчёт собранных данных
+					else if(!resultFn(estimateFn(seq))) return false;
+					// Удаляем данные в последовательности
+					seq.pop_back();
+				}
+			}
+			// Продолжаем работу
+			return true;
+		};
+		// Ищем начало предложения
+		const size_t index = this->child(0, idw_t::NIDW, size_t(token_t::start));
+		// Если начало предложения получено
+		if(index != idw_t::NIDW){
+			// Собранная последовательность
+			vector <size_t> seq;
+			// Получаем диапазон продолжений начала предложения
+			const auto & range = this->range(1, index);
+			// Переходим по всем данным
+			for(size_t i = range.first; i < range.second; i++){
+				// Формируем начало последовательности
+				seq.push_back(this->arpa.at(1).idw(i));
+				// Выполняем обработку данных
+				if(!runFn(seq, 2, i)) return;
+				// Удаляем данные в последовательности
+				seq.pop_back();
+			}
+		}
+	}
+}
+/**
+ * getUppers Метод извлечения регистров для каждого слова
+ * @param seq  последовательность слов для сборки контекста
+ * @param upps список извлечённых последовательностей
+ */
+void anyks::Alm3::getUppers(const vector <size_t> & seq, vector <size_t> & upps) const noexcept {
+	// Выполняем сборку словаря
+	this->build();
+	// Если последовательность передана
+	if(!seq.empty() && !this->arpa.empty()){
+		// Очищаем список регистров
+		upps.clear();
+		// Временная последовательность
+		vector <size_t> tmp, sequence = seq;
+		// Если последовательность не экранированна
+		const bool isFront = (seq.back() == size_t(token_t::finish));
+		const bool isBack =  (seq.front() == size_t(token_t::start));
+		// Если флаги не установлены
+		if(!isFront) sequence.push_back((size_t) token_t::finish);
+		if(!isBack)  sequence.insert(sequence.begin(), (size_t) token_t::start);
+		/**
+		 * Прототип функции извлечения регистров последовательности
+		 * @param  список слов последовательности
+		 * @return регистры последнего слова последовательности
+		 */
+		function <const size_t (const vector <size_t> &)> uppersFn;
+		/**
+		 * uppersFn Функция извлечения регистров последовательности
+		 * @param seq список слов последовательности
+		 * @return    регистры последнего слова последовательности
+		 */
+		uppersFn = [&uppersFn, this](const vector <size_t> & seq) noexcept {
+			// Регистры слова в последовательности
+			size_t result = 0;
+			// Если список последовательностей передан
+			if(!seq.empty() && (this->size > 0)){
+				// Итератор для подсчета длины n-граммы
+				u_short i = 0;
+				// Индекс найденной n-граммы
+				size_t index = idw_t::NIDW;
+				// Переходим по всему объекту
+				for(auto & idw : seq){
+					// Выполняем поиск нашего слова
+					index = this->child(i, index, idw);
+					// Если слово найдено
+					if(index != idw_t::NIDW){
+						// Если мы дошли до конца
+						if(i == (seq.size() - 1)) result = this->arpa.at(i).at(index).uppers;
+					// Выходим из цикла
+					} else break;
+					// Если количество n-грамм достигло предела, выходим
+					if((++i) > (this->size - 1)) break;
+				}
+				// Если последовательность не существует
+				if((i < seq.size()) && (seq.size() > 2)){
+					// Получаем новую последовательность
+					vector <size_t> tmp(seq.begin() + 1, seq.end());
+					// Пробуем уменьшить n-грамму
+					result = uppersFn(tmp);
+				}
+			}
+			// Выводим результат
+			return result;
+		};
+		// Регистр слова
+		size_t uppers = 0;
+		// Флаг сборки первой итерации
+		bool flag = false;
+		// Количество переданных последовательностей
+		const size_t count = sequence.size();
+		// Определяем смещение в последовательности
+		size_t offset1 = 0, offset2 = (count > size_t(this->size) ? this->size : count);
+		// Выполняем извлечение данных
+		while(offset2 < (count + 1)){
+			// Получаем первую часть последовательности
+			tmp.assign(sequence.begin() + offset1, sequence.begin() + offset2);
+			// Если последовательность получена
+			if(!tmp.empty()){
+				// Получаем регистр слова
+				uppers = uppersFn(tmp);
+				// Если сборка первой n-граммы не выполнена
+				if(!flag && (flag = !flag)){
+					// Переходим по всей последовательности
+					for(size_t i = (!isFront ? 1 : 0); i < tmp.size(); i++){
+						// Если это не последнее слово в списке, добавляем нули
+						if(i != (tmp.size() - 1))
+							upps.push_back(0);
+						// Если же это последнее слово, добавляем регистр
+						else upps.push_back(uppers);
+					}
+				// Если же сборка первой n-граммы уже выполнена
+				} else upps.push_back(uppers);
+			// Выходим из цикла
+			} else break;
+			// Увеличиваем смещение
+			offset1++;
+			offset2++;
+		}
+		// Удаляем лишний элемент регистра
+		if(!isBack) upps.pop_back();
+	}
+}
+/**
+ * find Метод поиска n-грамм в тексте
+ * @param text     текст в котором необходимо найти n-граммы
+ * @param callback функция обратного вызова
+ */
+void anyks::Alm3::find(const wstring & text, function <void (const wstring &)> callback) const noexcept {
+	// Выполняем сборку словаря
+	this->build();
+	// Если слово передано
+	if(!text.empty() && !this->arpa.empty()){
+		// Идентификатор неизвестного слова
+		const size_t uid = (size_t) token_t::unk;
+		// Идентификатор начала предложения
+		const size_t sid = (size_t) token_t::start;
+		// Идентификатор конца предложения
+		const size_t fid = (size_t) token_t::finish;
+		// Список последовательностей для обучения
+		vector <size_t> seq = {sid};
+		// Собранная n-грамма для проверки
+		vector <wstring> words = {L"<s>"};
+		// Кэш списка собранных n-грамм
+		std::unordered_set <wstring> cache = {};
+		/**
+		 * callbackFn Функция вывода результата
+		 * @param words список слов для вывода результата
+		 * @param count количество слов для вывода результата
+		 */
+		auto callbackFn = [&cache, &callback](const vector <wstring> & words, const size_t count){
+			// Если список слов передан
+			if(!words.empty() && (count > 1)){
+				// Получившаяся строка текста
+				wstring text = L"";
+				// Переходим по всему списку слов
+				for(size_t i = 0; i < count; i++){
+					// Добавляем в текст слово
+					text.append(words.at(i));
+					// Добавляем пробел
+					text.append(L" ");
+				}
+				// Удаляем последний пробел
+				text.pop_back();
+				// Если текст получен
+				if(!text.empty() && (cache.count(text) < 1)){
+					// Выводим результат
+					callback(text);
+					// Добавляем собранный результат в кэш
+					cache.emplace(text);
+				}
+			}
+		};
+		/**
+		 * unkFn Функция установки неизвестного слова в последовательность
+		 * @return нужно ли остановить сбор последовательности
+		 */
+		auto unkFn = [&seq, &words, uid, this]() noexcept {
+			// Получаем установленное неизвестное слово
+			const word_t & word = (this->unknown > 0 ? this->word(this->unknown) : L"");
+			// Если неизвестное слово не установлено
+			if((this->unknown == 0) || word.empty()){
+				// Добавляем неизвестное слово
+				seq.push_back(uid);
+				// Добавляем в список неизвестное слово
+				words.push_back(L"<unk>");
+			// Если неизвестное слово установлено
+			} else if(!word.empty()) {
+				// Добавляем установленное неизвестное слово
+				seq.push_back(this->unknown);
+				// Добавляем полученное ранее слово
+				words.push_back(word.wreal());
+			}
+		};
+		/**
+		 * Прототип функции проверки существования последовательности
+		 * @param список слов последовательности
+		 * @param список реальных слов в последовательности
+		 */
+		function <void (const vector <size_t> &, const vector <wstring> &)> checkFn;
+		/**
+		 * checkFn Функция проверки существования последовательности
+		 * @param seq   список слов последовательности
+		 * @param words список реальных слов в последовательности
+		 */
+		checkFn = [&checkFn, &callbackFn, this](const vector <size_t> & seq, const vector <wstring> & words) noexcept {
+			// Если список последовательностей передан
+			if(!seq.empty() && !words.empty() && (this->size > 0)){
+				// Итератор для подсчета длины n-граммы
+				u_short i = 0;
+				// Результат поиска слова
+				bool exist = false;
+				// Индекс найденной n-граммы
+				size_t index = idw_t::NIDW;
+				// Переходим по всему объекту
+				for(auto & idw : seq){
+					// Выполняем поиск нашего слова
+					index = this->child(i, index, idw);
+					// Если слово найдено
+					if(index != idw_t::NIDW){
+						// Если мы дошли до конца
+						exist = (i == (seq.size() - 1));
+					// Выходим из цикла
+					} else break;
+					// Если количество n-грамм достигло предела, выходим
+					if((++i) > (this->size - 1)) break;
+				}
+				// Выводим результат
+				callbackFn(words, i);
+				// Если последовательность не существует
+				if(!exist && (seq.size() > 2)){
+					// Получаем новую последовательность
+					vector <size_t> tmp1(seq.begin() + 1, seq.end());
+					// Получаем новую последовательность слов
+					vector <wstring> tmp2(words.begin() + 1, words.end());
+					// Пробуем уменьшить n-грамму
+					checkFn(tmp1, tmp2);
+				}
+			}
+		};
+		/**
+		 * resFn Функция вывода результата
+		 */
+		auto resFn = [&]() noexcept {
+			// Добавляем в список конец предложения
+			seq.push_back(fid);
+			// Добавляем конец предложения
+			words.push_back(L"</s>");
+			/**
+			 * Если слова всего два, значит это начало и конец предложения.
+			 * Нам же нужны только нормальные n-граммы.
+			 */
+			if((seq.size() > 2) && (seq.size() == words.size())){
+				// Временная последовательность
+				vector <size_t> tmp1;
+				// Временный список слов
+				vector <wstring> tmp2;
+				// Количество переданных последовательностей
+				const size_t count = seq.size();
+				// Определяем смещение в последовательности
+				size_t offset1 = 0, offset2 = (count > size_t(this->size) ? this->size : count);
+				// Выполняем извлечение данных
+				while(offset2 < (count + 1)){
+					// Получаем первую часть последовательности
+					tmp1.assign(seq.begin() + offset1, seq.begin() + offset2);
+					// Получаем первую часть списка слов
+					tmp2.assign(words.begin() + offset1, words.begin() + offset2);
+					// Если последовательность получена
+					if(!tmp1.empty()) checkFn(tmp1, tmp2);
+					// Увеличиваем смещение
+					offset1++;
+					offset2++;
+				}
+				// Выводим разделитель предложений
+				callback(L"\r\n");
+			}
+			// Очищаем список последовательностей
+			seq.clear();
+			// Очищаем список собранных слов
+			words.clear();
+			// Добавляем в список начало предложения
+			seq.push_back(sid);
+			// Добавляем начало предложения
+			words.push_back(L"<s>");
+		};
+		/**
+		 * modeFn Функция обработки разбитого текста
+		 * @param word  слово для обработки
+		 * @param ctx   контекст к которому принадлежит слово
+		 * @param reset флаг сброса контекста
+		 * @param stop  флаг завершения обработки
+		 */
+		auto modeFn = [&](const wstring & word, const vector <string> & ctx, const bool reset, const bool stop) noexcept {
+			// Если это сброс контекста, отправляем результат
+			if(reset) resFn();
+			// Если слово передано
+			if(!word.empty()){
+				// Получаем данные слова
+				word_t tmp = word;
+				// Если модуль питона активирован
+				if(this->python != nullptr){
+// Если работа идет не изнутри Python
+#ifndef NOPYTHON
+					// Ищем скрипт обработки слов
+					auto it = this->scripts.find(1);
+					// Если скрипт обработки слов установлен
+					if(it != this->scripts.end()){
+						// Блокируем поток
+						this->locker.lock();
+						// Выполняем внешний python скрипт
+						tmp = this->python->run(it->second.second, {tmp.real()}, ctx);
+						// Разблокируем поток
+						this->locker.unlock();
+					}
+#endif
+				// Если модуль предобработки слов, существует
+				} else if(this->wordPress != nullptr) tmp = this->wordPress(tmp.real(), ctx);
+				// Если слово не разрешено
+				if(tmp.length() >= MAX_WORD_LENGTH) unkFn();
+				// Если слово разрешено
+				else if(!tmp.empty()) {
+					// Получаем идентификатор слова
+					const size_t idw = this->getIdw(tmp);
+					// Если это плохое слово, заменяем его на неизвестное
+					if((idw == 0) || (idw == idw_t::NIDW) || (this->badwords.count(idw) > 0)) unkFn();
+					// Иначе продолжаем дальше
+					else {
+						// Проверяем является ли строка словом
+						const bool isWord = !this->tokenizer->isToken(idw);
+						// Если это неизвестное слово
+						if((idw == uid) || (isWord && (this->getWord(idw) == nullptr))) unkFn();
+						// Иначе добавляем слово
+						else if(!isWord || (this->goodwords.count(idw) > 0) || this->alphabet->isAllowed(tmp)){
+							// Добавляем идентификатор в список последовательности
+							seq.push_back(idw);
+							// Добавляем слово в список слов
+							words.push_back(word);
+						// Отправляем слово как неизвестное
+						} else unkFn();
+					}
+				}
+			}
+			// Если это конец, отправляем результат
+			if(stop) resFn();
+			// Выводим результат
+			return true;
+		};
+		// Выполняем разбивку текста на токены
+		this->tokenizer->run(text, modeFn);
+	}
+}
+/**
+ * context Метод сборки текстового контекста из последовательности
+ * @param seq  последовательность слов для сборки контекста
+ * @param nwrd флаг разрешающий вывод системных токенов
+ * @return     собранный текстовый контекст
+ */
+const std::wstring anyks::Alm3::context(const std::vector <std::size_t> & seq, const bool nwrd) const noexcept {
+	// Результат работы функции
+	wstring result = L"";
+	// Выполняем сборку словаря
+	this->build();
+	// Если последовательность передана
+	if(!seq.empty() && !this->arpa.empty()){
+		// Временная последовательность
+		vector <size_t> tmp, sequence = seq;
+		// Если последовательность не экранированна
+		if(seq.back() != size_t(token_t::finish)) sequence.push_back((size_t) token_t::finish);
+		if(seq.front() != size_t(token_t::start)) sequence.insert(sequence.begin(), (size_t) token_t::start);
+		/**
+		 * Прототип функции извлечения регистров последовательности
+		 * @param  список слов последовательности
+		 * @return регистры последнего слова последовательности
+		 */
+		function <const size_t (const vector <size_t> &)> uppersFn;
+		/**
+		 * uppersFn Функция извлечения регистров последовательности
+		 * @param seq список слов последовательности
+		 * @return    регистры последнего слова последовательности
+		 */
+		uppersFn = [&uppersFn, this](const vector <size_t> & seq) noexcept {
+			// Регистры слова в последовательности
+			size_t result = 0;
+			// Если список последовательностей передан
+			if(!seq.empty() && (this->size > 0)){
+				// Итератор для подсчета длины n-граммы
+				u_short i = 0;
+				// Индекс найденной n-граммы
+				size_t index = idw_t::NIDW;
+				// Переходим по всему объекту
+				for(auto & idw : seq){
+					// Выполняем поиск нашего слова
+					index = this->child(i, index, idw);
+					// Если слово найдено
+					if(index != idw_t::NIDW){
+						// Если мы дошли до конца
+						if(i == (seq.size() - 1)) result = this->arpa.at(i).at(index).uppers;
+					// Выходим из цикла
+					} else break;
+					// Если количество n-грамм достигло предела, выходим
+					if((++i) > (this->size - 1)) break;
+				}
+				// Если последовательность не существует
+				if((i < seq.size()) && (seq.size() > 2)){
+					// Получаем новую последовательность
+					vector <size_t> tmp(seq.begin() + 1, seq.end());
+					// Пробуем уменьшить n-грамму
+					result = uppersFn(tmp);
+				}
+			}
+			// Выводим результат
+			return result;
+		};
+		// Полученное слово последовательности
+		word_t word = L"";
+		// Регистр слова
+		size_t uppers = 0;
+		// Флаг сборки первой итерации
+		bool flag = false;
+		// Количество переданных последовательностей
+		const size_t count = sequence.size();
+		// Определяем смещение в последовательности
+		size_t offset1 = 0, offset2 = (count > size_t(this->size) ? this->size : count);
+		// Выполняем извлечение данных
+		while(offset2 < (count + 1)){
+			// Получаем первую часть последовательности
+			tmp.assign(sequence.begin() + offset1, sequence.begin() + offset2);
+			// Если последовательность получена
+			if(!tmp.empty()){
+				// Получаем регистр слова
+				uppers = uppersFn(tmp);
+				// Если сборка первой n-граммы не выполнена
+				if(!flag && (flag = !flag)){
+					// Переходим по всей последовательности
+					for(size_t i = 0; i < tmp.size(); i++){
+						// Получаем слово
+						word = this->word(tmp.at(i));
+						// Если разрешено выводить системные токены или это нормальные слова
+						if(nwrd || ((word.front() != L'<') && (word.back() != L'>'))){
+							// Если это первое слово
+							if(i == 1) word.setUppers(1);
+							// Если это последнее слово
+							else if(i == (tmp.size() - 1)) word.setUppers(uppers);
+							// Формируем строку
+							result.append(word.wreal());
+							// Добавляем разделитель
+							result.append(L" ");
+						}
+					}
+				// Если же сборка первой n-граммы уже выполнена
+				} else {
+					// Получаем слово
+					word = this->word(tmp.back());
+					// Если разрешено выводить системные токены или это нормальные слова
+					if(nwrd || ((word.front() != L'<') && (word.back() != L'>'))){
+						// Устанавливаем регистры слова
+						word.setUppers(uppers);
+						// Формируем строку
+						result.append(word.wreal());
+						// Добавляем разделитель
+						result.append(L" ");
+					}
+				}
+			// Выходим из цикла
+			} else break;
+			// Увеличиваем смещение
+			offset1++;
+			offset2++;
+		}
+		// Если строка получена
+		if(!result.empty()) result.pop_back();
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * ~Alm3 Деструктор
+ */
+anyks::Alm3::~Alm3() noexcept {
+	// Очищаем языковую модель
+	this->clear();
+}
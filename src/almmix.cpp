@@ -0,0 +1,457 @@
+/**
+ *  author:   Yuriy Lobarev
+ *  telegram: @forman
+ *  phone:    +7(910)983-95-90
+ *  email:    forman@anyks.com
+ *  site:     https://anyks.com
+ */
+
+#include <alm.hpp>
+
+/**
+ * interpolate Метод интерполяции весов полученных от каждой модели
+ * @param weights список весов моделей (log(0) если модель вес не вернула)
+ * @return        интерполированный вес (log(0) если вес не получен ни от одной модели)
+ */
+const double anyks::AlmMixture::interpolate(const vector <double> & weights) const noexcept {
+	// Результат работы функции
+	double result = this->zero;
+	// Сумма весов всех моделей и сумма весов моделей вернувших вес
+	double total = 0.0, found = 0.0, sum = 0.0;
+	// Переходим по всем моделям смеси
+	for(size_t i = 0; i < weights.size(); i++){
+		// Увеличиваем сумму весов всех моделей
+		total += this->lambdas[i];
+		// Если модель не вернула вес, пропускаем её
+		if(weights[i] == this->zero) continue;
+		// Увеличиваем сумму весов моделей вернувших вес
+		found += this->lambdas[i];
+		// Определяем режим интерполяции
+		switch((u_short) this->mode){
+			// Для линейной интерполяции суммируем вероятности
+			case (u_short) mode_t::linear: sum += (this->lambdas[i] * exp(weights[i] * this->mln10)); break;
+			// Для лог-линейной интерполяции суммируем веса
+			case (u_short) mode_t::loglinear: sum += (this->lambdas[i] * weights[i]); break;
+		}
+	}
+	// Если вес получен хотя бы от одной модели
+	if((found > 0.0) && (total > 0.0)){
+		// Определяем режим интерполяции
+		switch((u_short) this->mode){
+			// Для линейной интерполяции нормируем вероятность по весам всех моделей
+			case (u_short) mode_t::linear: if(sum > 0.0) result = log10(sum / total); break;
+			// Для лог-линейной интерполяции нормируем вес по весам моделей вернувших вес
+			case (u_short) mode_t::loglinear: result = (sum / found); break;
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * exist Метод проверки существования последовательности
+ * @param seq список слов последовательности
+ * @return    результат проверки
+ */
+const bool anyks::AlmMixture::exist(const vector <size_t> & seq) const noexcept {
+	// Переходим по всем моделям смеси
+	for(auto & alm : this->alms){
+		// Если последовательность существует хотя бы в одной модели, выходим
+		if(alm->exist(seq)) return true;
+	}
+	// Сообщаем что последовательность не найдена
+	return false;
+}
+/**
+ * weight Метод извлечения веса последовательности
+ * @param seq последовательность для извлечения веса
+ * @return    вес последовательноси и n-грамма для которой она получена
+ */
+const std::pair <u_short, double> anyks::AlmMixture::weight(const vector <size_t> & seq) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Если последовательность передана
+	if(!seq.empty() && !this->alms.empty()){
+		// Список весов полученных от каждой модели
+		vector <double> weights(this->alms.size(), this->zero);
+		// Переходим по всем моделям смеси
+		for(size_t i = 0; i < this->alms.size(); i++){
+			// Получаем вес последовательности в модели
+			const auto & wrs = this->alms[i]->weight(seq);
+			// Если вес получен
+			if(wrs.second != 0.0){
+				// Запоминаем вес модели
+				weights[i] = wrs.second;
+				// Запоминаем максимальную граммность
+				result.first = max(result.first, wrs.first);
+			}
+		}
+		// Выполняем интерполяцию весов
+		const double weight = this->interpolate(weights);
+		// Если вес получен, запоминаем его
+		if(weight != this->zero) result.second = weight;
+		// Иначе сбрасываем граммность
+		else result.first = 0;
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * frequency Метод извлечения частоты n-граммы
+ * @param seq список слов последовательности
+ * @return    частота и обратная частота n-граммы
+ */
+const std::pair <double, double> anyks::AlmMixture::frequency(const vector <size_t> & seq) const noexcept {
+	// Результат работы функции, у смеси нет собственной обратной частоты
+	pair <double, double> result = {this->zero, this->zero};
+	// Если последовательность передана
+	if(!seq.empty() && !this->alms.empty()){
+		// Список частот полученных от каждой модели
+		vector <double> weights(this->alms.size(), this->zero);
+		// Переходим по всем моделям смеси и получаем частоту n-граммы
+		for(size_t i = 0; i < this->alms.size(); i++) weights[i] = this->alms[i]->frequency(seq).first;
+		// Выполняем интерполяцию частот
+		result.first = this->interpolate(weights);
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * pplWeight Метод расчёта веса окна последовательности без его копирования
+ * @param seq   последовательность слов в которой находится окно
+ * @param begin позиция начала окна в последовательности
+ * @param end   позиция конца окна в последовательности (не включительно)
+ * @param unk   разрешено ли неизвестное слово
+ * @return      граммность и вес n-граммы
+ */
+const std::pair <u_short, double> anyks::AlmMixture::pplWeight(const vector <size_t> & seq, const size_t begin, const size_t end, const bool unk) const noexcept {
+	// Результат работы функции
+	pair <u_short, double> result = {0, 0.0};
+	// Если окно передано
+	if((begin < end) && !this->alms.empty()){
+		// Список весов полученных от каждой модели
+		vector <double> weights(this->alms.size(), this->zero);
+		// Переходим по всем моделям смеси
+		for(size_t i = 0; i < this->alms.size(); i++){
+			// Получаем размер n-граммы модели
+			const size_t size = this->alms[i]->size;
+			// Каждая модель получает окно не длиннее своей n-граммы
+			const size_t first = ((end - begin) > size ? end - size : begin);
+			// Получаем вес окна в модели
+			const auto & wrs = this->alms[i]->pplWeight(seq, first, end, unk && this->unks[i]);
+			// Если вес получен
+			if(wrs.second != 0.0){
+				// Запоминаем вес модели
+				weights[i] = wrs.second;
+				// Запоминаем максимальную граммность
+				result.first = max(result.first, wrs.first);
+			}
+		}
+		// Выполняем интерполяцию весов
+		const double weight = this->interpolate(weights);
+		// Если вес получен, запоминаем его
+		if(weight != this->zero) result.second = weight;
+		// Иначе сбрасываем граммность
+		else result.first = 0;
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * setWords Метод установки функций получения слов из словарей языковых моделей смеси
+ */
+void anyks::AlmMixture::setWords() noexcept {
+	/**
+	 * Идентификаторы слов одинаковы во всех моделях, поэтому слово запрашивается у моделей смеси,
+	 * словари моделей не копируются, так как модель может распаковывать слова только при обращении к ним
+	 */
+	this->setWordFn([this](const size_t idw) noexcept {
+		// Результат работы функции
+		const word_t * result = nullptr;
+		// Ищем слово среди слов добавленных в саму смесь
+		auto it = this->vocab.find(idw);
+		// Если слово найдено, выводим его
+		if(it != this->vocab.end()) result = &it->second;
+		// Иначе запрашиваем слово у моделей смеси по порядку
+		else {
+			// Переходим по всем моделям смеси, пока слово не найдено
+			for(size_t i = 0; (result == nullptr) && (i < this->alms.size()); i++) result = this->alms[i]->getWord(idw);
+		}
+		// Выводим результат
+		return result;
+	}, [this](const size_t idw, const word_t & word) noexcept {
+		// Добавляем слово в словарь смеси
+		this->vocab.emplace(idw, word);
+	});
+}
+/**
+ * clear Метод очистки всех данных
+ */
+void anyks::AlmMixture::clear(){
+	// Очищаем список языковых моделей
+	this->alms.clear();
+	// Очищаем список флагов неизвестного слова
+	this->unks.clear();
+	// Очищаем список весов моделей
+	this->lambdas.clear();
+	// Сбрасываем размер n-граммы
+	this->size = 1;
+	// Выполняем удаление всех основных параметров
+	reinterpret_cast <alm_t *> (this)->clear();
+}
+/**
+ * add Метод добавления языковой модели в смесь
+ * @param alm    объект загруженной языковой модели
+ * @param lambda вес языковой модели в смеси
+ */
+void anyks::AlmMixture::add(const alm_t * alm, const double lambda) noexcept {
+	// Если языковая модель передана
+	if((alm != nullptr) && (alm != this)){
+		// Добавляем языковую модель в смесь
+		this->alms.push_back(alm);
+		// Добавляем вес языковой модели
+		this->lambdas.push_back(lambda < 0.0 ? 0.0 : lambda);
+		// Запоминаем разрешено ли в модели неизвестное слово
+		this->unks.push_back(alm->frequency({size_t(token_t::unk)}).first != this->zero);
+		// Если первая модель или n-грамма модели больше, запоминаем размер n-граммы
+		if((this->alms.size() == 1) || (alm->size > this->size)) this->size = alm->size;
+	}
+}
+/**
+ * setMode Метод установки режима интерполяции моделей
+ * @param mode режим интерполяции моделей
+ */
+void anyks::AlmMixture::setMode(const mode_t mode) noexcept {
+	// Запоминаем режим интерполяции
+	this->mode = mode;
+}
+/**
+ * setLambda Метод установки веса языковой модели в смеси
+ * @param index  индекс языковой модели в смеси
+ * @param lambda вес языковой модели
+ */
+void anyks::AlmMixture::setLambda(const size_t index, const double lambda) noexcept {
+	// Если индекс модели существует, запоминаем вес модели
+	if(index < this->lambdas.size()) this->lambdas[index] = (lambda < 0.0 ? 0.0 : lambda);
+}
+/**
+ * setLambdas Метод установки весов всех языковых моделей в смеси
+ * @param lambdas список весов языковых моделей
+ */
+void anyks::AlmMixture::setLambdas(const vector <double> & lambdas) noexcept {
+	// Переходим по всем переданным весам и устанавливаем их
+	for(size_t i = 0; i < lambdas.size(); i++) this->setLambda(i, lambdas[i]);
+}
+/**
+ * getMode Метод получения режима интерполяции моделей
+ * @return режим интерполяции моделей
+ */
+const anyks::AlmMixture::mode_t anyks::AlmMixture::getMode() const noexcept {
+	// Выводим режим интерполяции
+	return this->mode;
+}
+/**
+ * getLambdas Метод получения весов языковых моделей в смеси
+ * @return список весов языковых моделей
+ */
+const std::vector <double> & anyks::AlmMixture::getLambdas() const noexcept {
+	// Выводим список весов моделей
+	return this->lambdas;
+}
+/**
+ * perplexity Метод расчёта перплексии
+ * @param  seq список последовательностей
+ * @return     результат расчёта
+ */
+const anyks::Alm::ppl_t anyks::AlmMixture::perplexity(const vector <size_t> & seq) const noexcept {
+	// Результат работы функции
+	ppl_t result;
+	// Если текст передан
+	if(!this->alms.empty() && (seq.size() > 2) && (this->size > 0) &&
+	(seq.front() == size_t(token_t::start)) && (seq.back() == size_t(token_t::finish))){
+		// Количество переданных последовательностей
+		const size_t count = seq.size();
+		// Количество моделей в смеси
+		const size_t models = this->alms.size();
+		// Последняя позиция слова для расчёта (не включительно), как при расчёте по окнам
+		const size_t last = (count >= size_t(this->size) ? count : count - 1);
+		// Проверяем разрешено ли неизвестное слово
+		const bool isAllowUnk = (this->frequency({size_t(token_t::unk)}).first != this->zero);
+		// Состояния контекста каждой модели для текущего и следующего слова
+		vector <state_t> states(models), next(models);
+		// Список весов полученных от каждой модели
+		vector <double> weights(models, this->zero);
+		// Текст данных отладки собранных при расчёте
+		vector <string> debugMessages;
+		// Переходим по всем моделям смеси и устанавливаем начало предложения
+		for(size_t i = 0; i < models; i++) this->alms[i]->score(states[i], seq.front(), next[i]);
+		// Меняем состояния местами
+		states.swap(next);
+		// Сбрасываем значение результата
+		result.logprob = 0.0;
+		// Переходим по всем словам последовательности
+		for(size_t pos = 1; pos < last; pos++){
+			// Граммность полученного веса
+			u_short gram = 0;
+			// Переходим по всем моделям смеси
+			for(size_t i = 0; i < models; i++){
+				// Получаем вес слова по сохранённому состоянию контекста модели
+				const auto & wrs = this->alms[i]->score(states[i], seq[pos], next[i]);
+				// Запоминаем вес модели
+				weights[i] = (wrs.second != 0.0 ? wrs.second : this->zero);
+				// Запоминаем максимальную граммность
+				if(wrs.second != 0.0) gram = max(gram, wrs.first);
+			}
+			// Меняем состояния местами
+			states.swap(next);
+			// Выполняем интерполяцию весов
+			const double weight = this->interpolate(weights);
+			// Если вес получен, увеличиваем общее значение веса
+			if(weight != this->zero) result.logprob += weight;
+			// Увеличиваем количество нулевых весов
+			else result.zeroprobs++;
+			// Если нужно вывести отладочную информацию
+			if(this->isOption(options_t::debug)){
+				// Граммность n-граммы
+				string numGram = "OOV";
+				// Значение полученного веса
+				double prob = 0.0, lprob = this->zero;
+				// Если вес не нулевой
+				if(weight != this->zero){
+					// Запоминаем вес n-граммы
+					lprob = weight;
+					// Избавляемся от логорифма
+					prob = pow(10, weight);
+					// Устанавливаем граммность
+					numGram = (std::to_string(gram) + "gram");
+				}
+				// Формируем информационное сообщение
+				debugMessages.push_back(this->alphabet->format(
+					"p( %s | %s %s) \t= [%s] %4.8f [ %4.8f ]",
+					this->word(seq[pos]).real().c_str(),
+					this->word(seq[pos - 1]).real().c_str(),
+					(pos > 1 ? "..." : ""),
+					numGram.c_str(),
+					prob, lprob
+				));
+			}
+		}
+		// Если неизвестное слово не разрешено
+		if(!isAllowUnk){
+			// Считаем количество неизвестных слов
+			for(auto & idw : seq){
+				// Считаем количество неизвестных слов
+				if(idw == size_t(token_t::unk)) result.oovs++;
+			}
+		}
+		// Устанавливаем предложение
+		result.sentences = 1;
+		// Устанавливаем количество слов
+		result.words = (seq.size() - 2);
+		// Если количество нулевых весов и количество неизвестных слов получено
+		if((result.oovs > 0) && (result.zeroprobs > 0)) result.zeroprobs -= result.oovs;
+		// Выполняем расчёт перплексии
+		const auto ppl = this->pplCalculate(result.logprob, result.words, result.oovs);
+		// Усталавниваем полученные значения перплексии
+		result.ppl  = ppl.first;
+		result.ppl1 = ppl.second;
+		// Выводим отладочную информацию
+		if(this->isOption(options_t::debug)){
+			// Блокируем поток
+			this->locker.lock();
+			// Если список отладки сформирован
+			if(!debugMessages.empty()){
+				// Получаем обрабатываемый текст
+				const wstring & text = this->context(seq, true);
+				// Выводим сообщение отладки - количество слов
+				this->alphabet->log("%ls\n", alphabet_t::log_t::info, this->logfile, text.c_str());
+				// Переходим по всему списку отладки и выводим сообщения
+				for(auto & mess : debugMessages) this->alphabet->log("%s", alphabet_t::log_t::info, this->logfile, mess.c_str());
+			}
+			// Выводим разделитель
+			this->alphabet->log("%s", alphabet_t::log_t::null, this->logfile, "\r\n");
+			// Выводим сообщение отладки - количество слов
+			this->alphabet->log(
+				"%u sentences, %u words, %u OOVs",
+				alphabet_t::log_t::info,
+				this->logfile,
+				result.sentences,
+				result.words,
+				result.oovs
+			);
+			// Выводим сообщение отладки - результатов расчёта
+			this->alphabet->log(
+				"%u zeroprobs, logprob= %4.8f ppl= %4.8f ppl1= %4.8f\r\n",
+				alphabet_t::log_t::info,
+				this->logfile,
+				result.zeroprobs,
+				result.logprob,
+				result.ppl,
+				result.ppl1
+			);
+			// Разблокируем поток
+			this->locker.unlock();
+		}
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * check Метод проверки существования последовательности, с указанным шагом
+ * @param seq  список слов последовательности
+ * @param step размер шага проверки последовательности
+ * @return     результат проверки
+ */
+const bool anyks::AlmMixture::check(const vector <size_t> & seq, const u_short step) const noexcept {
+	// Переходим по всем моделям смеси
+	for(auto & alm : this->alms){
+		// Если последовательность существует хотя бы в одной модели, выходим
+		if(alm->check(seq, step)) return true;
+	}
+	// Сообщаем что последовательность не найдена
+	return false;
+}
+/**
+ * exist Метод проверки существования последовательности
+ * @param seq  список слов последовательности
+ * @param step размер шага проверки последовательности
+ * @return     результат проверки
+ */
+const std::pair <bool, std::size_t> anyks::AlmMixture::exist(const std::vector <std::size_t> & seq, const u_short step) const noexcept {
+	// Результат работы функции
+	pair <bool, size_t> result = {false, 0};
+	// Переходим по всем моделям смеси
+	for(auto & alm : this->alms){
+		// Выполняем проверку в модели
+		const auto & res = alm->exist(seq, step);
+		// Запоминаем результат модели с наибольшим количеством совпадений
+		if(res.first && (!result.first || (res.second > result.second))) result = res;
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * check Метод проверки существования последовательности
+ * @param seq      список слов последовательности
+ * @param accurate режим точной проверки
+ * @return         результат проверки
+ */
+const std::pair <bool, std::size_t> anyks::AlmMixture::check(const std::vector <std::size_t> & seq, const bool accurate) const noexcept {
+	// Результат работы функции
+	pair <bool, size_t> result = {false, 0};
+	// Переходим по всем моделям смеси
+	for(auto & alm : this->alms){
+		// Выполняем проверку в модели
+		result = alm->check(seq, accurate);
+		// Если последовательность найдена, выходим
+		if(result.first) break;
+	}
+	// Выводим результат
+	return result;
+}
+/**
+ * ~AlmMixture Деструктор
+ */
+anyks::AlmMixture::~AlmMixture() noexcept {
+	// Очищаем смесь, сами языковые модели смесь не удаляет
+	this->clear();
+}
@@ -370,6 +370,60 @@ const double anyks::Arpa::backoff(const size_t idw, const data_t * context, cons
 	// Выводим результат
 	return result;
 }
+/**
+ * backoff Метод подсчёта обратной частоты n-граммы в заранее найденном контексте отката
+ * @param idw   идентификатор текущего слова
+ * @param lower контекст отката и вес последней найденной в нём n-граммы
+ * @return      результат расчёта обратной частоты
+ */
+const double anyks::Arpa::backoff(const size_t idw, const pair <const data_t *, double> & lower) const noexcept {
+	// Если контекст отката не найден, это юниграмма
+	if(lower.first == nullptr) return this->backoff(idw, nullptr, 0);
+	// Ищем слово в контексте отката
+	auto it = lower.first->find(idw);
+	// Выводим результат
+	return (it != lower.first->end() ? it->second.weight : lower.second);
+}
+/**
+ * suffix Метод поиска контекста отката, общего для всех слов контекста
+ * @param context контекст которому принадлежат слова
+ * @param gram    размер n-граммы для отката
+ * @return        контекст отката и вес последней найденной в нём n-граммы
+ */
+const std::pair <const anyks::Arpa::data_t *, double> anyks::Arpa::suffix(const data_t * context, const u_short gram) const noexcept {
+	// Результат работы функции
+	pair <const data_t *, double> result = {nullptr, this->zero};
+	// Если это не юниграмма
+	if((gram > 0) && (context != nullptr)){
+		// Индекс перехода
+		u_short index = 0;
+		// Список последовательности
+		size_t idws[MAXSIZE];
+		// Извлекаем предшествующую n-грамму
+		while((context->father != nullptr) && (index < gram) && (index < MAXSIZE)){
+			// Добавляем идентификатор (слова собираются с конца)
+			idws[index++] = context->idw;
+			// Выполняем смещение
+			context = context->father;
+		}
+		// Начинаем поиск с корня словаря
+		result.first = &this->data;
+		// Переходим по всему списку идентификаторов, от первого слова к последнему
+		for(u_short i = index; i > 0; i--){
+			// Ищем нашу n-грамму
+			auto it = result.first->find(idws[i - 1]);
+			// Если n-грамма найдена
+			if(it != result.first->end()){
+				// Получаем данные n-граммы
+				result.first = &it->second;
+				// Получаем вес n-граммы
+				result.second = it->second.weight;
+			}
+		}
+	}
+	// Выводим результат
+	return result;
+}
 /**
  * compute Метод расчёта коэффициентов для распределения весов в рамках 1.0
  * @param ngram       контекст для расчёта
@@ -393,6 +447,8 @@ const bool anyks::Arpa::compute(data_t * ngram, const u_short gram, double & num
 	 */
 	numerator   = 1.0;
 	denominator = 1.0;
+	// Контекст отката общий для всех слов контекста, поэтому ищем его один раз
+	const auto lower = this->suffix(ngram, (gram > 0 ? gram - 1 : 0));
 	// Переходим по всему слов в контексте
 	for(auto & item : * ngram){
 		// Если частота n-граммы существует
@@ -400,7 +456,7 @@ const bool anyks::Arpa::compute(data_t * ngram, const u_short gram, double & num
 			// Считаем нуминатор
 			numerator -= pow(10, item.second.weight);
 			// Считаем денуминатор
-			if(gram > 0) denominator -= pow(10, this->backoff(item.second.idw, ngram, gram - 1));
+			if(gram > 0) denominator -= pow(10, this->backoff(item.second.idw, lower));
 		}
 	}
 	/**
@@ -453,77 +509,139 @@ const bool anyks::Arpa::compute(data_t * ngram, const u_short gram, double & num
 	// Выводим результат
 	return result;
 }
+/**
+ * entropy Метод расчёта изменения перплексии от удаления каждой n-граммы контекста
+ * @param context     контекст n-граммы которого оцениваются
+ * @param gram        размер оцениваемых n-грамм
+ * @param numerator   разность частот n-грамм
+ * @param denominator разность частот отката n-грамм
+ * @param callback    функция обратного вызова (n-грамма, вес контекста, новый вес, дельта веса, дельта энтропии, изменение перплексии)
+ * @return            результат расчёта, контексты без частоты отката не оцениваются
+ */
+const bool anyks::Arpa::entropy(data_t * context, const u_short gram, double & numerator, double & denominator, function <void (data_t *, const double, const double, const double, const double, const double)> callback) const noexcept {
+	// Результат работы функции
+	bool result = false;
+	// Получаем частоту отката контекста
+	const double backoff = context->backoff;
+	/**
+	 * Вычисляем числитель и знаменатель обратной частоты отката,
+	 * чтобы мы могли быстро вычислить корректировку BOW из-за отсутствия одного пробника.
+	 */
+	if((result = (isnormal(backoff) && this->compute(context, gram - 1, numerator, denominator)))){
+		// Сумма весов (предельная вероятность контекста), она общая для всех n-грамм контекста
+		double total = 0.0;
+		// Извлекаем предшествующую n-грамму
+		for(const data_t * item = context; item->father != nullptr; item = item->father){
+			// Запоминаем результат
+			if((item->weight != this->zero) && !this->isStart(item->idw) &&
+			((gram > 1) || !this->isUnk(item->idw) || !this->isOption(options_t::resetUnk))) total += item->weight;
+			/**
+			 * Если мы вычисляем предельную вероятность контекста униграммы <s>,
+			 * мы должны искать </s> вместо неё, поскольку у начала предложения вес = 0.
+			 */
+			if(this->isStart(item->idw)) total += item->father->at((size_t) token_t::finish).weight;
+		}
+		// Контекст отката общий для всех n-грамм контекста, поэтому ищем его один раз
+		const auto lower = this->suffix(context, (gram > 1 ? gram - 2 : 0));
+		// Переходим по всему слов в контексте
+		for(auto & value : * context){
+			// Если частота n-граммы существует
+			if(this->isWord(&value.second)){
+				// Генерируем обратную частоту n-граммы
+				const double bow = this->backoff(value.second.idw, lower);
+				// Расчитываем новую обратную частоту документа
+				const double nbow = (log10(numerator + pow(10, value.second.weight)) - log10(denominator + pow(10, bow)));
+				/**
+				 * Вычислить изменение энтропии за счет удаления ngram
+				 * deltaH = - P(H) x
+				 *  {P(W | H) [log P(w|h') + log BOW'(h) - log P(w|h)] +
+				 *  (1 - \sum_{v,h ngrams} P(v|h)) [log BOW'(h) - log BOW(h)]}
+				 *
+				 * (1-\sum_{v,h ngrams}) - масса вероятности,
+				 * оставшаяся от n-граммы текущего порядка,
+				 * и такая же, как числитель в BOW(h).
+				 */
+				const double delta = (bow + nbow - value.second.weight);
+				// Считаем дельту энтропии
+				const double deltaEntropy = (- pow(10, total) * (pow(10, value.second.weight) * delta + numerator * (nbow - backoff)));
+				/**
+				 * Вычисляем относительное изменение модели (трейн-сета) перплексия
+				 *  (PPL' - PPL)/PPL = PPL'/PPL - 1
+				 *                   = exp(H')/exp(H) - 1
+				 *                   = exp(H' - H) - 1
+				 */
+				callback(&value.second, total, (bow + nbow), delta, deltaEntropy, (pow(10, deltaEntropy) - 1.0));
+			}
+		}
+	}
+	// Выводим результат
+	return result;
+}
 /**
  * get Метод извлечения списка n-грамм указанного размера
  * @param gram размер n-граммы список грамм которой нужно извлечь
  * @return     указатель на список запрашиваемых n-грамм
  */
-std::list <anyks::Arpa::data_t *> * anyks::Arpa::get(const u_short gram) const noexcept {
+std::vector <anyks::Arpa::data_t *> * anyks::Arpa::get(const u_short gram) const noexcept {
 	// Результат работы функции
-	list <data_t *> * result = nullptr;
-	/**
-	 * Прототип функции перехода по граммам
-	 * @param размер текущей n-граммы
-	 */
-	function <void (const u_short)> runFn;
-	/**
-	 * runFn Функция перехода по граммам
-	 * @param gram размер текущей n-граммы
-	 */
-	runFn = [&](const u_short gram) noexcept {
-		// Параметры следующего шага
-		list <data_t *> tmp;
-		// Если это нулевая n-грамма
-		switch(gram){
-			// Если это юниграмма
-			case 0: {
-				// Добавляем в временный список юниграммы
-				tmp.push_back(&this->data);
-				// Добавляем в список юниграмм
-				this->ngrams.emplace(gram + 1, move(tmp));
-				// Продолжаем дальше
-				runFn(gram + 1);
-			} break;
-			// Если это биграмма или больше
-			default: {
-				// Если шаг не пустой
-				if(this->ngrams.count(gram) > 0){
-					// Переходим по всему словарю
-					for(auto & item : this->ngrams[gram]){
-						// Если в n-грамме есть дочерные граммы
-						if(!item->empty()){
-							// Переходим по всему списку грамм
-							for(auto & value : * item){
-								// Если еще есть граммы
-								if(!value.second.empty()) tmp.push_back(&value.second);
-							}
-						}
-					}
-					// Добавляем в список юниграмм
-					if(!tmp.empty()){
-						// Если биграмма существует
-						this->ngrams.emplace(gram + 1, move(tmp));
-						// Продолжаем дальше
-						runFn(gram + 1);
-					}
-				}
+	vector <data_t *> * result = nullptr;
+	// Если индекс контекстов ещё не построен
+	if(this->ngrams.empty()){
+		// Резервируем память под все порядки, чтобы выданные указатели на списки не менялись при достройке
+		this->ngrams.reserve(MAXSIZE + 2);
+		// Нулевой порядок не используется
+		this->ngrams.emplace_back();
+		// Контекстом юниграмм является корень словаря
+		this->ngrams.push_back({&this->data});
+	}
+	// Достраиваем недостающие порядки, пока последний построенный порядок не пустой
+	while((this->ngrams.size() <= gram) && !this->ngrams.back().empty()){
+		// Список контекстов следующего порядка
+		vector <data_t *> tmp;
+		// Переходим по всем контекстам последнего построенного порядка
+		for(auto & item : this->ngrams.back()){
+			// Переходим по всему списку грамм
+			for(auto & value : * item){
+				// Если еще есть граммы
+				if(!value.second.empty()) tmp.push_back(&value.second);
 			}
 		}
-	};
-	// Выполняем сбор данных
-	if(this->ngrams.count(gram) < 1){
-		// Очищаем список грамм
-		this->ngrams.clear();
-		// Выполняем сбор данных
-		runFn(0);
+		// Добавляем построенный порядок в индекс
+		this->ngrams.push_back(move(tmp));
 	}
-	// Если список грамм получен
-	auto it = this->ngrams.find(gram);
-	// Если список n-грамм получен
-	if(it != this->ngrams.end()) result = &it->second;
+	// Если список n-грамм указанного порядка получен
+	if((gram > 0) && (gram < this->ngrams.size()) && !this->ngrams[gram].empty()) result = &this->ngrams[gram];
 	// Выводим результат
 	return result;
 }
+/**
+ * unindex Метод сброса индекса контекстов начиная с указанного порядка
+ * @param gram порядок, начиная с которого индекс становится недействительным
+ */
+void anyks::Arpa::unindex(const u_short gram) const noexcept {
+	// Если сбрасывается порядок юниграмм, очищаем индекс полностью
+	if(gram < 2) this->ngrams.clear();
+	// Иначе удаляем только порядки, начиная с указанного
+	else if(this->ngrams.size() > gram) this->ngrams.resize(gram);
+}
+/**
+ * unindex Метод сброса индекса контекстов перед добавлением n-граммы в контекст
+ * @param context контекст, в который добавляется n-грамма
+ */
+void anyks::Arpa::unindex(const data_t * context) const noexcept {
+	/**
+	 * Индекс меняется только тогда, когда пустой контекст получает первую n-грамму,
+	 * корень словаря присутствует в индексе всегда, поэтому его не учитываем
+	 */
+	if(!this->ngrams.empty() && (context != &this->data) && context->empty()){
+		// Порядок, в котором контекст появится
+		u_short gram = 1;
+		// Определяем глубину контекста по цепочке родителей
+		for(const data_t * it = context; (it != nullptr) && (it != &this->data); it = it->father) gram++;
+		// Сбрасываем индекс начиная с порядка контекста
+		this->unindex(gram);
+	}
+}
 /**
  * contextFn Метод получения контекста
  * @param context контекст n-граммы
@@ -715,7 +833,7 @@ void anyks::Arpa::fixupProbs(const u_short gram) const noexcept {
 	// Если n-грамма передана
 	if(gram <= this->size){
 		// Количество фейковых частот
-		size_t numFakes = 0;
+		std::atomic <size_t> numFakes{0};
 		// Проверяем включён ли режим отладки
 		const bool debug = this->isOption(options_t::debug);
 		// Если это нулевая n-грамма
@@ -770,9 +888,18 @@ void anyks::Arpa::fixupProbs(const u_short gram) const noexcept {
 					 * Если что-то из этого будет найдено в таком порядке,
 					 * мы можем остановиться, так-как предыдущий проход уже создал оставшиеся.
 					 */
-					for(auto & item : * ngrams){
-						// Если в n-грамме есть дочерные граммы
-						if(!item->empty()){
+					// Список контекстов текущего порядка
+					const vector <data_t *> & contexts = (* ngrams);
+					// Контексты независимы, младшие порядки уже зафиксированы, обрабатываем их параллельно
+					this->tpool.parallel_for(0, contexts.size(), [&](const size_t first, const size_t last){
+						// Количество фейковых частот блока
+						size_t fakes = 0;
+						// Переходим по всем контекстам блока
+						for(size_t i = first; i < last; i++){
+							// Получаем контекст n-граммы
+							data_t * item = contexts[i];
+							// Если в n-грамме нет дочерних грамм, пропускаем
+							if(item->empty()) continue;
 							// Переходим по всему списку юниграмм
 							for(auto & value : * item){
 								// Если частота n-граммы нормальная, пропускаем
@@ -789,7 +916,7 @@ void anyks::Arpa::fixupProbs(const u_short gram) const noexcept {
 								// Если вес юниграммы равно 1
 								if(value.second.weight == 1.0){
 									// Считаем количество фейковых частот
-									numFakes++;
+									fakes++;
 									/**
 									 * Примечание: мы не можем объединить два приведённых ниже оператора,
 									 * так-как мы создаём запись с нулевой вероятностью,
@@ -801,14 +928,16 @@ void anyks::Arpa::fixupProbs(const u_short gram) const noexcept {
 								}
 							}
 						}
-					}
+						// Переносим количество фейковых частот блока
+						numFakes += fakes;
+					});
 				}
 			}
 		}
 		// Если фейковые n-граммы найдены, выводим статистику по ним
 		if(debug && (numFakes > 0)){
 			// Выводим статистику в сообщении
-			this->alphabet->log("inserted %u redundant %u-gram probs", alphabet_t::log_t::info, this->logfile, numFakes, gram);
+			this->alphabet->log("inserted %u redundant %u-gram probs", alphabet_t::log_t::info, this->logfile, numFakes.load(), gram);
 		}
 		// Если есть следующий шаг
 		this->fixupProbs(gram + 1);
@@ -820,7 +949,7 @@ void anyks::Arpa::fixupProbs(const u_short gram) const noexcept {
  */
 void anyks::Arpa::uniUppers(std::multimap <size_t, size_t> & uppers) const noexcept {
 	// Список полученных N-грамм
-	list <data_t *> * ngrams = nullptr;
+	vector <data_t *> * ngrams = nullptr;
 	// Переходим по всем граммам корпуса
 	for(u_short i = 2; i <= this->size; i++){
 		// Выполняем запрос грамм
@@ -857,60 +986,6 @@ void anyks::Arpa::uniUppers(std::multimap <size_t, size_t> & uppers) const noexc
 		}
 	}
 }
-/**
- * sequence Метод извлечения правильной последовательности, игнорирования <unk> токена
- * @param seq      последовательность для обработки
- * @param callback функция обратного вызова
- */
-void anyks::Arpa::sequence(const vector <seq_t> & seq, function <void (const vector <seq_t> &, const seq_t &)> callback) const noexcept {
-	// Если последовательность передана
-	if(!seq.empty()){
-		// Собранная последовательность
-		vector <seq_t> tmp;
-		// Переходим по всей последовательности
-		for(auto & item : seq){
-			// Если это не неизвестное слово
-			if(!this->isUnk(item.idw)) tmp.push_back(item);
-			// Если это жето неизвестное слово и последовательность собрана
-			else if(!tmp.empty()) {
-				// Выводим резуьтат
-				callback(tmp, item);
-				// Очищаем список последовательности
-				tmp.clear();
-			// Выводим пустое сообщение
-			} else callback({}, item);
-		}
-		// Если последовательность собрана, выводим её
-		if(!tmp.empty()) callback(tmp, {});
-	}
-}
-/**
- * sequence Метод извлечения правильной последовательности, игнорирования <unk> токена
- * @param seq      последовательность для обработки
- * @param callback функция обратного вызова
- */
-void anyks::Arpa::sequence(const vector <pair_t> & seq, function <void (const vector <pair_t> &, const size_t)> callback) const noexcept {
-	// Если последовательность передана
-	if(!seq.empty()){
-		// Собранная последовательность
-		vector <pair_t> tmp;
-		// Переходим по всей последовательности
-		for(auto & item : seq){
-			// Если это не неизвестное слово
-			if(!this->isUnk(item.first)) tmp.push_back(item);
-			// Если это жето неизвестное слово и последовательность собрана
-			else if(!tmp.empty()) {
-				// Выводим резуьтат
-				callback(tmp, item.first);
-				// Очищаем список последовательности
-				tmp.clear();
-			// Выводим пустое сообщение
-			} else callback({}, item.first);
-		}
-		// Если последовательность собрана, выводим её
-		if(!tmp.empty()) callback(tmp, 0);
-	}
-}
 /**
  * nodiscount Метод проверки на необходимость расчёта скидки
  * @return результат проверки
@@ -1079,6 +1154,8 @@ const bool anyks::Arpa::emplace(const vector <pair_t> & seq, const double weight
 			// Запоминаем текущий объект
 			const data_t * father = obj;
 			// Добавляем юниграмму в словарь
+			// Сбрасываем индекс контекстов, если контекст получает первую n-грамму
+			this->unindex(obj);
 			auto ret = obj->emplace(idw, data_t());
 			// Получаем блок структуры
 			obj = &ret.first->second;
@@ -1148,8 +1225,6 @@ const bool anyks::Arpa::emplace(const vector <pair_t> & seq, const double weight
 				}
 			}
 		}
-		// Очищаем собранный список n-грамм
-		if(!this->ngrams.empty()) this->ngrams.clear();
 	}
 	// Выводим результат
 	return result;
@@ -1171,7 +1246,7 @@ const bool anyks::Arpa::replace(const vector <size_t> & seq1, const vector <pair
 			// Не существующий идентификатор
 			const size_t noid = idw_t::NIDW;
 			// Список n-грамм для работы
-			list <data_t *> * ngrams = nullptr;
+			vector <data_t *> * ngrams = nullptr;
 			// Список полученных последовательностей
 			std::map <size_t, vector <size_t>> variants;
 			/**
@@ -1575,6 +1650,8 @@ void anyks::Arpa::clear() noexcept {
 	this->delwords.clear();
 	// Сбрасываем параметры расчёта
 	this->param = param_t();
+	// Если узлов словарей больше не осталось, освобождаем слэбы пула
+	Pools::trim();
 }
 /**
  * removeWord Метод удаления слова и всех дочерних n-грамм
@@ -1592,6 +1669,14 @@ void anyks::Arpa::setSize(const u_short size) noexcept {
 	// Устанавливаем максимальный размер n-граммы
 	if((size >= 1) && (size <= MAXSIZE)) this->size = size;
 }
+/**
+ * setThreads Метод установки количества потоков
+ * @param threads количество потоков для работы
+ */
+void anyks::Arpa::setThreads(const size_t threads) noexcept {
+	// Устанавливаем новое количество потоков
+	this->threads = (threads > 0 ? threads : std::thread::hardware_concurrency());
+}
 /**
  * setWordMethod Метод установки функции получения слова
  * @param word функция получения слова
@@ -1675,8 +1760,6 @@ void anyks::Arpa::del(const vector <size_t> & seq) const noexcept {
 				break;
 			}
 		}
-		// Очищаем собранный список n-грамм
-		if(!this->ngrams.empty()) this->ngrams.clear();
 	}
 }
 /**
@@ -1776,8 +1859,79 @@ void anyks::Arpa::addBin(const vector <char> & buffer, const size_t idd) const n
 			// Добавляем полученные данные
 			this->add(seq, idd);
 		}
-		// Очищаем собранный список n-грамм
+	}
+}
+/**
+ * merge Метод переноса n-грамм из другого словаря
+ * @param arpa   словарь из которого переносятся n-граммы
+ * @param shard  номер шарда первого слова n-граммы
+ * @param shards общее количество шардов
+ */
+void anyks::Arpa::merge(const Arpa * arpa, const size_t shard, const size_t shards) const noexcept {
+	// Если словарь передан и он не пустой
+	if((arpa != nullptr) && (arpa != this) && !arpa->data.empty() && (shards > 0)){
+		/**
+		 * Прототип функции переноса n-грамм
+		 * @param словарь в который переносятся n-граммы
+		 * @param словарь из которого переносятся n-граммы
+		 */
+		function <void (data_t *, data_t *)> runFn;
+		/**
+		 * runFn Функция переноса n-грамм
+		 * @param dest словарь в который переносятся n-граммы
+		 * @param src  словарь из которого переносятся n-граммы
+		 */
+		runFn = [&](data_t * dest, data_t * src) noexcept {
+			// Флаг обработки юниграмм
+			const bool root = (src == &arpa->data);
+			// Переходим по всему списку n-грамм
+			for(auto it = src->begin(); it != src->end();){
+				// Если юниграмма принадлежит другому шарду или n-грамма не валидна, пропускаем её
+				if((root && ((it->first % shards) != shard)) || !arpa->isWord(&it->second)) ++it;
+				// Если n-грамма валидна
+				else {
+					// Ищем n-грамму в словаре
+					auto jt = dest->find(it->first);
+					// Если такой n-граммы нет, переносим её вместе с продолжениями без копирования
+					if(jt == dest->end()){
+						// Извлекаем узел n-граммы
+						auto node = src->extract(it++);
+						// Запоминаем родительский объект
+						node.mapped().father = dest;
+						// Добавляем узел в словарь
+						dest->insert(std::move(node));
+					// Если n-грамма уже существует
+					} else {
+						// Получаем объект n-граммы словаря
+						data_t & obj = jt->second;
+						// Получаем переносимую n-грамму
+						data_t & item = it->second;
+						// Увеличиваем встречаемость n-граммы, документ может быть разбит на несколько блоков
+						obj.oc += item.oc;
+						// Если идентификаторы документов не совпадают
+						if(obj.idd != item.idd){
+							// Запоминаем идентификатор документа
+							obj.idd = item.idd;
+							// Увеличиваем количество документов
+							obj.dc += item.dc;
+						}
+						// Переносим регистры слова
+						for(auto & upper : item.uppers) obj.uppers[upper.first] += upper.second;
+						// Переносим продолжения n-граммы
+						if(!item.empty()) runFn(&obj, &item);
+						// Удаляем перенесённую юниграмму, чтобы не обрабатывать её повторно
+						if(root) it = src->erase(it);
+						// Иначе переходим к следующей n-грамме
+						else ++it;
+					}
+				}
+			}
+		};
+		// Выполняем перенос n-грамм
+		runFn(&this->data, &arpa->data);
+		// Очищаем собранные списки n-грамм
 		if(!this->ngrams.empty()) this->ngrams.clear();
+		if(!arpa->ngrams.empty()) arpa->ngrams.clear();
 	}
 }
 /**
@@ -1830,8 +1984,6 @@ void anyks::Arpa::setBin(const vector <char> & buffer, const bool arpa) const no
 				}
 			}
 		}
-		// Очищаем собранный список n-грамм
-		if(!this->ngrams.empty()) this->ngrams.clear();
 	}
 }
 /**
@@ -1961,6 +2113,205 @@ void anyks::Arpa::arpa(const u_short gram, function <void (const string &)> call
 	// Выводим пустой результат
 	} else callback("");
 }
+/**
+ * arpaBlocks Метод извлечения данных arpa блоками строк
+ * @param gram     размер n-граммы для извлечения
+ * @param callback функция обратного вызова (блок строк arpa, количество n-грамм в блоке)
+ *
+ * Строки совпадают побайтно со строками метода arpa, контексты n-грамм форматируются параллельно,
+ * а блоки выводятся в порядке контекстов.
+ */
+void anyks::Arpa::arpaBlocks(const u_short gram, function <void (const string &, const size_t)> callback) const noexcept {
+	// Если n-граммы существуют
+	if(!this->data.empty()){
+		// Количество n-грамм в одном блоке
+		const size_t step = 0x10000;
+		/**
+		 * numberFn Функция добавления числа в строку в формате std::to_string (%f)
+		 * @param number число для добавления
+		 * @param buffer строка для добавления
+		 */
+		auto numberFn = [](const double number, string & buffer) noexcept {
+			// Буфер для формирования числа (максимальное число double с точностью 6 знаков)
+			char digits[330];
+			// Выполняем форматирование числа
+			const auto result = std::to_chars(digits, digits + sizeof(digits), number, std::chars_format::fixed, 6);
+			// Добавляем число в строку
+			buffer.append(digits, result.ptr);
+		};
+		/**
+		 * lineFn Функция добавления строки n-граммы
+		 * @param ngram   n-грамма для добавления
+		 * @param context контекст n-граммы с разделителем (для юниграмм пустой)
+		 * @param word    слово n-граммы
+		 * @param buffer  строка для добавления
+		 */
+		auto lineFn = [&numberFn, gram, this](const data_t * ngram, const string & context, const string & word, string & buffer) noexcept {
+			// Если это -Infinity или псевдо-ноль, устанавливаем вес равный псевдо-нулю
+			if((ngram->weight == this->zero) || (ngram->weight == this->pseudoZero)) numberFn(this->pseudoZero, buffer);
+			// Если это нормальный вес
+			else numberFn(ngram->weight, buffer);
+			// Добавляем разделитель
+			buffer.append(1, '\t');
+			// Добавляем контекст n-граммы
+			buffer.append(context);
+			// Добавляем слово n-граммы
+			buffer.append(word);
+			// Если слово имеет частоту отката
+			if((gram < this->size) && ((ngram->backoff != this->zero) && this->isWords(ngram))){
+				// Добавляем разделитель
+				buffer.append(1, '\t');
+				// Если частота отката нормальная, добавляем её
+				if(isnormal(ngram->backoff) && (fabs(ngram->backoff) > 0.000001)) numberFn(ngram->backoff, buffer);
+				// Иначе добавляем ноль
+				else buffer.append(1, '0');
+			}
+			// Завершаем строку
+			buffer.append(1, '\n');
+		};
+		// Если это юниграмма
+		if(gram == 1){
+			// Слово для извлечения и пустой контекст
+			string word = "", context = "";
+			// Блок строк arpa
+			string buffer = "";
+			// Количество n-грамм в блоке
+			size_t count = 0;
+			// Список регистров слова
+			multimap <size_t, size_t> uppers;
+			// Если слова нужно выводить не в нижнем регистре
+			if(!this->isOption(options_t::lowerCase)) this->uniUppers(uppers);
+			// Переходим по всему списку юниграмм
+			for(auto & value : this->data){
+				// Если n-грамма имеет вес
+				if(this->isWord(&value.second)){
+					// Получаем диапазон регистров слова
+					const auto & ret = uppers.equal_range(value.second.idw);
+					// Переходим по всему списку регистров
+					for(auto it = ret.first; it != ret.second; ++it){
+						// Получаем слово
+						word = this->word(value.second.idw, it->second);
+						// Если слово получено
+						if(!word.empty()){
+							// Добавляем строку слова с учётом регистра
+							lineFn(&value.second, context, word, buffer);
+							// Увеличиваем количество n-грамм
+							count++;
+						}
+					}
+					// Получаем слово
+					word = this->word(value.second.idw);
+					// Если слово получено
+					if(!word.empty()){
+						// Добавляем строку слова без учёта регистра
+						lineFn(&value.second, context, word, buffer);
+						// Увеличиваем количество n-грамм
+						count++;
+					}
+					// Если блок заполнен
+					if(count >= step){
+						// Выводим блок
+						callback(buffer, count);
+						// Очищаем блок
+						buffer.clear();
+						// Обнуляем количество n-грамм
+						count = 0;
+					}
+				}
+			}
+			// Выводим оставшийся блок
+			if(count > 0) callback(buffer, count);
+		// Если это n-грамма
+		} else {
+			// Выполняем извлечение n-грамм
+			auto ngrams = this->get(gram);
+			// Если список n-грамм получен
+			if((ngrams != nullptr) && !ngrams->empty()){
+				// Количество n-грамм в текущем блоке
+				size_t count = 0;
+				// Границы блоков контекстов
+				vector <size_t> bounds = {0};
+				// Список контекстов текущего порядка
+				const vector <data_t *> & contexts = (* ngrams);
+				// Разбиваем контексты на блоки примерно одинакового количества n-грамм
+				for(size_t i = 0; i < contexts.size(); i++){
+					// Если блок заполнен, запоминаем его границу
+					if((count += contexts[i]->size()) >= step){
+						// Запоминаем границу блока
+						bounds.push_back(i + 1);
+						// Обнуляем количество n-грамм
+						count = 0;
+					}
+				}
+				// Запоминаем границу последнего блока
+				if(bounds.back() != contexts.size()) bounds.push_back(contexts.size());
+				// Количество блоков формируемых за один проход
+				const size_t window = (max(this->threads, size_t(1)) * 4);
+				// Сформированные блоки строк arpa
+				vector <string> buffers(window);
+				// Количество n-грамм в сформированных блоках
+				vector <size_t> counts(window, 0);
+				// Если потоков несколько, запускаем тредпул
+				if(this->threads > 1) this->tpool.init(this->threads);
+				// Переходим по всем блокам проходами
+				for(size_t first = 0, blocks = (bounds.size() - 1); first < blocks; first += window){
+					// Получаем конец прохода
+					const size_t last = min(first + window, blocks);
+					// Выполняем форматирование блоков параллельно
+					this->tpool.parallel_for(first, last, [&](const size_t begin, const size_t end){
+						// Слово n-граммы
+						string word = "";
+						// Полученный контекст
+						string context = "";
+						// Переходим по всем блокам
+						for(size_t i = begin; i < end; i++){
+							// Получаем блок строк
+							string & buffer = buffers[i - first];
+							// Получаем количество n-грамм блока
+							size_t & count = counts[i - first];
+							// Очищаем блок строк
+							buffer.clear();
+							// Обнуляем количество n-грамм
+							count = 0;
+							// Переходим по всем контекстам блока
+							for(size_t j = bounds[i]; j < bounds[i + 1]; j++){
+								// Получаем данные контекста, он общий для всех n-грамм контекста
+								context = this->context(contexts[j]);
+								// Если контекст получен
+								if(!context.empty()){
+									// Добавляем разделитель
+									context.append(1, ' ');
+									// Переходим по всему списку слов
+									for(auto & value : * contexts[j]){
+										// Если n-грамма имеет вес
+										if(this->isWord(&value.second)){
+											// Получаем слово n-граммы
+											word = this->word(value.second.idw, this->uppers(&value.second).first);
+											// Если слово получено
+											if(!word.empty()){
+												// Добавляем строку n-граммы
+												lineFn(&value.second, context, word, buffer);
+												// Увеличиваем количество n-грамм
+												count++;
+											}
+										}
+									}
+								}
+							}
+						}
+					}, 1);
+					// Выводим сформированные блоки в порядке контекстов
+					for(size_t i = first; i < last; i++){
+						// Если блок не пустой, выводим его
+						if(counts[i - first] > 0) callback(buffers[i - first], counts[i - first]);
+					}
+				}
+				// Завершаем работу тредпула
+				this->tpool.wait();
+			}
+		}
+	}
+}
 /**
  * grams Метод извлечения данных n-грамм в текстовом виде
  * @param gram     размер n-граммы для извлечения
@@ -2207,6 +2558,8 @@ void anyks::Arpa::set(const vector <seq_t> & seq) const noexcept {
 		for(auto & item : seq){
 			// Запоминаем текущий объект
 			const data_t * father = obj;
+			// Сбрасываем индекс контекстов, если контекст получает первую n-грамму
+			this->unindex(obj);
 			// Добавляем слово в словарь
 			auto ret = obj->emplace(item.idw, data_t());
 			// Получаем блок структуры
@@ -2231,8 +2584,6 @@ void anyks::Arpa::set(const vector <seq_t> & seq) const noexcept {
 			// Если количество n-грамм достигло предела, выходим
 			if((++i) > (this->size - 1)) break;
 		}
-		// Очищаем собранный список n-грамм
-		if(!this->ngrams.empty()) this->ngrams.clear();
 	}
 }
 /**
@@ -2252,6 +2603,8 @@ void anyks::Arpa::set(const vector <pair_t> & seq, const size_t oc, const size_t
 		for(auto & item : seq){
 			// Запоминаем текущий объект
 			const data_t * father = obj;
+			// Сбрасываем индекс контекстов, если контекст получает первую n-грамму
+			this->unindex(obj);
 			// Добавляем слово в словарь
 			auto ret = obj->emplace(item.first, data_t());
 			// Получаем блок структуры
@@ -2282,8 +2635,6 @@ void anyks::Arpa::set(const vector <pair_t> & seq, const size_t oc, const size_t
 			// Если количество n-грамм достигло предела, выходим
 			if((++i) > (this->size - 1)) break;
 		}
-		// Очищаем собранный список n-грамм
-		if(!this->ngrams.empty()) this->ngrams.clear();
 	}
 }
 /**
@@ -2303,6 +2654,8 @@ void anyks::Arpa::set(const vector <pair_t> & seq, const double weight, const do
 		for(auto & item : seq){
 			// Запоминаем текущий объект
 			const data_t * father = obj;
+			// Сбрасываем индекс контекстов, если контекст получает первую n-грамму
+			this->unindex(obj);
 			// Добавляем слово в словарь
 			auto ret = obj->emplace(item.first, data_t());
 			// Получаем блок структуры
@@ -2334,8 +2687,6 @@ void anyks::Arpa::set(const vector <pair_t> & seq, const double weight, const do
 			// Если количество n-грамм достигло предела, выходим
 			if((++i) > (this->size - 1)) break;
 		}
-		// Очищаем собранный список n-грамм
-		if(!this->ngrams.empty()) this->ngrams.clear();
 	}
 }
 /**
@@ -2346,57 +2697,66 @@ void anyks::Arpa::set(const vector <pair_t> & seq, const double weight, const do
 void anyks::Arpa::add(const vector <pair_t> & seq, const size_t idd) const noexcept {
 	// Если список последовательностей передан
 	if(!seq.empty() && (this->size > 0)){
-		// Выполняем обработку последовательности
-		this->sequence(seq, [idd, this](const vector <pair_t> & seq, const size_t idw){
-			// Если неизвестный символ найден
-			if(idw > 0){
-				// Ищем неизвестный символ в словаре
-				auto it = this->data.find(idw);
-				// Если неизвестное слово найдено
-				if(it != this->data.end()){
-					// Увеличиваем встречаемость слова
-					it->second.oc++;
-					// Если идентификаторы документов не совпадают
-					if(it->second.idd != idd){
-						// Увеличиваем количество документов
-						it->second.dc++;
-						// Запоминаем идентификатор документа
-						it->second.idd = idd;
-					}
-				// Если неизвестное слово не найдено в словаре
-				} else {
-					// Добавляем слово в словарь
-					auto ret = this->data.emplace(idw, data_t());
-					// Увеличиваем встречаемость слова
-					ret.first->second.oc = 1;
+		/**
+		 * unkFn Функция учёта неизвестного слова
+		 * @param idw идентификатор неизвестного слова
+		 */
+		auto unkFn = [idd, this](const size_t idw) noexcept {
+			// Ищем неизвестный символ в словаре
+			auto it = this->data.find(idw);
+			// Если неизвестное слово найдено
+			if(it != this->data.end()){
+				// Увеличиваем встречаемость слова
+				it->second.oc++;
+				// Если идентификаторы документов не совпадают
+				if(it->second.idd != idd){
 					// Увеличиваем количество документов
-					ret.first->second.dc = 1;
-					// Запоминаем идентификатор слова
-					ret.first->second.idw = idw;
+					it->second.dc++;
 					// Запоминаем идентификатор документа
-					ret.first->second.idd = idd;
-					// Запоминаем родительский объект
-					ret.first->second.father = &this->data;
+					it->second.idd = idd;
 				}
+			// Если неизвестное слово не найдено в словаре
+			} else {
+				// Добавляем слово в словарь
+				auto ret = this->data.emplace(idw, data_t());
+				// Увеличиваем встречаемость слова
+				ret.first->second.oc = 1;
+				// Увеличиваем количество документов
+				ret.first->second.dc = 1;
+				// Запоминаем идентификатор слова
+				ret.first->second.idw = idw;
+				// Запоминаем идентификатор документа
+				ret.first->second.idd = idd;
+				// Запоминаем родительский объект
+				ret.first->second.father = &this->data;
 			}
-			// Если последовательность получена
-			if(!seq.empty()){
-				// Итератор для подсчета длины n-граммы
-				u_short i = 0;
+		};
+		/**
+		 * addFn Функция добавления n-грамм отрезка последовательности скользящим окном
+		 * @param first начало отрезка последовательности
+		 * @param last  конец отрезка последовательности
+		 */
+		auto addFn = [&seq, idd, this](const size_t first, const size_t last) noexcept {
+			// Переходим по всем позициям начала окна
+			for(size_t i = first; i < last; i++){
 				// Копируем основную карту
 				data_t * obj = &this->data;
-				// Получаем временный список последовательности
-				vector <pair_t> tmp(seq.cbegin(), seq.cend());
-				// Переходим по всему объекту
-				for(auto & seq : tmp){
+				// Определяем конец окна, окно не длиннее максимального размера n-граммы
+				const size_t end = min(last, i + size_t(this->size));
+				// Переходим по всем словам окна
+				for(size_t j = i; j < end; j++){
+					// Получаем слово последовательности
+					const pair_t & item = seq[j];
 					// Запоминаем текущий объект
 					const data_t * father = obj;
+					// Сбрасываем индекс контекстов, если контекст получает первую n-грамму
+					this->unindex(obj);
 					// Добавляем слово в словарь
-					auto ret = obj->emplace(seq.first, data_t());
+					auto ret = obj->emplace(item.first, data_t());
 					// Получаем блок структуры
 					obj = &ret.first->second;
 					// Запоминаем идентификатор слова
-					obj->idw = seq.first;
+					obj->idw = item.first;
 					// Запоминаем родительский объект
 					obj->father = father;
 					// Если нужно инкрементировать последовательность
@@ -2409,25 +2769,33 @@ void anyks::Arpa::add(const vector <pair_t> & seq, const size_t idd) const noexc
 						obj->idd = idd;
 					}
 					// Если регистры слова переданы, считаем их
-					if(seq.second > 0){
+					if(item.second > 0){
 						// Если такого регистра еще нет в списке
-						if(obj->uppers.count(seq.second) == 0)
+						if(obj->uppers.count(item.second) == 0)
 							// Добавляем в список регистр слова
-							obj->uppers.emplace(seq.second, 1);
+							obj->uppers.emplace(item.second, 1);
 						// Иначе увеличиваем существующий регистр слова
-						else obj->uppers[seq.second]++;
+						else obj->uppers[item.second]++;
 					}
-					// Если количество n-грамм достигло предела, выходим
-					if((++i) > (this->size - 1)) break;
 				}
-				// Удаляем первый идентификатор
-				tmp.erase(tmp.begin());
-				// Если список еще не пустой, продолжаем дальше
-				if(!tmp.empty()) this->add(tmp, idd);
 			}
-		});
-		// Очищаем собранный список n-грамм
-		if(!this->ngrams.empty()) this->ngrams.clear();
+		};
+		// Начало текущего отрезка без неизвестных слов
+		size_t first = 0;
+		// Переходим по всей последовательности
+		for(size_t i = 0; i < seq.size(); i++){
+			// Если это неизвестное слово, оно разрывает последовательность
+			if(this->isUnk(seq[i].first)){
+				// Учитываем неизвестное слово
+				unkFn(seq[i].first);
+				// Добавляем собранный отрезок
+				addFn(first, i);
+				// Следующий отрезок начинается после неизвестного слова
+				first = (i + 1);
+			}
+		}
+		// Добавляем оставшийся отрезок
+		addFn(first, seq.size());
 	}
 }
 /**
@@ -2439,90 +2807,114 @@ void anyks::Arpa::add(const vector <pair_t> & seq, const size_t idd) const noexc
 void anyks::Arpa::add(const vector <seq_t> & seq, const size_t idd, const bool rest) const noexcept {
 	// Если список последовательностей передан
 	if(!seq.empty() && (this->size > 0)){
-		// Выполняем обработку последовательности
-		this->sequence(seq, [idd, rest, this](const vector <seq_t> & seq, const seq_t & token){
-			// Если неизвестный символ найден
-			if(token.idw != idw_t::NIDW){
-				// Ищем неизвестный символ в словаре
-				auto it = this->data.find(token.idw);
-				// Если неизвестное слово найдено
-				if(it != this->data.end()){
-					// Увеличиваем встречаемость слова
-					it->second.oc += token.oc;
-					// Если идентификаторы документов не совпадают
-					if(it->second.idd != idd){
-						// Запоминаем идентификатор документа
-						it->second.idd = idd;
-						// Увеличиваем количество документов
-						it->second.dc += token.dc;
-					}
-				// Если неизвестное слово не найдено в словаре
-				} else {
-					// Добавляем слово в словарь
-					auto ret = this->data.emplace(token.idw, data_t());
+		/**
+		 * unkFn Функция учёта неизвестного слова
+		 * @param token неизвестное слово
+		 */
+		auto unkFn = [idd, this](const seq_t & token) noexcept {
+			// Ищем неизвестный символ в словаре
+			auto it = this->data.find(token.idw);
+			// Если неизвестное слово найдено
+			if(it != this->data.end()){
+				// Увеличиваем встречаемость слова
+				it->second.oc += token.oc;
+				// Если идентификаторы документов не совпадают
+				if(it->second.idd != idd){
 					// Запоминаем идентификатор документа
-					ret.first->second.idd = idd;
-					// Увеличиваем встречаемость слова
-					ret.first->second.oc = token.oc;
+					it->second.idd = idd;
 					// Увеличиваем количество документов
-					ret.first->second.dc = token.dc;
-					// Запоминаем идентификатор слова
-					ret.first->second.idw = token.idw;
-					// Запоминаем родительский объект
-					ret.first->second.father = &this->data;
+					it->second.dc += token.dc;
 				}
+			// Если неизвестное слово не найдено в словаре
+			} else {
+				// Добавляем слово в словарь
+				auto ret = this->data.emplace(token.idw, data_t());
+				// Запоминаем идентификатор документа
+				ret.first->second.idd = idd;
+				// Увеличиваем встречаемость слова
+				ret.first->second.oc = token.oc;
+				// Увеличиваем количество документов
+				ret.first->second.dc = token.dc;
+				// Запоминаем идентификатор слова
+				ret.first->second.idw = token.idw;
+				// Запоминаем родительский объект
+				ret.first->second.father = &this->data;
 			}
-			// Если последовательность получена
-			if(!seq.empty()){
-				// Итератор для подсчета длины n-граммы
-				u_short i = 0;
+		};
+		/**
+		 * addFn Функция добавления n-грамм отрезка последовательности скользящим окном
+		 * @param first начало отрезка последовательности
+		 * @param last  конец отрезка последовательности
+		 */
+		auto addFn = [&seq, idd, rest, this](const size_t first, const size_t last) noexcept {
+			// Переходим по всем позициям начала окна
+			for(size_t i = first; i < last; i++){
+				/**
+				 * Первое окно отрезка добавляется как есть, последующие окна
+				 * только переоценивают встречаемость и только полной длины
+				 */
+				const bool reset = ((i > first) || rest);
+				// Если окно короче максимального размера n-граммы, выходим
+				if((i > first) && ((last - i) < size_t(this->size))) break;
 				// Копируем основную карту
 				data_t * obj = &this->data;
-				// Получаем временный список последовательности
-				vector <seq_t> tmp(seq.cbegin(), seq.cend());
-				// Переходим по всему объекту
-				for(auto & seq : tmp){
+				// Определяем конец окна, окно не длиннее максимального размера n-граммы
+				const size_t end = min(last, i + size_t(this->size));
+				// Переходим по всем словам окна
+				for(size_t j = i; j < end; j++){
+					// Получаем слово последовательности
+					const seq_t & item = seq[j];
 					// Запоминаем текущий объект
 					const data_t * father = obj;
+					// Сбрасываем индекс контекстов, если контекст получает первую n-грамму
+					this->unindex(obj);
 					// Добавляем слово в словарь
-					auto ret = obj->emplace((size_t) seq.idw, data_t());
+					auto ret = obj->emplace((size_t) item.idw, data_t());
 					// Получаем блок структуры
 					obj = &ret.first->second;
 					// Запоминаем идентификатор слова
-					obj->idw = seq.idw;
+					obj->idw = item.idw;
 					// Запоминаем родительский объект
 					obj->father = father;
 					// Если нужно выполнить переоценку
-					if(rest) obj->oc++;
+					if(reset) obj->oc++;
 					// Если идентификаторы документов не совпадают
 					else if(obj->idd != idd){
 						// Запоминаем идентификатор документа
 						obj->idd = idd;
 						// Добавляем последовательность
-						obj->oc += seq.oc;
+						obj->oc += item.oc;
 						// Увеличиваем количество документов
-						obj->dc += seq.dc;
+						obj->dc += item.dc;
 					}
 					// Добавляем в список регистр слова
-					if(!rest && (seq.ups > 0)){
+					if(!reset && (item.ups > 0)){
 						// Если такого регистра еще нет в списке
-						if(obj->uppers.count(seq.ups) == 0)
+						if(obj->uppers.count(item.ups) == 0)
 							// Добавляем в список регистр слова
-							obj->uppers.emplace((size_t) seq.ups, 1);
+							obj->uppers.emplace((size_t) item.ups, 1);
 						// Иначе увеличиваем существующий регистр слова
-						else obj->uppers[seq.ups]++;
+						else obj->uppers[item.ups]++;
 					}
-					// Если количество n-грамм достигло предела, выходим
-					if((++i) > (this->size - 1)) break;
 				}
-				// Удаляем первый идентификатор
-				tmp.erase(tmp.begin());
-				// Если список еще не пустой, продолжаем дальше
-				if(tmp.size() >= size_t(this->size)) this->add(tmp, idd, true);
 			}
-		});
-		// Очищаем собранный список n-грамм
-		if(!this->ngrams.empty()) this->ngrams.clear();
+		};
+		// Начало текущего отрезка без неизвестных слов
+		size_t first = 0;
+		// Переходим по всей последовательности
+		for(size_t i = 0; i < seq.size(); i++){
+			// Если это неизвестное слово, оно разрывает последовательность
+			if(this->isUnk(seq[i].idw)){
+				// Учитываем неизвестное слово
+				unkFn(seq[i]);
+				// Добавляем собранный отрезок
+				addFn(first, i);
+				// Следующий отрезок начинается после неизвестного слова
+				first = (i + 1);
+			}
+		}
+		// Добавляем оставшийся отрезок
+		addFn(first, seq.size());
 	}
 }
 /**
@@ -2570,7 +2962,7 @@ void anyks::Arpa::sweep(function <void (const u_short)> status) const noexcept {
 				}
 			};
 			// Список n-грамм для работы
-			list <data_t *> * ngrams = nullptr;
+			vector <data_t *> * ngrams = nullptr;
 			// Переходим по всем n-граммам и удаляем те у которых слишком низкая частота
 			for(u_short i = (this->size - 1); i > 1; i--){
 				// Выполняем извлечение n-грамм
@@ -2638,31 +3030,38 @@ void anyks::Arpa::train(function <void (const u_short)> status) const noexcept {
 	if(!this->data.empty() && !this->isOption(options_t::notTrain)){
 		// Сбрасываем текущую позицию n-граммы
 		this->gram = 1;
-		// Количество n-грамм и индекс обработанной n-граммы
-		size_t count = 0, index = 0;
-		// Текущий и предыдущий статус
-		u_short actual = 0, past = 100;
-		// Получаем значение флага интерполяции
-		bool interpolate = this->isOption(options_t::interpolate);
+		// Количество n-грамм
+		size_t count = 0;
+		// Мютекс блокировки потока
+		std::mutex mtx;
+		// Индекс обработанной n-граммы
+		std::atomic <size_t> index{0};
+		// Предыдущий статус
+		std::atomic <u_short> past{0};
+		// Контексты обрабатываются параллельно, только если отладка отключена (сохраняем порядок лога)
+		if(!debug && (this->threads > 1)) this->tpool.init(this->threads);
 		/**
 		 * estimate1Fn Функция первоначального подсчёта грамм
-		 * @param oc встречаемость n-граммы
+		 * @param param параметры расчёта контекста
+		 * @param oc    встречаемость n-граммы
 		 */
-		auto estimate1Fn = [this](const size_t oc) noexcept {
+		auto estimate1Fn = [](param_t & param, const size_t oc) noexcept {
 			// Считаем существующее слова
-			this->param.observed++;
+			param.observed++;
 			// Считаем общее количество встречаемости
-			this->param.total += oc;
+			param.total += oc;
 			// Увеличиваем количество минимальных встречающихся слов
-			if(oc >= 2) this->param.min2Vocab++;
-			if(oc >= 3) this->param.min3Vocab++;
+			if(oc >= 2) param.min2Vocab++;
+			if(oc >= 3) param.min3Vocab++;
 		};
 		/**
 		 * estimate2Fn Функция основного подсчёта грамм
-		 * @param idw   идентификатор слова
-		 * @param ngram параметры граммы
+		 * @param param       параметры расчёта контекста
+		 * @param interpolate флаг интерполяции
+		 * @param idw         идентификатор слова
+		 * @param ngram       параметры граммы
 		 */
-		auto estimate2Fn = [debug, &interpolate, this](const size_t idw, data_t * ngram) noexcept {
+		auto estimate2Fn = [debug, this](param_t & param, const bool interpolate, const size_t idw, data_t * ngram) noexcept {
 			// Результат расчёта
 			double lprob = 0.0;
 			// Вероятность n-граммы
@@ -2672,7 +3071,7 @@ void anyks::Arpa::train(function <void (const u_short)> status) const noexcept {
 			// Если это безсобытийная грамма (Начальная)
 			if(this->isStart(idw) || ((this->gram == 1) && this->isUnk(idw) && this->isOption(options_t::resetUnk))){
 				// Если это неизвестный символ, то считаем количество безсобытийных грамм
-				if(this->isUnk(idw)) this->param.nonevent++;
+				if(this->isUnk(idw)) param.nonevent++;
 				// Устанавливаем значение скидки по умолчанию
 				discount = 1.0;
 				// Устанавливаем результат по умолчанию
@@ -2697,13 +3096,13 @@ void anyks::Arpa::train(function <void (const u_short)> status) const noexcept {
 				 */
 				if(this->nodiscount()) discount = 1.0;
 				// Выполняем дисконтирование
-				else discount = this->discount(ngram->oc, this->param.total, this->param.observed);
+				else discount = this->discount(ngram->oc, param.total, param.observed);
 				// Выполняем расчёт
-				prob = ((discount * double(ngram->oc)) / double(this->param.total));
+				prob = ((discount * double(ngram->oc)) / double(param.total));
 				// Если нужно использовать интерполирование
 				if(interpolate){
 					// Выполняем расчет веса интерполирования
-					lowerWeight = this->lowerWeight(this->param.total, this->param.observed, this->param.min2Vocab, this->param.min3Vocab);
+					lowerWeight = this->lowerWeight(param.total, param.observed, param.min2Vocab, param.min3Vocab);
 					// Если это не юниграмма
 					if(this->gram > 1) lowerProb = this->backoff(idw, ngram->father, this->gram - 2);
 					// Если же это юниграмма
@@ -2716,7 +3115,7 @@ void anyks::Arpa::train(function <void (const u_short)> status) const noexcept {
 				// Если результат получен
 				if(isnormal(discount)){
 					// Увеличиваем общую вероятность n-грамм
-					this->param.prob += prob;
+					param.prob += prob;
 					// Если режим отладки включён
 					if(debug){
 						// Выводимое сообщение статистики
@@ -2726,13 +3125,13 @@ void anyks::Arpa::train(function <void (const u_short)> status) const noexcept {
 							// Дополняем сообщение
 							message.append(" LOW %4.8f LOLPROB %4.8f");
 							// Выводим статистику в сообщении
-							this->alphabet->log(message.c_str(), alphabet_t::log_t::info, this->logfile, this->context(ngram->father).c_str(), this->word(idw).c_str(), ngram->oc, this->param.total, discount, lowerWeight, lowerProb);
+							this->alphabet->log(message.c_str(), alphabet_t::log_t::info, this->logfile, this->context(ngram->father).c_str(), this->word(idw).c_str(), ngram->oc, param.total, discount, lowerWeight, lowerProb);
 						// Если интерполирование отключено
 						} else {
 							// Дополняем сообщение
 							message.append(" LPROB %4.8f");
 							// Выводим статистику в сообщении
-							this->alphabet->log(message.c_str(), alphabet_t::log_t::info, this->logfile, this->context(ngram->father).c_str(), this->word(idw).c_str(), ngram->oc, this->param.total, discount, lprob);
+							this->alphabet->log(message.c_str(), alphabet_t::log_t::info, this->logfile, this->context(ngram->father).c_str(), this->word(idw).c_str(), ngram->oc, param.total, discount, lprob);
 						}
 					}
 				}
@@ -2741,50 +3140,144 @@ void anyks::Arpa::train(function <void (const u_short)> status) const noexcept {
 					// Устанавливаем вес n-граммы
 					ngram->weight = 0.0;
 					// Увеличиваем количество n-грамм которые не удалось расчитать
-					this->param.discounted++;
+					param.discounted++;
 				// Запоминаем результат
 				} else ngram->weight = lprob;
 			}
 		};
 		/**
-		 * Прототип функции перехода по граммам
+		 * statusFn Функция вывода статуса обучения
+		 * @param processed количество обработанных n-грамм
 		 */
-		function <void ()> runFn;
+		auto statusFn = [&](const size_t processed) noexcept {
+			// Если функция вывода статуса передана
+			if(status != nullptr){
+				// Выполняем расчёт текущего статуса
+				const u_short actual = u_short((index.fetch_add(processed) + processed) / double(count) * 100.0);
+				// Если статус обновился
+				if(actual > past.load()){
+					// Выполняем блокировку потока
+					const std::lock_guard <std::mutex> lock(mtx);
+					// Если статус не обновили в другом потоке
+					if(actual > past.load()){
+						// Запоминаем текущий статус
+						past.store(actual);
+						// Выводим статус обучения
+						status(actual);
+					}
+				}
+			}
+		};
 		/**
-		 * runFn Функция перехода по граммам
+		 * contextFn Функция расчёта весов и частоты отката одного контекста
+		 * @param item  контекст для расчёта
+		 * @param stat  статистика отброшенных n-грамм потока
 		 */
-		runFn = [&]() noexcept {
-			// Если дисконтирование включено, изменяем встречаемости
-			if(!this->nodiscount()) this->prepare(this->gram);
-			// Если это нулевая n-грамма
-			switch(this->gram){
-				// Если это юниграмма
-				case 1: {
-					// Переходим по всему списку юниграмм
-					for(auto & value : this->data){
+		auto contextFn = [&](data_t * item, param_t & stat) noexcept {
+			// Если в n-грамме нет дочерних грамм, выходим
+			if(item->empty()) return;
+			// Параметры расчёта контекста, контексты не зависят друг от друга
+			param_t param;
+			// Активируем снова интерполяцию
+			bool interpolate = this->isOption(options_t::interpolate);
+			// Переходим по всему списку грамм
+			for(auto & value : * item){
+				// Если это безсобытийная грамма (Начальная)
+				if(this->isStart(value.second.idw)) continue;
+				// Выполняем первоначальный подсчёт грамм
+				estimate1Fn(param, value.second.oc);
+			}
+			// Если общее количество n-грамм собрать не вышло
+			if(param.total == 0) return;
+			/**
+			 * Вычисляем дисконтированные вероятности
+			 * из подсчётов и сохраняем их в частоте отката.
+			 */
+			retry:
+			// Обнуляем общую вероятность n-грамм
+			param.prob = 0.0;
+			// Переходим по всему списку грамм
+			for(auto & value : * item){
+				// Если количество n-грамм не определено
+				if((this->gram > 1) && (value.second.oc == 0)){
+					// Устанавливаем вес n-граммы
+					value.second.weight = 0.0;
+					// Пропускаем данную n-грамму
+					continue;
+				}
+				// Выполняем расчёт
+				estimate2Fn(param, interpolate, value.second.idw, &value.second);
+			}
+			/**
+			 * Этот взлом зачислен Дугу Полу (Рони Розенфельдом в его инструментах CMU).
+			 * Может случиться так, что после суммирования всех явных проб не останется
+			 * массы вероятности, как правило, потому, что коэффициенты
+			 * дисконтирования были вне диапазона и были установлены на 1.0.
+			 * Если мы не увидели все словарные слова в этом контексте,
+			 * чтобы получить некоторую ненулевую массу отката,
+			 * мы пытаемся увеличить знаменатель в оценке на 1.
+			 * Еще один хак: если в методе дисконтирования используется интерполяция,
+			 * мы сначала пытаемся отключить его, поскольку интерполяция удаляет массу вероятности.
+			 */
+			if(!this->nodiscount() && (param.total > 0) && (param.observed < this->unigrams()) && (param.prob > (1.0 - EPSILON))){
+				// Выводим предупреждение
+				if(debug){
+					// Формируем вывод сообщения
+					string message = "%4.8f backoff probability mass left for \"%s\" -- ";
+					// Если интеполяция включена - сообщаем, что отключаем интерполяцию
+					if(interpolate)
+						// Если интеполяция включена - сообщаем, что отключаем интерполяцию
+						message.append("disabling interpolation");
+					// Выводим сообщение для неинтерполированного деноминатора
+					else message.append("incrementing denominator");
+					// Выводим сообщение об ошибке
+					this->alphabet->log(message.c_str(), alphabet_t::log_t::warning, this->logfile, (1.0 - param.prob), this->context(item).c_str());
+				}
+				// Отключаем интерполяцию
+				if(interpolate) interpolate = false;
+				// Увеличиваем количество n-грамм
+				else param.total += 1;
+				// Пробуем обработать еще раз
+				goto retry;
+			}
+			/**
+			 * При наличии всех проб, BOWs получаются просто путем обычной нормализации.
+			 * Мы делаем это прямо перед вычислением проб более высокого порядка,
+			 * поскольку оценка N-грамм более высокого порядка может относиться
+			 * к оценкам более низкого порядка (например, для интерполированных оценок).
+			 */
+			this->backoffs(this->gram - 1, item);
+			// Переносим статистику отброшенных n-грамм контекста
+			stat.nonevent   += param.nonevent;
+			stat.discounted += param.discounted;
+		};
+		/**
+		 * Прототип функции перехода по граммам
+		 */
+		function <void ()> runFn;
+		/**
+		 * runFn Функция перехода по граммам
+		 */
+		runFn = [&]() noexcept {
+			// Если дисконтирование включено, изменяем встречаемости
+			if(!this->nodiscount()) this->prepare(this->gram);
+			// Если это нулевая n-грамма
+			switch(this->gram){
+				// Если это юниграмма
+				case 1: {
+					// Переходим по всему списку юниграмм
+					for(auto & value : this->data){
 						// Если это безсобытийная грамма (Начальная)
 						if(this->isStart(value.second.idw) || (this->isOption(options_t::resetUnk) && this->isUnk(value.second.idw))) continue;
 						// Выполняем первоначальный подсчёт грамм
-						estimate1Fn(value.second.oc);
+						estimate1Fn(this->param, value.second.oc);
 					}
 					// Переходим по всему списку юниграмм
 					for(auto & value : this->data){
 						// Выполняем расчёт
-						estimate2Fn(value.second.idw, &value.second);
-						// Если функция вывода статуса передана
-						if(status != nullptr){
-							// Увеличиваем значение индекса
-							index++;
-							// Выполняем расчёт текущего статуса
-							actual = u_short(index / double(count) * 100.0);
-							// Если статус обновился
-							if(actual != past){
-								// Запоминаем текущий статус
-								past = actual;
-								// Выводим статус обучения
-								status(actual);
-							}
-						}
+						estimate2Fn(this->param, this->isOption(options_t::interpolate), value.second.idw, &value.second);
+						// Выводим статус обучения
+						statusFn(1);
 					}
 					/**
 					 * При наличии всех проб, BOWs получаются просто путем обычной нормализации.
@@ -2800,109 +3293,28 @@ void anyks::Arpa::train(function <void (const u_short)> status) const noexcept {
 					auto ngrams = this->get(this->gram);
 					// Если список n-грамм получен
 					if((ngrams != nullptr) && !ngrams->empty()){
-						// Переходим по всему списку полученных n-грамм
-						for(auto & item : * ngrams){
-							// Если в n-грамме есть дочерные граммы
-							if(!item->empty()){
-								// Обнуляем встречаемость всех n-грамм
-								this->param.total = 0;
-								// Обнуляем количество реальных слов
-								this->param.observed = 0;
-								// Обнуляем встречаемость больше 2-х раз
-								this->param.min2Vocab = 0;
-								// Обнуляем встречаемость больше 3-х раз
-								this->param.min3Vocab = 0;
-								// Активируем снова интерполяцию
-								interpolate = this->isOption(options_t::interpolate);
-								// Переходим по всему списку грамм
-								for(auto & value : * item){
-									// Если это безсобытийная грамма (Начальная)
-									if(this->isStart(value.second.idw)) continue;
-									// Выполняем первоначальный подсчёт грамм
-									estimate1Fn(value.second.oc);
-								}
-								// Если общее количество n-грамм собрать не вышло
-								if(this->param.total == 0) continue;
-								/**
-								 * Вычисляем дисконтированные вероятности
-								 * из подсчётов и сохраняем их в частоте отката.
-								 */
-								retry:
-								// Временный индекс обработанных грамм
-								size_t tindex = 0;
-								// Обнуляем общую вероятность n-грамм
-								this->param.prob = 0.0;
-								// Переходим по всему списку грамм
-								for(auto & value : * item){
-									// Если функция вывода статуса передана
-									if(status != nullptr){
-										// Увеличиваем значение индекса
-										index++;
-										// Увеличиваем временный индекс
-										tindex++;
-										// Выполняем расчёт текущего статуса
-										actual = u_short(index / double(count) * 100.0);
-										// Если статус обновился
-										if(actual != past){
-											// Запоминаем текущий статус
-											past = actual;
-											// Выводим статус обучения
-											status(actual);
-										}
-									}
-									// Если количество n-грамм не определено
-									if((this->gram > 1) && (value.second.oc == 0)){
-										// Устанавливаем вес n-граммы
-										value.second.weight = 0.0;
-										// Пропускаем данную n-грамму
-										continue;
-									}
-									// Выполняем расчёт
-									estimate2Fn(value.second.idw, &value.second);
-								}
-								/**
-								 * Этот взлом зачислен Дугу Полу (Рони Розенфельдом в его инструментах CMU).
-								 * Может случиться так, что после суммирования всех явных проб не останется
-								 * массы вероятности, как правило, потому, что коэффициенты
-								 * дисконтирования были вне диапазона и были установлены на 1.0.
-								 * Если мы не увидели все словарные слова в этом контексте,
-								 * чтобы получить некоторую ненулевую массу отката,
-								 * мы пытаемся увеличить знаменатель в оценке на 1.
-								 * Еще один хак: если в методе дисконтирования используется интерполяция,
-								 * мы сначала пытаемся отключить его, поскольку интерполяция удаляет массу вероятности.
-								 */
-								if(!this->nodiscount() && (this->param.total > 0) && (this->param.observed < this->unigrams()) && (this->param.prob > (1.0 - EPSILON))){
-									// Выводим предупреждение
-									if(debug){
-										// Формируем вывод сообщения
-										string message = "%4.8f backoff probability mass left for \"%s\" -- ";
-										// Если интеполяция включена - сообщаем, что отключаем интерполяцию
-										if(interpolate)
-											// Если интеполяция включена - сообщаем, что отключаем интерполяцию
-											message.append("disabling interpolation");
-										// Выводим сообщение для неинтерполированного деноминатора
-										else message.append("incrementing denominator");
-										// Выводим сообщение об ошибке
-										this->alphabet->log(message.c_str(), alphabet_t::log_t::warning, this->logfile, (1.0 - this->param.prob), this->context(item).c_str());
-									}
-									// Отключаем интерполяцию
-									if(interpolate) interpolate = false;
-									// Увеличиваем количество n-грамм
-									else this->param.total += 1;
-									// Обновляем обработанный индекс
-									if(status != nullptr) index -= tindex;
-									// Пробуем обработать еще раз
-									goto retry;
-								}
-								/**
-								 * При наличии всех проб, BOWs получаются просто путем обычной нормализации.
-								 * Мы делаем это прямо перед вычислением проб более высокого порядка,
-								 * поскольку оценка N-грамм более высокого порядка может относиться
-								 * к оценкам более низкого порядка (например, для интерполированных оценок).
-								 */
-								this->backoffs(this->gram - 1, item);
+						// Список контекстов текущего порядка
+						const vector <data_t *> & contexts = (* ngrams);
+						/**
+						 * Контексты одного порядка независимы, так как младшие порядки уже рассчитаны,
+						 * поэтому обрабатываем их параллельно блоками
+						 */
+						this->tpool.parallel_for(0, contexts.size(), [&](const size_t first, const size_t last){
+							// Статистика отброшенных n-грамм блока
+							param_t stat;
+							// Переходим по всем контекстам блока
+							for(size_t i = first; i < last; i++){
+								// Выполняем расчёт контекста
+								contextFn(contexts[i], stat);
+								// Выводим статус обучения
+								statusFn(contexts[i]->size());
 							}
-						}
+							// Выполняем блокировку потока
+							const std::lock_guard <std::mutex> lock(mtx);
+							// Переносим статистику отброшенных n-грамм блока
+							this->param.nonevent   += stat.nonevent;
+							this->param.discounted += stat.discounted;
+						});
 					}
 				}
 			}
@@ -2936,6 +3348,8 @@ void anyks::Arpa::train(function <void (const u_short)> status) const noexcept {
 		runFn();
 		// Выполняем фиксацию частот
 		this->fixupProbs(1);
+		// Завершаем работу тредпула
+		this->tpool.wait();
 	// Сообщаем что словарь оказался пустым
 	} else if(debug) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "arpa is empty");
 }
@@ -3058,52 +3472,132 @@ void anyks::Arpa::prune(const double threshold, const u_short mingram, function
 	const bool debug = this->isOption(options_t::debug);
 	// Если словарь не пустой
 	if(!this->data.empty() && (this->size > 1)){
-		/**
-		 * sumFn Функция подсчёта суммы весов n-граммы
-		 * @param gram    значение текущей n-граммы
-		 * @param context контекст которому принадлежит слово
-		 * @return        подсчитанная сумма весов
-		 */
-		auto sumFn = [this](const u_short gram, const data_t * context) noexcept {
-			// Результат работы функции
-			double result = 0.0;
-			// Если контекст передан
-			if(context != nullptr){
-				// Извлекаем предшествующую n-грамму
-				while(context->father != nullptr){
-					// Запоминаем результат
-					if((context->weight != this->zero) && !this->isStart(context->idw) &&
-					((gram > 1) || !this->isUnk(context->idw) || !this->isOption(options_t::resetUnk))) result += context->weight;
-					/**
-					 * Если мы вычисляем предельную вероятность контекста униграммы <s>,
-					 * мы должны искать </s> вместо неё, поскольку у начала предложения вес = 0.
-					 */
-					if(this->isStart(context->idw)) result += context->father->at((size_t) token_t::finish).weight;
-					// Выполняем смещение
-					context = context->father;
-				}
-			}
-			// Выводим результат
-			return result;
-		};
+		// Мютекс блокировки потока
+		std::mutex mtx;
 		// Количество n-грамм которые нужно обработать
-		size_t counts = 0, index = 0;
-		// Текущий и предыдущий статус
-		u_short actual = 0, past = 100;
-		// Частота и обратная частота документа
-		double backoff = 0.0, total = 0.0;
-		// Устанавливаем нуминатор и денуминатор
-		double numerator = 0.0, denominator = 0.0;
+		size_t counts = 0;
+		// Индекс обработанной n-граммы
+		std::atomic <size_t> index{0};
+		// Предыдущий статус
+		std::atomic <u_short> past{0};
 		// Если размер минимальной n-граммы не установлен, устанавливаем его
 		const u_short gram = (mingram == 0 ? this->size : mingram);
+		// Порядок, начиная с которого изменились веса n-грамм
+		u_short changed = (this->size + 1);
+		// Список контекстов, веса n-грамм которых изменились, для каждого порядка
+		vector <vector <data_t *>> dirty(this->size + 1);
+		// Контексты обрабатываются параллельно, только если отладка отключена (сохраняем порядок лога)
+		if(!debug && (this->threads > 1)) this->tpool.init(this->threads);
 		// Переходим по всем n-граммам задом наперёд
 		for(u_short i = this->size; (i > 0) && (i >= gram); i--){
 			// Получаем количество n-грамм
 			counts += this->count(i, true);
 		}
+		/**
+		 * statusFn Функция вывода статуса прунинга
+		 * @param processed количество обработанных n-грамм
+		 */
+		auto statusFn = [&](const size_t processed) noexcept {
+			// Если функция вывода статуса передана
+			if(status != nullptr){
+				// Выполняем расчёт текущего статуса
+				const u_short actual = u_short((index.fetch_add(processed) + processed) / double(counts) * 100.0);
+				// Если статус обновился
+				if(actual > past.load()){
+					// Выполняем блокировку потока
+					const std::lock_guard <std::mutex> lock(mtx);
+					// Если статус не обновили в другом потоке
+					if(actual > past.load()){
+						// Запоминаем текущий статус
+						past.store(actual);
+						// Выводим статус прунинга
+						status(actual);
+					}
+				}
+			}
+		};
+		/**
+		 * contextFn Функция прунинга n-грамм одного контекста
+		 * @param i      размер n-граммы для работы
+		 * @param item   контекст для прунинга
+		 * @param count  количество удалённых n-грамм
+		 * @return       результат проверки, изменились ли веса или частота отката контекста
+		 */
+		auto contextFn = [&](const u_short i, data_t * item, size_t & count) noexcept {
+			// Результат работы функции
+			bool result = false;
+			// Количество удалённых n-грамм контекста
+			size_t removed = 0;
+			// Прунник всех вариантов
+			bool allPruned = true;
+			// Устанавливаем нуминатор и денуминатор
+			double numerator = 0.0, denominator = 0.0;
+			// Получаем обратную частоту документа
+			const double backoff = item->backoff;
+			// Выполняем оценку всех n-грамм контекста
+			if(this->entropy(item, i, numerator, denominator, [&](data_t * ngram, const double total, const double weight, const double delta, const double deltaEntropy, const double perpChange) noexcept {
+				// Проверяем выполнен ли прунинг
+				bool pruned = ((threshold > 0) && (perpChange < threshold));
+				/**
+				 * Убеждаемся, что мы не удаляем n-граммы,
+				 * чьи частоты отката нам необходимы ...
+				 */
+				if(pruned && ((ngram->backoff != this->zero) && this->isWords(ngram))) pruned = false;
+				// Если отладка включена
+				if(debug){
+					// Выводим статистику в сообщении
+					this->alphabet->log(
+						"CONTEXT %s WORD %s CONTEXTPROB %4.8f OLDPROB %4.8f NEWPROB %4.8f DELTA-H %4.8f DELTA-LOGP %4.8f PPL-CHANGE %4.8f PRUNED %u",
+						alphabet_t::log_t::info,
+						this->logfile,
+						this->context(item).c_str(),
+						this->word(ngram->idw, this->uppers(ngram).first).c_str(),
+						total,
+						ngram->weight,
+						weight,
+						deltaEntropy,
+						delta,
+						perpChange,
+						pruned
+					);
+				}
+				// Если пруннинг выполнен
+				if(pruned){
+					// Запоминаем количество обработанных n-грамм
+					removed++;
+					// Удаляем вес n-граммы
+					ngram->weight = 0.0;
+				// Отмечаем что пруннинг выполнен не всех n-грамм
+				} else allPruned = false;
+			})){
+				/**
+				 * Нулевые коэффициенты означают, что расчёт мог перемасштабировать веса n-грамм контекста,
+				 * такой контекст считаем изменённым
+				 */
+				result = ((numerator == 0.0) && (denominator == 0.0));
+				/**
+				 * Если мы удалили все n-граммы для этого контекста,
+				 * мы можем удалить сам контекст,
+				 * но только если текущий контекст не является префиксом более длинного.
+				 */
+				if(allPruned && !this->isWords(item)) item->backoff = this->zero;
+				// Если n-граммы удалены или частота отката сброшена, контекст изменился
+				if((removed > 0) || (item->backoff != backoff)) result = true;
+			}
+			// Увеличиваем количество удалённых n-грамм
+			count += removed;
+			// Выводим статус обработки
+			statusFn(item->size());
+			// Выводим результат
+			return result;
+		};
 		// Список n-грамм для работы
-		list <data_t *> * ngrams = nullptr;
-		// Переходим по всем n-граммам задом наперёд
+		vector <data_t *> * ngrams = nullptr;
+		/**
+		 * Переходим по всем n-граммам задом наперёд.
+		 * Прунинг n-грамм порядка i читает только веса младших порядков,
+		 * а изменяет только n-граммы своего контекста, поэтому контексты одного порядка независимы.
+		 */
 		for(u_short i = this->size; (i > 0) && (i >= gram); i--){
 			// Выполняем извлечение n-грамм
 			ngrams = this->get(i);
@@ -3111,118 +3605,32 @@ void anyks::Arpa::prune(const double threshold, const u_short mingram, function
 			if((ngrams != nullptr) && !ngrams->empty()){
 				// Количество обработанных n-грамм
 				size_t prunedNgrams = 0;
-				// Переходим по всему списку полученных n-грамм
-				for(auto & item : * ngrams){
-					// Если в n-грамме есть дочерные граммы
-					if(!item->empty()){
-						// Обнуляем нумератор
-						numerator = 0.0;
-						// Обнуляем денумератор
-						denominator = 0.0;
-						// Получаем обратную частоту документа
-						backoff = item->backoff;
-						// Если обратная частота документа существует
-						if(isnormal(backoff)){
-							/**
-							 * Вычисляем числитель и знаменатель обратной частоты отката,
-							 * чтобы мы могли быстро вычислить корректировку BOW из-за отсутствия одного пробника.
-							 */
-							if(!this->compute(item, i - 1, numerator, denominator)){
-								// Увеличиваем количество обработанных n-грамм
-								index++;
-								// Пропускаем ход
-								continue;
-							}
-							// Получаем сумму весов
-							total = sumFn(i, item);
-							// Прунник всех вариантов
-							bool allPruned = true;
-							// Переходим по всему слов в контексте
-							for(auto & value : * item){
-								// Если частота n-граммы существует
-								if(this->isWord(&value.second)){
-									// Генерируем обратную частоту n-граммы
-									double bow = this->backoff(value.second.idw, item, i - 2);
-									// Расчитываем новую обратную частоту документа
-									double nbow = (log10(numerator + pow(10, value.second.weight)) - log10(denominator + pow(10, bow)));
-									/**
-									 * Вычислить изменение энтропии за счет удаления ngram
-									 * deltaH = - P(H) x
-									 *  {P(W | H) [log P(w|h') + log BOW'(h) - log P(w|h)] +
-									 *  (1 - \sum_{v,h ngrams} P(v|h)) [log BOW'(h) - log BOW(h)]}
-									 *
-									 * (1-\sum_{v,h ngrams}) - масса вероятности,
-									 * оставшаяся от n-граммы текущего порядка,
-									 * и такая же, как числитель в BOW(h).
-									 */
-									double delta = (bow + nbow - value.second.weight);
-									// Считаем дельту энтропии
-									double deltaEntropy = (- pow(10, total) * (pow(10, value.second.weight) * delta + numerator * (nbow - backoff)));
-									/**
-									 * Вычисляем относительное изменение модели (трейн-сета) перплексия
-									 *  (PPL' - PPL)/PPL = PPL'/PPL - 1
-									 *                   = exp(H')/exp(H) - 1
-									 *                   = exp(H' - H) - 1
-									 */
-									double perpChange = (pow(10, deltaEntropy) - 1.0);
-									// Проверяем выполнен ли прунинг
-									bool pruned = ((threshold > 0) && (perpChange < threshold));
-									/**
-									 * Убеждаемся, что мы не удаляем n-граммы,
-									 * чьи частоты отката нам необходимы ...
-									 */
-									if(pruned && ((value.second.backoff != this->zero) && this->isWords(&value.second))) pruned = false;
-									// Если отладка включена
-									if(debug){
-										// Выводим статистику в сообщении
-										this->alphabet->log(
-											"CONTEXT %s WORD %s CONTEXTPROB %4.8f OLDPROB %4.8f NEWPROB %4.8f DELTA-H %4.8f DELTA-LOGP %4.8f PPL-CHANGE %4.8f PRUNED %u",
-											alphabet_t::log_t::info,
-											this->logfile,
-											this->context(item).c_str(),
-											this->word(value.second.idw, this->uppers(&value.second).first).c_str(),
-											total,
-											value.second.weight,
-											(bow + nbow),
-											deltaEntropy,
-											delta,
-											perpChange,
-											pruned
-										);
-									}
-									// Если пруннинг выполнен
-									if(pruned){
-										// Запоминаем количество обработанных n-грамм
-										prunedNgrams++;
-										// Удаляем вес n-граммы
-										value.second.weight = 0.0;
-									// Отмечаем что пруннинг выполнен не всех n-грамм
-									} else allPruned = false;
-								}
-								// Если функция вывода статуса передана
-								if(status != nullptr){
-									// Увеличиваем количество обработанных n-грамм
-									index++;
-									// Выполняем расчёт текущего статуса
-									actual = u_short(index / double(counts) * 100.0);
-									// Если статус обновился
-									if(actual != past){
-										// Запоминаем текущий статус
-										past = actual;
-										// Выводим статус обработки
-										status(actual);
-									}
-								}
-							}
-							/**
-							 * Если мы удалили все n-граммы для этого контекста,
-							 * мы можем удалить сам контекст,
-							 * но только если текущий контекст не является префиксом более длинного.
-							 */
-							if(allPruned && !this->isWords(item)) item->backoff = this->zero;
-						}
+				// Количество изменённых контекстов
+				size_t modifiedContexts = 0;
+				// Список контекстов текущего порядка
+				const vector <data_t *> & contexts = (* ngrams);
+				// Выполняем прунинг контекстов блоками
+				this->tpool.parallel_for(0, contexts.size(), [&](const size_t first, const size_t last){
+					// Количество удалённых n-грамм блока
+					size_t pruned = 0;
+					// Список изменённых контекстов блока
+					vector <data_t *> modified;
+					// Переходим по всем контекстам блока
+					for(size_t j = first; j < last; j++){
+						// Если контекст изменился, запоминаем его
+						if(contextFn(i, contexts[j], pruned)) modified.push_back(contexts[j]);
 					}
-				}
+					// Выполняем блокировку потока
+					const std::lock_guard <std::mutex> lock(mtx);
+					// Увеличиваем количество удалённых n-грамм
+					prunedNgrams += pruned;
+					// Увеличиваем количество изменённых контекстов
+					modifiedContexts += modified.size();
+					// Добавляем изменённые контексты
+					dirty[i].insert(dirty[i].end(), modified.begin(), modified.end());
+				}, 64);
+				// Если контексты изменились, запоминаем порядок
+				if(modifiedContexts > 0) changed = i;
 				// Если отладка включена
 				if(debug && (prunedNgrams > 0)){
 					// Выводим статистику в сообщении
@@ -3236,21 +3644,280 @@ void anyks::Arpa::prune(const double threshold, const u_short mingram, function
 		 * Обратите внимание, что будут сгенерированны узлы отката только для тех контекстов,
 		 * в которых есть слова с явными вероятностями.
 		 * Но это именно так, как и должно быть.
+		 *
+		 * Частота отката контекста зависит только от весов его n-грамм и весов младших порядков,
+		 * поэтому пересчитываем только контексты, n-граммы которых удалены,
+		 * и все контексты порядков выше самого младшего изменённого.
 		 */
 		for(u_short i = 1; i <= this->size; i++){
 			// Выполняем извлечение n-грамм
 			ngrams = this->get(i);
 			// Если список n-грамм получен
 			if((ngrams != nullptr) && !ngrams->empty()){
-				// Переходим по всему списку полученных n-грамм
-				for(auto & item : * ngrams){
-					// Если в n-грамме есть дочерные граммы
-					if(!item->empty()) this->backoffs(i - 1, item);
+				// Если это юниграммы, распределение остатка массы может изменить их веса
+				if(i == 1){
+					// Запоминаем веса юниграмм
+					vector <double> weights;
+					// Выделяем память для весов
+					weights.reserve(this->data.size());
+					// Переходим по всем юниграммам
+					for(auto & item : this->data) weights.push_back(item.second.weight);
+					// Выполняем расчёт частоты отката корня
+					this->backoffs(0, &this->data);
+					// Индекс юниграммы
+					size_t j = 0;
+					// Переходим по всем юниграммам
+					for(auto & item : this->data){
+						// Если вес юниграммы изменился, пересчитываем все контексты
+						if(memcmp(&weights[j++], &item.second.weight, sizeof(double)) != 0){
+							// Запоминаем порядок
+							changed = 1;
+							// Выходим из цикла
+							break;
+						}
+					}
+				// Если контексты порядка зависят от изменённых весов, пересчитываем их все
+				} else if(i > changed) {
+					// Список контекстов текущего порядка
+					const vector <data_t *> & contexts = (* ngrams);
+					// Выполняем расчёт частот отката блоками
+					this->tpool.parallel_for(0, contexts.size(), [&](const size_t first, const size_t last){
+						// Переходим по всем контекстам блока
+						for(size_t j = first; j < last; j++){
+							// Если в n-грамме есть дочерные граммы
+							if(!contexts[j]->empty()) this->backoffs(i - 1, contexts[j]);
+						}
+					}, 64);
+				// Иначе пересчитываем только изменённые контексты
+				} else if(!dirty[i].empty()) {
+					// Выполняем расчёт частот отката блоками
+					this->tpool.parallel_for(0, dirty[i].size(), [&](const size_t first, const size_t last){
+						// Переходим по всем контекстам блока
+						for(size_t j = first; j < last; j++) this->backoffs(i - 1, dirty[i][j]);
+					}, 64);
+				}
+			}
+		}
+		// Завершаем работу тредпула
+		this->tpool.wait();
+	// Сообщаем что словарь оказался пустым
+	} else if(debug) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "arpa is empty");
+}
+/**
+ * pruneTo Метод прунинга языковой модели до заданного количества n-грамм или размера
+ * @param count   максимальное количество n-грамм (0 - не ограничено)
+ * @param size    максимальный размер записей arpa в бинарном контейнере в байтах (0 - не ограничен)
+ * @param mingram значение минимальной n-граммы за которую нельзя прунить
+ * @param status  функция вывода статуса обучения
+ * @return        подобранный порог прунинга (0 - прунинг не потребовался или ограничения недостижимы)
+ *
+ * Порог подбирается бинарным поиском по оценкам изменения перплексии (тот же критерий, что и в prune),
+ * размер оценивается по несжатым бинарным данным arpa (getBin), каждая последовательность которых
+ * сохраняется в ablm отдельной записью, вместе со служебными данными записи (BINRECORD).
+ * Если ограничения недостижимы даже при удалении всех n-грамм которые можно удалить, прунинг не выполняется.
+ */
+const double anyks::Arpa::pruneTo(const size_t count, const uintmax_t size, const u_short mingram, function <void (const u_short)> status) const noexcept {
+	// Результат работы функции
+	double result = 0.0;
+	// Проверяем включён ли режим отладки
+	const bool debug = this->isOption(options_t::debug);
+	// Если словарь не пустой
+	if(!this->data.empty() && (this->size > 1)){
+		// Мютекс блокировки потока
+		std::mutex mtx;
+		// Количество n-грамм которые нужно оценить
+		size_t counts = 0;
+		// Индекс обработанной n-граммы
+		std::atomic <size_t> index{0};
+		// Предыдущий статус
+		std::atomic <u_short> past{0};
+		// Список возможных порогов прунинга
+		vector <double> thresholds;
+		// Оценки изменения перплексии n-грамм, которые можно удалить
+		std::unordered_map <const data_t *, double> scores;
+		// Если размер минимальной n-граммы не установлен, устанавливаем его
+		const u_short gram = (mingram == 0 ? this->size : mingram);
+		// Контексты оцениваются параллельно, только если отладка отключена (сохраняем порядок лога)
+		if(!debug && (this->threads > 1)) this->tpool.init(this->threads);
+		// Переходим по всем n-граммам задом наперёд
+		for(u_short i = this->size; (i > 0) && (i >= gram); i--){
+			// Получаем количество n-грамм
+			counts += this->count(i, true);
+		}
+		/**
+		 * statusFn Функция вывода статуса оценки, оценка занимает первую половину работы
+		 * @param processed количество обработанных n-грамм
+		 */
+		auto statusFn = [&](const size_t processed) noexcept {
+			// Если функция вывода статуса передана
+			if(status != nullptr){
+				// Выполняем расчёт текущего статуса
+				const u_short actual = u_short((index.fetch_add(processed) + processed) / double(counts) * 50.0);
+				// Если статус обновился
+				if(actual > past.load()){
+					// Выполняем блокировку потока
+					const std::lock_guard <std::mutex> lock(mtx);
+					// Если статус не обновили в другом потоке
+					if(actual > past.load()){
+						// Запоминаем текущий статус
+						past.store(actual);
+						// Выводим статус оценки
+						status(actual);
+					}
 				}
 			}
+		};
+		/**
+		 * Оцениваем n-граммы в том же порядке что и prune,
+		 * оценка n-граммы зависит только от весов младших порядков, поэтому не зависит от порога.
+		 */
+		for(u_short i = this->size; (i > 0) && (i >= gram); i--){
+			// Выполняем извлечение n-грамм
+			vector <data_t *> * ngrams = this->get(i);
+			// Если список n-грамм получен
+			if((ngrams != nullptr) && !ngrams->empty()){
+				// Список контекстов текущего порядка
+				const vector <data_t *> & contexts = (* ngrams);
+				// Выполняем оценку контекстов блоками
+				this->tpool.parallel_for(0, contexts.size(), [&](const size_t first, const size_t last){
+					// Устанавливаем нуминатор и денуминатор
+					double numerator = 0.0, denominator = 0.0;
+					// Оценки n-грамм блока
+					vector <pair <const data_t *, double>> items;
+					// Переходим по всем контекстам блока
+					for(size_t j = first; j < last; j++){
+						// Выполняем оценку n-грамм контекста
+						this->entropy(contexts[j], i, numerator, denominator, [&items](data_t * ngram, const double, const double, const double, const double, const double perpChange) noexcept {
+							// Запоминаем оценку n-граммы
+							items.emplace_back(ngram, perpChange);
+						});
+						// Выводим статус обработки
+						statusFn(contexts[j]->size());
+					}
+					// Выполняем блокировку потока
+					const std::lock_guard <std::mutex> lock(mtx);
+					// Переходим по всем оценкам блока
+					for(auto & item : items){
+						// Запоминаем оценку n-граммы
+						scores.emplace(item.first, item.second);
+						// Прунинг выполняется только для положительного порога
+						if(item.second > 0.0) thresholds.push_back(item.second);
+					}
+				}, 64);
+			}
 		}
+		// Завершаем работу тредпула
+		this->tpool.wait();
+		/**
+		 * Прототип функции оценки модели после прунинга
+		 * @param контекст для оценки
+		 * @param размер n-граммы контекста
+		 * @param порог прунинга
+		 * @param количество оставшихся n-грамм
+		 * @param размер бинарных данных оставшихся n-грамм
+		 * @return результат проверки, остались ли у контекста n-граммы
+		 */
+		function <const bool (const data_t *, const u_short, const double, size_t &, uintmax_t &)> runFn;
+		/**
+		 * runFn Функция оценки модели после прунинга, повторяет правила prune и формат getBin
+		 * @param context контекст для оценки
+		 * @param depth   размер n-граммы контекста
+		 * @param limit   порог прунинга
+		 * @param ngrams  количество оставшихся n-грамм
+		 * @param bytes   размер бинарных данных оставшихся n-грамм
+		 * @return        результат проверки, остались ли у контекста n-граммы
+		 */
+		runFn = [&](const data_t * context, const u_short depth, const double limit, size_t & ngrams, uintmax_t & bytes) noexcept {
+			// Результат работы функции
+			bool result = false;
+			// Переходим по всем n-граммам контекста
+			for(auto & value : * context){
+				// Если частота n-граммы существует
+				if(this->isWord(&value.second)){
+					// Количество оставшихся n-грамм продолжения
+					size_t ngramsWords = 0;
+					// Размер бинарных данных продолжения
+					uintmax_t bytesWords = 0;
+					// Проверяем остались ли у n-граммы продолжения
+					const bool words = (!value.second.empty() && runFn(&value.second, depth + 1, limit, ngramsWords, bytesWords));
+					// Получаем оценку n-граммы
+					auto it = scores.find(&value.second);
+					// Проверяем будет ли выполнен прунинг
+					bool pruned = ((limit > 0.0) && (it != scores.end()) && (it->second < limit));
+					// Частоты отката n-грамм с продолжениями не удаляются
+					if(pruned && ((value.second.backoff != this->zero) && words)) pruned = false;
+					// Если n-грамма остаётся в модели
+					if(!pruned){
+						// Запоминаем что n-граммы остались
+						result = true;
+						// Считаем n-грамму и её продолжения
+						ngrams += (ngramsWords + 1);
+						// Последовательность без продолжений записывается отдельной записью (количество и n-граммы)
+						bytes += (words ? bytesWords : (sizeof(u_short) + depth * sizeof(seq_t) + BINRECORD));
+					}
+				}
+			}
+			// Выводим результат
+			return result;
+		};
+		/**
+		 * fitFn Функция проверки, укладывается ли модель в ограничения после прунинга
+		 * @param limit порог прунинга
+		 * @return      результат проверки
+		 */
+		auto fitFn = [&](const double limit) noexcept {
+			// Количество оставшихся n-грамм
+			size_t ngrams = 0;
+			// Размер бинарных данных
+			uintmax_t bytes = 0;
+			// Выполняем оценку модели
+			runFn(&this->data, 1, limit, ngrams, bytes);
+			// Если отладка включена, выводим оценку
+			if(debug) this->alphabet->log("threshold %4.8f: %zu n-grams, %ju bytes", alphabet_t::log_t::info, this->logfile, limit, ngrams, bytes);
+			// Выводим результат
+			return (((count == 0) || (ngrams <= count)) && ((size == 0) || (bytes <= size)));
+		};
+		// Если модель не укладывается в ограничения
+		if(!fitFn(0.0)){
+			// Сортируем пороги
+			sort(thresholds.begin(), thresholds.end());
+			// Удаляем повторяющиеся пороги
+			thresholds.erase(unique(thresholds.begin(), thresholds.end()), thresholds.end());
+			// Добавляем порог, при котором удаляются все n-граммы которые можно удалить
+			thresholds.push_back(nextafter(thresholds.empty() ? 0.0 : thresholds.back(), numeric_limits <double>::infinity()));
+			// Если даже максимальный порог не позволяет уложиться в ограничения, модель не урезаем
+			if(!fitFn(thresholds.back())){
+				// Выводим сообщение об ошибке
+				this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "the limits cannot be reached even if all prunable n-grams are removed, the model is not pruned");
+				// Выводим статус завершения
+				if(status != nullptr) status(100);
+				// Выходим
+				return result;
+			}
+			// Границы бинарного поиска
+			size_t first = 0, last = (thresholds.size() - 1);
+			// Ищем наименьший порог, при котором модель укладывается в ограничения
+			while(first < last){
+				// Получаем середину диапазона
+				const size_t middle = (first + (last - first) / 2);
+				// Если модель укладывается в ограничения, ищем меньший порог
+				if(fitFn(thresholds[middle])) last = middle;
+				// Иначе ищем больший порог
+				else first = (middle + 1);
+			}
+			// Запоминаем найденный порог
+			result = thresholds[first];
+			// Выполняем прунинг, прунинг занимает вторую половину работы
+			this->prune(result, mingram, [&status](const u_short actual) noexcept {
+				// Выводим статус прунинга
+				if(status != nullptr) status(50 + actual / 2);
+			});
+		// Выводим статус завершения
+		} else if(status != nullptr) status(100);
 	// Сообщаем что словарь оказался пустым
 	} else if(debug) this->alphabet->log("%s", alphabet_t::log_t::error, this->logfile, "arpa is empty");
+	// Выводим результат
+	return result;
 }
 /**
  * mixForward Метод интерполяции нескольких моделей в прямом направлении
@@ -3559,7 +4226,7 @@ void anyks::Arpa::mixBackward(const Arpa * lm, const double lambda, function <vo
 		// Очищаем загруженный ранее список кэша
 		this->ngrams.clear();
 		// Список n-грамм для работы
-		list <data_t *> * ngrams1 = nullptr, * ngrams2 = nullptr;
+		vector <data_t *> * ngrams1 = nullptr, * ngrams2 = nullptr;
 		// Переходим по всем n-грамм
 		for(u_short i = max(this->size, lm->size); i > 0; i--){
 			// Выполняем извлечение n-грамм текущей языковой модели
@@ -3688,469 +4355,166 @@ void anyks::Arpa::mixBackward(const Arpa * lm, const double lambda, function <vo
 	}
 }
 /**
- * mixLoglinear Метод интерполяции нескольких моделей алгоритмом Баеса
+ * mix Метод интерполяции нескольких моделей объединённым обходом деревьев
  * @param lms     список данных языковых моделей для объединения
  * @param lambdas список весов моделей при интерполяции
+ * @param bayes   флаг интерполяции алгоритмом Баеса (иначе логарифмическо-линейная)
+ * @param length  длина контекста для расчёта (для алгоритма Баеса)
+ * @param scale   логарифмическая шкала вероятности (для алгоритма Баеса)
  * @param status  статус расчёта
  */
-void anyks::Arpa::mixLoglinear(const vector <const Arpa *> & lms, const vector <double> & lambdas, function <void (const u_short)> status) noexcept {
-	// Если языковые модели загружены
-	if(!this->data.empty() && !lms.empty() && (lms.size() == (lambdas.size() - 1))){
-		// Индекс обхода всех языковых моделей
-		size_t index = 0, count = 0;
-		// Текущий и предыдущий статус
-		u_short actual = 0, past = 100;
-		// Проверяем включён ли режим отладки
-		const bool debug = this->isOption(options_t::debug);
-		/**
-		 * seqFn Функция получения последовательности
-		 * @param ngram контекст для получения последовательности
-		 * @return      полученный список последовательности
-		 */
-		auto seqFn = [](const data_t * ngram) noexcept {
-			// Последовательность для поиска
-			vector <size_t> result;
-			// Получаем текущее значение первого контекста
-			const data_t * context = ngram;
-			// Извлекаем предшествующую n-грамму
-			while(context->father != nullptr){
-				// Добавляем слово в последовательность
-				result.insert(result.begin(), context->idw);
-				// Выполняем смещение
-				context = context->father;
-			}
-			// Выводим результат
-			return result;
-		};
-		/**
-		 * Прототип функции получения частоты для контекста
-		 * @param список последовательности для обработки
-		 * @param языковая модель из которой нужно получить частоту
-		 * @param размер n-граммы для поиска
-		 * @param флаг предписывающий уменьшить длину n-граммы
-		 * @return обратная частота отката
-		 */
-		function <const double (const vector <size_t> &, const Arpa *, const bool)> weightFn;
-		/**
-		 * weightFn Функция получения частоты для контекста
-		 * @param seq  список последовательности для обработки
-		 * @param lm   языковая модель из которой нужно получить частоту
-		 * @param back флаг предписывающий уменьшить длину n-граммы
-		 * @return     обратная частота отката
-		 */
-		weightFn = [&weightFn, this](const vector <size_t> & seq, const Arpa * lm, const bool back) noexcept {
-			// Результат работы функции
-			double result = 0.0;
-			// Если это неизвестное слово, тогда выходим
-			if(this->isUnk(seq.back())) return result;
-			// Если размер запрашиваемых n-грамм больше 0
-			if(((seq.size() > 1) && back) || (!back && !seq.empty())){
-				// Получаем объект для поиска
-				const data_t * obj = &lm->data;
-				// Формируем последовательность для поиска
-				vector <size_t> tmp(seq.begin() + u_short(back), seq.end());
-				// Переходим по всему списку n-грамм
-				for(auto & idw : tmp){
-					// Ещем нашу n-грамму в другой языковой модели
-					auto it = obj->find(idw);
-					// Если n-гамма найдена
-					if(it != obj->end()){
-						// Запоминаем объект
-						obj = &it->second;
-						// Запоминаем вес последовательности
-						result = obj->weight;
-					// Если мы дошли до конца
-					} else {
-						// Продолжаем поиск дальше
-						result = weightFn(tmp, lm, true);
-						// Выходим из цикла
-						break;
-					}
-				}
-			}
-			// Выводим результат
-			return result;
-		};
-		/**
-		 * probFn Функция расчёта веса n-граммы
-		 * @param ngram контекст для получения последовательности
-		 * @return      результат расчёта
-		 */
-		auto probFn = [&](const data_t * ngram) noexcept {
-			// Результат работы функции
-			double result = this->zero;
-			// Если идентификатор передан
-			if((ngram->idw > 0) && (ngram->idw < idw_t::NIDW)){
-				// Получаем данные текущей языковой модели
-				const Arpa * lm = this;
-				// Сумма всех весов последовательности
-				double numerator = 0.0;
-				// Получаем количество языковых моделей
-				const size_t count = (lms.size() + 1);
-				// Получаем список последовательности
-				vector <size_t> tmp = seqFn(ngram);
-				// Переходим по всем остальным языковым моделям
-				for(size_t i = 0; i < count; i++){
-					// Если это не нулевая n-грамма
-					if(i > 0) lm = lms[i - 1];
-					// Выполняем расчёт нумератора
-					numerator += (lambdas[i] * weightFn(tmp, lm, true));
-					// Если нумератор больше считать нельзя, выходим
-					if(numerator == this->zero) break;
-				}
-				// Удаляем последнее слово из последовательности
-				tmp.pop_back();
-				// Сумма всех полученных весов
-				double sum = 0.0, probSum = 0.0;
-				// Выполняем переход по всем словам в словаре
-				for(auto & item : this->data){
-					// Пересчитываем число, если оно нормальное
-					if(isnormal(item.second.weight)){
-						// Получаем данные текущей языковой модели
-						lm = this;
-						// Сумма полученных весов
-						probSum = 0.0;
-						// Добавляем в последовательность слово
-						tmp.push_back(item.first);
-						// Переходим по всем остальным языковым моделям
-						for(size_t i = 0; i < count; i++){
-							// Если это не нулевая n-грамма
-							if(i > 0) lm = lms[i - 1];
-							// Выполняем расчёт весов
-							probSum += (lambdas[i] * weightFn(tmp, lm, false));
-						}
-						// Удаляем последнее слово из последовательности
-						tmp.pop_back();
-						// Выполняем расчёт суммы всех весов
-						sum += pow(10, probSum);
-					}
-				}
-				// Выводим результат
-				result = (numerator - log10(sum));
-				// Если результат не получен, скидываем
-				if(!isnormal(result)) result = this->zero;
-			}
-			// Выводим результат
-			return result;
-		};
-		/**
-		 * runFn Функция запуска статической интерполяции
-		 * @param контекст первой языковой модели (куда будут добавлены новые n-граммы)
-		 * @param контекст второй языковой модели (откуда будут добавлены новые n-граммы)
-		 * @param размер n-граммы для обработки
-		 * @param тип этапа интерполяции
-		 */
-		function <void (data_t *, const data_t *, const u_short, const bool)> runFn;
-		/**
-		 * runFn Функция запуска статической интерполяции
-		 * @param lm1  контекст первой языковой модели (куда будут добавлены новые n-граммы)
-		 * @param lm2  контекст второй языковой модели (откуда будут добавлены новые n-граммы)
-		 * @param size размер n-граммы для обработки
-		 * @param mode тип этапа интерполяции
-		 */
-		runFn = [&](data_t * lm1, const data_t * lm2, const u_short size, const bool mode) noexcept {
-			// Если это первый этап интерполяции
-			if(mode){
-				// Значение регистров слова n-граммы
-				size_t uppers = 0;
-				// Текущее значение частоты
-				double weight = 0.0;
-				// Переходим по всему списку n-грамм
-				for(auto & item : * lm1){
-					// Если слово имеет нормальный вес
-					if(isnormal(item.second.weight)){
-						// Запоминаем текущее значение частоты
-						weight = item.second.weight;
-						// Ещем нашу n-грамму в другой языковой модели
-						auto it = lm2->find(item.first);
-						// Если n-гамма найдена
-						if(it != lm2->end()){
-							// Если регистры слова переданы, считаем их
-							if((uppers = (!it->second.uppers.empty() ? it->second.uppers.begin()->first : 0)) > 0){
-								// Если такого регистра еще нет в списке
-								if(item.second.uppers.count(uppers) == 0)
-									// Добавляем в список регистр слова
-									item.second.uppers.emplace(uppers, 1);
-								// Иначе увеличиваем существующий регистр слова
-								else item.second.uppers[uppers]++;
-							}
-							// Выполняем расчёт веса n-граммы
-							item.second.weight = probFn(&item.second);
-							// Если отладка включена
-							if(debug){
-								// Выводим статистику в сообщении
-								this->alphabet->log(
-									"FOUND %s WEIGHT %4.8f => %4.8f",
-									alphabet_t::log_t::info,
-									this->logfile,
-									this->context(&item.second).c_str(),
-									weight,
-									item.second.weight
-								);
-							}
-							// Если есть еще данные, углубляемся
-							if(!item.second.empty()) runFn(&item.second, &it->second, size + 1, mode);
-						// Выполняем расчёт веса n-граммы
-						} else {
-							// Устанавливаем новое значение частоты
-							item.second.weight = probFn(&item.second);
-							// Если отладка включена
-							if(debug){
-								// Выводим статистику в сообщении
-								this->alphabet->log(
-									"NOT FOUND %s WEIGHT %4.8f => %4.8f",
-									alphabet_t::log_t::info,
-									this->logfile,
-									this->context(&item.second).c_str(),
-									weight,
-									item.second.weight
-								);
-							}
-						}
-					}
-					// Если функция вывода статуса передана
-					if((status != nullptr) && (size == 0)){
-						// Считаем количество обработанных данных
-						index++;
-						// Выполняем расчёт текущего статуса
-						actual = u_short(index / double(count) * 100.0);
-						// Если статус обновился
-						if(actual != past){
-							// Запоминаем текущий статус
-							past = actual;
-							// Выводим статус извлечения
-							status(actual);
-						}
-					}
-				}
-			// Если это второй этап интерполяции
-			} else {
-				// Переходим по всему списку n-грамм
-				for(auto & item : * lm2){
-					// Ещем нашу n-грамму в другой языковой модели
-					auto it = lm1->find(item.first);
-					// Если идентификатор найден
-					if(it != lm1->end()){
-						// Если еще есть данные, углубляемся
-						if(!item.second.empty()) runFn(&it->second, &item.second, size + 1, mode);
-					// Если идентификатор не найден
-					} else {
-						// Добавляем слово в словарь
-						auto ret = lm1->emplace(item.first, data_t());
-						// Запоминаем родительский объект
-						ret.first->second.father = lm1;
-						// Запоминаем идентификатор слова
-						ret.first->second.idw = item.first;
-						// Добавляем в список регистр слова
-						ret.first->second.uppers = item.second.uppers;
-						// Устанавливаем вес n-граммы
-						ret.first->second.weight = (isnormal(item.second.weight) ? probFn(&ret.first->second) : item.second.weight);
-						// Если отладка включена
-						if(debug){
-							// Выводим статистику в сообщении
-							this->alphabet->log(
-								"NEW %s WEIGHT %4.8f",
-								alphabet_t::log_t::info,
-								this->logfile,
-								this->context(&ret.first->second).c_str(),
-								ret.first->second.weight
-							);
-						}
-						// Если еще есть данные, углубляемся
-						if(!item.second.empty()) runFn(&ret.first->second, &item.second, size + 1, mode);
-					}
-					// Если функция вывода статуса передана
-					if((status != nullptr) && (size == 0)){
-						// Считаем количество обработанных данных
-						index++;
-						// Выполняем расчёт текущего статуса
-						actual = u_short(index / double(count) * 100.0);
-						// Если статус обновился
-						if(actual != past){
-							// Запоминаем текущий статус
-							past = actual;
-							// Выводим статус извлечения
-							status(actual);
-						}
-					}
-				}
+void anyks::Arpa::mix(const vector <const Arpa *> & lms, const vector <double> & lambdas, const bool bayes, const size_t length, const double scale, function <void (const u_short)> status) noexcept {
+	/**
+	 * Item Структура n-граммы объединённого дерева
+	 */
+	typedef struct Item {
+		// Идентификатор слова
+		size_t idw;
+		// Индекс контекста на предыдущем уровне
+		size_t father;
+		// Новый вес n-граммы
+		double weight;
+	} item_t;
+	/**
+	 * Level Структура одного порядка объединённого дерева
+	 */
+	typedef struct Level {
+		// Список n-грамм порядка
+		vector <item_t> items;
+		// Узлы n-грамм во всех моделях (по одному на модель, nullptr если в модели n-граммы нет)
+		vector <const data_t *> nodes;
+	} level_t;
+	/**
+	 * Scratch Структура рабочих буферов потока
+	 */
+	typedef struct Scratch {
+		// Последовательность текущей n-граммы
+		vector <size_t> seq;
+		// Частоты и веса языковых моделей
+		vector <double> probs, weights;
+		// Узлы суффиксов контекста во всех моделях
+		vector <const data_t *> suffixes;
+		// Текущие позиции обхода контекстов всех моделей
+		vector <pair <data_t::const_iterator, data_t::const_iterator>> iters;
+	} scratch_t;
+	// Текущий и предыдущий статус
+	u_short actual = 0, past = 100, maxGram = 1;
+	// Список всех моделей, текущая модель идёт первой
+	vector <const Arpa *> models = {this};
+	// Добавляем остальные модели
+	models.insert(models.end(), lms.begin(), lms.end());
+	// Получаем количество языковых моделей
+	const size_t count = models.size();
+	// Получаем максимальный размер n-граммы
+	for(auto & lm : models) maxGram = max(maxGram, lm->size);
+	// Проверяем включён ли режим отладки
+	const bool debug = this->isOption(options_t::debug);
+	// Уровни объединённого дерева, нулевой уровень - корень
+	vector <level_t> levels(1);
+	// Добавляем корень дерева
+	levels.front().items.push_back({0, 0, 0.0});
+	// Добавляем корни всех моделей
+	for(auto & lm : models) levels.front().nodes.push_back(&lm->data);
+	/**
+	 * weightFn Функция получения веса n-граммы с откатом к более коротким контекстам
+	 * @param suffixes узлы суффиксов контекста модели
+	 * @param gram     размер n-граммы
+	 * @param idw      идентификатор последнего слова n-граммы
+	 * @param start    количество отбрасываемых первых слов контекста
+	 * @param init     значение по умолчанию, если n-грамма не найдена
+	 * @return         вес n-граммы
+	 */
+	auto weightFn = [this](const data_t * const * suffixes, const u_short gram, const size_t idw, const u_short start, const double init) noexcept {
+		// Если это неизвестное слово, тогда выходим
+		if(this->isUnk(idw)) return init;
+		// Переходим по всем суффиксам контекста, начиная с самого длинного
+		for(u_short i = start; i < gram; i++){
+			// Если суффикс в модели существует
+			if(suffixes[i] != nullptr){
+				// Ищем слово в суффиксе
+				auto it = suffixes[i]->find(idw);
+				// Если слово найдено, выводим его вес
+				if(it != suffixes[i]->end()) return it->second.weight;
 			}
-		};
-		// Выполняем расчёт количества итераций
-		for(auto & lm : lms) count += (this->data.size() + lm->data.size());
-		// Переходим по всем языковым моделям
-		for(auto & lm : lms){
-			// Запускаем первый этап интерполяции
-			runFn(&this->data, &lm->data, 0, true);
-			// Запускаем второй этап интерполяции
-			runFn(&this->data, &lm->data, 0, false);
 		}
-		// Выполняем перерасчёт обратных частот
-		this->repair();
-	}
-}
-/**
- * mixBayes Метод интерполяции нескольких моделей алгоритмом Баеса
- * @param lms     список данных языковых моделей для объединения
- * @param lambdas список весов моделей при интерполяции
- * @param length  длина контекста для расчёта
- * @param scale   логарифмическая шкала вероятности
- * @param status  статус расчёта
- */
-void anyks::Arpa::mixBayes(const vector <const Arpa *> & lms, const vector <double> & lambdas, const size_t length, const double scale, function <void (const u_short)> status) noexcept {
-	// Если языковые модели загружены
-	if(!this->data.empty() && !lms.empty() && (lms.size() == (lambdas.size() - 1))){
-		// Индекс обхода всех языковых моделей
-		size_t index = 0, count = 0;
-		// Текущий и предыдущий статус
-		u_short actual = 0, past = 100;
-		// Проверяем включён ли режим отладки
-		const bool debug = this->isOption(options_t::debug);
-		/**
-		 * seqFn Функция получения последовательности
-		 * @param ngram контекст для получения последовательности
-		 * @return      полученный список последовательности
-		 */
-		auto seqFn = [](const data_t * ngram) noexcept {
-			// Последовательность для поиска
-			vector <size_t> result;
-			// Получаем текущее значение первого контекста
-			const data_t * context = ngram;
-			// Извлекаем предшествующую n-грамму
-			while(context->father != nullptr){
-				// Добавляем слово в последовательность
-				result.insert(result.begin(), context->idw);
-				// Выполняем смещение
-				context = context->father;
-			}
-			// Выводим результат
-			return result;
-		};
-		/**
-		 * Прототип функции получения частоты для контекста
-		 * @param список последовательности для обработки
-		 * @param языковая модель из которой нужно получить частоту
-		 * @param размер n-граммы для поиска
-		 * @param флаг предписывающий уменьшить длину n-граммы
-		 * @return обратная частота отката
-		 */
-		function <const double (const vector <size_t> &, const Arpa *, const bool)> weightFn;
-		/**
-		 * weightFn Функция получения частоты для контекста
-		 * @param seq  список последовательности для обработки
-		 * @param lm   языковая модель из которой нужно получить частоту
-		 * @param back флаг предписывающий уменьшить длину n-граммы
-		 * @return     обратная частота отката
-		 */
-		weightFn = [&weightFn, this](const vector <size_t> & seq, const Arpa * lm, const bool back) noexcept {
-			// Результат работы функции
-			double result = this->zero;
-			// Если это неизвестное слово, тогда выходим
-			if(this->isUnk(seq.back())) return result;
-			// Если размер запрашиваемых n-грамм больше 0
-			if(((seq.size() > 1) && back) || (!back && !seq.empty())){
-				// Получаем объект для поиска
-				const data_t * obj = &lm->data;
-				// Формируем последовательность для поиска
-				vector <size_t> tmp(seq.begin() + u_short(back), seq.end());
-				// Переходим по всему списку n-грамм
-				for(auto & idw : tmp){
-					// Ещем нашу n-грамму в другой языковой модели
-					auto it = obj->find(idw);
-					// Если n-гамма найдена
-					if(it != obj->end()){
-						// Запоминаем объект
-						obj = &it->second;
-						// Запоминаем вес последовательности
-						result = obj->weight;
-					// Если мы дошли до конца
-					} else {
-						// Продолжаем поиск дальше
-						result = weightFn(tmp, lm, true);
-						// Выходим из цикла
-						break;
-					}
-				}
-			}
-			// Выводим результат
-			return result;
-		};
-		/**
-		 * sumFn Функция подсчёта суммы весов n-граммы
-		 * @param lm   данные языковой модели
-		 * @param gram значение текущей n-граммы
-		 * @param seq  список последовательности
-		 * @return     подсчитанная сумма весов
-		 */
-		auto sumFn = [this](const Arpa * lm, const u_short gram, const vector <size_t> & seq) noexcept {
-			// Результат работы функции
-			double result = 0.0;
-			// Если последовательность получена
-			if(!seq.empty() && !lm->empty()){
-				// Получаем объект для поиска
-				const data_t * obj = &lm->data;
-				// Переходим по всему списку n-грамм
-				for(auto & idw : seq){
-					// Ещем нашу n-грамму в другой языковой модели
-					auto it = obj->find(idw);
-					// Если n-гамма найдена
-					if(it != obj->end()){
-						// Запоминаем объект
-						obj = &it->second;
-						// Запоминаем результат
-						if((obj->weight != this->zero) && !this->isStart(idw) &&
-						((gram > 1) || !this->isUnk(idw) || !this->isOption(options_t::resetUnk))) result += obj->weight;
-						/**
-						 * Если мы вычисляем предельную вероятность контекста униграммы <s>,
-						 * мы должны искать </s> вместо неё, поскольку у начала предложения вес = 0.
-						 */
-						if(this->isStart(idw)) result += lm->data[(size_t) token_t::finish].weight;
+		// Выводим результат
+		return init;
+	};
+	/**
+	 * sumFn Функция подсчёта суммы весов n-граммы
+	 * @param lm   данные языковой модели
+	 * @param gram значение текущей n-граммы
+	 * @param seq  список последовательности
+	 * @return     подсчитанная сумма весов
+	 */
+	auto sumFn = [this](const Arpa * lm, const u_short gram, const vector <size_t> & seq) noexcept {
+		// Результат работы функции
+		double result = 0.0;
+		// Если последовательность получена
+		if(!seq.empty() && !lm->empty()){
+			// Получаем объект для поиска
+			const data_t * obj = &lm->data;
+			// Переходим по всему списку n-грамм
+			for(auto & idw : seq){
+				// Ещем нашу n-грамму в другой языковой модели
+				auto it = obj->find(idw);
+				// Если n-гамма найдена
+				if(it != obj->end()){
+					// Запоминаем объект
+					obj = &it->second;
+					// Запоминаем результат
+					if((obj->weight != this->zero) && !this->isStart(idw) &&
+					((gram > 1) || !this->isUnk(idw) || !this->isOption(options_t::resetUnk))) result += obj->weight;
+					/**
+					 * Если мы вычисляем предельную вероятность контекста униграммы <s>,
+					 * мы должны искать </s> вместо неё, поскольку у начала предложения вес = 0.
+					 */
+					if(this->isStart(idw)){
+						// Ищем конец предложения
+						auto jt = lm->data.find((size_t) token_t::finish);
+						// Добавляем вес конца предложения
+						result += (jt != lm->data.end() ? jt->second.weight : this->zero);
 					}
 				}
 			}
-			// Выводим результат
-			return result;
-		};
-		/**
-		 * probFn Функция расчёта веса n-граммы
-		 * @param ngram контекст для получения последовательности
-		 * @return      результат расчёта
-		 */
-		auto probFn = [&](const data_t * ngram) noexcept {
-			// Результат работы функции
-			double result = this->zero;
-			// Если идентификатор передан
-			if((ngram->idw > 0) && (ngram->idw < idw_t::NIDW)){
-				// Получаем данные языковой модели
-				const Arpa * lm = this;
+		}
+		// Выводим результат
+		return result;
+	};
+	/**
+	 * probFn Функция расчёта веса n-граммы
+	 * @param scratch рабочие буферы потока
+	 * @param gram    размер n-граммы
+	 * @param sum     нормализующая сумма контекста (для логарифмическо-линейной интерполяции)
+	 * @return        результат расчёта
+	 */
+	auto probFn = [&](scratch_t & scratch, const u_short gram, const double sum) noexcept {
+		// Результат работы функции
+		double result = this->zero;
+		// Получаем идентификатор слова
+		const size_t idw = scratch.seq.back();
+		// Если идентификатор передан
+		if((idw > 0) && (idw < idw_t::NIDW)){
+			// Если это интерполяция алгоритмом Баеса
+			if(bayes){
 				// Общее значение всех весов
 				double totalProb = 0.0;
 				// Сумма всех весов языковых моделей
 				double lmWeightSum = 0.0;
 				// Флаг всех нулевых весов
 				bool allZeroWeights = true;
-				// Получаем количество языковых моделей
-				const size_t count = (lms.size() + 1);
-				// Получаем список последовательности
-				vector <size_t> tmp = seqFn(ngram);
-				// Создаём список частот языковых моделей
-				vector <double> lmProbs(count);
-				// Создаём список весов языковых моделей
-				vector <double> lmWeights(count);
-				// Переходим по всем остальным языковым моделям
+				// Переходим по всем языковым моделям
 				for(size_t i = 0; i < count; i++){
-					// Если это не нулевая n-грамма
-					if(i > 0) lm = lms[i - 1];
 					// Выполняем расчёт веса для текущей последовательности
-					lmProbs[i] = pow(10, weightFn(tmp, lm, false));
+					scratch.probs[i] = pow(10, weightFn(&scratch.suffixes[i * gram], gram, idw, 0, this->zero));
 					// Получаем уже расчитанный ранее вес
-					lmWeights[i] = lambdas[i];
+					scratch.weights[i] = lambdas[i];
 					// Выполняем расчёт весов языковой модели
-					if(scale > 0.0) lmWeights[i] *= pow(10, scale * sumFn(lm, length, tmp));
+					if(scale > 0.0) scratch.weights[i] *= pow(10, scale * sumFn(models[i], length, scratch.seq));
 					// Если веса не нулевые, сбрасываем флаг всех нулевых весов
-					if(lmWeights[i] != 0.0) allZeroWeights = false;
+					if(scratch.weights[i] != 0.0) allZeroWeights = false;
 					// Увеличиваем сумму всех весов языковых моделей
-					lmWeightSum += lmWeights[i];
+					lmWeightSum += scratch.weights[i];
 				}
 				/*
 				 * Если ни одна из языковых моделей не знает контекст, возвращаемся обратно
@@ -4158,209 +4522,351 @@ void anyks::Arpa::mixBayes(const vector <const Arpa *> & lms, const vector <doub
 				if(allZeroWeights){
 					// Сбрасываем сумму всех весов языковых моделей
 					lmWeightSum = 0.0;
-					// Переходим по всем остальным языковым моделям
+					// Переходим по всем языковым моделям
 					for(size_t i = 0; i < count; i++){
 						// Получаем уже расчитанный ранее вес
-						lmWeights[i] = lambdas[i];
+						scratch.weights[i] = lambdas[i];
 						// Увеличиваем сумму всех весов языковых моделей
-						lmWeightSum += lmWeights[i];
+						lmWeightSum += scratch.weights[i];
 					}
 				}
-				// Если отладка включена
-				if(debug){
-					// Сообщение отладки
-					string message = "";
-					// Если длина контекста для расчёта не нулевая
-					if(length > 0){
-						// Формируем сообщение отладки
-						message = "[post=";
-						// Добавляем расчёт первоначального веса
-						message.append(to_string(lmWeights[0] / lmWeightSum));
-						// Выполняем вывод остальных весов
-						for(size_t i = 1; i < count; i++){
-							// Добавляем разделитель
-							message.append(",");
-							// Добавляем значение следующего веса
-							message.append(to_string(lmWeights[i] / lmWeightSum));
-						}
-						// Закрываем сообщение
-						message.append("]");
-						// Выводим сообщение отладки
-						this->alphabet->log("%s", alphabet_t::log_t::info, this->logfile, message.c_str());
-						// Очищаем сообщение
-						message.clear();
-					}
-					// Формируем сообщение отладки
-					message = "[probs=";
-					// Добавляем вес текущей последовательности
-					message.append(to_string(lmProbs[0]));
-					// Выполняем вывод остальных весов
-					for(size_t i = 1; i < count; i++){
-						// Добавляем разделитель
-						message.append(",");
-						// Добавляем вес текущей последовательности
-						message.append(to_string(lmProbs[i]));
-					}
-					// Закрываем сообщение
-					message.append("]");
-					// Выводим сообщение отладки
-					this->alphabet->log("%s", alphabet_t::log_t::info, this->logfile, message.c_str());
-				}
 				// Выполняем расчёт общего количества весов
-				for(size_t i = 0; i < count; i++) totalProb += (lmWeights[i] * lmProbs[i]);
+				for(size_t i = 0; i < count; i++) totalProb += (scratch.weights[i] * scratch.probs[i]);
 				// Выполняем расчёт финального веса
 				result = log10(totalProb / lmWeightSum);
+			// Если это логарифмическо-линейная интерполяция
+			} else {
+				// Сумма всех весов последовательности
+				double numerator = 0.0;
+				// Переходим по всем языковым моделям
+				for(size_t i = 0; i < count; i++){
+					// Выполняем расчёт нумератора
+					numerator += (lambdas[i] * weightFn(&scratch.suffixes[i * gram], gram, idw, 0, 0.0));
+					// Если нумератор больше считать нельзя, выходим
+					if(numerator == this->zero) break;
+				}
+				// Выводим результат
+				result = (numerator - log10(sum));
+				// Если результат не получен, скидываем
+				if(!isnormal(result)) result = this->zero;
 			}
-			// Выводим результат
-			return result;
-		};
-		/**
-		 * runFn Функция запуска статической интерполяции
-		 * @param контекст первой языковой модели (куда будут добавлены новые n-граммы)
-		 * @param контекст второй языковой модели (откуда будут добавлены новые n-граммы)
-		 * @param размер n-граммы для обработки
-		 * @param тип этапа интерполяции
-		 */
-		function <void (data_t *, const data_t *, const u_short, const bool)> runFn;
-		/**
-		 * runFn Функция запуска статической интерполяции
-		 * @param lm1  контекст первой языковой модели (куда будут добавлены новые n-граммы)
-		 * @param lm2  контекст второй языковой модели (откуда будут добавлены новые n-граммы)
-		 * @param size размер n-граммы для обработки
-		 * @param mode тип этапа интерполяции
-		 */
-		runFn = [&](data_t * lm1, const data_t * lm2, const u_short size, const bool mode) noexcept {
-			// Если это первый этап интерполяции
-			if(mode){
-				// Значение регистров слова n-граммы
-				size_t uppers = 0;
-				// Текущее значение частоты
-				double weight = 0.0;
-				// Переходим по всему списку n-грамм
-				for(auto & item : * lm1){
-					// Если слово имеет нормальный вес
-					if(isnormal(item.second.weight)){
-						// Запоминаем текущее значение частоты
-						weight = item.second.weight;
-						// Ещем нашу n-грамму в другой языковой модели
-						auto it = lm2->find(item.first);
-						// Если n-гамма найдена
-						if(it != lm2->end()){
-							// Если регистры слова переданы, считаем их
-							if((uppers = (!it->second.uppers.empty() ? it->second.uppers.begin()->first : 0)) > 0){
-								// Если такого регистра еще нет в списке
-								if(item.second.uppers.count(uppers) == 0)
-									// Добавляем в список регистр слова
-									item.second.uppers.emplace(uppers, 1);
-								// Иначе увеличиваем существующий регистр слова
-								else item.second.uppers[uppers]++;
-							}
-							// Выполняем расчёт веса n-граммы
-							item.second.weight = probFn(&item.second);
-							// Если отладка включена
-							if(debug){
-								// Выводим статистику в сообщении
-								this->alphabet->log(
-									"FOUND %s WEIGHT %4.8f => %4.8f",
-									alphabet_t::log_t::info,
-									this->logfile,
-									this->context(&item.second).c_str(),
-									weight,
-									item.second.weight
-								);
-							}
-							// Если есть еще данные, углубляемся
-							if(!item.second.empty()) runFn(&item.second, &it->second, size + 1, mode);
-						// Выполняем расчёт веса n-граммы
-						} else {
-							// Устанавливаем новое значение частоты
-							item.second.weight = probFn(&item.second);
-							// Если отладка включена
-							if(debug){
-								// Выводим статистику в сообщении
-								this->alphabet->log(
-									"NOT FOUND %s WEIGHT %4.8f => %4.8f",
-									alphabet_t::log_t::info,
-									this->logfile,
-									this->context(&item.second).c_str(),
-									weight,
-									item.second.weight
-								);
-							}
-						}
+		}
+		// Выводим результат
+		return result;
+	};
+	/**
+	 * contextFn Функция расчёта n-грамм одного контекста объединённого дерева
+	 * @param scratch рабочие буферы потока
+	 * @param gram    размер рассчитываемых n-грамм
+	 * @param index   индекс контекста на предыдущем уровне
+	 * @param result  уровень в который добавляются n-граммы контекста
+	 */
+	auto contextFn = [&](scratch_t & scratch, const u_short gram, const size_t index, level_t & result) noexcept {
+		// Получаем узлы контекста во всех моделях
+		const data_t * const * contexts = &levels[gram - 1].nodes[index * count];
+		// Флаг наличия n-грамм в контексте
+		bool children = false;
+		// Переходим по всем моделям и запоминаем начало обхода контекста
+		for(size_t i = 0; i < count; i++){
+			// Если контекст в модели существует
+			if(contexts[i] != nullptr){
+				// Запоминаем позиции обхода
+				scratch.iters[i] = make_pair(contexts[i]->begin(), contexts[i]->end());
+				// Запоминаем что в контексте есть n-граммы
+				if(!contexts[i]->empty()) children = true;
+			// Иначе устанавливаем пустой обход
+			} else scratch.iters[i] = make_pair(data_t::const_iterator(), data_t::const_iterator());
+		}
+		// Если n-грамм в контексте нет, выходим
+		if(!children) return;
+		// Выделяем память для последовательности
+		scratch.seq.resize(gram);
+		// Восстанавливаем последовательность контекста по уровням дерева
+		for(size_t i = gram - 1, j = index; i > 0; i--){
+			// Добавляем слово контекста
+			scratch.seq[i - 1] = levels[i].items[j].idw;
+			// Переходим к родительскому контексту
+			j = levels[i].items[j].father;
+		}
+		// Выделяем память для суффиксов контекста
+		scratch.suffixes.assign(count * gram, nullptr);
+		// Переходим по всем моделям
+		for(size_t i = 0; i < count; i++){
+			// Полный контекст уже найден при обходе
+			scratch.suffixes[i * gram] = contexts[i];
+			// Переходим по всем более коротким суффиксам контекста
+			for(u_short j = 1; j < gram; j++){
+				// Получаем корень модели
+				const data_t * obj = &models[i]->data;
+				// Спускаемся по словам суффикса
+				for(u_short k = j; (k < (gram - 1)) && (obj != nullptr); k++){
+					// Ищем слово суффикса
+					auto it = obj->find(scratch.seq[k]);
+					// Запоминаем найденный узел
+					obj = (it != obj->end() ? &it->second : nullptr);
+				}
+				// Запоминаем суффикс
+				scratch.suffixes[i * gram + j] = obj;
+			}
+		}
+		// Нормализующая сумма контекста
+		double sum = 0.0;
+		// Если это логарифмическо-линейная интерполяция, рассчитываем сумму по всем словам словаря
+		if(!bayes){
+			// Переходим по всем словам словаря
+			for(auto & item : this->data){
+				// Пересчитываем число, если оно нормальное
+				if(isnormal(item.second.weight)){
+					// Сумма полученных весов
+					double probSum = 0.0;
+					// Переходим по всем языковым моделям
+					for(size_t i = 0; i < count; i++) probSum += (lambdas[i] * weightFn(&scratch.suffixes[i * gram], gram, item.first, 0, 0.0));
+					// Выполняем расчёт суммы всех весов
+					sum += pow(10, probSum);
+				}
+			}
+		}
+		// Выполняем слияние n-грамм контекста всех моделей в порядке идентификаторов
+		while(true){
+			// Минимальный идентификатор слова
+			size_t idw = idw_t::NIDW;
+			// Флаг наличия следующей n-граммы
+			bool found = false;
+			// Ищем минимальный идентификатор среди всех моделей
+			for(size_t i = 0; i < count; i++){
+				// Если обход модели не завершён
+				if(scratch.iters[i].first != scratch.iters[i].second){
+					// Если идентификатор меньше найденного
+					if(!found || (scratch.iters[i].first->first < idw)){
+						// Запоминаем идентификатор
+						idw = scratch.iters[i].first->first;
+						// Запоминаем что n-грамма найдена
+						found = true;
 					}
-					// Если функция вывода статуса передана
-					if((status != nullptr) && (size == 0)){
-						// Считаем количество обработанных данных
-						index++;
-						// Выполняем расчёт текущего статуса
-						actual = u_short(index / double(count) * 100.0);
-						// Если статус обновился
-						if(actual != past){
-							// Запоминаем текущий статус
-							past = actual;
-							// Выводим статус извлечения
-							status(actual);
-						}
+				}
+			}
+			// Если n-грамм больше нет, выходим
+			if(!found) break;
+			// Запоминаем последнее слово n-граммы
+			scratch.seq.back() = idw;
+			// Узел n-граммы с которого берётся исходный вес
+			const data_t * source = nullptr;
+			// Переходим по всем моделям
+			for(size_t i = 0; i < count; i++){
+				// Если n-грамма есть в модели
+				if((scratch.iters[i].first != scratch.iters[i].second) && (scratch.iters[i].first->first == idw)){
+					// Добавляем узел n-граммы
+					result.nodes.push_back(&scratch.iters[i].first->second);
+					// Исходный вес берётся из первой модели, содержащей n-грамму
+					if(source == nullptr) source = &scratch.iters[i].first->second;
+					// Смещаем позицию обхода
+					scratch.iters[i].first++;
+				// Иначе n-граммы в модели нет
+				} else result.nodes.push_back(nullptr);
+			}
+			// Пересчитываем вес только для n-грамм с нормальным весом
+			result.items.push_back({idw, index, (isnormal(source->weight) ? probFn(scratch, gram, sum) : source->weight)});
+		}
+	};
+	// Переходим по всем порядкам объединённого дерева
+	for(u_short gram = 1; !levels.back().items.empty(); gram++){
+		// Получаем количество контекстов предыдущего порядка
+		const size_t contexts = levels.back().items.size();
+		// Количество контекстов обрабатываемых одним блоком
+		const size_t block = 0x400;
+		// Количество блоков обрабатываемых за один проход
+		const size_t window = (max(this->threads, size_t(1)) * 4);
+		// Уровень текущего порядка
+		level_t level;
+		// Результаты блоков одного прохода
+		vector <level_t> blocks(window);
+		// Выполняем инициализацию тредпула
+		this->tpool.init(this->threads);
+		// Переходим по всем контекстам проходами
+		for(size_t first = 0; first < contexts; first += (block * window)){
+			// Получаем количество блоков прохода
+			const size_t size = min(window, (contexts - first + block - 1) / block);
+			// Выполняем расчёт блоков параллельно
+			this->tpool.parallel_for(0, size, [&](const size_t begin, const size_t end){
+				// Рабочие буферы потока
+				scratch_t scratch;
+				// Выделяем память для буферов моделей
+				scratch.iters.resize(count);
+				// Выделяем память для частот моделей
+				scratch.probs.resize(count);
+				// Выделяем память для весов моделей
+				scratch.weights.resize(count);
+				// Переходим по всем блокам
+				for(size_t i = begin; i < end; i++){
+					// Очищаем список n-грамм блока
+					blocks[i].items.clear();
+					// Очищаем список узлов блока
+					blocks[i].nodes.clear();
+					// Переходим по всем контекстам блока
+					for(size_t j = (first + i * block); j < min(first + (i + 1) * block, contexts); j++){
+						// Выполняем расчёт n-грамм контекста
+						contextFn(scratch, gram, j, blocks[i]);
 					}
 				}
-			// Если это второй этап интерполяции
+			}, 1);
+			// Добавляем результаты блоков в порядке обхода
+			for(size_t i = 0; i < size; i++){
+				// Добавляем n-граммы блока
+				level.items.insert(level.items.end(), blocks[i].items.begin(), blocks[i].items.end());
+				// Добавляем узлы n-грамм блока
+				level.nodes.insert(level.nodes.end(), blocks[i].nodes.begin(), blocks[i].nodes.end());
+			}
+			// Если функция вывода статуса передана
+			if(status != nullptr){
+				// Выполняем расчёт текущего статуса
+				actual = u_short(min(((gram - 1) + min(first + block * window, contexts) / double(contexts)) / maxGram * 100.0, 100.0));
+				// Если статус обновился
+				if(actual != past){
+					// Запоминаем текущий статус
+					past = actual;
+					// Выводим статус извлечения
+					status(actual);
+				}
+			}
+		}
+		// Ожидаем завершения обработки
+		this->tpool.wait();
+		// Добавляем уровень текущего порядка
+		levels.push_back(std::move(level));
+	}
+	// Контексты предыдущего и текущего порядка в текущей модели
+	vector <data_t *> fathers = {&this->data}, contexts;
+	// Переходим по всем порядкам объединённого дерева
+	for(size_t gram = 1; gram < levels.size(); gram++){
+		// Получаем уровень текущего порядка
+		const level_t & level = levels[gram];
+		// Выделяем память для контекстов текущего порядка
+		contexts.resize(level.items.size());
+		// Переходим по всем n-граммам порядка
+		for(size_t i = 0; i < level.items.size(); i++){
+			// Получаем n-грамму объединённого дерева
+			const item_t & item = level.items[i];
+			// Получаем узлы n-граммы во всех моделях
+			const data_t * const * nodes = &level.nodes[i * count];
+			// Получаем контекст n-граммы в текущей модели
+			data_t * context = fathers[item.father];
+			// Индекс модели, начиная с которой добавляются регистры слова
+			size_t from = count;
+			// Ищем n-грамму в текущей модели
+			auto it = context->find(item.idw);
+			// Если n-грамма в текущей модели есть
+			if(it != context->end()){
+				// Запоминаем контекст
+				contexts[i] = &it->second;
+				// Если вес n-граммы пересчитан
+				if(isnormal(contexts[i]->weight)){
+					// Если отладка включена
+					if(debug){
+						// Флаг наличия n-граммы в других моделях
+						bool found = false;
+						// Проверяем наличие n-граммы в других моделях
+						for(size_t j = 1; j < count; j++) found = (found || (nodes[j] != nullptr));
+						// Выводим статистику в сообщении
+						this->alphabet->log(
+							"%s %s WEIGHT %4.8f => %4.8f",
+							alphabet_t::log_t::info,
+							this->logfile,
+							(found ? "FOUND" : "NOT FOUND"),
+							this->context(contexts[i]).c_str(),
+							contexts[i]->weight,
+							item.weight
+						);
+					}
+					// Устанавливаем новый вес n-граммы
+					contexts[i]->weight = item.weight;
+					// Регистры добавляются из всех остальных моделей
+					from = 1;
+				}
+			// Если n-граммы в текущей модели нет
 			} else {
-				// Переходим по всему списку n-грамм
-				for(auto & item : * lm2){
-					// Ещем нашу n-грамму в другой языковой модели
-					auto it = lm1->find(item.first);
-					// Если идентификатор найден
-					if(it != lm1->end()){
-						// Если еще есть данные, углубляемся
-						if(!item.second.empty()) runFn(&it->second, &item.second, size + 1, mode);
-					// Если идентификатор не найден
-					} else {
-						// Добавляем слово в словарь
-						auto ret = lm1->emplace(item.first, data_t());
-						// Запоминаем родительский объект
-						ret.first->second.father = lm1;
-						// Запоминаем идентификатор слова
-						ret.first->second.idw = item.first;
+				// Индекс первой модели, содержащей n-грамму
+				size_t first = 1;
+				// Ищем первую модель, содержащую n-грамму
+				while(nodes[first] == nullptr) first++;
+				// Добавляем n-грамму в словарь
+				auto ret = context->emplace(item.idw, data_t());
+				// Запоминаем контекст
+				contexts[i] = &ret.first->second;
+				// Запоминаем родительский объект
+				contexts[i]->father = context;
+				// Запоминаем идентификатор слова
+				contexts[i]->idw = item.idw;
+				// Добавляем в список регистр слова
+				contexts[i]->uppers = nodes[first]->uppers;
+				// Устанавливаем вес n-граммы
+				contexts[i]->weight = item.weight;
+				// Если отладка включена
+				if(debug){
+					// Выводим статистику в сообщении
+					this->alphabet->log(
+						"NEW %s WEIGHT %4.8f",
+						alphabet_t::log_t::info,
+						this->logfile,
+						this->context(contexts[i]).c_str(),
+						contexts[i]->weight
+					);
+				}
+				// Регистры остальных моделей добавляются, если вес n-граммы нормальный
+				if(isnormal(item.weight)) from = (first + 1);
+			}
+			// Переходим по всем остальным моделям, содержащим n-грамму
+			for(size_t j = from; j < count; j++){
+				// Значение регистров слова n-граммы
+				const size_t uppers = ((nodes[j] != nullptr) && !nodes[j]->uppers.empty() ? nodes[j]->uppers.begin()->first : 0);
+				// Если регистры слова переданы, считаем их
+				if(uppers > 0){
+					// Если такого регистра еще нет в списке
+					if(contexts[i]->uppers.count(uppers) == 0)
 						// Добавляем в список регистр слова
-						ret.first->second.uppers = item.second.uppers;
-						// Устанавливаем вес n-граммы
-						ret.first->second.weight = (isnormal(item.second.weight) ? probFn(&ret.first->second) : item.second.weight);
-						// Если отладка включена
-						if(debug){
-							// Выводим статистику в сообщении
-							this->alphabet->log(
-								"NEW %s WEIGHT %4.8f",
-								alphabet_t::log_t::info,
-								this->logfile,
-								this->context(&ret.first->second).c_str(),
-								ret.first->second.weight
-							);
-						}
-						// Если еще есть данные, углубляемся
-						if(!item.second.empty()) runFn(&ret.first->second, &item.second, size + 1, mode);
-					}
-					// Если функция вывода статуса передана
-					if((status != nullptr) && (size == 0)){
-						// Считаем количество обработанных данных
-						index++;
-						// Выполняем расчёт текущего статуса
-						actual = u_short(index / double(count) * 100.0);
-						// Если статус обновился
-						if(actual != past){
-							// Запоминаем текущий статус
-							past = actual;
-							// Выводим статус извлечения
-							status(actual);
-						}
-					}
+						contexts[i]->uppers.emplace(uppers, 1);
+					// Иначе увеличиваем существующий регистр слова
+					else contexts[i]->uppers[uppers]++;
 				}
 			}
-		};
+		}
+		// Контексты текущего порядка становятся родительскими
+		fathers.swap(contexts);
+	}
+	// Если в текущей модели появились более длинные n-граммы, меняем размер
+	if((levels.size() - 2) > this->size) this->size = (levels.size() - 2);
+	// Очищаем загруженный ранее список кэша
+	this->ngrams.clear();
+	// Выполняем перерасчёт обратных частот
+	this->repair();
+}
+/**
+ * mixLoglinear Метод интерполяции нескольких моделей алгоритмом Баеса
+ * @param lms     список данных языковых моделей для объединения
+ * @param lambdas список весов моделей при интерполяции
+ * @param status  статус расчёта
+ */
+void anyks::Arpa::mixLoglinear(const vector <const Arpa *> & lms, const vector <double> & lambdas, function <void (const u_short)> status) noexcept {
+	// Если языковые модели загружены
+	if(!this->data.empty() && !lms.empty() && (lms.size() == (lambdas.size() - 1))){
+		// Выполняем интерполяцию объединённым обходом деревьев
+		this->mix(lms, lambdas, false, 0, 0.0, status);
+	}
+}
+/**
+ * mixBayes Метод интерполяции нескольких моделей алгоритмом Баеса
+ * @param lms     список данных языковых моделей для объединения
+ * @param lambdas список весов моделей при интерполяции
+ * @param length  длина контекста для расчёта
+ * @param scale   логарифмическая шкала вероятности
+ * @param status  статус расчёта
+ */
+void anyks::Arpa::mixBayes(const vector <const Arpa *> & lms, const vector <double> & lambdas, const size_t length, const double scale, function <void (const u_short)> status) noexcept {
+	// Если языковые модели загружены
+	if(!this->data.empty() && !lms.empty() && (lms.size() == (lambdas.size() - 1))){
 		// Сумма всех весов моделей
 		double priorSum = 0.0;
-		// Выполняем расчёт количества итераций
-		for(auto & lm : lms) count += (this->data.size() + lm->data.size());
+		// Проверяем включён ли режим отладки
+		const bool debug = this->isOption(options_t::debug);
 		// Проверяем все веса моделей для интерполяции
 		for(auto & lambda : lambdas){
 			// Если вес модели не верный, пересчитываем его
@@ -4375,15 +4881,8 @@ void anyks::Arpa::mixBayes(const vector <const Arpa *> & lms, const vector <doub
 		}
 		// Выполняем сглаживание всех весов языковых моделей
 		for(auto & lambda : lambdas) (* const_cast <double *> (&lambda)) /= priorSum;
-		// Переходим по всем языковым моделям
-		for(auto & lm : lms){
-			// Запускаем первый этап интерполяции
-			runFn(&this->data, &lm->data, 0, true);
-			// Запускаем второй этап интерполяции
-			runFn(&this->data, &lm->data, 0, false);
-		}
-		// Выполняем перерасчёт обратных частот
-		this->repair();
+		// Выполняем интерполяцию объединённым обходом деревьев
+		this->mix(lms, lambdas, true, length, scale, status);
 	}
 }
 /**
@@ -4433,8 +4932,8 @@ void anyks::GoodTuring::init() const noexcept {
 		// Запоминаем размер максимальной и минимальной встречаемости
 		this->minCountTuring[i + 1] = this->minCount[(((i + 1) > MAXSIZE) || this->isOption(options_t::allGrams) ? 0 : i + 1)];
 		this->maxCountTuring[i + 1] = this->maxCount[(((i + 1) > MAXSIZE) || this->isOption(options_t::allGrams) ? 0 : i + 1)];
-		// Добавляем первоначальное значение
-		this->discountCoeffs[i + 1].resize(this->maxCountTuring[i + 1], 1.0);
+		// Добавляем первоначальное значение, коэффициенты индексируются встречаемостью от 1 до максимальной включительно
+		this->discountCoeffs[i + 1].resize(this->maxCountTuring[i + 1] + 1, 1.0);
 	}
 }
 /**
@@ -4558,6 +5057,7 @@ const double anyks::GoodTuring::discount(const size_t count, const size_t total,
 	if(count <= 0) return 1.0;
 	else if(count < this->minCount[this->gram]) return 0.0;
 	else if(count > this->maxCount[this->gram]) return 1.0;
+	else if(count >= this->discountCoeffs[this->gram].size()) return 1.0;
 	else return this->discountCoeffs[this->gram][count];
 }
 /**
@@ -20,6 +20,8 @@ void anyks::Collector::start(){
 			this->tpool = new tpool_t;
 			// Выполняем инициализацию тредпула
 			this->tpool->init(this->threads);
+			// Создаём по одному шарду n-грамм на каждый поток
+			this->shards = vector <shard_t> (max(this->threads, size_t(1)));
 		// Если происходит ошибка то игнорируем её
 		} catch(const bad_alloc &) {
 			// Выводим сообщение об ошибке, если режим отладки включён
@@ -37,12 +39,109 @@ void anyks::Collector::finish(){
 	if(this->tpool != nullptr){
 		// Ожидаем завершения обработки
 		this->tpool->wait();
+		// Переносим n-граммы всех шардов в основной словарь, первые слова шардов не пересекаются
+		for(auto & shard : this->shards) this->toolkit->appendArpa(&shard.arpa);
+		// Удаляем шарды n-грамм
+		this->shards.clear();
 		// Удаляем выделенную память
 		delete this->tpool;
 		// Зануляем объект
 		this->tpool = nullptr;
 	}
 }
+/**
+ * merge Метод слияния собранных данных с основным словарём
+ * @param toolkit тулкит с собранными данными
+ * @param idd     идентификатор документа
+ */
+void anyks::Collector::merge(const toolkit_t & toolkit, const size_t idd) noexcept {
+	// Блокируем поток
+	this->locker.lock();
+	// Получаем данные статистики словаря
+	const auto & stat1 = toolkit.getStatistic();
+	// Получаем данные статистики основного словаря
+	const auto & stat2 = this->toolkit->getStatistic();
+	// Увеличиваем статистику основного словаря
+	this->toolkit->setStatistic(stat1.first + stat2.first, stat1.second + stat2.second);
+	// Считываем все слова словаря
+	toolkit.words([this](const word_t & word, const size_t idw, const size_t size){
+		// Добавляем слово в словарь
+		this->toolkit->addWord(word, idw);
+		// Разрешаем перебор остальных слов
+		return true;
+	});
+	// Разблокируем поток
+	this->locker.unlock();
+	// Переносим n-граммы в шарды
+	this->shard(toolkit, idd);
+}
+/**
+ * merge Метод слияния слов блоков одного документа с основным словарём
+ * @param parts слова блоков документа в порядке следования блоков
+ */
+void anyks::Collector::merge(const vector <part_t> & parts) noexcept {
+	// Слова всего документа
+	part_t document;
+	/**
+	 * Блоки складываются в порядке следования, поэтому форма слова берётся из первого блока,
+	 * а документ и слова учитываются так же, как если бы документ обучался одним блоком
+	 */
+	for(auto & part : parts){
+		// Документ учитывается один раз
+		document.ad = max(document.ad, part.ad);
+		// Увеличиваем количество слов документа
+		document.cw += part.cw;
+		// Переходим по всем словам блока
+		for(auto & item : part.words){
+			// Ищем слово среди слов документа
+			auto it = document.words.find(item.first);
+			// Если слова ещё нет, добавляем его
+			if(it == document.words.end()) document.words.emplace(item.first, item.second);
+			// Иначе увеличиваем встречаемость слова
+			else {
+				// Получаем метаданные слова документа
+				auto meta = it->second.getmeta();
+				// Получаем метаданные слова блока
+				const auto & wmta = item.second.getmeta();
+				// Увеличиваем встречаемость слова
+				meta.oc += wmta.oc;
+				// Слово встречалось в том же документе
+				meta.dc = max(meta.dc, wmta.dc);
+				// Устанавливаем полученные метаданные
+				it->second.setmeta(meta);
+			}
+		}
+	}
+	// Блокируем поток
+	const std::lock_guard <std::mutex> lock(this->locker);
+	// Получаем данные статистики основного словаря
+	const auto & stat = this->toolkit->getStatistic();
+	// Увеличиваем статистику основного словаря
+	this->toolkit->setStatistic(document.ad + stat.first, document.cw + stat.second);
+	// Добавляем все слова документа в словарь
+	for(auto & item : document.words) this->toolkit->addWord(item.second, item.first);
+}
+/**
+ * shard Метод переноса n-грамм собранных данных в шарды
+ * @param toolkit тулкит с собранными данными
+ * @param idd     идентификатор документа
+ */
+void anyks::Collector::shard(const toolkit_t & toolkit, const size_t idd) noexcept {
+	/**
+	 * Каждый поток начинает обход шардов со своего смещения,
+	 * поэтому потоки переносят n-граммы одновременно в разные шарды
+	 */
+	for(size_t i = 0; i < this->shards.size(); i++){
+		// Получаем номер шарда
+		const size_t index = ((idd + i) % this->shards.size());
+		// Получаем шард n-грамм
+		shard_t & shard = this->shards.at(index);
+		// Блокируем шард
+		const std::lock_guard <std::mutex> lock(shard.locker);
+		// Переносим n-граммы шарда без сериализации
+		toolkit.shardArpa(&shard.arpa, index, this->shards.size());
+	}
+}
 /**
  * dumpRaw Метод дампа промежуточных данных
  */
@@ -246,6 +345,47 @@ const long anyks::Collector::getSize(const string & str) const noexcept {
 	// Выводим результат
 	return size;
 }
+/**
+ * prepare Метод подготовки тулкита потока по параметрам основного тулкита
+ * @param toolkit тулкит для подготовки
+ */
+void anyks::Collector::prepare(toolkit_t & toolkit) const noexcept {
+	// Устанавливаем log файл
+	toolkit.setLogfile(this->logfile);
+	// Устанавливаем неизвестное слово
+	toolkit.setUnknown(this->toolkit->getUnknown());
+	// Устанавливаем опции тулкита
+	toolkit.setOptions(this->toolkit->getOptions());
+	// Устанавливаем скрипт препроцессинга слов
+	toolkit.setWordScript(this->toolkit->getWordScript());
+// Если работа идет не изнутри Python
+#ifndef NOPYTHON
+	// Устанавливаем внешний объект питона
+	if(!this->nopython) toolkit.setPythonObj(this->python);
+#endif
+	// Устанавливаем список токенов приводимых к <unk>
+	toolkit.setTokensUnknown(this->toolkit->getTokensUnknown());
+	// Устанавливаем список запрещённых токенов
+	toolkit.setTokensDisable(this->toolkit->getTokensDisable());
+	// Устанавливаем скрипт идентифицирования пользовательский токенов
+	toolkit.setUserTokenScript(this->toolkit->getUserTokenScript());
+	// Получаем пользовательские токены
+	const auto & tokens = this->toolkit->getUserTokens();
+	// Получаем список плохих слов
+	const auto & badwords = this->toolkit->getBadwords();
+	// Получаем список хороших слов
+	const auto & goodwords = this->toolkit->getGoodwords();
+	// Устанавливаем пользовательские токены
+	if(!tokens.empty()) for(auto & token : tokens) toolkit.setUserToken(token);
+	// Переходим по всему списку плохих слов и добавляем их
+	if(!badwords.empty()) for(auto & idw : badwords) toolkit.addBadword(idw);
+	// Переходим по всему списку хороших слов и добавляем их
+	if(!goodwords.empty()) for(auto & idw : goodwords) toolkit.addGoodword(idw);
+	// Получаем параметры туллкита
+	const auto params = this->toolkit->getParams();
+	// Выполняем инициализацию тулкита
+	toolkit.init((toolkit_t::algorithm_t) params.algorithm, params.modified, params.prepares, params.mod);
+}
 /**
  * train Обучения полученного текста
  * @param filename файл для чтения
@@ -255,71 +395,28 @@ void anyks::Collector::train(const string & filename, const size_t idd) noexcept
 	// Если текст передан
 	if(!filename.empty() && (this->tpool != nullptr)){
 		// Добавляем в тредпул новое задание на обработку
-		this->tpool->push([this](const string filename, const size_t idd){
+		this->tpool->post([this](const string filename, const size_t idd){
 			// Получаем копию объекта тулкита
 			toolkit_t toolkit(this->alphabet, this->tokenizer, this->order);
-			// Устанавливаем log файл
-			toolkit.setLogfile(this->logfile);
-			// Устанавливаем неизвестное слово
-			toolkit.setUnknown(this->toolkit->getUnknown());
-			// Устанавливаем опции тулкита
-			toolkit.setOptions(this->toolkit->getOptions());
-			// Устанавливаем скрипт препроцессинга слов
-			toolkit.setWordScript(this->toolkit->getWordScript());
-// Если работа идет не изнутри Python
-#ifndef NOPYTHON
-			// Устанавливаем внешний объект питона
-			if(!this->nopython) toolkit.setPythonObj(this->python);
-#endif
-			// Устанавливаем список токенов приводимых к <unk>
-			toolkit.setTokensUnknown(this->toolkit->getTokensUnknown());
-			// Устанавливаем список запрещённых токенов
-			toolkit.setTokensDisable(this->toolkit->getTokensDisable());
-			// Устанавливаем скрипт идентифицирования пользовательский токенов
-			toolkit.setUserTokenScript(this->toolkit->getUserTokenScript());
-			// Получаем пользовательские токены
-			const auto & tokens = this->toolkit->getUserTokens();
-			// Получаем список плохих слов
-			const auto & badwords = this->toolkit->getBadwords();
-			// Получаем список хороших слов
-			const auto & goodwords = this->toolkit->getGoodwords();
-			// Устанавливаем пользовательские токены
-			if(!tokens.empty()) for(auto & token : tokens) toolkit.setUserToken(token);
-			// Переходим по всему списку плохих слов и добавляем их
-			if(!badwords.empty()) for(auto & idw : badwords) toolkit.addBadword(idw);
-			// Переходим по всему списку хороших слов и добавляем их
-			if(!goodwords.empty()) for(auto & idw : goodwords) toolkit.addGoodword(idw);
-			// Получаем параметры туллкита
-			const auto params = this->toolkit->getParams();
-			// Выполняем инициализацию тулкита
-			toolkit.init((toolkit_t::algorithm_t) params.algorithm, params.modified, params.prepares, params.mod);
-			// Выполняем считывание всех строк текста
-			fsys_t::rfile2(filename, [&](const string & str, const uintmax_t fileSize) noexcept {
-				// Добавляем полученную строку текста
-				if(!str.empty()) toolkit.addText(str, idd);
-			});
-			// Блокируем поток
-			this->locker.lock();
-			// Получаем данные статистики словаря
-			const auto & stat1 = toolkit.getStatistic();
-			// Получаем данные статистики основного словаря
-			const auto & stat2 = this->toolkit->getStatistic();
-			// Увеличиваем статистику основного словаря
-			this->toolkit->setStatistic(stat1.first + stat2.first, stat1.second + stat2.second);
-			// Считываем все слова словаря
-			toolkit.words([this](const word_t & word, const size_t idw, const size_t size){
-				// Добавляем слово в словарь
-				this->toolkit->addWord(word, idw);
-				// Разрешаем перебор остальных слов
-				return true;
-			});
-			// Извлекаем n-граммы
-			toolkit.saveArpa([idd, this](const vector <char> & buffer, const u_short status){
-				// Загружаем данные n-граммы
-				this->toolkit->appendArpa(buffer, idd);
+			// Выполняем подготовку тулкита
+			this->prepare(toolkit);
+			// Буфер строки, переиспользуемый для всех строк файла
+			string text = "";
+			// Выполняем отображение файла в памяти целиком
+			fsys_t::rchunks(filename, 0, [&](const vector <std::string_view> & chunks, const uintmax_t fileSize) noexcept {
+				// Переходим по всем блокам файла
+				for(auto & chunk : chunks){
+					// Переходим по всем строкам блока
+					fsys_t::lines(chunk, [&](const std::string_view & line){
+						// Копируем строку в буфер
+						text.assign(line.data(), line.size());
+						// Добавляем полученную строку текста
+						toolkit.addText(text, idd);
+					});
+				}
 			});
-			// Разблокируем поток
-			this->locker.unlock();
+			// Выполняем слияние собранных данных с основным словарём
+			this->merge(toolkit, idd);
 			// Если отладка включена, выводим индикатор загрузки
 			if(this->debug > 0){
 				// Общий полученный размер данных
@@ -351,115 +448,125 @@ void anyks::Collector::train(const string & filename, const size_t idd) noexcept
 	}
 }
 /**
- * train Обучения полученного текста
- * @param texts список строк текста для обучения
- * @param idd   идентификатор документа
+ * cut Метод разбивки текста на сегменты по накопленной длине строк
+ * @param text     текст для разбивки
+ * @param size     накопленная длина строк текущего сегмента (переходит между файлами)
+ * @param callback функция обратного вызова (позиция начала строки, с которой начинается новый сегмент)
+ *
+ * Длина строк считается так же, как их выдаёт fsys_t::rfile: без переноса строки и возврата каретки,
+ * пустая строка считается за один байт. Строка, на которой сегмент набрал нужный размер, начинает
+ * следующий сегмент, а её длина в накопленный размер не входит.
  */
-void anyks::Collector::train(const vector <string> & texts, const size_t idd) noexcept {
-	// Если тексты переданы
-	if(!texts.empty() && (this->tpool != nullptr)){
-		// Добавляем в тредпул новое задание на обработку
-		this->tpool->push([this](const vector <string> texts, const size_t idd){
-			// Получаем копию объекта тулкита
-			toolkit_t toolkit(this->alphabet, this->tokenizer, this->order);
-			// Устанавливаем log файл
-			toolkit.setLogfile(this->logfile);
-			// Устанавливаем неизвестное слово
-			toolkit.setUnknown(this->toolkit->getUnknown());
-			// Устанавливаем опции тулкита
-			toolkit.setOptions(this->toolkit->getOptions());
-			// Устанавливаем скрипт препроцессинга слов
-			toolkit.setWordScript(this->toolkit->getWordScript());
-// Если работа идет не изнутри Python
-#ifndef NOPYTHON
-			// Устанавливаем внешний объект питона
-			if(!this->nopython) toolkit.setPythonObj(this->python);
-#endif
-			// Устанавливаем список токенов приводимых к <unk>
-			toolkit.setTokensUnknown(this->toolkit->getTokensUnknown());
-			// Устанавливаем список запрещённых токенов
-			toolkit.setTokensDisable(this->toolkit->getTokensDisable());
-			// Устанавливаем скрипт идентифицирования пользовательский токенов
-			toolkit.setUserTokenScript(this->toolkit->getUserTokenScript());
-			// Получаем пользовательские токены
-			const auto & tokens = this->toolkit->getUserTokens();
-			// Получаем список плохих слов
-			const auto & badwords = this->toolkit->getBadwords();
-			// Получаем список хороших слов
-			const auto & goodwords = this->toolkit->getGoodwords();
-			// Устанавливаем пользовательские токены
-			if(!tokens.empty()) for(auto & token : tokens) toolkit.setUserToken(token);
-			// Переходим по всему списку плохих слов и добавляем их
-			if(!badwords.empty()) for(auto & idw : badwords) toolkit.addBadword(idw);
-			// Переходим по всему списку хороших слов и добавляем их
-			if(!goodwords.empty()) for(auto & idw : goodwords) toolkit.addGoodword(idw);
-			// Получаем параметры туллкита
-			const auto params = this->toolkit->getParams();
-			// Выполняем инициализацию тулкита
-			toolkit.init((toolkit_t::algorithm_t) params.algorithm, params.modified, params.prepares, params.mod);
-			// Сегодня в мире - две остановки
-			// Переходим по всему списку строк текста
-			for(auto & text : texts){
-				// Если текст не пустой
-				if(!text.empty()){
-					// Добавляем полученную строку текста
-					toolkit.addText(text, idd);
-					// Если отладка включена, выводим индикатор загрузки
-					if(this->debug > 0){
-						// Общий полученный размер данных
-						this->allSize.store(this->allSize + text.size(), std::memory_order_relaxed);
-						// Подсчитываем статус выполнения
-						this->status = u_short(this->allSize / double(this->dataSize) * 100.0);
-						// Если процентное соотношение изменилось
-						if(this->rate != this->status){
-							// Запоминаем текущее процентное соотношение
-							this->rate.store(this->status, std::memory_order_relaxed);
-							// Блокируем поток
-							this->locker.lock();
-							// Если внешний прогресс-бар отключен
-							if(this->progressFn == nullptr){
-								// Отображаем ход процесса
-								switch(this->debug){
-									case 1: this->pss.update(this->status); break;
-									case 2: this->pss.status(this->status); break;
-								}
-							// Выводим сообщение во внешний прогресс-бар
-							} else this->progressFn(L"Read text corpora", this->status);
-							// Разблокируем поток
-							this->locker.unlock();
+void anyks::Collector::cut(const std::string_view & text, uintmax_t & size, function <void (const size_t)> callback) const noexcept {
+	// Если текст передан
+	if(!text.empty()){
+		// Значение текущей и предыдущей буквы
+		char letter = 0, old = 0;
+		// Смещение в тексте и длина полученной строки
+		size_t offset = 0, length = 0;
+		// Переходим по всему тексту
+		for(size_t i = 0; i < text.size(); i++){
+			// Получаем значение текущей буквы
+			letter = text[i];
+			// Если текущая буква является переносом строк
+			if((i > 0) && ((letter == '\n') || (i == (text.size() - 1)))){
+				// Если предыдущая буква была возвратом каретки, уменьшаем длину строки
+				length = ((old == '\r' ? i - 1 : i) - offset);
+				// Если это конец файла, корректируем размер последнего байта
+				if(length == 0) length = 1;
+				// Формируем блок собранных данных
+				size += length;
+				// Если собранных данных достаточно, начинаем новый сегмент с текущей строки
+				if(size >= this->segmentSize){
+					// Очищаем размер собранных данных
+					size = 0;
+					// Сообщаем позицию начала нового сегмента
+					callback(offset);
+				}
+				// Выполняем смещение
+				offset = (i + 1);
+			}
+			// Запоминаем предыдущую букву
+			old = letter;
+		}
+		// Если текст состоит из одного символа, он является одной строкой
+		if(offset == 0){
+			// Формируем блок собранных данных
+			size += text.size();
+			// Если собранных данных достаточно, начинаем новый сегмент с текущей строки
+			if(size >= this->segmentSize){
+				// Очищаем размер собранных данных
+				size = 0;
+				// Сообщаем позицию начала нового сегмента
+				callback(0);
+			}
+		}
+	}
+}
+/**
+ * learn Метод обучения блока текста в текущем потоке
+ * @param text блок текста для обучения (строки разделены переносом строки)
+ * @param idd  идентификатор документа
+ */
+void anyks::Collector::learn(const std::string_view & text, const size_t idd, part_t * part) noexcept {
+	// Если текст передан
+	if(!text.empty()){
+		// Получаем копию объекта тулкита
+		toolkit_t toolkit(this->alphabet, this->tokenizer, this->order);
+		// Выполняем подготовку тулкита
+		this->prepare(toolkit);
+		// Буфер строки, переиспользуемый для всех строк блока
+		string buffer = "";
+		// Переходим по всем строкам блока
+		fsys_t::lines(text, [&](const std::string_view & line){
+			// Копируем строку в буфер
+			buffer.assign(line.data(), line.size());
+			// Добавляем полученную строку текста
+			toolkit.addText(buffer, idd);
+			// Если отладка включена, выводим индикатор загрузки
+			if(this->debug > 0){
+				// Общий полученный размер данных
+				this->allSize.store(this->allSize + line.size(), std::memory_order_relaxed);
+				// Подсчитываем статус выполнения
+				this->status = u_short(this->allSize / double(this->dataSize) * 100.0);
+				// Если процентное соотношение изменилось
+				if(this->rate != this->status){
+					// Запоминаем текущее процентное соотношение
+					this->rate.store(this->status, std::memory_order_relaxed);
+					// Блокируем поток
+					this->locker.lock();
+					// Если внешний прогресс-бар отключен
+					if(this->progressFn == nullptr){
+						// Отображаем ход процесса
+						switch(this->debug){
+							case 1: this->pss.update(this->status); break;
+							case 2: this->pss.status(this->status); break;
 						}
-					}
+					// Выводим сообщение во внешний прогресс-бар
+					} else this->progressFn(L"Read text corpora", this->status);
+					// Разблокируем поток
+					this->locker.unlock();
 				}
 			}
-			// Блокируем поток
-			this->locker.lock();
-			// Получаем данные статистики словаря
-			const auto & stat1 = toolkit.getStatistic();
-			// Получаем данные статистики основного словаря
-			const auto & stat2 = this->toolkit->getStatistic();
-			// Увеличиваем статистику основного словаря
-			this->toolkit->setStatistic(stat1.first + stat2.first, stat1.second + stat2.second);
-			// Считываем все слова словаря
-			toolkit.words([this](const word_t & word, const size_t idw, const size_t size){
-				// Добавляем слово в словарь
-				this->toolkit->addWord(word, idw);
+		});
+		// Если документ разбит на блоки
+		if(part != nullptr){
+			// Получаем данные статистики блока
+			const auto & stat = toolkit.getStatistic();
+			// Запоминаем статистику блока
+			part->ad = stat.first;
+			part->cw = stat.second;
+			// Запоминаем слова блока, они сливаются с основным словарём после обучения всех блоков документа
+			toolkit.words([part](const word_t & word, const size_t idw, const size_t size){
+				// Добавляем слово блока
+				if(!word.empty()) part->words.emplace(idw, word);
 				// Разрешаем перебор остальных слов
 				return true;
 			});
-			// Извлекаем n-граммы
-			toolkit.saveArpa([idd, this](const vector <char> & buffer, const u_short status){
-				// Загружаем данные n-граммы
-				this->toolkit->appendArpa(buffer, idd);
-			});
-			// Разблокируем поток
-			this->locker.unlock();
-		}, texts, idd);
-		// Получаем объект текста
-		vector <string> * obj = const_cast <vector <string> *> (&texts);
-		// Очищаем список текстов
-		obj->clear();
-		// Очищаем выделенную память
-		vector <string> ().swap(* obj);
+			// Переносим n-граммы в шарды
+			this->shard(toolkit, idd);
+		// Выполняем слияние собранных данных с основным словарём
+		} else this->merge(toolkit, idd);
 	}
 }
 /**
@@ -583,12 +690,6 @@ void anyks::Collector::readFile(const string & filename) noexcept {
 		this->dataSize = fsys_t::fsize(filename);
 		// Если размер файла получен
 		if(this->dataSize > 0){
-			// Количество файлов
-			size_t count = 0;
-			// Размер собранных данных
-			uintmax_t size = 0;
-			// Список текстов для обработки
-			vector <string> texts;
 			// Если отладка включена, выводим индикатор загрузки
 			if((this->debug > 0) && (this->progressFn == nullptr)){
 				// Сбрасываем общий размер собранных данных
@@ -607,41 +708,46 @@ void anyks::Collector::readFile(const string & filename) noexcept {
 			}
 			// Создаём тредпул
 			this->start();
-			// Если нужно произвести сегментацию файла
-			if(this->segments && (this->dataSize > this->segmentSize)){
-				// Если размер сегмента нулевой
-				if(this->segmentSize == 0) this->segmentSize = ceil(this->dataSize / double(this->threads));
-				// Выполняем считывание всех строк текста
-				fsys_t::rfile(filename, [&count, &size, &texts, this](const string & text, const uintmax_t fileSize) noexcept {
-					// Если текст получен
-					if(!text.empty()){
-						// Формируем блок собранных данных
-						size += text.size();
-						// Если собранных данных достаточно, добавляем данные в поток
-						if(size >= this->segmentSize){
-							// Очищаем размер собранных данных
-							size = 0;
-							// Выполняем обучение полученного текста
-							this->train(texts, count);
-							// Увеличиваем количество файлов
-							count++;
-						}
-						// Добавляем в список текстов полученный текст
-						texts.push_back(text);
-					}
-				});
-				// Выполняем обучение полученного текста
-				this->train(texts, count);
-			// Если сегментация файла не нужна
-			} else {
-				// Выполняем считывание всех строк текста
-				fsys_t::rfile(filename, [&texts](const string & text, const uintmax_t fileSize) noexcept {
-					// Если текст получен
-					if(!text.empty()) texts.push_back(text);
-				});
-				// Выполняем обучение полученного текста
-				this->train(texts, 0);
-			}
+			// Определяем нужно ли произвести сегментацию файла
+			const bool segments = (this->segments && (this->dataSize > this->segmentSize));
+			// Если размер сегмента нулевой
+			if(segments && (this->segmentSize == 0)) this->segmentSize = ceil(this->dataSize / double(this->threads));
+			// Размер блока, без сегментации файл делится поровну между потоками, сегменты нарезаются целиком
+			const uintmax_t chunk = (segments ? 0 : ceil(this->dataSize / double(this->threads)));
+			// Выполняем отображение файла в памяти и разбивку его на блоки по границам строк
+			fsys_t::rchunks(filename, chunk, [segments, this](const vector <std::string_view> & chunks, const uintmax_t fileSize) noexcept {
+				// Список сегментов файла
+				vector <std::string_view> texts;
+				// Если нужно произвести сегментацию файла
+				if(segments){
+					// Размер собранных данных
+					uintmax_t size = 0;
+					// Начало текущего сегмента
+					size_t start = 0;
+					// Получаем текст файла
+					const std::string_view & text = chunks.front();
+					// Выполняем разбивку текста на сегменты
+					this->cut(text, size, [&](const size_t pos){
+						// Добавляем собранный сегмент, пустой сегмент тоже занимает идентификатор документа
+						texts.push_back(text.substr(start, pos - start));
+						// Запоминаем начало нового сегмента
+						start = pos;
+					});
+					// Добавляем последний сегмент
+					texts.push_back(text.substr(start));
+				}
+				// Получаем список блоков для обучения
+				const vector <std::string_view> & blocks = (segments ? texts : chunks);
+				// Слова блоков, без сегментации весь файл является одним документом, разбитым на блоки
+				vector <part_t> parts(segments ? 0 : blocks.size());
+				// Обучаем блоки параллельно, отображение файла живёт до завершения обработки
+				this->tpool->parallel_for(0, blocks.size(), [&](const size_t first, const size_t last){
+					// Каждый сегмент считается отдельным документом
+					for(size_t i = first; i < last; i++) this->learn(blocks[i], (segments ? i : 0), (segments ? nullptr : &parts.at(i)));
+				}, 1);
+				// Сливаем слова всех блоков файла как одного документа
+				if(!segments) this->merge(parts);
+			});
 			// Завершаем работу тредпула
 			this->finish();
 			// Если внешний прогресс-бар отключен
@@ -690,36 +796,54 @@ void anyks::Collector::readDir(const string & path, const string & ext) noexcept
 		if(this->segments && (this->dataSize > this->segmentSize)){
 			// Размер собранных данных
 			uintmax_t size = 0;
-			// Список текстов для обработки
-			vector <string> texts;
+			// Строки незавершённого сегмента, сегмент может продолжаться в следующем файле
+			string tail = "";
 			// Если размер сегмента нулевой
 			if(this->segmentSize == 0) this->segmentSize = ceil(this->dataSize / double(this->threads));
 			// Переходим по всему списку файлов в каталоге
-			fsys_t::rdir(path, ext, [&count, &size, &texts, this](const string & filename, const uintmax_t dirSize) noexcept {
+			fsys_t::rdir(path, ext, [&count, &size, &tail, this](const string & filename, const uintmax_t dirSize) noexcept {
 				// Устанавливаем название файла
 				if(this->progressFn == nullptr) this->pss.description(filename);
-				// Выполняем считывание всех строк текста
-				fsys_t::rfile2(filename, [&count, &size, &texts, this](const string & text, const uintmax_t fileSize) noexcept {
-					// Если текст получен
-					if(!text.empty()){
-						// Формируем блок собранных данных
-						size += text.size();
-						// Если собранных данных достаточно, добавляем данные в поток
-						if(size >= this->segmentSize){
-							// Очищаем размер собранных данных
-							size = 0;
-							// Выполняем обучение полученного текста
-							this->train(texts, count);
-							// Увеличиваем количество файлов
-							count++;
-						}
-						// Добавляем в список текстов полученный текст
-						texts.push_back(text);
-					}
+				// Выполняем отображение файла в памяти целиком
+				fsys_t::rchunks(filename, 0, [&count, &size, &tail, this](const vector <std::string_view> & chunks, const uintmax_t fileSize) noexcept {
+					// Начало текущего сегмента
+					size_t start = 0;
+					// Первый сегмент файла, собранный вместе с незавершённым сегментом прошлых файлов
+					string head = "";
+					// Список сегментов файла
+					vector <std::string_view> texts;
+					// Получаем текст файла
+					const std::string_view & text = chunks.front();
+					// Выполняем разбивку текста на сегменты
+					this->cut(text, size, [&](const size_t pos){
+						// Если это первый сегмент файла, дополняем им незавершённый сегмент
+						if(texts.empty()){
+							// Формируем первый сегмент
+							head = (tail + string(text.data(), pos));
+							// Очищаем незавершённый сегмент
+							tail.clear();
+							// Добавляем первый сегмент
+							texts.push_back(head);
+						// Добавляем собранный сегмент, пустой сегмент тоже занимает идентификатор документа
+						} else texts.push_back(text.substr(start, pos - start));
+						// Запоминаем начало нового сегмента
+						start = pos;
+					});
+					// Обучаем сегменты параллельно, отображение файла живёт до завершения обработки
+					this->tpool->parallel_for(0, texts.size(), [&](const size_t first, const size_t last){
+						// Каждый сегмент считается отдельным документом
+						for(size_t i = first; i < last; i++) this->learn(texts[i], count + i);
+					}, 1);
+					// Увеличиваем количество сегментов
+					count += texts.size();
+					// Запоминаем строки незавершённого сегмента
+					tail.append(text.data() + start, text.size() - start);
+					// Отделяем строки следующего файла переносом строки
+					if(!tail.empty() && (tail.back() != '\n')) tail.append(1, '\n');
 				});
 			});
-			// Выполняем обучение полученного текста
-			this->train(texts, count);
+			// Обучаем последний сегмент
+			this->learn(tail, count);
 		// Если сегментация файла не нужна
 		} else {
 			// Получаем размер файла
@@ -628,6 +628,14 @@ void anyks::Toolkit::setLogfile(const char * logfile) noexcept {
 	// Устанавливаем адрес log файла
 	this->logfile = logfile;
 }
+/**
+ * setThreads Метод установки количества потоков
+ * @param threads количество потоков для работы
+ */
+void anyks::Toolkit::setThreads(const size_t threads) noexcept {
+	// Устанавливаем новое количество потоков
+	this->threads = (threads > 0 ? threads : std::thread::hardware_concurrency());
+}
 /**
  * setUserToken Метод добавления токена пользователя
  * @param name слово - обозначение токена
@@ -1303,6 +1311,8 @@ void anyks::Toolkit::sweep(function <void (const u_short)> status) noexcept {
  * @param status функция вывода статуса обучения
  */
 void anyks::Toolkit::train(function <void (const u_short)> status) noexcept {
+	// Устанавливаем количество потоков обучения
+	this->arpa->setThreads(this->threads);
 	// Выполняем обучение arpa
 	this->arpa->train(status);
 }
@@ -1587,9 +1597,52 @@ void anyks::Toolkit::modify(const string & filename, modify_t flag, function <vo
  * @param status    функция вывода статуса обучения
  */
 void anyks::Toolkit::prune(const double threshold, const u_short mingram, function <void (const u_short)> status) const noexcept {
+	// Устанавливаем количество потоков прунинга
+	this->arpa->setThreads(this->threads);
 	// Выполняем прунинг arpa
 	this->arpa->prune(threshold, mingram, status);
 }
+/**
+ * pruneTo Метод прунинга языковой модели до заданного количества n-грамм или размера
+ * @param count   максимальное количество n-грамм (0 - не ограничено)
+ * @param size    максимальный размер бинарного контейнера в байтах, вместе со словарём и метаданными (0 - не ограничен)
+ * @param mingram значение минимальной n-граммы за которую нельзя прунить
+ * @param status  функция вывода статуса обучения
+ * @return        подобранный порог прунинга (0 - прунинг не потребовался или ограничения недостижимы)
+ *
+ * Словарь и метаданные прунингом не уменьшаются, поэтому их размер вычитается из ограничения как постоянная часть.
+ */
+const double anyks::Toolkit::pruneTo(const size_t count, const uintmax_t size, const u_short mingram, function <void (const u_short)> status) const noexcept {
+	// Размер записей arpa в бинарном контейнере
+	uintmax_t bytes = 0;
+	// Если размер контейнера ограничен
+	if(size > 0){
+		// Размер постоянной части контейнера: заголовок, метаданные и информационные данные словаря
+		uintmax_t floor = (BINHEADER + sizeof(this->info) + arpa_t::BINRECORD);
+		// Каждое слово словаря сохраняется отдельной записью
+		this->saveVocab([&floor](const vector <char> & buffer, const u_short){
+			// Увеличиваем размер постоянной части
+			floor += (buffer.size() + arpa_t::BINRECORD);
+		});
+		// Если постоянная часть не укладывается в ограничение, модель не урезаем
+		if(floor >= size){
+			// Выводим сообщение об ошибке
+			this->alphabet->log("the size limit %ju bytes is less than the vocabulary and metadata size %ju bytes, the model is not pruned", alphabet_t::log_t::error, this->logfile, size, floor);
+			// Выводим статус завершения
+			if(status != nullptr) status(100);
+			// Выходим
+			return 0.0;
+		}
+		// Если отладка включена, выводим размер постоянной части
+		if(this->isOption(options_t::debug)) this->alphabet->log("vocabulary and metadata size: %ju bytes", alphabet_t::log_t::info, this->logfile, floor);
+		// Запоминаем размер доступный для записей arpa
+		bytes = (size - floor);
+	}
+	// Устанавливаем количество потоков прунинга
+	this->arpa->setThreads(this->threads);
+	// Выполняем прунинг arpa до заданных ограничений
+	return this->arpa->pruneTo(count, bytes, mingram, status);
+}
 /**
  * pruneVocab Метод прунинга словаря
  * @param wltf   пороговый вес слова для прунинга
@@ -2097,6 +2150,8 @@ void anyks::Toolkit::mix(const vector <string> & filenames, const vector <double
 					}
 				}
 			}
+			// Устанавливаем количество потоков для интерполяции
+			this->arpa->setThreads(this->threads);
 			// Если нужно выполнить интерполяцию методом Баеса
 			if(length > 0){
 				// Выполняем интерполяцию алгоритмом Баеса
@@ -2180,6 +2235,24 @@ void anyks::Toolkit::appendArpa(const vector <char> & buffer, const size_t idd)
 	// Выполняем добавление бинарных данных
 	this->arpa->addBin(buffer, idd);
 }
+/**
+ * appendArpa Метод переноса n-грамм из объекта arpa в словарь
+ * @param arpa объект arpa из которого переносятся n-граммы
+ */
+void anyks::Toolkit::appendArpa(const arpa_t * arpa) const noexcept {
+	// Выполняем перенос n-грамм
+	this->arpa->merge(arpa);
+}
+/**
+ * shardArpa Метод переноса n-грамм шарда из словаря в объект arpa
+ * @param arpa   объект arpa шарда
+ * @param shard  номер шарда первого слова n-граммы
+ * @param shards общее количество шардов
+ */
+void anyks::Toolkit::shardArpa(const arpa_t * arpa, const size_t shard, const size_t shards) const noexcept {
+	// Если объект arpa передан, переносим в него n-граммы шарда
+	if(arpa != nullptr) arpa->merge(this->arpa, shard, shards);
+}
 /**
  * saveInfoVocab Метод сохранения бинарных информационных данных словаря
  * @param buffer буфер бинарных информационных данных словаря
@@ -2223,63 +2296,74 @@ void anyks::Toolkit::saveVocab(function <void (const vector <char> &, const u_sh
 	}
 }
 /**
- * writeArpa Метод записи данных в файл arpa
+ * writeArpa Метод записи данных в файл arpa (если адрес оканчивается на .gz, файл сжимается gzip)
  * @param filename адрес файла для записи
  * @param status   функция вывода статуса записи
  */
 void anyks::Toolkit::writeArpa(const string & filename, function <void (const u_short)> status) const noexcept {
 	// Если адрес файла передан
 	if(!filename.empty()){
-		// Открываем файл на запись
-		ofstream file(filename, ios::binary);
+		// Файл для записи
+		ofstream file;
+		// Сжатый файл для записи
+		gzFile gzfile = nullptr;
+		// Определяем нужно ли сжимать файл
+		const bool gzip = ((filename.size() > 3) && (filename.compare(filename.size() - 3, 3, ".gz") == 0));
+		// Если файл нужно сжимать, открываем сжатый файл на запись
+		if(gzip){
+			// Открываем сжатый файл
+			if((gzfile = gzopen(filename.c_str(), "wb")) != nullptr) gzbuffer(gzfile, 0x100000);
+		// Иначе открываем обычный файл
+		} else file.open(filename, ios::binary);
 		// Если файл открыт
-		if(file.is_open()){
+		if(gzip ? (gzfile != nullptr) : file.is_open()){
 			// Данные данных для записи
 			string data = "";
 			// Текущий и предыдущий статус
 			u_short actual = 0, past = 100;
 			// Количество n-грамм и количество всех n-грамм
 			size_t count = 0, counts = 0, index = 0;
+			/**
+			 * writeFn Функция записи данных в файл
+			 * @param buffer данные для записи
+			 */
+			auto writeFn = [&](const string & buffer) noexcept {
+				// Если файл сжимается, записываем сжатые данные
+				if(gzip) gzwrite(gzfile, buffer.data(), buffer.size());
+				// Иначе записываем данные как есть
+				else file.write(buffer.data(), buffer.size());
+			};
+			// Устанавливаем количество потоков форматирования
+			this->arpa->setThreads(this->threads);
 			// Получаем штамп файла
-			const string & stamp = this->arpa->stamp();
-			// Выполняем запись штампа в файл
-			file.write(stamp.data(), stamp.size());
+			data = this->arpa->stamp();
 			// Формируем начало документа
-			data = "\\data\\\n";
-			// Выполняем запись данных в файл
-			file.write(data.data(), data.size());
+			data.append("\\data\\\n");
 			// Переходим по всей длине n-граммы
 			for(u_short i = 1; i <= this->size; i++){
 				// Получаем количество n-грамм
 				count = this->arpa->count(i);
 				// Формируем количество n-грамм
-				data = this->alphabet->format("ngram %u=%u\n", i, count);
-				// Выполняем запись данных в файл
-				file.write(data.data(), data.size());
+				data.append(this->alphabet->format("ngram %u=%u\n", i, count));
 				// Увеличиваем количество всех n-грамм
 				counts += count;
 			}
+			// Выполняем запись заголовка в файл
+			writeFn(data);
 			// Если количество элементов больше 0
 			if(counts > 0){
 				// Переходим по всей длине n-граммы
 				for(u_short i = 1; i <= this->size; i++){
-					// Получаем количество n-грамм
-					data = this->alphabet->format("\n\\%u-grams:\n", i);
-					// Выполняем запись данных в файл
-					file.write(data.data(), data.size());
-					// Выполняем извлечение данных n-граммы
-					this->arpa->arpa(i, [&](const string & ngram){
-						// Если строка получена
-						if(!ngram.empty()){
-							// Формируем тело n-граммы
-							data = this->alphabet->format("%s\n", ngram.c_str());
-							// Выполняем запись данных в файл
-							file.write(data.data(), data.size());
-						}
+					// Выполняем запись заголовка n-граммы в файл
+					writeFn(this->alphabet->format("\n\\%u-grams:\n", i));
+					// Выполняем извлечение данных n-граммы блоками
+					this->arpa->arpaBlocks(i, [&](const string & buffer, const size_t count){
+						// Выполняем запись блока в файл
+						writeFn(buffer);
 						// Если функция вывода статуса передана
 						if(status != nullptr){
 							// Увеличиваем количество записанных n-грамм
-							index++;
+							index += count;
 							// Выполняем расчёт текущего статуса
 							actual = u_short(index / double(counts) * 100.0);
 							// Если статус обновился
@@ -2293,12 +2377,12 @@ void anyks::Toolkit::writeArpa(const string & filename, function <void (const u_
 					});
 				}
 			}
-			// Формируем конец документа
-			data = "\n\\end\\\n";
-			// Выполняем запись данных в файл
-			file.write(data.data(), data.size());
+			// Выполняем запись конца документа
+			writeFn("\n\\end\\\n");
+			// Закрываем сжатый файл
+			if(gzip) gzclose(gzfile);
 			// Закрываем файл
-			file.close();
+			else file.close();
 		// Выводим сообщение об ошибке
 		} else this->alphabet->log("arpa file: %s is broken", alphabet_t::log_t::error, this->logfile, filename.c_str());
 	// Выводим сообщение об ошибке
@@ -2629,124 +2713,205 @@ void anyks::Toolkit::words(function <const bool (const wstring &, const size_t,
 void anyks::Toolkit::readArpa(const string & filename, function <void (const u_short)> status) noexcept {
 	// Если адрес файла передан
 	if(!filename.empty() && fsys_t::isfile(filename)){
-		// Тип извлечения данных
-		u_short type = 0;
+		/**
+		 * Ngram Структура прочитанной n-граммы
+		 */
+		typedef struct Ngram {
+			// Вес и частота отката n-граммы
+			double weight, backoff;
+			// Границы последовательности n-граммы в списке блока
+			size_t begin, end;
+			// Идентификатор последнего слова
+			size_t idw;
+			// Последнее слово n-граммы для добавления в словарь
+			wstring word;
+		} ngram_t;
+		/**
+		 * Chunk Структура разобранного блока файла
+		 */
+		typedef struct Chunk {
+			// Размер блока в байтах
+			size_t size = 0;
+			// Список n-грамм блока
+			vector <ngram_t> ngrams;
+			// Последовательности всех n-грамм блока
+			vector <pair_t> seqs;
+		} chunk_t;
 		// Последовательность для добавления
 		vector <pair_t> seq;
-		// Список полученных слов последовательности
-		vector <wstring> words;
 		// Текущий и предыдущий статус
 		u_short actual = 0, past = 100;
 		// Количество обработанных данных
-		size_t index = 0, pos = 0, loc = 0;
+		size_t index = 0;
 		// Идентификатор неизвестного слова
 		const size_t uid = (size_t) token_t::unk;
-		// Выполняем считывание всех строк текста
-		fsys_t::rfile(filename, [&](const string & text, const uintmax_t fileSize) noexcept {
-			// Если слово получено
-			if(!text.empty()){
-				// Определяем тип считываемых данных
-				switch(type){
-					// Если получено обозначение заголовка
-					case 0: if(text.find("\\data\\") != string::npos) type++; break;
-					// Если мы дошли до считывания данных слов
-					case 1: if(text.rfind("-grams:") != string::npos) type++; break;
-					// Если это тип считывания данных n-грамм
-					case 2: {
-						// Если мы дошли до конца, выходим
-						if(text.find("\\end\\") != string::npos) break;
-						// Иначе считываем данные n-граммы
-						else if((pos = text.find("\t")) != string::npos){
-							// Обнуляем локальную позицию
-							loc = 0;
-							// Данные n-граммы и обратной частоты документа
-							string ngram = "", backoff = "0.0";
-							// Считываем частоту n-граммы
-							const string & weight = this->alphabet->trim(text.substr(loc, pos));
-							// Запоминаем текущую позицию
-							loc = pos;
-							// Ищем значение n-граммы
-							if((pos = text.find("\t", pos + 1)) != string::npos){
-								// Извлекаем данные n-граммы
-								ngram = this->alphabet->trim(text.substr(loc + 1, pos - (loc + 1)));
-								// Излвлекаем обратную частоту документа
-								backoff = this->alphabet->trim(text.substr(pos + 1, text.length() - (pos + 1)));
-							// Извлекаем данные n-граммы
-							} else ngram = this->alphabet->trim(text.substr(loc + 1, text.length() - (loc + 1)));
-							// Если данные получены
-							if(!ngram.empty() && !weight.empty()){
-								// Очищаем последовательность
-								seq.clear();
-								// Выполняем сплит n-грамм
-								this->alphabet->split(ngram, " ", words);
-								// Если список слов получен
-								if(!words.empty()){
-									// Идентификатор слова
-									size_t idw = 0;
-									// Полученное слово
-									word_t word = L"";
-									// Переходим по всему списку слов
-									for(auto & item : words){
-										// Получаем слово
-										word = move(item);
-										// Получаем идентификатор слова
-										idw = this->getIdw(word, !this->isOption(options_t::confidence));
-										// Проверяем отсутствует ли слово в списке запрещённых слов
-										if(this->badwords.count(idw) < 1){
-											// Если это неизвестное слово
-											if(uid == idw){
-												// Если неизвестное слово не установлено
-												if(this->unknown == 0) seq.emplace_back(idw, 0);
-												// Если неизвестное слово установлено
-												else if(this->unknown > 0) seq.emplace_back(this->unknown, this->vocab.at(this->unknown).getUppers());
-											// Добавляем слово в список последовательности
-											} else seq.emplace_back(idw, ((words.size() > 1) && (this->utokens.count(idw) > 0) ? 0 : word.getUppers()));
-										// Если слово найдено в всписке запрещённых
-										} else {
-											// Очищаем последовательность
-											seq.clear();
-											// Выходим из цикла
-											break;
-										}
-									}
-									// Если количество собранных n-грамм выше установленных, меняем
-									if(seq.size() > size_t(this->size)){
-										// Устанавливаем новый размер n-грамм
-										this->size = seq.size();
-										// Устанавливаем новый размер n-грамм для arpa
-										this->arpa->setSize(this->size);
-									}
-									// Добавляем последовательность в словарь
-									if(!seq.empty()){
-										// Проверяем отсутствует ли слово в списке запрещённых слов
-										if(!this->tokenizer->isToken(idw) && (this->badwords.count(idw) < 1)){
-											// Добавляем слово в словарь
-											this->addWord(word.wreal(), idw);
-										}
-										// Добавляем последовательность в языковую модель
-										this->arpa->set(seq, stod(weight), stod(backoff));
-									}
-								}
-							}
-						}
-					} break;
+		// Флаг проверки слов при получении идентификатора
+		const bool check = !this->isOption(options_t::confidence);
+		/**
+		 * trimFn Функция удаления пробелов по краям строки без копирования
+		 * @param text строка для обработки
+		 * @return     строка без пробелов по краям
+		 */
+		auto trimFn = [](std::string_view text) noexcept {
+			// Удаляем пробелы в начале строки
+			while(!text.empty() && isspace(text.front())) text.remove_prefix(1);
+			// Удаляем пробелы в конце строки
+			while(!text.empty() && isspace(text.back())) text.remove_suffix(1);
+			// Выводим результат
+			return text;
+		};
+		/**
+		 * parseFn Функция разбора строки n-граммы
+		 * @param line  строка для разбора
+		 * @param chunk блок в который добавляется n-грамма
+		 * @param word  слово, переиспользуемое для всех слов блока
+		 */
+		auto parseFn = [&](const std::string_view & line, chunk_t & chunk, word_t & word) noexcept {
+			// Получаем позицию разделителя веса
+			const size_t pos = line.find('\t');
+			// Если разделитель найден
+			if(pos != std::string_view::npos){
+				// Прочитанная n-грамма
+				ngram_t ngram;
+				// Данные n-граммы и частоты отката
+				std::string_view text = "", backoff = "";
+				// Считываем частоту n-граммы
+				const std::string_view weight = trimFn(line.substr(0, pos));
+				// Ищем значение частоты отката
+				const size_t loc = line.find('\t', pos + 1);
+				// Если частота отката найдена
+				if(loc != std::string_view::npos){
+					// Извлекаем данные n-граммы
+					text = trimFn(line.substr(pos + 1, loc - (pos + 1)));
+					// Излвлекаем обратную частоту документа
+					backoff = trimFn(line.substr(loc + 1));
+				// Извлекаем данные n-граммы
+				} else text = trimFn(line.substr(pos + 1));
+				// Если данные не получены или вес не является числом, пропускаем строку
+				if(text.empty() || weight.empty() || (std::from_chars(weight.data(), weight.data() + weight.size(), ngram.weight).ec != std::errc())) return;
+				// Если частота отката не получена, устанавливаем её нулевой
+				if(backoff.empty() || (std::from_chars(backoff.data(), backoff.data() + backoff.size(), ngram.backoff).ec != std::errc())) ngram.backoff = 0.0;
+				// Получаем текст n-граммы
+				const wstring & ngramText = this->alphabet->convert(string(text));
+				// Получаем количество слов в n-грамме
+				const size_t count = (std::count(ngramText.begin(), ngramText.end(), L' ') + 1);
+				// Запоминаем начало последовательности
+				ngram.begin = chunk.seqs.size();
+				// Идентификатор слова
+				size_t idw = 0;
+				// Переходим по всем словам n-граммы
+				for(size_t i = 0, j = 0; i <= ngramText.size(); i = (j + 1)){
+					// Ищем конец слова
+					if((j = ngramText.find(L' ', i)) == wstring::npos) j = ngramText.size();
+					// Если слово пустое, пропускаем его
+					if(j == i) continue;
+					// Получаем слово
+					word.assign(ngramText.data() + i, j - i);
+					// Получаем идентификатор слова
+					idw = this->getIdw(word, check);
+					// Если слово найдено в всписке запрещённых, пропускаем n-грамму
+					if(this->badwords.count(idw) > 0){
+						// Удаляем последовательность n-граммы
+						chunk.seqs.resize(ngram.begin);
+						// Выходим
+						return;
+					}
+					// Если это неизвестное слово
+					if(uid == idw){
+						// Если неизвестное слово не установлено
+						if(this->unknown == 0) chunk.seqs.emplace_back(idw, 0);
+						// Если неизвестное слово установлено
+						else if(this->unknown > 0) chunk.seqs.emplace_back(this->unknown, this->vocab.at(this->unknown).getUppers());
+					// Добавляем слово в список последовательности
+					} else chunk.seqs.emplace_back(idw, ((count > 1) && (this->utokens.count(idw) > 0) ? 0 : word.getUppers()));
 				}
+				// Запоминаем конец последовательности
+				ngram.end = chunk.seqs.size();
+				// Запоминаем идентификатор последнего слова
+				ngram.idw = idw;
+				// Если последнее слово не является токеном, запоминаем его для словаря
+				if(!this->tokenizer->isToken(idw)) ngram.word = word.wreal();
+				// Добавляем n-грамму в блок
+				if(ngram.end > ngram.begin) chunk.ngrams.push_back(std::move(ngram));
 			}
-			// Если функция вывода статуса передана
-			if(status != nullptr){
-				// Увеличиваем количество записанных n-грамм
-				index += text.size();
-				// Выполняем расчёт текущего статуса
-				actual = u_short(index / double(fileSize) * 100.0);
-				// Если статус обновился
-				if(actual != past){
-					// Запоминаем текущий статус
-					past = actual;
-					// Выводим статус извлечения
-					status(actual);
+		};
+		// Выполняем инициализацию тредпула
+		this->tpool.init(this->threads);
+		/**
+		 * Выполняем отображение файла в памяти, блоки разбираются параллельно,
+		 * а n-граммы добавляются последовательно в порядке файла.
+		 */
+		fsys_t::rarpa(filename, 0x400000, [&](const vector <std::string_view> & chunks, const uintmax_t fileSize) noexcept {
+			// Количество блоков разбираемых за один проход
+			const size_t window = (max(this->threads, size_t(1)) * 2);
+			// Разобранные блоки
+			vector <chunk_t> parsed(window);
+			// Переходим по всем блокам проходами
+			for(size_t first = 0; first < chunks.size(); first += window){
+				// Получаем конец прохода
+				const size_t last = min(first + window, chunks.size());
+				// Выполняем разбор блоков параллельно
+				this->tpool.parallel_for(first, last, [&](const size_t begin, const size_t end){
+					// Слово, переиспользуемое для всех слов блока
+					word_t word = L"";
+					// Переходим по всем блокам
+					for(size_t i = begin; i < end; i++){
+						// Получаем разобранный блок
+						chunk_t & chunk = parsed[i - first];
+						// Очищаем список n-грамм
+						chunk.ngrams.clear();
+						// Очищаем последовательности
+						chunk.seqs.clear();
+						// Запоминаем размер блока
+						chunk.size = chunks[i].size();
+						// Переходим по всем строкам блока
+						fsys_t::lines(chunks[i], [&](const std::string_view & line){
+							// Выполняем разбор строки
+							parseFn(line, chunk, word);
+						});
+					}
+				}, 1);
+				// Добавляем разобранные n-граммы в порядке файла
+				for(size_t i = first; i < last; i++){
+					// Получаем разобранный блок
+					const chunk_t & chunk = parsed[i - first];
+					// Переходим по всем n-граммам блока
+					for(auto & ngram : chunk.ngrams){
+						// Получаем последовательность n-граммы
+						seq.assign(chunk.seqs.begin() + ngram.begin, chunk.seqs.begin() + ngram.end);
+						// Если количество собранных n-грамм выше установленных, меняем
+						if(seq.size() > size_t(this->size)){
+							// Устанавливаем новый размер n-грамм
+							this->size = seq.size();
+							// Устанавливаем новый размер n-грамм для arpa
+							this->arpa->setSize(this->size);
+						}
+						// Добавляем слово в словарь
+						if(!ngram.word.empty()) this->addWord(ngram.word, ngram.idw);
+						// Добавляем последовательность в языковую модель
+						this->arpa->set(seq, ngram.weight, ngram.backoff);
+					}
+					// Если функция вывода статуса передана
+					if(status != nullptr){
+						// Увеличиваем количество обработанных данных
+						index += chunk.size;
+						// Выполняем расчёт текущего статуса
+						actual = u_short(index / double(fileSize) * 100.0);
+						// Если статус обновился
+						if(actual != past){
+							// Запоминаем текущий статус
+							past = actual;
+							// Выводим статус извлечения
+							status(actual);
+						}
+					}
 				}
 			}
 		});
+		// Ожидаем завершения обработки
+		this->tpool.wait();
+		// Заголовок файла в блоки не входит, поэтому завершаем вывод статуса
+		if((status != nullptr) && (actual != 100)) status(100);
 		// Обновляем количество уникальных слов
 		this->info.unq = this->vocab.size();
 	// Выводим сообщение об ошибке
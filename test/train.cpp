@@ -0,0 +1,233 @@
+/**
+ *  author:   Yuriy Lobarev
+ *  telegram: @forman
+ *  phone:    +7(910)983-95-90
+ *  email:    forman@anyks.com
+ *  site:     https://anyks.com
+ */
+
+#include <clocale>
+#include <fstream>
+#include <toolkit.hpp>
+#include <collector.hpp>
+
+// Устанавливаем область видимости
+using namespace std;
+using namespace anyks;
+
+/**
+ * Smoothing Структура параметров проверяемого алгоритма сглаживания
+ */
+typedef struct Smoothing {
+	// Название алгоритма
+	const char * name;
+	// Алгоритм сглаживания
+	toolkit_t::algorithm_t algorithm;
+	// Флаги модификации и подготовки KneserNey
+	bool modified, prepares;
+} smoothing_t;
+
+/**
+ * train Функция обучения языковой модели на корпусе и записи её в файл arpa
+ * @param locale    локаль алфавита
+ * @param corpus    адрес файла корпуса
+ * @param filename  адрес файла arpa для записи
+ * @param smoothing параметры алгоритма сглаживания
+ * @param threads   количество потоков обучения
+ */
+static void train(const string & locale, const string & corpus, const string & filename, const smoothing_t & smoothing, const size_t threads) noexcept {
+	// Создаём алфавит
+	alphabet_t alphabet(locale);
+	// Устанавливаем буквы алфавита
+	alphabet.set("abcdefghijklmnopqrstuvwxyz");
+	// Создаём токенизатор
+	tokenizer_t tokenizer(&alphabet);
+	// Создаём объект тулкита языковой модели
+	toolkit_t toolkit(&alphabet, &tokenizer, 3);
+	// Разрешаем токен неизвестного слова
+	toolkit.setOption(toolkit_t::options_t::allowUnk);
+	// Включаем интерполяцию
+	toolkit.setOption(toolkit_t::options_t::interpolate);
+	// Устанавливаем количество потоков обучения
+	toolkit.setThreads(threads);
+	// Устанавливаем алгоритм сглаживания
+	toolkit.init(smoothing.algorithm, smoothing.modified, smoothing.prepares, 0.0);
+	// Подсчёт n-грамм выполняется в одном потоке, различаться может только обучение
+	fsys_t::rfile(corpus, [&toolkit](const string & text, const uintmax_t size) noexcept {
+		// Если текст получен
+		if(!text.empty()) toolkit.addText(text, 0);
+	});
+	// Выполняем обучение
+	toolkit.train();
+	// Выполняем запись arpa
+	toolkit.writeArpa(filename);
+}
+
+/**
+ * collect Функция сбора слов и n-грамм корпуса коллектором и записи словаря и карты последовательностей в файлы
+ * @param locale  локаль алфавита
+ * @param corpus  адрес файла корпуса
+ * @param vocab   адрес файла словаря для записи
+ * @param map     адрес файла карты последовательностей для записи
+ * @param threads количество потоков сбора
+ */
+static void collect(const string & locale, const string & corpus, const string & vocab, const string & map, const size_t threads) noexcept {
+	// Создаём алфавит
+	alphabet_t alphabet(locale);
+	// Устанавливаем буквы алфавита
+	alphabet.set("abcdefghijklmnopqrstuvwxyz");
+	// Создаём токенизатор
+	tokenizer_t tokenizer(&alphabet);
+	// Создаём объект тулкита языковой модели
+	toolkit_t toolkit(&alphabet, &tokenizer, 3);
+	// Разрешаем токен неизвестного слова
+	toolkit.setOption(toolkit_t::options_t::allowUnk);
+	// Устанавливаем алгоритм сглаживания
+	toolkit.init(toolkit_t::algorithm_t::wittenBell, false, false, 0.0);
+	// Создаём коллектор
+	collector_t collector(&toolkit, &alphabet, &tokenizer, nullptr);
+	// Запрещаем использование объекта Python
+	collector.disallowPython();
+	// Устанавливаем размер n-граммы
+	collector.setOrder(3);
+	// Устанавливаем количество потоков, без сегментации файл делится на блоки по числу потоков
+	collector.setThreads(threads);
+	// Выполняем сбор слов и n-грамм
+	collector.readFile(corpus);
+	// Выполняем запись словаря и карты последовательностей
+	toolkit.writeVocab(vocab);
+	toolkit.writeMap(map);
+}
+
+/**
+ * read Функция чтения файла без строки с датой сборки
+ * @param filename адрес файла
+ * @return         содержимое файла
+ */
+static const string read(const string & filename) noexcept {
+	// Результат работы функции
+	string result = "";
+	// Строка файла
+	string line = "";
+	// Открываем файл на чтение
+	ifstream file(filename, ios::binary);
+	// Считываем все строки файла
+	while(getline(file, line)){
+		// Дата сборки отличается у каждого запуска, пропускаем её
+		if(line.find("#  built:") == 0) continue;
+		// Добавляем строку
+		result.append(line);
+		// Добавляем перенос строки
+		result.append("\n");
+	}
+	// Выводим результат
+	return result;
+}
+
+/**
+ * main Главная функция приложения
+ * @param argc длина массива параметров
+ * @param argv массив параметров
+ * @return     код выхода из приложения
+ *
+ * Проверка того, что параллельное обучение Arpa::train даёт тот же файл arpa, что и последовательное,
+ * а сбор корпуса коллектором в несколько потоков даёт те же словарь и карту последовательностей, что и в один поток,
+ * параметры: адрес файла корпуса, количество потоков (по умолчанию 4) и каталог для файлов (по умолчанию текущий)
+ */
+int main(int argc, char * argv[]){
+	// Если корпус не передан, выходим
+	if(argc < 2){
+		// Выводим сообщение об ошибке
+		printf("usage: %s <corpus> [threads] [directory]\n", argv[0]);
+		// Выходим
+		return 1;
+	}
+	// Локаль алфавита, в контейнерах обычно есть только C.UTF-8
+	string locale = "";
+	// Выбираем первую доступную локаль UTF-8
+	for(auto name : {"en_US.UTF-8", "C.UTF-8"}){
+		// Если локаль доступна, запоминаем её
+		if(::setlocale(LC_CTYPE, name) != nullptr){
+			// Запоминаем локаль
+			locale = name;
+			// Выходим из цикла
+			break;
+		}
+	}
+	// Без локали UTF-8 алфавит создать нельзя, проверка должна завершиться ошибкой, а не пропуском
+	if(locale.empty()){
+		// Выводим сообщение об ошибке
+		printf("neither en_US.UTF-8 nor C.UTF-8 locale is available\n");
+		// Выходим
+		return 1;
+	}
+	// Адрес файла корпуса
+	const string corpus = argv[1];
+	// Количество потоков параллельного обучения
+	const size_t threads = (argc > 2 ? stoull(argv[2]) : 4);
+	// Каталог для файлов
+	const string directory = (argc > 3 ? argv[3] : ".");
+	// Количество алгоритмов, обученных с расхождениями
+	size_t failed = 0;
+	// Список проверяемых алгоритмов сглаживания
+	const vector <smoothing_t> smoothings = {
+		{"wittenbell", toolkit_t::algorithm_t::wittenBell, false, false},
+		{"addsmooth", toolkit_t::algorithm_t::addSmooth, false, false},
+		{"goodturing", toolkit_t::algorithm_t::goodTuring, false, false},
+		{"cdiscount", toolkit_t::algorithm_t::constDiscount, false, false},
+		{"ndiscount", toolkit_t::algorithm_t::naturalDiscount, false, false},
+		{"kneserney", toolkit_t::algorithm_t::kneserNey, true, true},
+		{"mkneserney", toolkit_t::algorithm_t::modKneserNey, true, true}
+	};
+	// Переходим по всем алгоритмам сглаживания
+	for(auto & smoothing : smoothings){
+		// Формируем адреса файлов arpa последовательного и параллельного обучения
+		const string serial = (directory + "/" + smoothing.name + "_1.arpa");
+		const string parallel = (directory + "/" + smoothing.name + "_" + to_string(threads) + ".arpa");
+		// Выполняем последовательное обучение
+		train(locale, corpus, serial, smoothing, 1);
+		// Выполняем параллельное обучение
+		train(locale, corpus, parallel, smoothing, threads);
+		// Получаем содержимое файлов
+		const string & first = read(serial), & second = read(parallel);
+		// Если файлы совпадают
+		if(!first.empty() && (first == second)){
+			// Выводим результат
+			printf("%s: ok\n", smoothing.name);
+			// Удаляем файлы arpa
+			remove(serial.c_str());
+			remove(parallel.c_str());
+		// Если файлы различаются
+		} else {
+			// Выводим сообщение об ошибке
+			printf("%s: %s and %s differ\n", smoothing.name, serial.c_str(), parallel.c_str());
+			// Увеличиваем количество расхождений
+			failed++;
+		}
+	}
+	// Формируем адреса файлов словаря и карты последовательностей сбора в один поток и в несколько
+	const string vocab1 = (directory + "/collect_1.vocab"), vocab2 = (directory + "/collect_" + to_string(threads) + ".vocab");
+	const string map1 = (directory + "/collect_1.map"), map2 = (directory + "/collect_" + to_string(threads) + ".map");
+	// Выполняем сбор корпуса в один поток
+	collect(locale, corpus, vocab1, map1, 1);
+	// Выполняем сбор корпуса в несколько потоков
+	collect(locale, corpus, vocab2, map2, threads);
+	// Если словари и карты последовательностей совпадают
+	if(!read(vocab1).empty() && !read(map1).empty() && (read(vocab1) == read(vocab2)) && (read(map1) == read(map2))){
+		// Выводим результат
+		printf("collector: ok\n");
+		// Удаляем файлы словарей и карт последовательностей
+		remove(vocab1.c_str());
+		remove(vocab2.c_str());
+		remove(map1.c_str());
+		remove(map2.c_str());
+	// Если файлы различаются
+	} else {
+		// Выводим сообщение об ошибке
+		printf("collector: %s and %s or %s and %s differ\n", vocab1.c_str(), vocab2.c_str(), map1.c_str(), map2.c_str());
+		// Увеличиваем количество расхождений
+		failed++;
+	}
+	// Выходим
+	return (failed > 0 ? 1 : 0);
+}